@@ -0,0 +1,195 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BAND_LLT_H
+#define EIGEN_BAND_LLT_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+template <typename Scalar_>
+class BandLLT;
+
+namespace internal {
+
+template <typename Scalar_>
+struct traits<BandLLT<Scalar_> > : traits<Matrix<Scalar_, Dynamic, Dynamic> > {
+  typedef MatrixXpr XprKind;
+  typedef SolverStorage StorageKind;
+  typedef int StorageIndex;
+  enum { Flags = 0 };
+};
+
+}  // namespace internal
+
+/** \ingroup Cholesky_Module
+ *
+ * \class BandLLT
+ *
+ * \brief Cholesky decomposition (LL^T) of a selfadjoint positive definite band matrix
+ *
+ * \tparam Scalar_ the type of the coefficients
+ *
+ * This class computes the Cholesky factorization A = LL^* of a selfadjoint band matrix with \c kd
+ * sub-diagonals, as LAPACK's \c pbtrf. The factor L has the same band structure, so that the
+ * decomposition takes O(n kd^2) operations and (kd+1) n coefficients of storage.
+ *
+ * The matrix is given as a BandMatrix. Its lower part is read, unless it has no sub-diagonals, in
+ * which case the upper part is read instead, as for a \c #SelfAdjoint BandMatrix storing its super-diagonals.
+ *
+ * \sa class BandPartialPivLU, class LLT
+ */
+template <typename Scalar_>
+class BandLLT : public SolverBase<BandLLT<Scalar_> > {
+ public:
+  typedef SolverBase<BandLLT> Base;
+  friend class SolverBase<BandLLT>;
+
+  EIGEN_GENERIC_PUBLIC_INTERFACE(BandLLT)
+  typedef Matrix<Scalar, Dynamic, Dynamic> CoefficientsType;
+
+  BandLLT() : m_isInitialized(false), m_info(Success) {}
+
+  template <typename Derived>
+  explicit BandLLT(const internal::BandMatrixBase<Derived>& matrix) : m_isInitialized(false), m_info(Success) {
+    compute(matrix);
+  }
+
+  template <typename Derived>
+  BandLLT& compute(const internal::BandMatrixBase<Derived>& matrix);
+
+#ifdef EIGEN_PARSED_BY_DOXYGEN
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A. */
+  template <typename Rhs>
+  inline const Solve<BandLLT, Rhs> solve(const MatrixBase<Rhs>& b) const;
+#endif
+
+  template <typename Derived>
+  void solveInPlace(const MatrixBase<Derived>& bAndX) const;
+
+  /** \returns the band storage of L, such that L(i,j) = matrixLLT()(i-j, j) for 0 <= i-j <= bandwidth() */
+  inline const CoefficientsType& matrixLLT() const {
+    eigen_assert(m_isInitialized && "BandLLT is not initialized.");
+    return m_band;
+  }
+
+  /** \returns the number of sub-diagonals of L */
+  inline Index bandwidth() const { return m_band.rows() - 1; }
+
+  /** \brief Reports whether previous computation was successful.
+   *
+   * \returns \c Success if computation was successful,
+   *          \c NumericalIssue if the matrix.appears not to be positive definite.
+   */
+  ComputationInfo info() const {
+    eigen_assert(m_isInitialized && "BandLLT is not initialized.");
+    return m_info;
+  }
+
+  const BandLLT& adjoint() const EIGEN_NOEXCEPT { return *this; }
+
+  inline EIGEN_CONSTEXPR Index rows() const EIGEN_NOEXCEPT { return m_band.cols(); }
+  inline EIGEN_CONSTEXPR Index cols() const EIGEN_NOEXCEPT { return m_band.cols(); }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+  template <typename RhsType, typename DstType>
+  void _solve_impl(const RhsType& rhs, DstType& dst) const {
+    _solve_impl_transposed<true>(rhs, dst);
+  }
+
+  template <bool Conjugate, typename RhsType, typename DstType>
+  void _solve_impl_transposed(const RhsType& rhs, DstType& dst) const {
+    // A^T = conj(A)
+    dst = rhs.template conjugateIf<!Conjugate>();
+    solveInPlace(dst);
+    if (!Conjugate) dst = dst.conjugate();
+  }
+#endif
+
+ protected:
+  EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar)
+
+  CoefficientsType m_band;
+  bool m_isInitialized;
+  ComputationInfo m_info;
+};
+
+template <typename Scalar_>
+template <typename Derived>
+BandLLT<Scalar_>& BandLLT<Scalar_>::compute(const internal::BandMatrixBase<Derived>& matrix) {
+  using std::sqrt;
+  eigen_assert(matrix.rows() == matrix.cols());
+  const Index size = matrix.rows();
+  const Index supers = matrix.supers();
+  const bool lower = matrix.subs() > 0 || supers == 0;
+  const Index kd = lower ? matrix.subs() : supers;
+
+  // L(i,j) is stored at (i-j, j), such that the columns of L are contiguous.
+  // The coefficients past the last row of L are kept to zero.
+  m_band.setZero(kd + 1, size);
+  for (Index j = 0; j < size; ++j) {
+    const Index len = numext::mini(kd, size - 1 - j);
+    for (Index d = 0; d <= len; ++d)
+      m_band.coeffRef(d, j) =
+          lower ? matrix.coeffs().coeff(supers + d, j) : numext::conj(matrix.coeffs().coeff(supers - d, j + d));
+  }
+
+  m_info = Success;
+  for (Index j = 0; j < size; ++j) {
+    const Index len = numext::mini(kd, size - 1 - j);
+    RealScalar x = numext::real(m_band.coeff(0, j));
+    if (x <= RealScalar(0)) {
+      m_info = NumericalIssue;
+      break;
+    }
+    m_band.coeffRef(0, j) = x = sqrt(x);
+    if (len == 0) continue;
+    m_band.col(j).segment(1, len) /= x;
+    // The trailing len x len block is a dense matrix with outer stride kd in
+    // the band storage. Only its lower part is updated, the upper part aliases
+    // other coefficients of the band.
+    Map<CoefficientsType, 0, OuterStride<> > a22(&m_band.coeffRef(0, j + 1), len, len, OuterStride<>(kd));
+    a22.template selfadjointView<Lower>().rankUpdate(m_band.col(j).segment(1, len), RealScalar(-1));
+  }
+  m_isInitialized = true;
+  return *this;
+}
+
+/** \internal use x = llt_object.solve(x);
+ *
+ * This is the \em in-place version of solve().
+ *
+ * \warning The parameter is only marked 'const' to make the C++ compiler accept a temporary expression here.
+ * This function will const_cast it, so constness isn't honored here.
+ */
+template <typename Scalar_>
+template <typename Derived>
+void BandLLT<Scalar_>::solveInPlace(const MatrixBase<Derived>& bAndX) const {
+  eigen_assert(m_isInitialized && "BandLLT is not initialized.");
+  eigen_assert(rows() == bAndX.rows());
+  Derived& x = bAndX.const_cast_derived();
+  const Index size = rows();
+  const Index kd = bandwidth();
+  // L y = b
+  for (Index j = 0; j < size; ++j) {
+    const Index len = numext::mini(kd, size - 1 - j);
+    x.row(j) /= m_band.coeff(0, j);
+    if (len > 0) x.middleRows(j + 1, len).noalias() -= m_band.col(j).segment(1, len) * x.row(j);
+  }
+  // L^* x = y
+  for (Index j = size - 1; j >= 0; --j) {
+    const Index len = numext::mini(kd, size - 1 - j);
+    if (len > 0) x.row(j).noalias() -= m_band.col(j).segment(1, len).adjoint() * x.middleRows(j + 1, len);
+    x.row(j) /= m_band.coeff(0, j);
+  }
+}
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_BAND_LLT_H
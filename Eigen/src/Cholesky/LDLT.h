@@ -474,6 +474,8 @@ template <typename InputType>
 LDLT<MatrixType, UpLo_>& LDLT<MatrixType, UpLo_>::compute(const EigenBase<InputType>& a) {
   eigen_assert(a.rows() == a.cols());
   const Index size = a.rows();
+  EIGEN_INSTRUMENT_KERNEL("ldlt", double(size) * double(size) * double(size) / 3,
+                          2.0 * double(size) * double(size) * double(sizeof(Scalar)));
 
   m_matrix = a.derived();
 
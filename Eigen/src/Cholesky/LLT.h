@@ -399,6 +399,8 @@ template <typename InputType>
 LLT<MatrixType, UpLo_>& LLT<MatrixType, UpLo_>::compute(const EigenBase<InputType>& a) {
   eigen_assert(a.rows() == a.cols());
   const Index size = a.rows();
+  EIGEN_INSTRUMENT_KERNEL("llt", double(size) * double(size) * double(size) / 3,
+                          2.0 * double(size) * double(size) * double(sizeof(Scalar)));
   m_matrix.resize(size, size);
   if (!internal::is_same_dense(m_matrix, a.derived())) m_matrix = a.derived();
 
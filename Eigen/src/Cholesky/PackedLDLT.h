@@ -0,0 +1,254 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PACKED_LDLT_H
+#define EIGEN_PACKED_LDLT_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+template <typename MatrixType_>
+struct traits<PackedLDLT<MatrixType_> > : traits<MatrixType_> {
+  typedef MatrixXpr XprKind;
+  typedef SolverStorage StorageKind;
+  typedef int StorageIndex;
+  enum { Flags = 0 };
+};
+
+/* Right-looking blocked LDL^* factorization of a packed matrix, without
+ * pivoting. D overwrites the diagonal and the unit lower triangular L the
+ * strictly lower part of L.
+ *
+ * Each panel of columns is factorized by the left-looking algorithm, which
+ * also computes the rows of the panel below its diagonal block. The trailing
+ * matrix is updated by the product of L21 D by L21^*.
+ */
+template <typename Scalar, int UpLo>
+struct packed_ldlt {
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  static Index blocked(Scalar* data, Index size) {
+    typedef packed_storage<Scalar, UpLo> Storage;
+    typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+    const Index bs = Storage::panel_size(size);
+    MatrixType panel, work, trailing;
+    Matrix<Scalar, Dynamic, 1> temp;
+    for (Index k = 0; k < size; k += bs) {
+      const Index cols = numext::mini(bs, size - k);
+      const Index rs = size - k - cols;
+      panel.resize(size - k, cols);
+      Storage::gather_lower(data, size, k, k, panel);
+
+      for (Index c = 0; c < cols; ++c) {
+        const Index rows = size - k - c;
+        if (c > 0) {
+          temp.noalias() = panel.diagonal().head(c).cwiseProduct(panel.row(c).head(c).adjoint());
+          panel.col(c).tail(rows).noalias() -= panel.block(c, 0, rows, c) * temp;
+        }
+        const RealScalar d = numext::real(panel.coeff(c, c));
+        if (d == RealScalar(0) || !(numext::isfinite)(d)) return k + c;
+        panel.coeffRef(c, c) = d;
+        panel.col(c).tail(rows - 1) /= d;
+      }
+      Storage::scatter_lower(data, size, k, k, panel);
+
+      // A22 -= L21 D L21^*
+      Block<MatrixType, Dynamic, Dynamic> l21(panel, cols, 0, rs, cols);
+      work.noalias() = l21 * panel.diagonal().asDiagonal();
+      for (Index j = 0; j < rs; j += bs) {
+        const Index tcols = numext::mini(bs, rs - j);
+        trailing.resize(rs - j, tcols);
+        Storage::gather_lower(data, size, k + cols + j, k + cols + j, trailing);
+        trailing.noalias() -= work.bottomRows(rs - j) * l21.middleRows(j, tcols).adjoint();
+        Storage::scatter_lower(data, size, k + cols + j, k + cols + j, trailing);
+      }
+    }
+    return -1;
+  }
+};
+
+}  // namespace internal
+
+/** \ingroup Cholesky_Module
+ *
+ * \class PackedLDLT
+ *
+ * \brief Cholesky decomposition without square root (LDL^T) of a selfadjoint matrix in packed storage
+ *
+ * \tparam MatrixType_ the type of the packed matrix, a PackedSelfAdjointMatrix
+ *
+ * This class computes A = L D L^* where L is unit lower triangular and D is diagonal. The factors
+ * overwrite a copy of A in the packed format of PackedSelfAdjointMatrix: D on the diagonal, and the
+ * strictly lower part of L (for a \c #Lower storage) or the strictly upper part of L^* (for an \c #Upper
+ * storage) elsewhere. The copy can be avoided by moving the matrix to compute().
+ *
+ * Unlike LDLT, the decomposition is computed without pivoting, which preserves the packed layout and
+ * allows a blocked algorithm based on matrix products. It is therefore only stable for positive or
+ * negative definite matrices (or, more generally, for matrices whose leading principal minors are
+ * well conditioned), and info() reports \c NumericalIssue when a pivot vanishes.
+ *
+ * \sa PackedSelfAdjointMatrix::ldlt(), class LDLT, class PackedLLT
+ */
+template <typename MatrixType_>
+class PackedLDLT : public SolverBase<PackedLDLT<MatrixType_> > {
+ public:
+  typedef MatrixType_ MatrixType;
+  typedef SolverBase<PackedLDLT> Base;
+  friend class SolverBase<PackedLDLT>;
+
+  EIGEN_GENERIC_PUBLIC_INTERFACE(PackedLDLT)
+  enum { UpLo = MatrixType::UpLo };
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+
+  /** \brief Default Constructor.
+   *
+   * The default constructor is useful in cases in which the user intends to
+   * perform decompositions via PackedLDLT::compute().
+   */
+  PackedLDLT() : m_matrix(), m_isInitialized(false), m_info(Success) {}
+
+  explicit PackedLDLT(const MatrixType& matrix) : m_matrix(), m_isInitialized(false), m_info(Success) {
+    compute(matrix);
+  }
+
+  /** Computes the decomposition in the storage of \a matrix, which is left empty. */
+  explicit PackedLDLT(MatrixType&& matrix) : m_matrix(), m_isInitialized(false), m_info(Success) {
+    compute(std::move(matrix));
+  }
+
+  PackedLDLT& compute(const MatrixType& matrix) {
+    m_matrix = matrix;
+    return factorize();
+  }
+
+  /** Computes the decomposition in the storage of \a matrix, which is left empty. */
+  PackedLDLT& compute(MatrixType&& matrix) {
+    m_matrix = std::move(matrix);
+    matrix.resize(0);
+    return factorize();
+  }
+
+#ifdef EIGEN_PARSED_BY_DOXYGEN
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+   *
+   * \sa solveInPlace(), PackedSelfAdjointMatrix::ldlt()
+   */
+  template <typename Rhs>
+  inline const Solve<PackedLDLT, Rhs> solve(const MatrixBase<Rhs>& b) const;
+#endif
+
+  template <typename Derived>
+  void solveInPlace(const MatrixBase<Derived>& bAndX) const;
+
+  /** \returns the coefficients of the diagonal matrix D */
+  inline Matrix<Scalar, Dynamic, 1> vectorD() const {
+    eigen_assert(m_isInitialized && "PackedLDLT is not initialized.");
+    return m_matrix.diagonal();
+  }
+
+  /** \returns the packed factors, see the class documentation for their layout */
+  inline const MatrixType& matrixLDLT() const {
+    eigen_assert(m_isInitialized && "PackedLDLT is not initialized.");
+    return m_matrix;
+  }
+
+  DenseMatrixType reconstructedMatrix() const;
+
+  /** \brief Reports whether previous computation was successful.
+   *
+   * \returns \c Success if computation was successful,
+   *          \c NumericalIssue if a pivot vanished.
+   */
+  ComputationInfo info() const {
+    eigen_assert(m_isInitialized && "PackedLDLT is not initialized.");
+    return m_info;
+  }
+
+  /** \returns the adjoint of \c *this, that is, a const reference to the decomposition itself as the underlying matrix
+   * is self-adjoint.
+   */
+  const PackedLDLT& adjoint() const EIGEN_NOEXCEPT { return *this; }
+
+  inline EIGEN_CONSTEXPR Index rows() const EIGEN_NOEXCEPT { return m_matrix.rows(); }
+  inline EIGEN_CONSTEXPR Index cols() const EIGEN_NOEXCEPT { return m_matrix.cols(); }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+  template <typename RhsType, typename DstType>
+  void _solve_impl(const RhsType& rhs, DstType& dst) const {
+    _solve_impl_transposed<true>(rhs, dst);
+  }
+
+  template <bool Conjugate, typename RhsType, typename DstType>
+  void _solve_impl_transposed(const RhsType& rhs, DstType& dst) const {
+    // A^T = conj(A)
+    dst = rhs.template conjugateIf<!Conjugate>();
+    solveInPlace(dst);
+    if (!Conjugate) dst = dst.conjugate();
+  }
+#endif
+
+ protected:
+  EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar)
+
+  PackedLDLT& factorize() {
+    const Index ret = internal::packed_ldlt<Scalar, UpLo>::blocked(m_matrix.data(), m_matrix.rows());
+    m_info = ret == -1 ? Success : NumericalIssue;
+    m_isInitialized = true;
+    return *this;
+  }
+
+  MatrixType m_matrix;
+  bool m_isInitialized;
+  ComputationInfo m_info;
+};
+
+/** \internal use x = ldlt_object.solve(x);
+ *
+ * This is the \em in-place version of solve().
+ *
+ * \warning The parameter is only marked 'const' to make the C++ compiler accept a temporary expression here.
+ * This function will const_cast it, so constness isn't honored here.
+ */
+template <typename MatrixType>
+template <typename Derived>
+void PackedLDLT<MatrixType>::solveInPlace(const MatrixBase<Derived>& bAndX) const {
+  eigen_assert(m_isInitialized && "PackedLDLT is not initialized.");
+  eigen_assert(m_matrix.rows() == bAndX.rows());
+  Derived& x = bAndX.const_cast_derived();
+  internal::packed_triangular_solver<Scalar, UpLo, UnitLower>::run(m_matrix.data(), rows(), x);
+  x = vectorD().asDiagonal().inverse() * x;
+  internal::packed_triangular_solver<Scalar, UpLo, UnitUpper>::run(m_matrix.data(), rows(), x);
+}
+
+/** \returns the matrix represented by the decomposition,
+ * i.e., it returns the product: L D L^*.
+ * This function is provided for debug purpose. */
+template <typename MatrixType>
+typename PackedLDLT<MatrixType>::DenseMatrixType PackedLDLT<MatrixType>::reconstructedMatrix() const {
+  eigen_assert(m_isInitialized && "PackedLDLT is not initialized.");
+  DenseMatrixType l(rows(), cols());
+  internal::packed_storage<Scalar, UpLo>::gather_lower(m_matrix.data(), rows(), 0, 0, l);
+  l.diagonal().setOnes();
+  return l * vectorD().asDiagonal() * l.adjoint();
+}
+
+/** \cholesky_module
+ * \returns the PackedLDLT decomposition of \c *this
+ */
+template <typename Scalar_, int UpLo_>
+inline const PackedLDLT<PackedSelfAdjointMatrix<Scalar_, UpLo_> > PackedSelfAdjointMatrix<Scalar_, UpLo_>::ldlt()
+    const {
+  return PackedLDLT<PackedSelfAdjointMatrix>(*this);
+}
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_PACKED_LDLT_H
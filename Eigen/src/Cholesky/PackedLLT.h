@@ -0,0 +1,234 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PACKED_LLT_H
+#define EIGEN_PACKED_LLT_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+template <typename MatrixType_>
+struct traits<PackedLLT<MatrixType_> > : traits<MatrixType_> {
+  typedef MatrixXpr XprKind;
+  typedef SolverStorage StorageKind;
+  typedef int StorageIndex;
+  enum { Flags = 0 };
+};
+
+/* Right-looking blocked Cholesky factorization of a packed matrix.
+ *
+ * Each panel of columns of L is gathered to a dense buffer, factorized by the
+ * dense blocked algorithm, and scattered back. The trailing matrix is then
+ * updated one panel of columns at a time by a matrix product with the panel.
+ */
+template <typename Scalar, int UpLo>
+struct packed_llt {
+  static Index blocked(Scalar* data, Index size) {
+    typedef packed_storage<Scalar, UpLo> Storage;
+    typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+    const Index bs = Storage::panel_size(size);
+    MatrixType panel, trailing;
+    for (Index k = 0; k < size; k += bs) {
+      const Index cols = numext::mini(bs, size - k);
+      const Index rs = size - k - cols;
+      panel.resize(size - k, cols);
+      Storage::gather_lower(data, size, k, k, panel);
+
+      Block<MatrixType, Dynamic, Dynamic> a11(panel, 0, 0, cols, cols);
+      Index ret;
+      if ((ret = llt_inplace<Scalar, Lower>::blocked(a11)) >= 0) return k + ret;
+      if (rs > 0) a11.adjoint().template triangularView<Upper>().template solveInPlace<OnTheRight>(panel.bottomRows(rs));
+      Storage::scatter_lower(data, size, k, k, panel);
+
+      // A22 -= L21 L21^*
+      Block<MatrixType, Dynamic, Dynamic> l21(panel, cols, 0, rs, cols);
+      for (Index j = 0; j < rs; j += bs) {
+        const Index tcols = numext::mini(bs, rs - j);
+        trailing.resize(rs - j, tcols);
+        Storage::gather_lower(data, size, k + cols + j, k + cols + j, trailing);
+        trailing.noalias() -= l21.bottomRows(rs - j) * l21.middleRows(j, tcols).adjoint();
+        Storage::scatter_lower(data, size, k + cols + j, k + cols + j, trailing);
+      }
+    }
+    return -1;
+  }
+};
+
+}  // namespace internal
+
+/** \ingroup Cholesky_Module
+ *
+ * \class PackedLLT
+ *
+ * \brief Standard Cholesky decomposition (LL^T) of a selfadjoint matrix in packed storage
+ *
+ * \tparam MatrixType_ the type of the packed matrix, a PackedSelfAdjointMatrix
+ *
+ * This class performs the same decomposition as LLT, A = LL^* = U^*U, but reads A and stores the
+ * factor in the packed format of PackedSelfAdjointMatrix. The factor L (for a \c #Lower storage) or U
+ * (for an \c #Upper storage) overwrites a copy of A, so that the decomposition takes half the memory
+ * of a LLT on a full matrix. The copy can be avoided by moving the matrix to compute().
+ *
+ * The factorization is blocked: the panels of columns are factorized by the dense LLT algorithm
+ * and the trailing matrix is updated by matrix products, such that its speed is close to the one
+ * of a LLT on a full matrix.
+ *
+ * \sa PackedSelfAdjointMatrix::llt(), class LLT, class PackedLDLT
+ */
+template <typename MatrixType_>
+class PackedLLT : public SolverBase<PackedLLT<MatrixType_> > {
+ public:
+  typedef MatrixType_ MatrixType;
+  typedef SolverBase<PackedLLT> Base;
+  friend class SolverBase<PackedLLT>;
+
+  EIGEN_GENERIC_PUBLIC_INTERFACE(PackedLLT)
+  enum { UpLo = MatrixType::UpLo };
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+
+  /** \brief Default Constructor.
+   *
+   * The default constructor is useful in cases in which the user intends to
+   * perform decompositions via PackedLLT::compute().
+   */
+  PackedLLT() : m_matrix(), m_isInitialized(false), m_info(Success) {}
+
+  explicit PackedLLT(const MatrixType& matrix) : m_matrix(), m_isInitialized(false), m_info(Success) {
+    compute(matrix);
+  }
+
+  /** Computes the decomposition in the storage of \a matrix, which is left empty. */
+  explicit PackedLLT(MatrixType&& matrix) : m_matrix(), m_isInitialized(false), m_info(Success) {
+    compute(std::move(matrix));
+  }
+
+  PackedLLT& compute(const MatrixType& matrix) {
+    m_matrix = matrix;
+    return factorize();
+  }
+
+  /** Computes the decomposition in the storage of \a matrix, which is left empty. */
+  PackedLLT& compute(MatrixType&& matrix) {
+    m_matrix = std::move(matrix);
+    matrix.resize(0);
+    return factorize();
+  }
+
+#ifdef EIGEN_PARSED_BY_DOXYGEN
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+   *
+   * \sa solveInPlace(), PackedSelfAdjointMatrix::llt()
+   */
+  template <typename Rhs>
+  inline const Solve<PackedLLT, Rhs> solve(const MatrixBase<Rhs>& b) const;
+#endif
+
+  template <typename Derived>
+  void solveInPlace(const MatrixBase<Derived>& bAndX) const;
+
+  /** \returns the packed factor, L for a \c #Lower storage and U for an \c #Upper one.
+   *
+   * Its coefficients are the ones of a PackedTriangularMatrix with the same storage.
+   */
+  inline const MatrixType& matrixLLT() const {
+    eigen_assert(m_isInitialized && "PackedLLT is not initialized.");
+    return m_matrix;
+  }
+
+  DenseMatrixType reconstructedMatrix() const;
+
+  /** \brief Reports whether previous computation was successful.
+   *
+   * \returns \c Success if computation was successful,
+   *          \c NumericalIssue if the matrix.appears not to be positive definite.
+   */
+  ComputationInfo info() const {
+    eigen_assert(m_isInitialized && "PackedLLT is not initialized.");
+    return m_info;
+  }
+
+  /** \returns the adjoint of \c *this, that is, a const reference to the decomposition itself as the underlying matrix
+   * is self-adjoint.
+   */
+  const PackedLLT& adjoint() const EIGEN_NOEXCEPT { return *this; }
+
+  inline EIGEN_CONSTEXPR Index rows() const EIGEN_NOEXCEPT { return m_matrix.rows(); }
+  inline EIGEN_CONSTEXPR Index cols() const EIGEN_NOEXCEPT { return m_matrix.cols(); }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+  template <typename RhsType, typename DstType>
+  void _solve_impl(const RhsType& rhs, DstType& dst) const {
+    _solve_impl_transposed<true>(rhs, dst);
+  }
+
+  template <bool Conjugate, typename RhsType, typename DstType>
+  void _solve_impl_transposed(const RhsType& rhs, DstType& dst) const {
+    // A^T = conj(A)
+    dst = rhs.template conjugateIf<!Conjugate>();
+    solveInPlace(dst);
+    if (!Conjugate) dst = dst.conjugate();
+  }
+#endif
+
+ protected:
+  EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar)
+
+  PackedLLT& factorize() {
+    const Index ret = internal::packed_llt<Scalar, UpLo>::blocked(m_matrix.data(), m_matrix.rows());
+    m_info = ret == -1 ? Success : NumericalIssue;
+    m_isInitialized = true;
+    return *this;
+  }
+
+  MatrixType m_matrix;
+  bool m_isInitialized;
+  ComputationInfo m_info;
+};
+
+/** \internal use x = llt_object.solve(x);
+ *
+ * This is the \em in-place version of solve().
+ *
+ * \warning The parameter is only marked 'const' to make the C++ compiler accept a temporary expression here.
+ * This function will const_cast it, so constness isn't honored here.
+ */
+template <typename MatrixType>
+template <typename Derived>
+void PackedLLT<MatrixType>::solveInPlace(const MatrixBase<Derived>& bAndX) const {
+  eigen_assert(m_isInitialized && "PackedLLT is not initialized.");
+  eigen_assert(m_matrix.rows() == bAndX.rows());
+  Derived& x = bAndX.const_cast_derived();
+  internal::packed_triangular_solver<Scalar, UpLo, Lower>::run(m_matrix.data(), rows(), x);
+  internal::packed_triangular_solver<Scalar, UpLo, Upper>::run(m_matrix.data(), rows(), x);
+}
+
+/** \returns the matrix represented by the decomposition,
+ * i.e., it returns the product: L L^*.
+ * This function is provided for debug purpose. */
+template <typename MatrixType>
+typename PackedLLT<MatrixType>::DenseMatrixType PackedLLT<MatrixType>::reconstructedMatrix() const {
+  eigen_assert(m_isInitialized && "PackedLLT is not initialized.");
+  DenseMatrixType l(rows(), cols());
+  internal::packed_storage<Scalar, UpLo>::gather_lower(m_matrix.data(), rows(), 0, 0, l);
+  return l * l.adjoint();
+}
+
+/** \cholesky_module
+ * \returns the PackedLLT decomposition of \c *this
+ */
+template <typename Scalar_, int UpLo_>
+inline const PackedLLT<PackedSelfAdjointMatrix<Scalar_, UpLo_> > PackedSelfAdjointMatrix<Scalar_, UpLo_>::llt() const {
+  return PackedLLT<PackedSelfAdjointMatrix>(*this);
+}
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_PACKED_LLT_H
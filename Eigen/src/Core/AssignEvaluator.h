@@ -25,6 +25,18 @@ namespace internal {
  * Part 1 : the logic deciding a strategy for traversal and unrolling       *
  ***************************************************************************/
 
+// Whether the packets of a destination are written at arbitrary positions with writePacket() rather than stored at
+// the address of their first coefficient, e.g., by scattering them into an IndexedView. Such destinations are
+// vectorized for plain assignments only, since compound assignments must accumulate into repeated positions, and
+// slice-vectorized without peeling for alignment.
+template <typename DstEvaluator>
+struct evaluator_scatters_packets : false_type {};
+
+template <typename Functor>
+struct is_plain_assign_op : false_type {};
+template <typename DstScalar, typename SrcScalar>
+struct is_plain_assign_op<assign_op<DstScalar, SrcScalar>> : true_type {};
+
 // copy_using_evaluator_traits is based on assign_traits
 
 template <typename DstEvaluator, typename SrcEvaluator, typename AssignFunc, int MaxPacketSize = -1>
@@ -39,6 +51,7 @@ struct copy_using_evaluator_traits {
     DstAlignment = DstEvaluator::Alignment,
     SrcAlignment = SrcEvaluator::Alignment,
     DstHasDirectAccess = (DstFlags & DirectAccessBit) == DirectAccessBit,
+    DstScattersPackets = evaluator_scatters_packets<DstEvaluator>::value,
     JointAlignment = plain_enum_min(DstAlignment, SrcAlignment)
   };
 
@@ -77,7 +90,8 @@ struct copy_using_evaluator_traits {
     SrcIsRowMajor = SrcFlags & RowMajorBit,
     StorageOrdersAgree = (int(DstIsRowMajor) == int(SrcIsRowMajor)),
     MightVectorize = bool(StorageOrdersAgree) && (int(DstFlags) & int(SrcFlags) & ActualPacketAccessBit) &&
-                     bool(functor_traits<AssignFunc>::PacketAccess),
+                     bool(functor_traits<AssignFunc>::PacketAccess) &&
+                     (!bool(DstScattersPackets) || bool(is_plain_assign_op<AssignFunc>::value)),
     MayInnerVectorize = MightVectorize && int(InnerSize) != Dynamic && int(InnerSize) % int(InnerPacketSize) == 0 &&
                         int(OuterStride) != Dynamic && int(OuterStride) % int(InnerPacketSize) == 0 &&
                         (EIGEN_UNALIGNED_VECTORIZE || int(JointAlignment) >= int(InnerRequiredAlignment)),
@@ -87,7 +101,7 @@ struct copy_using_evaluator_traits {
                           MaxSizeAtCompileTime == Dynamic),
     /* If the destination isn't aligned, we have to do runtime checks and we don't unroll,
        so it's only good for large enough sizes. */
-    MaySliceVectorize = bool(MightVectorize) && bool(DstHasDirectAccess) &&
+    MaySliceVectorize = bool(MightVectorize) && (bool(DstHasDirectAccess) || bool(DstScattersPackets)) &&
                         (int(InnerMaxSize) == Dynamic ||
                          int(InnerMaxSize) >= (EIGEN_UNALIGNED_VECTORIZE ? InnerPacketSize : (3 * InnerPacketSize)))
     /* slice vectorization can be slow, so we only want it if the slices are big, which is
@@ -173,6 +187,7 @@ struct copy_using_evaluator_traits {
     EIGEN_DEBUG_VAR(MayInnerVectorize)
     EIGEN_DEBUG_VAR(MayLinearVectorize)
     EIGEN_DEBUG_VAR(MaySliceVectorize)
+    EIGEN_DEBUG_VAR(DstScattersPackets)
     std::cerr << "Traversal"
               << " = " << Traversal << " (" << demangle_traversal(Traversal) << ")" << std::endl;
     EIGEN_DEBUG_VAR(SrcEvaluator::CoeffReadCost)
@@ -507,6 +522,19 @@ struct dense_assignment_loop<Kernel, LinearTraversal, CompleteUnrolling> {
 *** Slice vectorization ***
 ***************************/
 
+// Storage of the destination of a slice-vectorized assignment, which is only used for alignment when it is accessible.
+template <typename Kernel, bool DstHasDirectAccess>
+struct slice_vectorized_destination {
+  EIGEN_DEVICE_FUNC static const typename Kernel::Scalar* data(const Kernel& kernel) { return kernel.dstDataPtr(); }
+  EIGEN_DEVICE_FUNC static Index outerStride(const Kernel& kernel) { return kernel.outerStride(); }
+};
+
+template <typename Kernel>
+struct slice_vectorized_destination<Kernel, false> {
+  EIGEN_DEVICE_FUNC static const typename Kernel::Scalar* data(const Kernel&) { return nullptr; }
+  EIGEN_DEVICE_FUNC static Index outerStride(const Kernel&) { return 0; }
+};
+
 template <typename Kernel>
 struct dense_assignment_loop<Kernel, SliceVectorizedTraversal, NoUnrolling> {
   EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE EIGEN_CONSTEXPR void run(Kernel& kernel) {
@@ -515,12 +543,14 @@ struct dense_assignment_loop<Kernel, SliceVectorizedTraversal, NoUnrolling> {
     enum {
       packetSize = unpacket_traits<PacketType>::size,
       requestedAlignment = int(Kernel::AssignmentTraits::InnerRequiredAlignment),
-      alignable =
-          packet_traits<Scalar>::AlignedOnScalar || int(Kernel::AssignmentTraits::DstAlignment) >= sizeof(Scalar),
+      dstHasDirectAccess = bool(Kernel::AssignmentTraits::DstHasDirectAccess),
+      alignable = dstHasDirectAccess && (packet_traits<Scalar>::AlignedOnScalar ||
+                                         int(Kernel::AssignmentTraits::DstAlignment) >= sizeof(Scalar)),
       dstIsAligned = int(Kernel::AssignmentTraits::DstAlignment) >= int(requestedAlignment),
       dstAlignment = alignable ? int(requestedAlignment) : int(Kernel::AssignmentTraits::DstAlignment)
     };
-    const Scalar* dst_ptr = kernel.dstDataPtr();
+    typedef slice_vectorized_destination<Kernel, dstHasDirectAccess> Destination;
+    const Scalar* dst_ptr = Destination::data(kernel);
     if ((!bool(dstIsAligned)) && (std::uintptr_t(dst_ptr) % sizeof(Scalar)) > 0) {
       // the pointer is not aligned-on scalar, so alignment is not possible
       return dense_assignment_loop<Kernel, DefaultTraversal, NoUnrolling>::run(kernel);
@@ -528,7 +558,8 @@ struct dense_assignment_loop<Kernel, SliceVectorizedTraversal, NoUnrolling> {
     const Index packetAlignedMask = packetSize - 1;
     const Index innerSize = kernel.innerSize();
     const Index outerSize = kernel.outerSize();
-    const Index alignedStep = alignable ? (packetSize - kernel.outerStride() % packetSize) & packetAlignedMask : 0;
+    const Index alignedStep =
+        alignable ? (packetSize - Destination::outerStride(kernel) % packetSize) & packetAlignedMask : 0;
     Index alignedStart =
         ((!alignable) || bool(dstIsAligned)) ? 0 : internal::first_aligned<requestedAlignment>(dst_ptr, innerSize);
 
@@ -632,8 +663,7 @@ class generic_dense_assignment_kernel {
 
   template <int StoreMode, int LoadMode, typename Packet>
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void assignPacket(Index row, Index col) {
-    m_functor.template assignPacket<StoreMode>(&m_dst.coeffRef(row, col),
-                                               m_src.template packet<LoadMode, Packet>(row, col));
+    assignPacket<StoreMode, LoadMode, Packet>(row, col, bool_constant<bool(AssignmentTraits::DstScattersPackets)>());
   }
 
   template <int StoreMode, int LoadMode, typename Packet>
@@ -648,6 +678,17 @@ class generic_dense_assignment_kernel {
     assignPacket<StoreMode, LoadMode, Packet>(row, col);
   }
 
+  template <int StoreMode, int LoadMode, typename Packet>
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void assignPacket(Index row, Index col, false_type /*scatter*/) {
+    m_functor.template assignPacket<StoreMode>(&m_dst.coeffRef(row, col),
+                                               m_src.template packet<LoadMode, Packet>(row, col));
+  }
+
+  template <int StoreMode, int LoadMode, typename Packet>
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void assignPacket(Index row, Index col, true_type /*scatter*/) {
+    m_dst.template writePacket<StoreMode>(row, col, m_src.template packet<LoadMode, Packet>(row, col));
+  }
+
   EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE Index rowIndexByOuterInner(Index outer, Index inner) {
     typedef typename DstEvaluatorType::ExpressionTraits Traits;
     return int(Traits::RowsAtCompileTime) == 1          ? 0
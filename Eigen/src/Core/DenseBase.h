@@ -344,6 +344,7 @@ class DenseBase
   EIGEN_DEVICE_FUNC Derived& setZero();
   EIGEN_DEVICE_FUNC Derived& setOnes();
   EIGEN_DEVICE_FUNC Derived& setRandom();
+  Derived& setRandom(const Philox& generator);
 
   template <typename OtherDerived>
   EIGEN_DEVICE_FUNC bool isApprox(const DenseBase<OtherDerived>& other,
@@ -515,6 +516,11 @@ class DenseBase
   static const RandomReturnType Random(Index rows, Index cols);
   static const RandomReturnType Random(Index size);
   static const RandomReturnType Random();
+  typedef CwiseNullaryOp<internal::scalar_philox_random_op<Scalar, bool(IsRowMajor)>, PlainObject>
+      PhiloxRandomReturnType;
+  static const PhiloxRandomReturnType Random(Index rows, Index cols, const Philox& generator);
+  static const PhiloxRandomReturnType Random(Index size, const Philox& generator);
+  static const PhiloxRandomReturnType Random(const Philox& generator);
 
   template <typename ThenDerived, typename ElseDerived>
   inline EIGEN_DEVICE_FUNC
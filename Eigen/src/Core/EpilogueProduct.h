@@ -0,0 +1,363 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_EPILOGUE_PRODUCT_H
+#define EIGEN_EPILOGUE_PRODUCT_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+/** \class EpilogueProduct
+ * \ingroup Core_Module
+ *
+ * \brief Expression of a matrix product followed by an epilogue
+ *
+ * \tparam Lhs the type of the left-hand side
+ * \tparam Rhs the type of the right-hand side
+ * \tparam Epilogue the type of the operation applied to the result
+ *
+ * This class represents an expression of A.productWithEpilogue(B, epilogue)
+ * and most of the time this is the only way it is used.
+ *
+ * The epilogue is a functor with a templated
+ * \code void operator()(Block& block, Index row, Index col) const \endcode
+ * which updates \c block in place. \c block is a writable dense expression of a
+ * block of the result starting at (\c row, \c col), and holding the final
+ * coefficients of the product. When the product is evaluated by the blocked
+ * GEMM kernel, the epilogue is called on each block of the result as soon as it
+ * is complete, while it is still in cache, and saves a pass over the whole
+ * result. Otherwise it is called once on the whole result.
+ *
+ * The blocks are disjoint, and the epilogue of a multithreaded product is
+ * called concurrently by the threads: it must not modify any shared state.
+ * The epilogues of the namespace Eigen::epilogue cover the usual bias,
+ * scaling, activation and conversion operations, and can be chained with
+ * epilogue::EpilogueBase::then().
+ *
+ * \sa MatrixBase::productWithEpilogue()
+ */
+namespace internal {
+
+template <typename Lhs, typename Rhs, typename Epilogue>
+struct traits<EpilogueProduct<Lhs, Rhs, Epilogue> > : traits<typename Product<Lhs, Rhs>::PlainObject> {
+  typedef typename Product<Lhs, Rhs>::PlainObject PlainObject;
+  typedef traits<PlainObject> BaseTraits;
+  enum { Flags = BaseTraits::Flags & RowMajorBit, CoeffReadCost = HugeCost };
+};
+
+}  // namespace internal
+
+template <typename Lhs, typename Rhs, typename Epilogue>
+class EpilogueProduct : public MatrixBase<EpilogueProduct<Lhs, Rhs, Epilogue> > {
+ public:
+  typedef MatrixBase<EpilogueProduct> Base;
+  EIGEN_DENSE_PUBLIC_INTERFACE(EpilogueProduct)
+  typedef typename internal::traits<EpilogueProduct>::PlainObject PlainObject;
+
+  EpilogueProduct(const Lhs& lhs, const Rhs& rhs, const Epilogue& epilogue)
+      : m_lhs(lhs), m_rhs(rhs), m_epilogue(epilogue) {
+    eigen_assert(lhs.cols() == rhs.rows() && "invalid matrix product" &&
+                 "if you wanted a coeff-wise or a dot product use the respective explicit functions");
+  }
+
+  EIGEN_CONSTEXPR Index rows() const EIGEN_NOEXCEPT { return m_lhs.rows(); }
+  EIGEN_CONSTEXPR Index cols() const EIGEN_NOEXCEPT { return m_rhs.cols(); }
+
+  const Lhs& lhs() const { return m_lhs; }
+  const Rhs& rhs() const { return m_rhs; }
+  const Epilogue& epilogue() const { return m_epilogue; }
+
+ protected:
+  typename internal::ref_selector<Lhs>::type m_lhs;
+  typename internal::ref_selector<Rhs>::type m_rhs;
+  const Epilogue m_epilogue;
+
+ private:
+  Scalar coeff(Index row, Index col) const;
+  Scalar coeff(Index i) const;
+};
+
+namespace internal {
+
+// Calls a user epilogue on the blocks of the result passed by the GEMM kernel
+// (see gemm_no_epilogue).
+template <typename Epilogue, int ResInnerStride>
+struct gemm_epilogue_adaptor {
+  explicit gemm_epilogue_adaptor(const Epilogue& epilogue) : m_epilogue(epilogue) {}
+  template <int Order, typename Scalar, typename Index_>
+  EIGEN_ALWAYS_INLINE void apply(Scalar* data, Index_ incr, Index_ stride, Index_ row, Index_ col, Index_ rows,
+                                 Index_ cols) const {
+    typedef Stride<Dynamic, ResInnerStride> StrideType;
+    Map<Matrix<Scalar, Dynamic, Dynamic, Order>, 0, StrideType> block(data, rows, cols, StrideType(stride, incr));
+    m_epilogue(block, Index(row), Index(col));
+  }
+  const Epilogue& m_epilogue;
+};
+
+template <typename Lhs, typename Rhs, typename Epilogue,
+          bool UseGemm = product_type<Lhs, Rhs>::value == GemmProduct>
+struct epilogue_product_impl {
+  template <typename Dest>
+  static void evalTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Epilogue& epilogue) {
+    call_assignment_no_alias(dst, lhs.lazyProduct(rhs));
+    epilogue(dst, Index(0), Index(0));
+  }
+};
+
+template <typename Lhs, typename Rhs, typename Epilogue>
+struct epilogue_product_impl<Lhs, Rhs, Epilogue, true> {
+  typedef generic_product_impl<Lhs, Rhs, DenseShape, DenseShape, GemmProduct> ProductImpl;
+  typedef typename Product<Lhs, Rhs>::Scalar Scalar;
+
+  template <typename Dest>
+  static void evalTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Epilogue& epilogue) {
+    evalTo(dst, lhs, rhs, epilogue, bool_constant<bool(Dest::Flags & DirectAccessBit)>());
+  }
+
+ private:
+  template <typename Dest>
+  static void evalTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Epilogue& epilogue, true_type) {
+    // Same heuristic as generic_product_impl<..., GemmProduct>::evalTo.
+    if ((rhs.rows() + dst.rows() + dst.cols()) < EIGEN_GEMM_TO_COEFFBASED_THRESHOLD && rhs.rows() > 0) {
+      call_assignment_no_alias(dst, lhs.lazyProduct(rhs));
+      epilogue(dst, Index(0), Index(0));
+    } else {
+      ProductImpl::scaleAndAssignTo(dst, lhs, rhs, Scalar(1),
+                                    gemm_epilogue_adaptor<Epilogue, Dest::InnerStrideAtCompileTime>(epilogue));
+    }
+  }
+
+  template <typename Dest>
+  static void evalTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Epilogue& epilogue, false_type) {
+    typename Product<Lhs, Rhs>::PlainObject tmp(dst.rows(), dst.cols());
+    evalTo(tmp, lhs, rhs, epilogue, true_type());
+    call_assignment_no_alias(dst, tmp);
+  }
+};
+
+// Evaluator of EpilogueProduct -> eval into a temporary
+template <typename Lhs, typename Rhs, typename Epilogue>
+struct evaluator<EpilogueProduct<Lhs, Rhs, Epilogue> >
+    : public evaluator<typename EpilogueProduct<Lhs, Rhs, Epilogue>::PlainObject> {
+  typedef EpilogueProduct<Lhs, Rhs, Epilogue> XprType;
+  typedef typename XprType::PlainObject PlainObject;
+  typedef evaluator<PlainObject> Base;
+
+  enum { Flags = Base::Flags | EvalBeforeNestingBit };
+
+  explicit evaluator(const XprType& xpr) : m_result(xpr.rows(), xpr.cols()) {
+    internal::construct_at<Base>(this, m_result);
+    epilogue_product_impl<Lhs, Rhs, Epilogue>::evalTo(m_result, xpr.lhs(), xpr.rhs(), xpr.epilogue());
+  }
+
+ protected:
+  PlainObject m_result;
+};
+
+// Like products, "dst = a.productWithEpilogue(b, e)" is evaluated into a
+// temporary, and "dst.noalias() = ..." directly into dst.
+template <typename Lhs, typename Rhs, typename Epilogue>
+struct evaluator_assume_aliasing<EpilogueProduct<Lhs, Rhs, Epilogue> > {
+  static const bool value = true;
+};
+
+// Specialization for "dst.noalias() = lhs.productWithEpilogue(rhs, epilogue)"
+template <typename DstXprType, typename Lhs, typename Rhs, typename Epilogue, typename Scalar>
+struct Assignment<DstXprType, EpilogueProduct<Lhs, Rhs, Epilogue>, internal::assign_op<Scalar, Scalar>, Dense2Dense> {
+  typedef EpilogueProduct<Lhs, Rhs, Epilogue> SrcXprType;
+  static void run(DstXprType& dst, const SrcXprType& src, const internal::assign_op<Scalar, Scalar>&) {
+    Index dstRows = src.rows();
+    Index dstCols = src.cols();
+    if ((dst.rows() != dstRows) || (dst.cols() != dstCols)) dst.resize(dstRows, dstCols);
+
+    epilogue_product_impl<Lhs, Rhs, Epilogue>::evalTo(dst, src.lhs(), src.rhs(), src.epilogue());
+  }
+};
+
+}  // end namespace internal
+
+/** \returns an expression of the matrix product of \c *this and \a other, followed by the \a epilogue applied to
+ * each block of the result while it is still in cache.
+ *
+ * Example:
+ * \code
+ * MatrixXf y = (w.productWithEpilogue(x, epilogue::bias(b).then(epilogue::relu())));
+ * \endcode
+ * computes \c (w*x).colwise()+b followed by a ReLU, in a single pass over \c y.
+ *
+ * \sa class EpilogueProduct, operator*()
+ */
+template <typename Derived>
+template <typename OtherDerived, typename Epilogue>
+const EpilogueProduct<Derived, OtherDerived, Epilogue> MatrixBase<Derived>::productWithEpilogue(
+    const MatrixBase<OtherDerived>& other, const Epilogue& epilogue) const {
+  return EpilogueProduct<Derived, OtherDerived, Epilogue>(derived(), other.derived(), epilogue);
+}
+
+/** \namespace Eigen::epilogue
+ * \ingroup Core_Module
+ *
+ * Namespace containing the epilogues of MatrixBase::productWithEpilogue().
+ */
+namespace epilogue {
+
+template <typename First, typename Second>
+class Chain;
+
+/** \ingroup Core_Module
+ * Base class of the epilogues, providing their chaining. */
+template <typename Derived>
+class EpilogueBase {
+ public:
+  const Derived& derived() const { return *static_cast<const Derived*>(this); }
+
+  /** \returns an epilogue applying \c *this, then \a next. */
+  template <typename Next>
+  Chain<Derived, Next> then(const Next& next) const {
+    return Chain<Derived, Next>(derived(), next);
+  }
+};
+
+/** \ingroup Core_Module
+ * Epilogue applying \a First, then \a Second. \sa EpilogueBase::then() */
+template <typename First, typename Second>
+class Chain : public EpilogueBase<Chain<First, Second> > {
+ public:
+  Chain(const First& first, const Second& second) : m_first(first), m_second(second) {}
+
+  template <typename Block>
+  void operator()(Block& block, Index row, Index col) const {
+    m_first(block, row, col);
+    m_second(block, row, col);
+  }
+
+ protected:
+  const First m_first;
+  const Second m_second;
+};
+
+/** \ingroup Core_Module
+ * Epilogue adding a bias vector: a column vector is added to each column of the result, and a row vector to each
+ * row. \sa bias() */
+template <typename BiasType>
+class Bias : public EpilogueBase<Bias<BiasType> > {
+ public:
+  explicit Bias(const BiasType& bias) : m_bias(bias) {}
+
+  template <typename Block>
+  void operator()(Block& block, Index row, Index col) const {
+    add(block, row, col, internal::bool_constant<BiasType::ColsAtCompileTime == 1>());
+  }
+
+ protected:
+  template <typename Block>
+  void add(Block& block, Index row, Index, internal::true_type) const {
+    block.colwise() += m_bias.segment(row, block.rows());
+  }
+  template <typename Block>
+  void add(Block& block, Index, Index col, internal::false_type) const {
+    block.rowwise() += m_bias.segment(col, block.cols());
+  }
+
+  typename internal::ref_selector<BiasType>::type m_bias;
+};
+
+/** \ingroup Core_Module
+ * Epilogue multiplying the result by a scalar. \sa scale() */
+template <typename Scalar>
+class Scale : public EpilogueBase<Scale<Scalar> > {
+ public:
+  explicit Scale(const Scalar& factor) : m_factor(factor) {}
+
+  template <typename Block>
+  void operator()(Block& block, Index, Index) const {
+    block *= m_factor;
+  }
+
+ protected:
+  const Scalar m_factor;
+};
+
+/** \ingroup Core_Module
+ * Epilogue replacing the negative coefficients of the result by zero. \sa relu() */
+class Relu : public EpilogueBase<Relu> {
+ public:
+  template <typename Block>
+  void operator()(Block& block, Index, Index) const {
+    block = block.cwiseMax(typename Block::Scalar(0));
+  }
+};
+
+/** \ingroup Core_Module
+ * Epilogue applying a unary functor to each coefficient of the result. \sa unary() */
+template <typename Functor>
+class Unary : public EpilogueBase<Unary<Functor> > {
+ public:
+  explicit Unary(const Functor& func) : m_func(func) {}
+
+  template <typename Block>
+  void operator()(Block& block, Index, Index) const {
+    block = block.unaryExpr(m_func);
+  }
+
+ protected:
+  const Functor m_func;
+};
+
+/** \ingroup Core_Module
+ * Epilogue writing the result, converted to the scalar type of \a Dest, to the matching block of \a Dest. The result
+ * itself is left unchanged. \sa cast() */
+template <typename Dest>
+class Cast : public EpilogueBase<Cast<Dest> > {
+ public:
+  explicit Cast(Dest& dst) : m_dst(dst) {}
+
+  template <typename Block>
+  void operator()(Block& block, Index row, Index col) const {
+    m_dst.block(row, col, block.rows(), block.cols()) = block.template cast<typename Dest::Scalar>();
+  }
+
+ protected:
+  Dest& m_dst;
+};
+
+/** \returns an epilogue adding the column vector \a bias to each column of the result, or the row vector \a bias to
+ * each row. */
+template <typename Derived>
+Bias<Derived> bias(const MatrixBase<Derived>& bias) {
+  return Bias<Derived>(bias.derived());
+}
+
+/** \returns an epilogue multiplying the result by \a factor. */
+template <typename Scalar>
+Scale<Scalar> scale(const Scalar& factor) {
+  return Scale<Scalar>(factor);
+}
+
+/** \returns an epilogue replacing the negative coefficients of the result by zero. */
+inline Relu relu() { return Relu(); }
+
+/** \returns an epilogue applying \a func to each coefficient of the result. */
+template <typename Functor>
+Unary<Functor> unary(const Functor& func) {
+  return Unary<Functor>(func);
+}
+
+/** \returns an epilogue writing the result converted to the scalar type of \a dst to \a dst, which must already have
+ * the size of the result. */
+template <typename Derived>
+Cast<Derived> cast(MatrixBase<Derived>& dst) {
+  return Cast<Derived>(dst.derived());
+}
+
+}  // namespace epilogue
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_EPILOGUE_PRODUCT_H
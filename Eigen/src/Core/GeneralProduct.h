@@ -286,6 +286,8 @@ struct gemv_dense_selector<OnTheRight, ColMajor, true> {
     typedef Map<Matrix<ResScalar, Dynamic, 1>, plain_enum_min(AlignedMax, internal::packet_traits<ResScalar>::size)>
         MappedDest;
 
+    EIGEN_INSTRUMENT_KERNEL("gemv", 2.0 * double(lhs.rows()) * double(lhs.cols()),
+                            double(lhs.size() + rhs.size() + 2 * dest.size()) * double(sizeof(ResScalar)));
     ActualLhsType actualLhs = LhsBlasTraits::extract(lhs);
     ActualRhsType actualRhs = RhsBlasTraits::extract(rhs);
 
@@ -371,6 +373,8 @@ struct gemv_dense_selector<OnTheRight, RowMajor, true> {
     typedef typename RhsBlasTraits::DirectLinearAccessType ActualRhsType;
     typedef internal::remove_all_t<ActualRhsType> ActualRhsTypeCleaned;
 
+    EIGEN_INSTRUMENT_KERNEL("gemv", 2.0 * double(lhs.rows()) * double(lhs.cols()),
+                            double(lhs.size() + rhs.size() + 2 * dest.size()) * double(sizeof(ResScalar)));
     std::add_const_t<ActualLhsType> actualLhs = LhsBlasTraits::extract(lhs);
     std::add_const_t<ActualRhsType> actualRhs = RhsBlasTraits::extract(rhs);
 
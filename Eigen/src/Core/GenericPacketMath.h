@@ -968,6 +968,30 @@ EIGEN_DEVICE_FUNC inline void pscatter_partial(Scalar* to, const Packet& from, I
   }
 }
 
+/** \internal \returns the packet of the coefficients from[offsets[i]], for arbitrary offsets (e.g., the positions of
+ * an index vector). */
+template <typename Scalar, typename Packet>
+EIGEN_DEVICE_FUNC inline Packet pgather_indexed(const Scalar* from, const Index* offsets) {
+  const Index packet_size = unpacket_traits<Packet>::size;
+  EIGEN_ALIGN_MAX Scalar elements[packet_size];
+  for (Index i = 0; i < packet_size; i++) {
+    elements[i] = from[offsets[i]];
+  }
+  return pload<Packet>(elements);
+}
+
+/** \internal stores the i-th coefficient of \a from at to[offsets[i]], for arbitrary offsets. The coefficients are
+ * stored in order, so that the last one wins for repeated offsets. */
+template <typename Scalar, typename Packet>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed(Scalar* to, const Packet& from, const Index* offsets) {
+  const Index packet_size = unpacket_traits<Packet>::size;
+  EIGEN_ALIGN_MAX Scalar elements[packet_size];
+  pstore<Scalar>(elements, from);
+  for (Index i = 0; i < packet_size; i++) {
+    to[offsets[i]] = elements[i];
+  }
+}
+
 /** \internal tries to do cache prefetching of \a addr */
 template <typename Scalar>
 EIGEN_DEVICE_FUNC inline void prefetch(const Scalar* addr) {
@@ -228,6 +228,423 @@ std::ostream& operator<<(std::ostream& s, const DiagonalBase<Derived>& m) {
   return internal::print_matrix(s, m.derived(), EIGEN_DEFAULT_IO_FORMAT);
 }
 
+namespace internal {
+
+template <typename Functor>
+void parallelize_tasks(const Functor& func, int tasks);
+
+// Approximate number of bytes formatted or parsed by each task of the text routines below, and maximal number of
+// tasks formatted before their output is written.
+const std::ptrdiff_t text_io_chunk_bytes = 1 << 20;
+const int text_io_max_tasks = 16;
+
+inline IOFormat text_io_default_format() { return IOFormat(FullPrecision, DontAlignCols, ",", "\n", "", "", "", "\n"); }
+
+inline bool text_io_is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline const char* text_io_skip_blanks(const char* p, const char* end) {
+  while (p < end && text_io_is_blank(*p)) ++p;
+  return p;
+}
+
+inline const char* text_io_line_end(const char* p, const char* end) {
+  const char* newline = p < end ? static_cast<const char*>(std::memchr(p, '\n', std::size_t(end - p))) : nullptr;
+  return newline != nullptr ? newline : end;
+}
+
+inline const char* text_io_next_line(const char* p, const char* end) {
+  p = text_io_line_end(p, end);
+  return p < end ? p + 1 : end;
+}
+
+inline void text_io_strto(const char* s, char** stop, float& value) { value = std::strtof(s, stop); }
+inline void text_io_strto(const char* s, char** stop, double& value) { value = std::strtod(s, stop); }
+inline void text_io_strto(const char* s, char** stop, long double& value) { value = std::strtold(s, stop); }
+
+// Appends value to out. A precision of 0 means the shortest representation that reads back to the same value.
+template <typename Scalar>
+std::enable_if_t<std::is_floating_point<Scalar>::value> text_io_put(std::string& out, Scalar value, int precision) {
+  char buffer[64];
+#ifdef EIGEN_HAS_CHARCONV
+  std::to_chars_result result = precision > 0 ? std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                                              std::chars_format::general, precision)
+                                              : std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+#else
+  // Without to_chars, the shortest representation is the first one which reads back to value.
+  int digits = precision > 0 ? precision : NumTraits<Scalar>::digits10();
+  int n;
+  for (;; ++digits) {
+    n = std::snprintf(buffer, sizeof(buffer), "%.*Lg", digits, static_cast<long double>(value));
+    if (precision > 0 || digits >= NumTraits<Scalar>::max_digits10() || !(numext::isfinite)(value)) break;
+    Scalar parsed;
+    text_io_strto(buffer, nullptr, parsed);
+    if (parsed == value) break;
+  }
+  out.append(buffer, std::size_t(n));
+#endif
+}
+
+template <typename Scalar>
+std::enable_if_t<std::is_integral<Scalar>::value> text_io_put(std::string& out, Scalar value, int) {
+  typedef std::make_unsigned_t<std::conditional_t<std::is_same<Scalar, bool>::value, unsigned char, Scalar> > Unsigned;
+  char buffer[24];
+  char* p = buffer + sizeof(buffer);
+  const bool negative = value < Scalar(0);
+  Unsigned v = negative ? Unsigned(0) - Unsigned(value) : Unsigned(value);
+  do {
+    *--p = char('0' + v % 10);
+    v /= 10;
+  } while (v != 0);
+  if (negative) *--p = '-';
+  out.append(p, buffer + sizeof(buffer));
+}
+
+template <typename Scalar>
+std::enable_if_t<!std::is_floating_point<Scalar>::value && !std::is_integral<Scalar>::value> text_io_put(
+    std::string& out, const Scalar& value, int precision) {
+  std::ostringstream s;
+  s.precision(precision > 0 ? precision : significant_decimals_impl<Scalar>::run());
+  s << value;
+  out += s.str();
+}
+
+// Parses the token [first, last) into value. Returns false if the token is not entirely a valid value.
+template <typename Scalar>
+std::enable_if_t<std::is_floating_point<Scalar>::value, bool> text_io_parse(const char* first, const char* last,
+                                                                            Scalar& value) {
+#ifdef EIGEN_HAS_CHARCONV
+  // from_chars does not accept a leading '+', nor return denormals and overflows, which strtod handles below.
+  std::from_chars_result result = std::from_chars(*first == '+' ? first + 1 : first, last, value);
+  if (result.ec == std::errc() && result.ptr == last) return true;
+  if (result.ec == std::errc::invalid_argument) return false;
+#endif
+  char buffer[128];
+  const std::size_t n = std::size_t(last - first);
+  if (n >= sizeof(buffer)) return false;
+  std::memcpy(buffer, first, n);
+  buffer[n] = '\0';
+  char* stop;
+  text_io_strto(buffer, &stop, value);
+  return stop == buffer + n;
+}
+
+template <typename Scalar>
+std::enable_if_t<std::is_integral<Scalar>::value, bool> text_io_parse(const char* first, const char* last,
+                                                                      Scalar& value) {
+  const bool negative = *first == '-';
+  if (*first == '-' || *first == '+') ++first;
+  if (first == last) return false;
+  unsigned long long v = 0;
+  const unsigned long long max_value = (std::numeric_limits<unsigned long long>::max)();
+  for (; first < last; ++first) {
+    const unsigned digit = static_cast<unsigned>(*first - '0');
+    if (digit > 9 || v > (max_value - digit) / 10) return false;
+    v = 10 * v + digit;
+  }
+  if (negative) {
+    if (v > 0 && (!std::numeric_limits<Scalar>::is_signed ||
+                  v - 1 > static_cast<unsigned long long>((std::numeric_limits<Scalar>::max)())))
+      return false;
+    value = v == 0 ? Scalar(0) : Scalar(-Scalar(v - 1) - Scalar(1));
+  } else {
+    if (v > static_cast<unsigned long long>((std::numeric_limits<Scalar>::max)())) return false;
+    value = Scalar(v);
+  }
+  return true;
+}
+
+template <typename Scalar>
+std::enable_if_t<!std::is_floating_point<Scalar>::value && !std::is_integral<Scalar>::value, bool> text_io_parse(
+    const char* first, const char* last, Scalar& value) {
+  std::istringstream s(std::string(first, last));
+  s >> value;
+  return !s.fail() && (s >> std::ws).eof();
+}
+
+// Parses the coefficients of the line [p, end) separated by separator and/or blanks into the row i of m, or only
+// counts them if m is null. Returns false on an empty or invalid coefficient, or a row of the wrong size.
+template <typename Derived>
+bool text_io_parse_line(const char* p, const char* end, char separator, Derived* m, Index i, Index& count) {
+  count = 0;
+  for (;;) {
+    p = text_io_skip_blanks(p, end);
+    const char* first = p;
+    while (p < end && *p != separator && !text_io_is_blank(*p)) ++p;
+    if (first == p) return false;
+    if (m != nullptr && (count >= m->cols() || !text_io_parse(first, p, m->coeffRef(i, count)))) return false;
+    ++count;
+    p = text_io_skip_blanks(p, end);
+    if (p == end) return m == nullptr || count == m->cols();
+    if (*p == separator) ++p;
+  }
+}
+
+// Formats the rows [begin, end) of m into out.
+template <typename Derived>
+void text_io_format_rows(std::string& out, const Derived& m, Index begin, Index end, const IOFormat& fmt,
+                         int precision) {
+  for (Index i = begin; i < end; ++i) {
+    out += fmt.rowPrefix;
+    for (Index j = 0; j < m.cols(); ++j) {
+      if (j > 0) out += fmt.coeffSeparator;
+      text_io_put(out, m.coeff(i, j), precision);
+    }
+    out += fmt.rowSuffix;
+    if (i + 1 < m.rows()) out += fmt.rowSeparator;
+  }
+}
+
+// Formats m by blocks of rows, in parallel when possible, and passes the text to write(const char*, size_t) in order.
+template <typename Derived, typename Writer>
+bool text_io_write(const Derived& m, const IOFormat& fmt, Writer& write) {
+  const int precision = fmt.precision > 0 ? fmt.precision : 0;
+  if (!write(fmt.matPrefix.data(), fmt.matPrefix.size())) return false;
+  // About 24 characters per coefficient.
+  const Index rows_per_task =
+      numext::maxi<Index>(1, Index(text_io_chunk_bytes) / (24 * numext::maxi<Index>(1, m.cols())));
+  std::vector<std::string> buffers(text_io_max_tasks);
+  for (Index first = 0; first < m.rows(); first += text_io_max_tasks * rows_per_task) {
+    const int tasks = int(numext::mini<Index>(text_io_max_tasks,
+                                              numext::div_ceil<Index>(m.rows() - first, rows_per_task)));
+    parallelize_tasks(
+        [&](int k) {
+          buffers[k].clear();
+          const Index begin = first + k * rows_per_task;
+          text_io_format_rows(buffers[k], m, begin, numext::mini(m.rows(), begin + rows_per_task), fmt, precision);
+        },
+        tasks);
+    for (int k = 0; k < tasks; ++k)
+      if (!write(buffers[k].data(), buffers[k].size())) return false;
+  }
+  return write(fmt.matSuffix.data(), fmt.matSuffix.size());
+}
+
+template <typename Derived, bool Contiguous = (Derived::Flags & DirectAccessBit) == DirectAccessBit>
+struct raw_io_impl {
+  // Writes or reads the coefficients of m one outer vector at a time. Costly expressions, e.g., products, are
+  // evaluated once beforehand rather than for each outer vector.
+  static bool write(std::FILE* file, const Derived& m) {
+    typename nested_eval<Derived, 1>::type nested(m);
+    Matrix<typename Derived::Scalar, Dynamic, 1> buffer(m.innerSize());
+    for (Index j = 0; j < m.outerSize(); ++j) {
+      if (Derived::IsRowMajor)
+        buffer = nested.row(j).transpose();
+      else
+        buffer = nested.col(j);
+      if (std::fwrite(buffer.data(), sizeof(typename Derived::Scalar), std::size_t(buffer.size()), file) !=
+          std::size_t(buffer.size()))
+        return false;
+    }
+    return true;
+  }
+
+  static bool read(std::FILE* file, Derived& m) {
+    Matrix<typename Derived::Scalar, Dynamic, 1> buffer(m.innerSize());
+    for (Index j = 0; j < m.outerSize(); ++j) {
+      if (std::fread(buffer.data(), sizeof(typename Derived::Scalar), std::size_t(buffer.size()), file) !=
+          std::size_t(buffer.size()))
+        return false;
+      if (Derived::IsRowMajor)
+        m.row(j) = buffer.transpose();
+      else
+        m.col(j) = buffer;
+    }
+    return true;
+  }
+};
+
+template <typename Derived>
+struct raw_io_impl<Derived, true> {
+  // Single call when the coefficients are contiguous, e.g., for plain objects and most Maps.
+  static bool contiguous(const Derived& m) {
+    return m.size() == 0 || (m.innerStride() == 1 && (m.outerSize() == 1 || m.outerStride() == m.innerSize()));
+  }
+
+  static bool write(std::FILE* file, const Derived& m) {
+    if (!contiguous(m)) return raw_io_impl<Derived, false>::write(file, m);
+    return std::fwrite(m.data(), sizeof(typename Derived::Scalar), std::size_t(m.size()), file) ==
+           std::size_t(m.size());
+  }
+
+  static bool read(std::FILE* file, Derived& m) {
+    if (!contiguous(m)) return raw_io_impl<Derived, false>::read(file, m);
+    return std::fread(m.data(), sizeof(typename Derived::Scalar), std::size_t(m.size()), file) ==
+           std::size_t(m.size());
+  }
+};
+
+}  // end namespace internal
+
+/** \relates DenseBase
+ *
+ * Writes the matrix \a m as text to the stream \a s, with the separators, prefixes and suffixes of \a fmt.
+ *
+ * Unlike operator<<, the coefficients are converted without streams (with \c std::to_chars when available), by
+ * blocks of rows formatted in parallel when OpenMP or the GEMM thread pool is enabled. The \c DontAlignCols flag
+ * is implied. A precision of \c StreamPrecision or \c FullPrecision writes the shortest representation of floating
+ * point values which reads back exactly. The default format writes comma separated values, one row per line.
+ *
+ * \returns true if the text was successfully written.
+ *
+ * \sa saveText(), parseText()
+ */
+template <typename Derived>
+bool writeText(std::ostream& s, const DenseBase<Derived>& m,
+               const IOFormat& fmt = internal::text_io_default_format()) {
+  auto write = [&s](const char* data, std::size_t size) {
+    s.write(data, std::streamsize(size));
+    return bool(s);
+  };
+  return internal::text_io_write(m.eval(), fmt, write);
+}
+
+/** \relates DenseBase
+ *
+ * Writes the matrix \a m as text to the file \a filename, see writeText().
+ *
+ * \returns true if the file was successfully written.
+ */
+template <typename Derived>
+bool saveText(const std::string& filename, const DenseBase<Derived>& m,
+              const IOFormat& fmt = internal::text_io_default_format()) {
+  std::FILE* file = std::fopen(filename.c_str(), "wb");
+  if (file == nullptr) return false;
+  auto write = [file](const char* data, std::size_t size) { return std::fwrite(data, 1, size, file) == size; };
+  const bool ok = internal::text_io_write(m.eval(), fmt, write);
+  return (std::fclose(file) == 0) && ok;
+}
+
+/** \relates PlainObjectBase
+ *
+ * Reads the matrix \a m from the text [\a begin, \a end), with one row per line and the coefficients separated
+ * by \a separator and/or blanks. Blank lines are ignored. For instance, comma separated values, or values separated
+ * by spaces and tabs with \a separator = ' '. \a m is resized to the number of lines and of values per line.
+ *
+ * The text is split into chunks of lines, which are counted and then parsed in parallel when OpenMP or the GEMM
+ * thread pool is enabled. Floating point values are parsed with \c std::from_chars when available.
+ *
+ * \returns false if a coefficient cannot be parsed, if the rows do not have the same number of coefficients, or if
+ * the fixed dimensions of \a m do not match.
+ *
+ * \sa loadText(), writeText()
+ */
+template <typename Derived>
+bool parseText(const char* begin, const char* end, PlainObjectBase<Derived>& m, char separator = ',') {
+  // The number of columns is given by the first non blank line.
+  const char* p = begin;
+  while (p < end && internal::text_io_skip_blanks(p, internal::text_io_line_end(p, end)) ==
+                        internal::text_io_line_end(p, end))
+    p = internal::text_io_next_line(p, end);
+  Index cols = 0;
+  if (p < end &&
+      !internal::text_io_parse_line<Derived>(p, internal::text_io_line_end(p, end), separator, nullptr, 0, cols))
+    return false;
+
+  const std::ptrdiff_t bytes = end - p;
+  const int tasks = int(numext::mini<std::ptrdiff_t>(64, bytes / internal::text_io_chunk_bytes + 1));
+  std::vector<const char*> bounds(tasks + 1);
+  bounds[0] = p;
+  bounds[tasks] = end;
+  for (int k = 1; k < tasks; ++k)
+    bounds[k] = numext::maxi(bounds[k - 1], internal::text_io_next_line(p + bytes / tasks * k, end));
+
+  // Number of rows in each chunk.
+  std::vector<Index> offsets(tasks + 1, 0);
+  internal::parallelize_tasks(
+      [&](int k) {
+        Index rows = 0;
+        for (const char* q = bounds[k]; q < bounds[k + 1]; q = internal::text_io_next_line(q, bounds[k + 1])) {
+          const char* line_end = internal::text_io_line_end(q, bounds[k + 1]);
+          if (internal::text_io_skip_blanks(q, line_end) != line_end) ++rows;
+        }
+        offsets[k + 1] = rows;
+      },
+      tasks);
+  for (int k = 0; k < tasks; ++k) offsets[k + 1] += offsets[k];
+  const Index rows = offsets[tasks];
+
+  if ((Derived::RowsAtCompileTime != Dynamic && rows != Derived::RowsAtCompileTime) ||
+      (Derived::ColsAtCompileTime != Dynamic && cols != Derived::ColsAtCompileTime) ||
+      (Derived::MaxRowsAtCompileTime != Dynamic && rows > Derived::MaxRowsAtCompileTime) ||
+      (Derived::MaxColsAtCompileTime != Dynamic && cols > Derived::MaxColsAtCompileTime))
+    return false;
+  m.resize(rows, cols);
+
+  std::vector<char> parsed(tasks, 0);
+  internal::parallelize_tasks(
+      [&](int k) {
+        Index i = offsets[k], count;
+        for (const char* q = bounds[k]; q < bounds[k + 1]; q = internal::text_io_next_line(q, bounds[k + 1])) {
+          const char* line_end = internal::text_io_line_end(q, bounds[k + 1]);
+          if (internal::text_io_skip_blanks(q, line_end) == line_end) continue;
+          if (!internal::text_io_parse_line(q, line_end, separator, &m.derived(), i++, count)) return;
+        }
+        parsed[k] = 1;
+      },
+      tasks);
+  return std::find(parsed.begin(), parsed.end(), 0) == parsed.end();
+}
+
+/** \relates PlainObjectBase
+ *
+ * Reads the matrix \a m from the text file \a filename, see parseText().
+ *
+ * \returns false if the file cannot be read or parsed.
+ */
+template <typename Derived>
+bool loadText(const std::string& filename, PlainObjectBase<Derived>& m, char separator = ',') {
+  std::FILE* file = std::fopen(filename.c_str(), "rb");
+  if (file == nullptr) return false;
+  std::vector<char> content;
+  char block[1 << 16];
+  std::size_t n;
+  while ((n = std::fread(block, 1, sizeof(block), file)) > 0) content.insert(content.end(), block, block + n);
+  const bool ok = !std::ferror(file);
+  std::fclose(file);
+  return ok && parseText(content.data(), content.data() + content.size(), m, separator);
+}
+
+/** \relates DenseBase
+ *
+ * Writes the coefficients of \a m to the file \a filename, in the storage order of \a m and without any header.
+ * Objects with contiguous storage are written with a single call, and others one column (or row) at a time.
+ * Expressions which are costly to evaluate coefficient-wise, such as products, are evaluated once beforehand.
+ *
+ * \returns true if the file was successfully written.
+ *
+ * \sa loadRaw()
+ */
+template <typename Derived>
+bool saveRaw(const std::string& filename, const DenseBase<Derived>& m) {
+  std::FILE* file = std::fopen(filename.c_str(), "wb");
+  if (file == nullptr) return false;
+  const bool ok = internal::raw_io_impl<Derived>::write(file, m.derived());
+  return (std::fclose(file) == 0) && ok;
+}
+
+/** \relates DenseBase
+ *
+ * Reads the coefficients of \a dst from the file \a filename, written by saveRaw() with the same storage order.
+ * \a dst is not resized, and is typically a Map over an existing buffer or a block:
+ * \code
+ * std::vector<float> buffer(rows * cols);
+ * loadRaw("data.bin", Map<MatrixXf>(buffer.data(), rows, cols));
+ * \endcode
+ *
+ * \returns false if the file cannot be read, or if its size does not match the size of \a dst.
+ *
+ * \sa saveRaw()
+ */
+template <typename Derived>
+bool loadRaw(const std::string& filename, const DenseBase<Derived>& dst) {
+  std::FILE* file = std::fopen(filename.c_str(), "rb");
+  if (file == nullptr) return false;
+  const bool ok = internal::raw_io_impl<Derived>::read(file, dst.const_cast_derived()) && std::fgetc(file) == EOF;
+  std::fclose(file);
+  return ok;
+}
+
 }  // end namespace Eigen
 
 #endif  // EIGEN_IO_H
@@ -253,7 +253,21 @@ struct unary_evaluator<IndexedView<ArgType, RowIndices, ColIndices>, IndexBased>
 
     FlagsRowMajorBit = traits<XprType>::FlagsRowMajorBit,
 
-    Flags = (evaluator<ArgType>::Flags & (HereditaryBits & ~RowMajorBit /*| LinearAccessBit | DirectAccessBit*/)) |
+    IsRowMajor = traits<XprType>::IsRowMajor,
+    // packets are loaded from (or stored to) the nested expression when they span a contiguous run of its inner
+    // dimension, and gathered (or scattered) with the offsets of their coefficients otherwise, or coefficient by
+    // coefficient for nested expressions without direct access.
+    InnerIsArgInner = traits<XprType>::HasSameStorageOrderAsXprType,
+    InnerIncr = traits<XprType>::InnerIncr,
+    ArgHasDirectAccess = (int(traits<remove_all_t<ArgType>>::Flags) & DirectAccessBit) != 0,
+    // blocks of direct access views are evaluated as maps, which require a unit inner stride for packet access
+    FlagsPacketAccessBit = (int(traits<XprType>::Flags) & DirectAccessBit) == 0 ||
+                                   int(traits<XprType>::InnerStrideAtCompileTime) == 1
+                               ? PacketAccessBit
+                               : 0,
+
+    Flags = (evaluator<ArgType>::Flags &
+             ((HereditaryBits & ~RowMajorBit) | FlagsPacketAccessBit /*| LinearAccessBit | DirectAccessBit*/)) |
             FlagsLinearAccessBit | FlagsRowMajorBit,
 
     Alignment = 0
@@ -303,11 +317,111 @@ struct unary_evaluator<IndexedView<ArgType, RowIndices, ColIndices>, IndexBased>
     return m_argImpl.coeff(m_xpr.rowIndices()[row], m_xpr.colIndices()[col]);
   }
 
+  template <int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE PacketType packet(Index row, Index col) const {
+    constexpr int PacketSize = unpacket_traits<PacketType>::size;
+    if (isContiguousRun(row, col, PacketSize)) {
+      return m_argImpl.template packet<Unaligned, PacketType>(m_xpr.rowIndices()[row], m_xpr.colIndices()[col]);
+    }
+    return gatherPacket<PacketType>(row, col, bool_constant<ArgHasDirectAccess>());
+  }
+
+  template <int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE PacketType packet(Index index) const {
+    return packet<LoadMode, PacketType>(XprType::RowsAtCompileTime == 1 ? 0 : index,
+                                        XprType::RowsAtCompileTime == 1 ? index : 0);
+  }
+
+  // Duplicated indices receive the last value, as with the coefficient-wise assignment, see also
+  // evaluator_scatters_packets.
+  template <int StoreMode, typename PacketType>
+  EIGEN_STRONG_INLINE void writePacket(Index row, Index col, const PacketType& x) {
+    constexpr int PacketSize = unpacket_traits<PacketType>::size;
+    if (isContiguousRun(row, col, PacketSize)) {
+      m_argImpl.template writePacket<Unaligned, PacketType>(m_xpr.rowIndices()[row], m_xpr.colIndices()[col], x);
+      return;
+    }
+    scatterPacket(row, col, x, bool_constant<ArgHasDirectAccess>());
+  }
+
+  template <int StoreMode, typename PacketType>
+  EIGEN_STRONG_INLINE void writePacket(Index index, const PacketType& x) {
+    writePacket<StoreMode, PacketType>(XprType::RowsAtCompileTime == 1 ? 0 : index,
+                                       XprType::RowsAtCompileTime == 1 ? index : 0, x);
+  }
+
  protected:
+  template <typename PacketType>
+  EIGEN_STRONG_INLINE PacketType gatherPacket(Index row, Index col, true_type /*direct access*/) const {
+    constexpr int PacketSize = unpacket_traits<PacketType>::size;
+    Index offsets[PacketSize];
+    packetOffsets(row, col, offsets, PacketSize);
+    return pgather_indexed<Scalar, PacketType>(m_xpr.nestedExpression().data(), offsets);
+  }
+
+  template <typename PacketType>
+  EIGEN_STRONG_INLINE PacketType gatherPacket(Index row, Index col, false_type /*direct access*/) const {
+    constexpr int PacketSize = unpacket_traits<PacketType>::size;
+    EIGEN_ALIGN_MAX Scalar values[PacketSize];
+    for (int k = 0; k < PacketSize; ++k) values[k] = coeff(IsRowMajor ? row : row + k, IsRowMajor ? col + k : col);
+    return pload<PacketType>(values);
+  }
+
+  template <typename PacketType>
+  EIGEN_STRONG_INLINE void scatterPacket(Index row, Index col, const PacketType& x, true_type /*direct access*/) {
+    constexpr int PacketSize = unpacket_traits<PacketType>::size;
+    Index offsets[PacketSize];
+    packetOffsets(row, col, offsets, PacketSize);
+    pscatter_indexed<Scalar, PacketType>(const_cast<Scalar*>(m_xpr.nestedExpression().data()), x, offsets);
+  }
+
+  template <typename PacketType>
+  EIGEN_STRONG_INLINE void scatterPacket(Index row, Index col, const PacketType& x, false_type /*direct access*/) {
+    constexpr int PacketSize = unpacket_traits<PacketType>::size;
+    EIGEN_ALIGN_MAX Scalar values[PacketSize];
+    pstore(values, x);
+    for (int k = 0; k < PacketSize; ++k) coeffRef(IsRowMajor ? row : row + k, IsRowMajor ? col + k : col) = values[k];
+  }
+
+  // Offsets in the storage of the nested expression of the size coefficients starting at (row, col) along the inner
+  // dimension.
+  EIGEN_STRONG_INLINE void packetOffsets(Index row, Index col, Index* offsets, Index size) const {
+    const Index rowStride = m_xpr.nestedExpression().rowStride(), colStride = m_xpr.nestedExpression().colStride();
+    for (Index k = 0; k < size; ++k) {
+      const Index i = m_xpr.rowIndices()[IsRowMajor ? row : row + k];
+      const Index j = m_xpr.colIndices()[IsRowMajor ? col + k : col];
+      eigen_assert(i >= 0 && i < m_xpr.nestedExpression().rows() && j >= 0 && j < m_xpr.nestedExpression().cols());
+      offsets[k] = i * rowStride + j * colStride;
+    }
+  }
+
+  // Returns whether the size coefficients starting at (row, col) along the inner dimension are consecutive
+  // coefficients of the inner dimension of the nested expression. This is known at compile time for
+  // sequences of unit increment, and checked on the indices otherwise (e.g., for sorted runs of indices).
+  EIGEN_STRONG_INLINE bool isContiguousRun(Index row, Index col, Index size) const {
+    if (!InnerIsArgInner) return false;
+    const Index start = IsRowMajor ? col : row;
+    const Index first = innerIndex(start);
+    if (InnerIncr != 1) {
+      for (Index k = 1; k < size; ++k)
+        if (innerIndex(start + k) != first + k) return false;
+    }
+    eigen_assert(first >= 0 &&
+                 first + size <= (IsRowMajor ? m_xpr.nestedExpression().cols() : m_xpr.nestedExpression().rows()));
+    return true;
+  }
+
+  EIGEN_STRONG_INLINE Index innerIndex(Index i) const {
+    return IsRowMajor ? Index(m_xpr.colIndices()[i]) : Index(m_xpr.rowIndices()[i]);
+  }
+
   evaluator<ArgType> m_argImpl;
   const XprType& m_xpr;
 };
 
+template <typename ArgType, typename RowIndices, typename ColIndices>
+struct evaluator_scatters_packets<evaluator<IndexedView<ArgType, RowIndices, ColIndices>>> : true_type {};
+
 }  // end namespace internal
 
 }  // end namespace Eigen
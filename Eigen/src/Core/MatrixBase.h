@@ -162,6 +162,10 @@ class MatrixBase : public DenseBase<Derived> {
   EIGEN_DEVICE_FUNC const Product<Derived, OtherDerived, LazyProduct> lazyProduct(
       const MatrixBase<OtherDerived>& other) const;
 
+  template <typename OtherDerived, typename Epilogue>
+  const EpilogueProduct<Derived, OtherDerived, Epilogue> productWithEpilogue(const MatrixBase<OtherDerived>& other,
+                                                                             const Epilogue& epilogue) const;
+
   template <typename OtherDerived>
   Derived& operator*=(const EigenBase<OtherDerived>& other);
 
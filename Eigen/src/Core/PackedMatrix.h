@@ -0,0 +1,393 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PACKEDMATRIX_H
+#define EIGEN_PACKEDMATRIX_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+/* Column-major packed storage of a triangular part, as used by the BLAS and
+ * LAPACK routines with a 'p' in their name (spmv, tpsv, pptrf, ...).
+ *
+ * For the Lower part, column j stores the coefficients (j..n-1, j), and for the
+ * Upper part, column j stores the coefficients (0..j, j). Columns are stored
+ * one after the other, such that a n x n matrix takes n(n+1)/2 coefficients.
+ *
+ * The algorithms working on packed matrices are written in terms of the lower
+ * triangle L of the matrix, where L = A for the Lower part and L = A^* for the
+ * Upper part. They copy panels of consecutive columns of L to a dense buffer
+ * (gather_lower) and write them back (scatter_lower), such that the floating
+ * point work is done by the dense kernels.
+ */
+template <typename Scalar, int UpLo>
+struct packed_storage {
+  /** \internal \returns the position of the coefficient (i,j) of the stored part */
+  static EIGEN_STRONG_INLINE Index offset(Index size, Index i, Index j) {
+    return UpLo == Lower ? i + j * (2 * size - j - 1) / 2 : i + j * (j + 1) / 2;
+  }
+
+  static EIGEN_STRONG_INLINE Index storage_size(Index size) { return size * (size + 1) / 2; }
+
+  /** \internal Copies the block of L starting at (row,col) to \a dst, with zeros in its strictly upper part. */
+  template <typename Dest>
+  static void gather_lower(const Scalar* data, Index size, Index row, Index col, Dest& dst) {
+    typedef Map<const Matrix<Scalar, Dynamic, 1> > VectorMap;
+    const Index rows = dst.rows(), cols = dst.cols();
+    if (UpLo == Lower) {
+      for (Index j = 0; j < cols; ++j) {
+        const Index start = numext::maxi(row, col + j);
+        const Index len = numext::maxi<Index>(0, row + rows - start);
+        dst.col(j).head(rows - len).setZero();
+        dst.col(j).tail(len) = VectorMap(data + offset(size, start, col + j), len);
+      }
+    } else {
+      // The rows of L are the columns of the stored upper part.
+      for (Index i = 0; i < rows; ++i) {
+        const Index len = numext::mini(cols, numext::maxi<Index>(0, row + i - col + 1));
+        dst.row(i).head(len) = VectorMap(data + offset(size, col, row + i), len).adjoint();
+        dst.row(i).tail(cols - len).setZero();
+      }
+    }
+  }
+
+  /** \internal Copies the lower part of \a src, a block of L starting at (row,col), to the packed storage. */
+  template <typename Src>
+  static void scatter_lower(Scalar* data, Index size, Index row, Index col, const Src& src) {
+    typedef Map<Matrix<Scalar, Dynamic, 1> > VectorMap;
+    const Index rows = src.rows(), cols = src.cols();
+    if (UpLo == Lower) {
+      for (Index j = 0; j < cols; ++j) {
+        const Index start = numext::maxi(row, col + j);
+        const Index len = numext::maxi<Index>(0, row + rows - start);
+        VectorMap(data + offset(size, start, col + j), len) = src.col(j).tail(len);
+      }
+    } else {
+      for (Index i = 0; i < rows; ++i) {
+        const Index len = numext::mini(cols, numext::maxi<Index>(0, row + i - col + 1));
+        VectorMap(data + offset(size, col, row + i), len) = src.row(i).head(len).adjoint();
+      }
+    }
+  }
+
+  /** \internal Width of the column panels of L used by the blocked algorithms. */
+  static Index panel_size(Index size) {
+    // The panels are copied once per panel of the factorizations and of the
+    // products, so that wide panels keep this overhead small compared to the
+    // O(n^2 k) floating point work.
+    return numext::mini<Index>(size, 128);
+  }
+};
+
+template <typename Derived>
+class PackedMatrixBase : public EigenBase<Derived> {
+ public:
+  typedef EigenBase<Derived> Base;
+  typedef typename traits<Derived>::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename traits<Derived>::StorageIndex StorageIndex;
+  typedef typename traits<Derived>::CoefficientsType CoefficientsType;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+  typedef DenseMatrixType PlainObject;
+  typedef packed_storage<Scalar, traits<Derived>::UpLo> Storage;
+  enum {
+    Flags = traits<Derived>::Flags,
+    RowsAtCompileTime = traits<Derived>::RowsAtCompileTime,
+    ColsAtCompileTime = traits<Derived>::ColsAtCompileTime,
+    MaxRowsAtCompileTime = traits<Derived>::MaxRowsAtCompileTime,
+    MaxColsAtCompileTime = traits<Derived>::MaxColsAtCompileTime,
+    UpLo = traits<Derived>::UpLo
+  };
+
+  using Base::derived;
+
+  EIGEN_CONSTEXPR inline Index rows() const EIGEN_NOEXCEPT { return m_size; }
+  EIGEN_CONSTEXPR inline Index cols() const EIGEN_NOEXCEPT { return m_size; }
+
+  /** \returns the packed coefficients, in the order of the LAPACK \c AP arrays */
+  inline const CoefficientsType& coeffs() const { return m_coeffs; }
+  /** \returns the packed coefficients, in the order of the LAPACK \c AP arrays */
+  inline CoefficientsType& coeffs() { return m_coeffs; }
+
+  inline const Scalar* data() const { return m_coeffs.data(); }
+  inline Scalar* data() { return m_coeffs.data(); }
+
+  /** \returns a reference to the coefficient (i,j), which must belong to the stored triangular part */
+  inline Scalar& coeffRef(Index i, Index j) {
+    eigen_assert(i >= 0 && j >= 0 && i < m_size && j < m_size && (UpLo == Lower ? i >= j : i <= j));
+    return m_coeffs.coeffRef(Storage::offset(m_size, i, j));
+  }
+
+  /** Resizes to a \a size x \a size matrix. The coefficients are left uninitialized. */
+  void resize(Index size) {
+    eigen_assert(size >= 0);
+    m_coeffs.resize(Storage::storage_size(size));
+    m_size = size;
+  }
+
+  Derived& setZero() {
+    m_coeffs.setZero();
+    return derived();
+  }
+
+  /** \returns a vector of the diagonal coefficients */
+  Matrix<Scalar, Dynamic, 1> diagonal() const {
+    Matrix<Scalar, Dynamic, 1> res(m_size);
+    for (Index i = 0; i < m_size; ++i) res.coeffRef(i) = m_coeffs.coeff(Storage::offset(m_size, i, i));
+    return res;
+  }
+
+  DenseMatrixType toDenseMatrix() const {
+    DenseMatrixType res(m_size, m_size);
+    derived().evalTo(res);
+    return res;
+  }
+
+ protected:
+  explicit PackedMatrixBase(Index size) : m_coeffs(Storage::storage_size(size)), m_size(size) {}
+
+  /** \internal copies the \a UpLo triangular part of \a other */
+  template <typename OtherDerived>
+  void assignTriangle(const MatrixBase<OtherDerived>& other) {
+    eigen_assert(other.rows() == other.cols());
+    resize(other.rows());
+    typedef Map<Matrix<Scalar, Dynamic, 1> > VectorMap;
+    for (Index j = 0; j < m_size; ++j) {
+      if (UpLo == Lower)
+        VectorMap(data() + Storage::offset(m_size, j, j), m_size - j) = other.col(j).tail(m_size - j);
+      else
+        VectorMap(data() + Storage::offset(m_size, 0, j), j + 1) = other.col(j).head(j + 1);
+    }
+  }
+
+  /** \internal copies the stored part to \a dst, and sets its other part to zero */
+  template <typename Dest>
+  void evalStoredPart(Dest& dst) const {
+    typedef Map<const Matrix<Scalar, Dynamic, 1> > VectorMap;
+    dst.resize(m_size, m_size);
+    for (Index j = 0; j < m_size; ++j) {
+      if (UpLo == Lower) {
+        dst.col(j).head(j).setZero();
+        dst.col(j).tail(m_size - j) = VectorMap(data() + Storage::offset(m_size, j, j), m_size - j);
+      } else {
+        dst.col(j).head(j + 1) = VectorMap(data() + Storage::offset(m_size, 0, j), j + 1);
+        dst.col(j).tail(m_size - j - 1).setZero();
+      }
+    }
+  }
+
+  CoefficientsType m_coeffs;
+  Index m_size;
+};
+
+template <typename Scalar_, int UpLo_>
+struct traits<PackedTriangularMatrix<Scalar_, UpLo_> > : traits<Matrix<Scalar_, Dynamic, Dynamic> > {
+  typedef Matrix<Scalar_, Dynamic, 1> CoefficientsType;
+  enum { UpLo = UpLo_, Mode = UpLo_, Flags = NestByRefBit };
+};
+
+template <typename Scalar_, int UpLo_>
+struct traits<PackedSelfAdjointMatrix<Scalar_, UpLo_> > : traits<Matrix<Scalar_, Dynamic, Dynamic> > {
+  typedef Matrix<Scalar_, Dynamic, 1> CoefficientsType;
+  enum { UpLo = UpLo_, Mode = UpLo_ | SelfAdjoint, Flags = NestByRefBit };
+};
+
+}  // end namespace internal
+
+/** \class PackedTriangularMatrix
+ * \ingroup Core_Module
+ *
+ * \brief A triangular matrix stored in packed format
+ *
+ * \tparam Scalar_ the type of the coefficients
+ * \tparam UpLo_ either \c #Lower or \c #Upper, the stored triangular part
+ *
+ * Only the n(n+1)/2 coefficients of the triangular part are stored, column by column, as in the
+ * packed BLAS and LAPACK routines (see coeffs()). This halves the memory footprint of a
+ * TriangularView over a full matrix.
+ *
+ * Products with dense matrices and triangular solves are computed on panels of consecutive
+ * columns by the dense matrix-matrix kernels.
+ *
+ * \sa PackedSelfAdjointMatrix, TriangularView
+ */
+template <typename Scalar_, int UpLo_>
+class PackedTriangularMatrix : public internal::PackedMatrixBase<PackedTriangularMatrix<Scalar_, UpLo_> > {
+  EIGEN_STATIC_ASSERT(UpLo_ == Lower || UpLo_ == Upper, PACKED_MATRICES_ACCEPT_UPPER_AND_LOWER_MODE_ONLY)
+ public:
+  typedef internal::PackedMatrixBase<PackedTriangularMatrix> Base;
+  typedef typename Base::Scalar Scalar;
+  using Base::cols;
+  using Base::rows;
+
+  /** Constructs a \a size x \a size matrix with uninitialized coefficients */
+  explicit PackedTriangularMatrix(Index size = 0) : Base(size) {}
+
+  /** Constructs a packed copy of the \a UpLo_ part of \a other. The other part is not read. */
+  template <typename OtherDerived>
+  explicit PackedTriangularMatrix(const MatrixBase<OtherDerived>& other) : Base(0) {
+    this->assignTriangle(other);
+  }
+
+  template <typename OtherDerived>
+  PackedTriangularMatrix& operator=(const MatrixBase<OtherDerived>& other) {
+    this->assignTriangle(other);
+    return *this;
+  }
+
+  /** \returns the coefficient (i,j), which is zero outside of the stored part */
+  inline Scalar coeff(Index i, Index j) const {
+    eigen_assert(i >= 0 && j >= 0 && i < rows() && j < cols());
+    if (UpLo_ == Lower ? i < j : i > j) return Scalar(0);
+    return this->m_coeffs.coeff(Base::Storage::offset(rows(), i, j));
+  }
+  inline Scalar operator()(Index i, Index j) const { return coeff(i, j); }
+
+  template <typename Dest>
+  void evalTo(Dest& dst) const {
+    this->evalStoredPart(dst);
+  }
+
+  /** \returns the product of \c *this by the dense matrix \a rhs */
+  template <typename OtherDerived>
+  const Product<PackedTriangularMatrix, OtherDerived> operator*(const MatrixBase<OtherDerived>& rhs) const {
+    return Product<PackedTriangularMatrix, OtherDerived>(*this, rhs.derived());
+  }
+
+  /** \returns the product of the dense matrix \a lhs by \a mat */
+  template <typename OtherDerived>
+  friend const Product<OtherDerived, PackedTriangularMatrix> operator*(const MatrixBase<OtherDerived>& lhs,
+                                                                     const PackedTriangularMatrix& mat) {
+    return Product<OtherDerived, PackedTriangularMatrix>(lhs.derived(), mat);
+  }
+
+  template <typename OtherDerived>
+  void solveInPlace(const MatrixBase<OtherDerived>& other) const;
+
+  /** \returns the solution X of \c *this * X = \a other */
+  template <typename OtherDerived>
+  typename OtherDerived::PlainObject solve(const MatrixBase<OtherDerived>& other) const {
+    typename OtherDerived::PlainObject res(other);
+    solveInPlace(res);
+    return res;
+  }
+};
+
+/** \class PackedSelfAdjointMatrix
+ * \ingroup Core_Module
+ *
+ * \brief A selfadjoint matrix stored in packed format
+ *
+ * \tparam Scalar_ the type of the coefficients
+ * \tparam UpLo_ either \c #Lower or \c #Upper, the stored triangular part
+ *
+ * Only one triangular part of the matrix is stored, in the packed format of the BLAS and LAPACK
+ * routines (see PackedTriangularMatrix). The other part is defined by symmetry, and the imaginary part
+ * of the diagonal coefficients is assumed to be zero.
+ *
+ * Besides the products with dense matrices, rank updates and the packed Cholesky factorizations
+ * PackedLLT and PackedLDLT (see llt() and ldlt()) work directly on the packed storage.
+ *
+ * \sa PackedTriangularMatrix, SelfAdjointView
+ */
+template <typename Scalar_, int UpLo_>
+class PackedSelfAdjointMatrix : public internal::PackedMatrixBase<PackedSelfAdjointMatrix<Scalar_, UpLo_> > {
+  EIGEN_STATIC_ASSERT(UpLo_ == Lower || UpLo_ == Upper, PACKED_MATRICES_ACCEPT_UPPER_AND_LOWER_MODE_ONLY)
+ public:
+  typedef internal::PackedMatrixBase<PackedSelfAdjointMatrix> Base;
+  typedef typename Base::Scalar Scalar;
+  typedef typename Base::RealScalar RealScalar;
+  using Base::cols;
+  using Base::rows;
+
+  /** Constructs a \a size x \a size matrix with uninitialized coefficients */
+  explicit PackedSelfAdjointMatrix(Index size = 0) : Base(size) {}
+
+  /** Constructs a packed copy of the \a UpLo_ part of \a other. The other part is not read. */
+  template <typename OtherDerived>
+  explicit PackedSelfAdjointMatrix(const MatrixBase<OtherDerived>& other) : Base(0) {
+    this->assignTriangle(other);
+  }
+
+  template <typename OtherDerived>
+  PackedSelfAdjointMatrix& operator=(const MatrixBase<OtherDerived>& other) {
+    this->assignTriangle(other);
+    return *this;
+  }
+
+  /** \returns the coefficient (i,j), read from the stored part */
+  inline Scalar coeff(Index i, Index j) const {
+    eigen_assert(i >= 0 && j >= 0 && i < rows() && j < cols());
+    if (UpLo_ == Lower ? i < j : i > j) return numext::conj(this->m_coeffs.coeff(Base::Storage::offset(rows(), j, i)));
+    return this->m_coeffs.coeff(Base::Storage::offset(rows(), i, j));
+  }
+  inline Scalar operator()(Index i, Index j) const { return coeff(i, j); }
+
+  template <typename Dest>
+  void evalTo(Dest& dst) const {
+    this->evalStoredPart(dst);
+    if (UpLo_ == Lower)
+      dst.template triangularView<StrictlyUpper>() = dst.adjoint();
+    else
+      dst.template triangularView<StrictlyLower>() = dst.adjoint();
+  }
+
+  /** \returns the product of \c *this by the dense matrix \a rhs */
+  template <typename OtherDerived>
+  const Product<PackedSelfAdjointMatrix, OtherDerived> operator*(const MatrixBase<OtherDerived>& rhs) const {
+    return Product<PackedSelfAdjointMatrix, OtherDerived>(*this, rhs.derived());
+  }
+
+  /** \returns the product of the dense matrix \a lhs by \a mat */
+  template <typename OtherDerived>
+  friend const Product<OtherDerived, PackedSelfAdjointMatrix> operator*(const MatrixBase<OtherDerived>& lhs,
+                                                                      const PackedSelfAdjointMatrix& mat) {
+    return Product<OtherDerived, PackedSelfAdjointMatrix>(lhs.derived(), mat);
+  }
+
+  template <typename DerivedU>
+  PackedSelfAdjointMatrix& rankUpdate(const MatrixBase<DerivedU>& u, const RealScalar& alpha = RealScalar(1));
+
+  /////////// Cholesky module ///////////
+
+  const PackedLLT<PackedSelfAdjointMatrix> llt() const;
+  const PackedLDLT<PackedSelfAdjointMatrix> ldlt() const;
+};
+
+namespace internal {
+
+template <typename Scalar_, int UpLo_>
+struct evaluator_traits<PackedTriangularMatrix<Scalar_, UpLo_> >
+    : public evaluator_traits_base<PackedTriangularMatrix<Scalar_, UpLo_> > {
+  typedef PackedTriangularShape Shape;
+};
+
+template <typename Scalar_, int UpLo_>
+struct evaluator_traits<PackedSelfAdjointMatrix<Scalar_, UpLo_> >
+    : public evaluator_traits_base<PackedSelfAdjointMatrix<Scalar_, UpLo_> > {
+  typedef PackedSelfAdjointShape Shape;
+};
+
+template <>
+struct AssignmentKind<DenseShape, PackedTriangularShape> {
+  typedef EigenBase2EigenBase Kind;
+};
+
+template <>
+struct AssignmentKind<DenseShape, PackedSelfAdjointShape> {
+  typedef EigenBase2EigenBase Kind;
+};
+
+}  // end namespace internal
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_PACKEDMATRIX_H
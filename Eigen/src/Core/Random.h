@@ -29,6 +29,175 @@ struct functor_traits<scalar_random_op<Scalar> > {
 
 }  // end namespace internal
 
+/** \class Philox
+ * \ingroup Core_Module
+ *
+ * \brief A counter-based random number generator for reproducible random matrices
+ *
+ * This class implements the Philox4x32-10 generator of Salmon et al. Unlike std::rand(), which is used by
+ * DenseBase::Random(), it has no state: the coefficient number \c k of a random matrix is computed from the
+ * \a seed, the \a stream and \c k only. As a consequence:
+ *  - random matrices are reproducible across platforms, compilers and runs,
+ *  - DenseBase::setRandom(const Philox&) fills large matrices with several threads, and the result does not
+ *    depend on the number of threads,
+ *  - evaluating the expression by blocks, or a block of it, gives the same coefficients,
+ *  - different streams of the same seed are independent sequences, e.g., one per task or per block.
+ *
+ * Coefficients are numbered following the storage order of the generated matrix type. The distribution of the
+ * coefficients is the same as the one of DenseBase::Random().
+ *
+ * Example:
+ * \code
+ * Philox gen(42);
+ * MatrixXf a = MatrixXf::Random(1000, 1000, gen);  // same values on every run
+ * MatrixXf b(1000, 1000);
+ * b.setRandom(gen);                                // b == a, filled in parallel
+ * VectorXd c = VectorXd::Random(10, gen.withStream(1));
+ * \endcode
+ *
+ * \sa DenseBase::Random(Index,Index,const Philox&), DenseBase::setRandom(const Philox&)
+ */
+class Philox {
+ public:
+  /** Constructs a generator with the given \a seed and \a stream. */
+  explicit Philox(uint64_t seed = 0, uint64_t stream = 0) : m_seed(seed), m_stream(stream) {}
+
+  /** \returns the seed of the generator */
+  uint64_t seed() const { return m_seed; }
+  /** \returns the stream of the generator */
+  uint64_t stream() const { return m_stream; }
+  /** \returns a generator with the same seed and the given \a stream */
+  Philox withStream(uint64_t stream) const { return Philox(m_seed, stream); }
+
+  /** Writes the 4 random words of the block number \a counter of the stream to \a out. */
+  void block(uint64_t counter, uint32_t* out) const { internal::philox4x32::run<1>(m_seed, m_stream, counter, 1, out); }
+
+ private:
+  uint64_t m_seed;
+  uint64_t m_stream;
+};
+
+namespace internal {
+
+// Coefficient (i,j) is the random number of index (i + rowOffset) + (j + colOffset) * innerSize,
+// or (j + colOffset) + (i + rowOffset) * innerSize if RowMajor.
+template <typename Scalar, bool RowMajor>
+struct scalar_philox_random_op {
+  typedef philox_random_scalar<Scalar> Convert;
+  enum { Words = Convert::Words, PerBlock = 4 / Words };
+
+  scalar_philox_random_op(const Philox& generator, Index innerSize, Index rowOffset = 0, Index colOffset = 0)
+      : m_seed(generator.seed()),
+        m_stream(generator.stream()),
+        m_innerSize(innerSize),
+        m_rowOffset(rowOffset),
+        m_colOffset(colOffset) {}
+
+  inline uint64_t index(Index i, Index j) const {
+    const Index inner = RowMajor ? j + m_colOffset : i + m_rowOffset;
+    const Index outer = RowMajor ? i + m_rowOffset : j + m_colOffset;
+    return static_cast<uint64_t>(inner) + static_cast<uint64_t>(outer) * static_cast<uint64_t>(m_innerSize);
+  }
+
+  inline const Scalar operator()(Index i, Index j) const {
+    const uint64_t k = index(i, j);
+    uint32_t words[4];
+    philox4x32::run<1>(m_seed, m_stream, k / PerBlock, 1, words);
+    return Convert::run(words + (k % PerBlock) * Words);
+  }
+
+  template <typename Packet>
+  inline const Packet packetOp(Index i, Index j) const {
+    // an unaligned packet of Size coefficients spans at most Batch blocks
+    enum {
+      Size = unpacket_traits<Packet>::size,
+      MaxBlocks = (Size + 2 * PerBlock - 2) / PerBlock,
+      Batch = MaxBlocks < philox4x32::kBatch ? int(MaxBlocks) : int(philox4x32::kBatch)
+    };
+    EIGEN_ALIGN_MAX Scalar values[Size];
+    fill<Batch>(values, index(i, j), Size);
+    return pload<Packet>(values);
+  }
+
+  // Writes the random numbers of indices first, ..., first + count - 1 to out, computing Batch blocks at once.
+  template <int Batch = philox4x32::kBatch>
+  void fill(Scalar* out, uint64_t first, Index count) const {
+    uint32_t words[4 * Batch];
+    uint64_t block = first / PerBlock;
+    Index skip = static_cast<Index>(first % PerBlock);
+    while (count > 0) {
+      const int blocks = static_cast<int>(numext::mini<Index>((skip + count + PerBlock - 1) / PerBlock, Batch));
+      philox4x32::run<Batch>(m_seed, m_stream, block, blocks, words);
+      const Index n = numext::mini<Index>(blocks * PerBlock - skip, count);
+      for (Index k = 0; k < n; ++k) out[k] = Convert::run(words + (skip + k) * Words);
+      out += n;
+      count -= n;
+      skip = 0;
+      block += static_cast<uint64_t>(blocks);
+    }
+  }
+
+  uint64_t m_seed;
+  uint64_t m_stream;
+  Index m_innerSize;
+  Index m_rowOffset;
+  Index m_colOffset;
+};
+
+template <typename Scalar, bool RowMajor>
+struct functor_traits<scalar_philox_random_op<Scalar, RowMajor> > {
+  enum {
+    Cost = 8 * NumTraits<Scalar>::MulCost * philox_random_scalar<Scalar>::Words,
+    PacketAccess = packet_traits<Scalar>::Vectorizable,
+    IsRepeatable = true
+  };
+};
+
+// Below this number of coefficients, setRandom(const Philox&) runs on a single thread.
+static constexpr Index kPhiloxParallelThreshold = 1 << 16;
+
+template <typename Derived, bool HasDirectAccess = (evaluator<Derived>::Flags & DirectAccessBit) != 0>
+struct philox_random_fill {
+  static void run(Derived& dst, const Philox& generator) {
+    typedef scalar_philox_random_op<typename Derived::Scalar, bool(Derived::IsRowMajor)> Op;
+    dst = Derived::PlainObject::NullaryExpr(dst.rows(), dst.cols(), Op(generator, dst.innerSize()));
+  }
+};
+
+// Fills the memory of dst directly by batches of blocks, splitting the coefficients evenly between the threads.
+template <typename Derived>
+struct philox_random_fill<Derived, true> {
+  static void run(Derived& dst, const Philox& generator) {
+    typedef typename Derived::Scalar Scalar;
+    typedef scalar_philox_random_op<Scalar, bool(Derived::IsRowMajor)> Op;
+    if (dst.innerStride() != 1) {
+      philox_random_fill<Derived, false>::run(dst, generator);
+      return;
+    }
+    const Index inner = dst.innerSize();
+    const Index size = dst.size();
+    const Index outerStride = dst.outerStride();
+    Scalar* data = dst.data();
+    const Op op(generator, inner);
+    const int tasks = static_cast<int>(numext::maxi<Index>(
+        1, numext::mini<Index>(Index(nbThreads()), size / kPhiloxParallelThreshold)));
+    parallelize_tasks(
+        [&](int task) {
+          const Index begin = size / tasks * task + numext::mini<Index>(size % tasks, task);
+          const Index end = begin + size / tasks + (task < size % tasks ? 1 : 0);
+          for (Index k = begin; k < end;) {
+            const Index outer = k / inner, i = k % inner;
+            const Index count = numext::mini<Index>(end - k, inner - i);
+            op.fill(data + outer * outerStride + i, static_cast<uint64_t>(k), count);
+            k += count;
+          }
+        },
+        tasks);
+  }
+};
+
+}  // end namespace internal
+
 /** \returns a random matrix expression
  *
  * Numbers are uniformly spread through their whole definition range for integer types,
@@ -113,6 +282,60 @@ inline const typename DenseBase<Derived>::RandomReturnType DenseBase<Derived>::R
   return NullaryExpr(RowsAtCompileTime, ColsAtCompileTime, internal::scalar_random_op<Scalar>());
 }
 
+/** \returns a reproducible random matrix expression whose coefficients are computed by \a generator
+ *
+ * Numbers follow the same distribution as Random(Index,Index). Each coefficient only depends on the
+ * generator and on its index in storage order, so that the expression can be evaluated in any order,
+ * or by blocks, and always gives the same matrix. Unlike Random(Index,Index), this function is reentrant,
+ * and the expression is vectorized and does not need to be evaluated before nesting.
+ *
+ * \sa class Philox, setRandom(const Philox&), Random(Index,Index)
+ */
+template <typename Derived>
+inline const typename DenseBase<Derived>::PhiloxRandomReturnType DenseBase<Derived>::Random(Index rows, Index cols,
+                                                                                          const Philox& generator) {
+  typedef internal::scalar_philox_random_op<Scalar, bool(IsRowMajor)> Op;
+  return NullaryExpr(rows, cols, Op(generator, IsRowMajor ? cols : rows));
+}
+
+/** \returns a reproducible random vector expression of size \a size whose coefficients are computed by
+ * \a generator
+ *
+ * \only_for_vectors
+ *
+ * \sa class Philox, Random(Index,Index,const Philox&)
+ */
+template <typename Derived>
+inline const typename DenseBase<Derived>::PhiloxRandomReturnType DenseBase<Derived>::Random(Index size,
+                                                                                          const Philox& generator) {
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
+  return Random(RowsAtCompileTime == 1 ? 1 : size, RowsAtCompileTime == 1 ? size : 1, generator);
+}
+
+/** \returns a fixed-size reproducible random matrix or vector expression whose coefficients are computed by
+ * \a generator
+ *
+ * \sa class Philox, Random(Index,Index,const Philox&)
+ */
+template <typename Derived>
+inline const typename DenseBase<Derived>::PhiloxRandomReturnType DenseBase<Derived>::Random(const Philox& generator) {
+  return Random(RowsAtCompileTime, ColsAtCompileTime, generator);
+}
+
+/** Sets all coefficients in this expression to reproducible random values computed by \a generator.
+ *
+ * The result is the same as the one of Random(rows(), cols(), generator). When the expression gives direct
+ * access to its coefficients, they are written by batches, and large matrices are filled by nbThreads()
+ * threads; the result does not depend on the number of threads.
+ *
+ * \sa class Philox, Random(Index,Index,const Philox&), setRandom()
+ */
+template <typename Derived>
+inline Derived& DenseBase<Derived>::setRandom(const Philox& generator) {
+  internal::philox_random_fill<Derived>::run(derived(), generator);
+  return derived();
+}
+
 /** Sets all coefficients in this expression to random values.
  *
  * Numbers are uniformly spread through their whole definition range for integer types,
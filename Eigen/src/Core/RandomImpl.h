@@ -247,6 +247,128 @@ struct random_default_impl<Scalar, true, false> {
   static EIGEN_DEVICE_FUNC inline Scalar run() { return Scalar(Impl::run(), Impl::run()); }
 };
 
+/****************************************************************************
+ * Counter-based random numbers                                             *
+ ****************************************************************************/
+
+/* Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11) maps a 128-bit counter
+ * and a 64-bit key to 128 random bits. Every block of 4 words is computed independently of the others, so that
+ * a matrix can be filled in any order, by any number of threads, and always receive the same coefficients.
+ * The counter is made of the block index (low 64 bits) and the stream (high 64 bits).
+ */
+struct philox4x32 {
+  static constexpr uint32_t kMul0 = 0xD2511F53u;
+  static constexpr uint32_t kMul1 = 0xCD9E8D57u;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+  static constexpr int kRounds = 10;
+  // Default number of blocks processed together by run(); the rounds are written over arrays of this length
+  // so that the compiler can vectorize them.
+  static constexpr int kBatch = 8;
+
+  // Computes the blocks first, ..., first + count - 1 of the given stream, with count <= Batch.
+  // Word w of block first + b is stored in out[4 * b + w].
+  template <int Batch>
+  static EIGEN_DEVICE_FUNC inline void run(uint64_t key, uint64_t stream, uint64_t first, int count, uint32_t* out) {
+    eigen_internal_assert(count >= 0 && count <= Batch);
+    uint32_t x0[Batch], x1[Batch], x2[Batch], x3[Batch];
+    for (int b = 0; b < Batch; ++b) {
+      const uint64_t counter = first + static_cast<uint64_t>(b);
+      x0[b] = static_cast<uint32_t>(counter);
+      x1[b] = static_cast<uint32_t>(counter >> 32);
+      x2[b] = static_cast<uint32_t>(stream);
+      x3[b] = static_cast<uint32_t>(stream >> 32);
+    }
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+    for (int r = 0; r < kRounds; ++r) {
+      for (int b = 0; b < Batch; ++b) {
+        const uint64_t p0 = static_cast<uint64_t>(kMul0) * x0[b];
+        const uint64_t p1 = static_cast<uint64_t>(kMul1) * x2[b];
+        const uint32_t y0 = static_cast<uint32_t>(p1 >> 32) ^ x1[b] ^ k0;
+        const uint32_t y2 = static_cast<uint32_t>(p0 >> 32) ^ x3[b] ^ k1;
+        x1[b] = static_cast<uint32_t>(p1);
+        x3[b] = static_cast<uint32_t>(p0);
+        x0[b] = y0;
+        x2[b] = y2;
+      }
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    for (int b = 0; b < count; ++b) {
+      out[4 * b + 0] = x0[b];
+      out[4 * b + 1] = x1[b];
+      out[4 * b + 2] = x2[b];
+      out[4 * b + 3] = x3[b];
+    }
+  }
+};
+
+// Converts Words 32-bit random words into a Scalar, following the conventions of random<Scalar>():
+// integers span their whole range, floating point numbers lie in [-1,1), complexes have random real
+// and imaginary parts.
+template <typename Scalar, bool IsComplex = NumTraits<Scalar>::IsComplex,
+          bool IsInteger = NumTraits<Scalar>::IsInteger>
+struct philox_random_scalar {
+  // custom floating point types are generated from a double with at most as many digits as the target type
+  static constexpr int Words = 2;
+  static EIGEN_DEVICE_FUNC inline Scalar run(const uint32_t* words) {
+    const int digits = numext::mini<int>(NumTraits<Scalar>::digits(), NumTraits<double>::digits());
+    uint64_t randomBits = (static_cast<uint64_t>(words[1]) << 32) | words[0];
+    randomBits = (randomBits >> (64 - (digits - 1))) << (NumTraits<double>::digits() - digits);
+    randomBits |= numext::bit_cast<uint64_t>(2.0);
+    return static_cast<Scalar>(numext::bit_cast<double>(randomBits) - 3.0);
+  }
+};
+
+template <typename Scalar>
+struct philox_random_float {
+  using BitsType = typename numext::get_integer_by_size<sizeof(Scalar)>::unsigned_type;
+  static constexpr int Words = sizeof(Scalar) > 4 ? 2 : 1;
+  static constexpr int kTotalBits = sizeof(Scalar) * CHAR_BIT;
+  static EIGEN_DEVICE_FUNC inline Scalar run(const uint32_t* words) {
+    BitsType randomBits = static_cast<BitsType>(words[0]);
+    if (Words == 2) randomBits |= static_cast<BitsType>(static_cast<uint64_t>(words[1]) << 32);
+    // keep the most significant bits as the mantissa, in the half-open interval [2,4)
+    randomBits >>= kTotalBits - (NumTraits<Scalar>::digits() - 1);
+    randomBits |= numext::bit_cast<BitsType>(Scalar(2));
+    return numext::bit_cast<Scalar>(randomBits) - Scalar(3);
+  }
+};
+
+template <>
+struct philox_random_scalar<float, false, false> : philox_random_float<float> {};
+template <>
+struct philox_random_scalar<double, false, false> : philox_random_float<double> {};
+
+template <typename Scalar>
+struct philox_random_scalar<Scalar, false, true> {
+  EIGEN_STATIC_ASSERT(std::is_integral<Scalar>::value, RANDOM FOR CUSTOM INTEGERS NOT YET SUPPORTED)
+  using BitsType = typename numext::get_integer_by_size<sizeof(Scalar)>::unsigned_type;
+  static constexpr int Words = sizeof(Scalar) > 4 ? 2 : 1;
+  static EIGEN_DEVICE_FUNC inline Scalar run(const uint32_t* words) {
+    uint64_t randomBits = words[0];
+    if (Words == 2) randomBits |= static_cast<uint64_t>(words[1]) << 32;
+    return static_cast<Scalar>(static_cast<BitsType>(randomBits));
+  }
+};
+
+template <>
+struct philox_random_scalar<bool, false, true> {
+  static constexpr int Words = 1;
+  static EIGEN_DEVICE_FUNC inline bool run(const uint32_t* words) { return (words[0] >> 31) != 0; }
+};
+
+template <typename Scalar>
+struct philox_random_scalar<Scalar, true, false> {
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef philox_random_scalar<RealScalar> Impl;
+  static constexpr int Words = 2 * Impl::Words;
+  static EIGEN_DEVICE_FUNC inline Scalar run(const uint32_t* words) {
+    return Scalar(Impl::run(words), Impl::run(words + Impl::Words));
+  }
+};
+
 }  // namespace internal
 }  // namespace Eigen
 
@@ -14,6 +14,11 @@
 // IWYU pragma: private
 #include "./InternalHeaderCheck.h"
 
+#ifndef EIGEN_INPLACE_TRANSPOSE_THRESHOLD
+// Size in bytes from which the non-square matrices are transposed in place without a full temporary.
+#define EIGEN_INPLACE_TRANSPOSE_THRESHOLD (32 << 20)
+#endif
+
 namespace Eigen {
 
 namespace internal {
@@ -196,6 +201,190 @@ EIGEN_DEVICE_FUNC inline const typename MatrixBase<Derived>::AdjointReturnType M
   return AdjointReturnType(this->transpose());
 }
 
+/***************************************************************************
+ * blocked transpose kernels
+ ***************************************************************************/
+
+namespace internal {
+
+/* dst = src^T, where dst is a rows x cols column-major matrix and src a
+ * cols x rows column-major matrix. Row-major operands are handled by swapping
+ * the dimensions.
+ *
+ * The matrices are split recursively along their largest dimension, such
+ * that the tiles of both matrices fit in the cache at some level of the
+ * recursion whatever the cache sizes are. The tiles are transposed by blocks
+ * of PacketSize x PacketSize coefficients with ptranspose.
+ */
+template <typename Scalar,
+          bool Vectorize = packet_traits<Scalar>::Vectorizable && !NumTraits<Scalar>::IsComplex &&
+                           (packet_traits<Scalar>::size > 1)>
+struct transpose_kernel {
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { PacketSize = Vectorize ? int(packet_traits<Scalar>::size) : 1, TileSize = 32 };
+
+  static void run(Index rows, Index cols, const Scalar* src, Index srcStride, Scalar* dst, Index dstStride) {
+    if (rows <= TileSize && cols <= TileSize) {
+      tile(rows, cols, src, srcStride, dst, dstStride);
+    } else if (rows >= cols) {
+      const Index half = numext::maxi<Index>(PacketSize, rows / 2 / PacketSize * PacketSize);
+      run(half, cols, src, srcStride, dst, dstStride);
+      run(rows - half, cols, src + half * srcStride, srcStride, dst + half, dstStride);
+    } else {
+      const Index half = numext::maxi<Index>(PacketSize, cols / 2 / PacketSize * PacketSize);
+      run(rows, half, src, srcStride, dst, dstStride);
+      run(rows, cols - half, src + half, srcStride, dst + half * dstStride, dstStride);
+    }
+  }
+
+ private:
+  static void tile(Index rows, Index cols, const Scalar* src, Index srcStride, Scalar* dst, Index dstStride) {
+    Index i = 0;
+    if (Vectorize) {
+      for (; i + PacketSize <= rows; i += PacketSize) {
+        Index j = 0;
+        for (; j + PacketSize <= cols; j += PacketSize) {
+          // The rows i..i+PacketSize-1 of dst are read as columns of src.
+          PacketBlock<Packet> block;
+          for (Index k = 0; k < PacketSize; ++k) block.packet[k] = ploadu<Packet>(src + j + (i + k) * srcStride);
+          ptranspose(block);
+          for (Index k = 0; k < PacketSize; ++k) pstoreu(dst + i + (j + k) * dstStride, block.packet[k]);
+        }
+        for (; j < cols; ++j)
+          for (Index k = 0; k < PacketSize; ++k) dst[i + k + j * dstStride] = src[j + (i + k) * srcStride];
+      }
+    }
+    for (Index j = 0; j < cols; ++j)
+      for (Index k = i; k < rows; ++k) dst[k + j * dstStride] = src[j + k * srcStride];
+  }
+};
+
+/* Transposes in place the rows x cols column-major matrix stored in data, that
+ * is, stores its transpose as a cols x rows column-major matrix. Row-major
+ * matrices are handled by swapping the dimensions.
+ *
+ * Transposing a R x C matrix in place permutes its coefficients by the cycles
+ * of k -> k C mod (RC - 1). Following these cycles reads the memory at random,
+ * so that the permutation is applied to vectors of b consecutive coefficients
+ * instead. When b divides the number of rows r, the r/b x C matrix of b-vectors
+ * is transposed by following the cycles, which leaves r/b consecutive b x C
+ * blocks to transpose. When b divides the number of columns instead, the r x b
+ * blocks are transposed first, and then the r x c/b matrix of b-vectors. Both
+ * need a workspace of b x C or r x b coefficients for the blocks, and a bit per
+ * b-vector to mark the visited cycles.
+ *
+ * Vectors shorter than a cache line would make each step of a cycle a cache
+ * miss for a few coefficients: when neither dimension has a large enough
+ * divisor, for instance when both are prime, run() returns false without
+ * modifying data, and the caller transposes through a temporary instead.
+ */
+template <typename Scalar>
+struct inplace_rectangular_transpose {
+  typedef Map<Matrix<Scalar, Dynamic, 1> > VectorMap;
+  enum { MinBlock = (64 + sizeof(Scalar) - 1) / sizeof(Scalar) };
+
+  static bool run(Scalar* data, Index rows, Index cols) {
+    const Index rowBlock = largest_divisor(rows, numext::mini<Index>(256, rows / 8));
+    const Index colBlock = largest_divisor(cols, numext::mini<Index>(256, cols / 8));
+    if (numext::maxi(rowBlock, colBlock) < Index(MinBlock)) return false;
+    if (rowBlock >= colBlock) {
+      follow_cycles(data, rows / rowBlock, cols, rowBlock);
+      if (rowBlock > 1) transpose_blocks(data, rowBlock, cols, rows / rowBlock);
+    } else {
+      transpose_blocks(data, rows, colBlock, cols / colBlock);
+      follow_cycles(data, rows, cols / colBlock, colBlock);
+    }
+    return true;
+  }
+
+ private:
+  // \returns the largest divisor of n which is at most max, or 1.
+  static Index largest_divisor(Index n, Index max) {
+    for (Index b = max; b > 1; --b)
+      if (n % b == 0) return b;
+    return 1;
+  }
+
+  // Transposes each of the count consecutive rows x cols blocks of data.
+  static void transpose_blocks(Scalar* data, Index rows, Index cols, Index count) {
+    const Index size = rows * cols;
+    ei_declare_aligned_stack_constructed_variable(Scalar, work, size, 0);
+    for (Index k = 0; k < count; ++k) {
+      Scalar* block = data + k * size;
+      transpose_kernel<Scalar>::run(cols, rows, block, rows, work, cols);
+      VectorMap(block, size) = VectorMap(work, size);
+    }
+  }
+
+  // Transposes the rows x cols column-major matrix of b-vectors stored in data.
+  static void follow_cycles(Scalar* data, Index rows, Index cols, Index b) {
+    const Index n = rows * cols;
+    if (rows == 1 || cols == 1) return;
+    std::vector<bool> visited(n, false);
+    ei_declare_aligned_stack_constructed_variable(Scalar, first, b, 0);
+    // 0 and n-1 are fixed points.
+    for (Index start = 1; start < n - 1; ++start) {
+      if (visited[start]) continue;
+      // Moves the vectors of the cycle of start, the vector at position k
+      // being replaced by the coefficient (k / cols, k % cols) of the matrix.
+      VectorMap(first, b) = VectorMap(data + start * b, b);
+      Index k = start;
+      while (true) {
+        visited[k] = true;
+        const Index next = k / cols + (k % cols) * rows;
+        if (next == start) break;
+        VectorMap(data + k * b, b) = VectorMap(data + next * b, b);
+        k = next;
+      }
+      VectorMap(data + k * b, b) = VectorMap(first, b);
+    }
+  }
+};
+
+/* Assignment of a transposed matrix to a matrix with the same storage order.
+ * Large matrices with direct access are copied by the blocked transpose_kernel
+ * instead of reading one of the two matrices with a large stride.
+ */
+template <typename DstXprType, typename SrcXprType,
+          bool Enable = (evaluator<DstXprType>::Flags & DirectAccessBit) &&
+                        (evaluator<SrcXprType>::Flags & DirectAccessBit) &&
+                        bool(int(DstXprType::Flags & RowMajorBit) == int(SrcXprType::Flags & RowMajorBit)) &&
+                        (DstXprType::SizeAtCompileTime == Dynamic) && (SrcXprType::SizeAtCompileTime == Dynamic) &&
+                        is_same<typename DstXprType::Scalar, typename SrcXprType::Scalar>::value>
+struct transpose_assignment {
+  static bool run(DstXprType&, const SrcXprType&) { return false; }
+};
+
+template <typename DstXprType, typename SrcXprType>
+struct transpose_assignment<DstXprType, SrcXprType, true> {
+  static bool run(DstXprType& dst, const SrcXprType& src) {
+    const Index minSize = transpose_kernel<typename DstXprType::Scalar>::TileSize / 2;
+    if (dst.rows() < minSize || dst.cols() < minSize || dst.innerStride() != 1 || src.innerStride() != 1) return false;
+    const bool rowMajor = DstXprType::Flags & RowMajorBit;
+    transpose_kernel<typename DstXprType::Scalar>::run(rowMajor ? dst.cols() : dst.rows(),
+                                                       rowMajor ? dst.rows() : dst.cols(), src.data(),
+                                                       src.outerStride(), dst.data(), dst.outerStride());
+    return true;
+  }
+};
+
+template <typename DstXprType, typename MatrixType, typename Scalar>
+struct Assignment<DstXprType, Transpose<MatrixType>, assign_op<Scalar, Scalar>, Dense2Dense> {
+  typedef Transpose<MatrixType> SrcXprType;
+  EIGEN_DEVICE_FUNC static void run(DstXprType& dst, const SrcXprType& src, const assign_op<Scalar, Scalar>& func) {
+#ifndef EIGEN_NO_DEBUG
+    internal::check_for_aliasing(dst, src);
+#endif
+#ifndef EIGEN_GPU_COMPILE_PHASE
+    resize_if_allowed(dst, src, func);
+    if (transpose_assignment<DstXprType, remove_all_t<MatrixType> >::run(dst, src.nestedExpression())) return;
+#endif
+    call_dense_assignment_loop(dst, src, func);
+  }
+};
+
+}  // end namespace internal
+
 /***************************************************************************
  * "in place" transpose implementation
  ***************************************************************************/
@@ -272,6 +461,34 @@ void BlockedInPlaceTranspose(MatrixType& m) {
   }
 }
 
+template <typename MatrixType, bool InPlace = std::is_base_of<PlainObjectBase<MatrixType>, MatrixType>::value>
+struct inplace_rectangular_transpose_selector {
+  static void run(MatrixType& m) { m = m.transpose().eval(); }
+};
+
+template <typename MatrixType>
+struct inplace_rectangular_transpose_selector<MatrixType, true> {
+  static void run(MatrixType& m) {
+    typedef typename MatrixType::Scalar Scalar;
+    if (m.size() * Index(sizeof(Scalar)) < Index(EIGEN_INPLACE_TRANSPOSE_THRESHOLD)) {
+      m = m.transpose().eval();
+      return;
+    }
+    const Index rows = m.rows(), cols = m.cols();
+    const bool done = MatrixType::IsRowMajor ? inplace_rectangular_transpose<Scalar>::run(m.data(), cols, rows)
+                                             : inplace_rectangular_transpose<Scalar>::run(m.data(), rows, cols);
+    if (!done) {
+      // Keeps the storage of m, as in place.
+      const typename MatrixType::PlainObject tmp = m.transpose();
+      m.resize(cols, rows);
+      m = tmp;
+      return;
+    }
+    // Same size: no reallocation.
+    m.resize(cols, rows);
+  }
+};
+
 template <typename MatrixType, bool MatchPacketSize>
 struct inplace_transpose_selector<MatrixType, false, MatchPacketSize> {  // non square or dynamic matrix
   static void run(MatrixType& m) {
@@ -288,7 +505,7 @@ struct inplace_transpose_selector<MatrixType, false, MatchPacketSize> {  // non
             m.matrix().transpose().template triangularView<StrictlyUpper>());
       }
     } else {
-      m = m.transpose().eval();
+      inplace_rectangular_transpose_selector<MatrixType>::run(m);
     }
   }
 };
@@ -312,6 +529,8 @@ struct inplace_transpose_selector<MatrixType, false, MatchPacketSize> {  // non
  *
  * \note if the matrix is not square, then \c *this must be a resizable matrix.
  * This excludes (non-square) fixed-size matrices, block-expressions and maps.
+ * Non-square matrices larger than \c EIGEN_INPLACE_TRANSPOSE_THRESHOLD bytes are transposed without a full
+ * temporary, the workspace being a small fraction of the matrix.
  *
  * \sa transpose(), adjoint(), adjointInPlace() */
 template <typename Derived>
@@ -1710,6 +1710,28 @@ EIGEN_DEVICE_FUNC inline void pscatter<uint32_t, Packet8ui>(uint32_t* to, const
   pscatter<int, Packet8i>((int*)to, (Packet8i)from, stride);
 }
 
+#ifdef EIGEN_VECTORIZE_AVX2
+// Gathers with arbitrary 64-bit offsets. There is no scatter instruction before AVX512.
+EIGEN_STRONG_INLINE __m256i pload_offsets4(const Index* offsets) {
+  return _mm256_set_epi64x(int64_t(offsets[3]), int64_t(offsets[2]), int64_t(offsets[1]), int64_t(offsets[0]));
+}
+
+template <>
+EIGEN_DEVICE_FUNC inline Packet8f pgather_indexed<float, Packet8f>(const float* from, const Index* offsets) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_i64gather_ps(from, pload_offsets4(offsets), 4)),
+                              _mm256_i64gather_ps(from, pload_offsets4(offsets + 4), 4), 1);
+}
+template <>
+EIGEN_DEVICE_FUNC inline Packet4d pgather_indexed<double, Packet4d>(const double* from, const Index* offsets) {
+  return _mm256_i64gather_pd(from, pload_offsets4(offsets), 8);
+}
+template <>
+EIGEN_DEVICE_FUNC inline Packet8i pgather_indexed<int, Packet8i>(const int* from, const Index* offsets) {
+  return _mm256_insertf128_si256(_mm256_castsi128_si256(_mm256_i64gather_epi32(from, pload_offsets4(offsets), 4)),
+                                 _mm256_i64gather_epi32(from, pload_offsets4(offsets + 4), 4), 1);
+}
+#endif
+
 template <>
 EIGEN_STRONG_INLINE void pstore1<Packet8f>(float* to, const float& a) {
   Packet8f pa = pset1<Packet8f>(a);
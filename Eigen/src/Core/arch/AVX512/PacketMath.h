@@ -1235,6 +1235,54 @@ EIGEN_DEVICE_FUNC inline void pscatter<int, Packet16i>(int* to, const Packet16i&
   _mm512_i32scatter_epi32(to, indices, from, 4);
 }
 
+// Gathers and scatters with arbitrary 64-bit offsets. Overlapping scatters are ordered from the lowest to the highest
+// element, so that the last one wins as in the generic version.
+EIGEN_STRONG_INLINE __m512i pload_offsets8(const Index* offsets) {
+  return _mm512_set_epi64(int64_t(offsets[7]), int64_t(offsets[6]), int64_t(offsets[5]), int64_t(offsets[4]),
+                          int64_t(offsets[3]), int64_t(offsets[2]), int64_t(offsets[1]), int64_t(offsets[0]));
+}
+
+template <>
+EIGEN_DEVICE_FUNC inline Packet16f pgather_indexed<float, Packet16f>(const float* from, const Index* offsets) {
+  return cat256(_mm512_i64gather_ps(pload_offsets8(offsets), from, 4),
+                _mm512_i64gather_ps(pload_offsets8(offsets + 8), from, 4));
+}
+template <>
+EIGEN_DEVICE_FUNC inline Packet8d pgather_indexed<double, Packet8d>(const double* from, const Index* offsets) {
+  return _mm512_i64gather_pd(pload_offsets8(offsets), from, 8);
+}
+template <>
+EIGEN_DEVICE_FUNC inline Packet8l pgather_indexed<int64_t, Packet8l>(const int64_t* from, const Index* offsets) {
+  return _mm512_i64gather_epi64(pload_offsets8(offsets), from, 8);
+}
+template <>
+EIGEN_DEVICE_FUNC inline Packet16i pgather_indexed<int, Packet16i>(const int* from, const Index* offsets) {
+  return cat256i(_mm512_i64gather_epi32(pload_offsets8(offsets), from, 4),
+                 _mm512_i64gather_epi32(pload_offsets8(offsets + 8), from, 4));
+}
+
+template <>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed<float, Packet16f>(float* to, const Packet16f& from,
+                                                                 const Index* offsets) {
+  _mm512_i64scatter_ps(to, pload_offsets8(offsets), extract256<0>(from), 4);
+  _mm512_i64scatter_ps(to, pload_offsets8(offsets + 8), extract256<1>(from), 4);
+}
+template <>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed<double, Packet8d>(double* to, const Packet8d& from,
+                                                                 const Index* offsets) {
+  _mm512_i64scatter_pd(to, pload_offsets8(offsets), from, 8);
+}
+template <>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed<int64_t, Packet8l>(int64_t* to, const Packet8l& from,
+                                                                  const Index* offsets) {
+  _mm512_i64scatter_epi64(to, pload_offsets8(offsets), from, 8);
+}
+template <>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed<int, Packet16i>(int* to, const Packet16i& from, const Index* offsets) {
+  _mm512_i64scatter_epi32(to, pload_offsets8(offsets), _mm512_castsi512_si256(from), 4);
+  _mm512_i64scatter_epi32(to, pload_offsets8(offsets + 8), _mm512_extracti64x4_epi64(from, 1), 4);
+}
+
 template <>
 EIGEN_STRONG_INLINE void pstore1<Packet16f>(float* to, const float& a) {
   Packet16f pa = pset1<Packet16f>(a);
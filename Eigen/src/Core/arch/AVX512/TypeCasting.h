@@ -281,6 +281,11 @@ EIGEN_STRONG_INLINE Packet32h pcast<Packet16f, Packet32h>(const Packet16f& a, co
   return _mm512_castpd_ph(result);
 }
 
+template <>
+EIGEN_STRONG_INLINE Packet16f pcast<Packet16h, Packet16f>(const Packet16h& a) {
+  return _mm512_cvtxph_ps(_mm256_castsi256_ph(a));
+}
+
 template <>
 EIGEN_STRONG_INLINE Packet8f pcast<Packet16h, Packet8f>(const Packet16h& a) {
   // Discard second-half of input.
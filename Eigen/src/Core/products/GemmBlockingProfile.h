@@ -0,0 +1,259 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GEMM_BLOCKING_PROFILE_H
+#define EIGEN_GEMM_BLOCKING_PROFILE_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Index of the scalar types whose GEMM blocking can be tuned at runtime, -1 for the other ones. */
+template <typename LhsScalar, typename RhsScalar>
+struct gemm_blocking_profile_scalar {
+  enum { Id = -1 };
+};
+template <>
+struct gemm_blocking_profile_scalar<float, float> {
+  enum { Id = 0 };
+};
+template <>
+struct gemm_blocking_profile_scalar<double, double> {
+  enum { Id = 1 };
+};
+template <>
+struct gemm_blocking_profile_scalar<std::complex<float>, std::complex<float> > {
+  enum { Id = 2 };
+};
+template <>
+struct gemm_blocking_profile_scalar<std::complex<double>, std::complex<double> > {
+  enum { Id = 3 };
+};
+
+/* Table of GEMM blocking sizes measured at runtime, see tuneGemmBlocking().
+ *
+ * An entry gives the kc, mc and nc blocking sizes of a scalar type for a
+ * class of shapes and a number of threads. The shape class of a m x k times
+ * k x n product is made of the classes of its three dimensions, see
+ * shape_class(). The number of threads is the one of the product, as passed to
+ * computeProductBlockingSizes, which is 1 for sequential products. When the
+ * table has an entry for a product, its blocking sizes replace the ones of the
+ * cache size heuristic. The table is empty by default.
+ *
+ * The products read the table without lock: the entries are published as an
+ * immutable snapshot, which is replaced as a whole by the rare updates. The
+ * previous snapshots are only freed with the table, since a product may still
+ * be reading them.
+ */
+class gemm_blocking_profile : noncopyable {
+ public:
+  enum { NumScalars = 4, NumShapeClasses = 4 };
+
+  struct entry {
+    int scalar;
+    int k_class, m_class, n_class;
+    int threads;
+    Index kc, mc, nc;
+  };
+
+  static gemm_blocking_profile& instance() {
+    static gemm_blocking_profile profile;
+    return profile;
+  }
+
+  static const char* scalar_name(int scalar) {
+    static const char* const names[NumScalars] = {"float", "double", "cfloat", "cdouble"};
+    return names[scalar];
+  }
+
+  static int shape_class(Index size) { return size <= 128 ? 0 : size <= 512 ? 1 : size <= 2048 ? 2 : 3; }
+
+  gemm_blocking_profile() : m_current(nullptr) {}
+
+  ~gemm_blocking_profile() {
+    const snapshot* s = m_current.load(std::memory_order_acquire);
+    while (s != nullptr) {
+      const snapshot* previous = s->previous;
+      delete s;
+      s = previous;
+    }
+  }
+
+  bool empty() const {
+    const snapshot* s = m_current.load(std::memory_order_acquire);
+    return s == nullptr || s->entries.empty();
+  }
+
+  bool lookup(int scalar, Index k, Index m, Index n, Index threads, Index& kc, Index& mc, Index& nc) const {
+    const entry* e = find(m_current.load(std::memory_order_acquire), scalar, shape_class(k), shape_class(m),
+                          shape_class(n), static_cast<int>(threads));
+    if (e == nullptr) return false;
+    kc = e->kc;
+    mc = e->mc;
+    nc = e->nc;
+    return true;
+  }
+
+  bool contains(int scalar, int k_class, int m_class, int n_class, int threads) const {
+    return find(m_current.load(std::memory_order_acquire), scalar, k_class, m_class, n_class, threads) != nullptr;
+  }
+
+  // Adds entries, or replaces the ones of the same scalar type, shape class and number of threads.
+  void insert(const std::vector<entry>& new_entries) {
+    update([&new_entries](std::vector<entry>& entries) {
+      for (const entry& e : new_entries) {
+        entry* old = const_cast<entry*>(find(entries, e.scalar, e.k_class, e.m_class, e.n_class, e.threads));
+        if (old != nullptr)
+          *old = e;
+        else
+          entries.push_back(e);
+      }
+    });
+  }
+
+  void insert(const entry& e) { insert(std::vector<entry>(1, e)); }
+
+  void clear() {
+    update([](std::vector<entry>& entries) { entries.clear(); });
+  }
+
+  std::vector<entry> entries() const {
+    const snapshot* s = m_current.load(std::memory_order_acquire);
+    return s != nullptr ? s->entries : std::vector<entry>();
+  }
+
+ private:
+  struct snapshot {
+    std::vector<entry> entries;
+    const snapshot* previous;
+  };
+
+  static const entry* find(const std::vector<entry>& entries, int scalar, int k_class, int m_class, int n_class,
+                           int threads) {
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      const entry& e = entries[i];
+      if (e.scalar == scalar && e.k_class == k_class && e.m_class == m_class && e.n_class == n_class &&
+          e.threads == threads)
+        return &e;
+    }
+    return nullptr;
+  }
+
+  static const entry* find(const snapshot* s, int scalar, int k_class, int m_class, int n_class, int threads) {
+    return s != nullptr ? find(s->entries, scalar, k_class, m_class, n_class, threads) : nullptr;
+  }
+
+  // Publishes a modified copy of the current snapshot.
+  template <typename Modifier>
+  void update(const Modifier& modify) {
+    const snapshot* current = m_current.load(std::memory_order_acquire);
+    snapshot* next = new snapshot;
+    for (;;) {
+      next->entries = current != nullptr ? current->entries : std::vector<entry>();
+      next->previous = current;
+      modify(next->entries);
+      if (m_current.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_acquire)) return;
+    }
+  }
+
+  std::atomic<const snapshot*> m_current;
+};
+
+/* Blocking sizes imposed on the products of the calling thread while the
+ * tuner measures them. With kc == 0, the heuristic is used and only the
+ * number of threads is recorded. With EIGEN_AVOID_THREAD_LOCAL, the sizes are
+ * imposed on the products of all the threads, which must not run products
+ * while a shape is tuned.
+ */
+struct gemm_blocking_override {
+  gemm_blocking_override() : active(false), kc(0), mc(0), nc(0), threads(0) {}
+
+  static gemm_blocking_override& current() {
+    static EIGEN_MALLOC_CHECK_THREAD_LOCAL gemm_blocking_override value;
+    return value;
+  }
+
+  bool active;
+  Index kc, mc, nc;
+  Index threads;
+};
+
+}  // end namespace internal
+
+#ifndef EIGEN_NO_IO
+
+/** Writes the GEMM blocking sizes measured by tuneGemmBlocking() to the text file \a filename, one entry per line.
+ * \returns false if the file could not be written.
+ * \sa loadGemmBlockingProfile() */
+inline bool saveGemmBlockingProfile(const char* filename) {
+  typedef internal::gemm_blocking_profile Profile;
+  std::FILE* file = std::fopen(filename, "w");
+  if (file == 0) return false;
+  bool ok = std::fprintf(file, "# Eigen GEMM blocking profile\n# scalar k_class m_class n_class threads kc mc nc\n") > 0;
+  const std::vector<Profile::entry> entries = Profile::instance().entries();
+  for (std::size_t i = 0; i < entries.size() && ok; ++i) {
+    const Profile::entry& e = entries[i];
+    ok = std::fprintf(file, "%s %d %d %d %d %lld %lld %lld\n", Profile::scalar_name(e.scalar), e.k_class, e.m_class,
+                      e.n_class, e.threads, static_cast<long long>(e.kc), static_cast<long long>(e.mc),
+                      static_cast<long long>(e.nc)) > 0;
+  }
+  return (std::fclose(file) == 0) && ok;
+}
+
+/** Loads the GEMM blocking sizes written by saveGemmBlockingProfile(), such that the products use them without being
+ * tuned again. The entries replace the ones of the same scalar type, shape class and number of threads.
+ * \returns false, and leaves the current profile unchanged, if the file could not be read or is malformed.
+ * \sa saveGemmBlockingProfile(), tuneGemmBlocking() */
+inline bool loadGemmBlockingProfile(const char* filename) {
+  typedef internal::gemm_blocking_profile Profile;
+  std::FILE* file = std::fopen(filename, "r");
+  if (file == 0) return false;
+  std::vector<Profile::entry> entries;
+  bool ok = true;
+  char line[256];
+  while (ok && std::fgets(line, sizeof(line), file)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    char name[16];
+    int classes[3], threads;
+    long long sizes[3];
+    ok = std::sscanf(line, "%15s %d %d %d %d %lld %lld %lld", name, &classes[0], &classes[1], &classes[2], &threads,
+                     &sizes[0], &sizes[1], &sizes[2]) == 8;
+    Profile::entry e;
+    e.scalar = -1;
+    for (int s = 0; ok && s < Profile::NumScalars; ++s)
+      if (std::strcmp(name, Profile::scalar_name(s)) == 0) e.scalar = s;
+    ok = ok && e.scalar >= 0 && threads > 0 && sizes[0] > 0 && sizes[1] > 0 && sizes[2] > 0;
+    for (int c = 0; c < 3; ++c) ok = ok && classes[c] >= 0 && classes[c] < Profile::NumShapeClasses;
+    if (!ok) break;
+    e.k_class = classes[0];
+    e.m_class = classes[1];
+    e.n_class = classes[2];
+    e.threads = threads;
+    e.kc = static_cast<Index>(sizes[0]);
+    e.mc = static_cast<Index>(sizes[1]);
+    e.nc = static_cast<Index>(sizes[2]);
+    entries.push_back(e);
+  }
+  ok = ok && !std::ferror(file);
+  std::fclose(file);
+  if (!ok) return false;
+  Profile::instance().insert(entries);
+  return true;
+}
+
+#endif  // EIGEN_NO_IO
+
+/** Removes all the GEMM blocking sizes measured or loaded so far: the products use the cache size heuristic again.
+ * \sa tuneGemmBlocking(), loadGemmBlockingProfile() */
+inline void clearGemmBlockingProfile() { internal::gemm_blocking_profile::instance().clear(); }
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_GEMM_BLOCKING_PROFILE_H
@@ -0,0 +1,199 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GEMM_BLOCKING_TUNER_H
+#define EIGEN_GEMM_BLOCKING_TUNER_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+/* Measures the GEMM blocking sizes of a product shape.
+ *
+ * The products are run through the regular code path, with the blocking sizes
+ * imposed by gemm_blocking_override, such that the number of threads and the
+ * kernels are the ones of the user products. Starting from the sizes of the
+ * cache size heuristic, kc, then mc, then nc are scaled down and up in turn,
+ * and a candidate is kept if it is faster by more than the timing noise. The
+ * mc blocking is not tuned for parallel products, which split the rows
+ * between the threads.
+ */
+template <typename Scalar>
+class gemm_blocking_tuner {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef gebp_traits<Scalar, Scalar> Traits;
+
+ public:
+  gemm_blocking_tuner(Index rows, Index cols, Index depth)
+      : m_lhs(MatrixType::Random(rows, depth)), m_rhs(MatrixType::Random(depth, cols)), m_res(rows, cols) {
+    // Time about 5e7 multiply-adds per measurement.
+    const double work = double(rows) * double(cols) * double(depth);
+    m_repeat = static_cast<int>(numext::maxi(1.0, 5e7 / numext::maxi(work, 1.0)));
+
+    // A first product with the heuristic warms up the caches and the workspace,
+    // and records the number of threads.
+    gemm_blocking_override& forced = gemm_blocking_override::current();
+    const gemm_blocking_override saved = forced;
+    forced = gemm_blocking_override();
+    forced.active = true;
+    m_res.setZero();
+    m_res.noalias() += m_lhs * m_rhs;
+    m_threads = numext::maxi<Index>(forced.threads, 1);
+    forced = saved;
+  }
+
+  gemm_blocking_profile::entry run() {
+    gemm_blocking_override& forced = gemm_blocking_override::current();
+    const gemm_blocking_override saved = forced;
+    forced = gemm_blocking_override();
+    forced.active = true;
+    const Index threads = m_threads;
+
+    Index kc = m_lhs.cols(), mc = m_lhs.rows(), nc = m_rhs.cols();
+    evaluateProductBlockingSizesHeuristic<Scalar, Scalar, 1>(kc, mc, nc, threads);
+    const Index kc0 = kc, mc0 = mc, nc0 = nc;
+    double best = time(kc, mc, nc);
+
+    const int factors[4][2] = {{1, 2}, {3, 4}, {3, 2}, {2, 1}};
+    for (int f = 0; f < 4; ++f) {
+      const Index k = round(kc * factors[f][0] / factors[f][1], 8, m_lhs.cols());
+      try_candidate(k, mc, nc, kc, mc, nc, best);
+    }
+    if (threads == 1) {
+      for (int f = 0; f < 4; f += 3) {
+        const Index m = round(mc * factors[f][0] / factors[f][1], Traits::mr, m_lhs.rows());
+        try_candidate(kc, m, nc, kc, mc, nc, best);
+      }
+    }
+    for (int f = 0; f < 4; f += 3) {
+      const Index n = round(nc * factors[f][0] / factors[f][1], Traits::nr, m_rhs.cols());
+      try_candidate(kc, mc, n, kc, mc, nc, best);
+    }
+    // The best of many noisy timings is biased: confirm the gain against the
+    // heuristic with fresh timings.
+    if (kc != kc0 || mc != mc0 || nc != nc0) {
+      const double tuned = time(kc, mc, nc);
+      if (!(tuned < 0.97 * time(kc0, mc0, nc0))) {
+        kc = kc0;
+        mc = mc0;
+        nc = nc0;
+      }
+    }
+
+    forced = saved;
+
+    gemm_blocking_profile::entry e;
+    e.scalar = gemm_blocking_profile_scalar<Scalar, Scalar>::Id;
+    e.k_class = gemm_blocking_profile::shape_class(m_lhs.cols());
+    e.m_class = gemm_blocking_profile::shape_class(m_lhs.rows());
+    e.n_class = gemm_blocking_profile::shape_class(m_rhs.cols());
+    e.threads = static_cast<int>(threads);
+    e.kc = kc;
+    e.mc = mc;
+    e.nc = nc;
+    return e;
+  }
+
+ private:
+  // Rounds down to a multiple of the register block, within [multiple, size].
+  static Index round(Index value, Index multiple, Index size) {
+    return numext::mini(size, numext::maxi(multiple, value - value % multiple));
+  }
+
+  void try_candidate(Index k, Index m, Index n, Index& kc, Index& mc, Index& nc, double& best) {
+    if (k == kc && m == mc && n == nc) return;
+    const double t = time(k, m, n);
+    if (t < 0.97 * best) {
+      best = t;
+      kc = k;
+      mc = m;
+      nc = n;
+    }
+  }
+
+  // Best time of a few runs of the product with the given blocking sizes.
+  double time(Index kc, Index mc, Index nc) {
+    gemm_blocking_override& forced = gemm_blocking_override::current();
+    forced.kc = kc;
+    forced.mc = mc;
+    forced.nc = nc;
+    double best = NumTraits<double>::highest();
+    for (int tries = 0; tries < 3; ++tries) {
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (int r = 0; r < m_repeat; ++r) m_res.noalias() += m_lhs * m_rhs;
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = numext::mini(best, elapsed.count());
+    }
+    return best;
+  }
+
+  MatrixType m_lhs, m_rhs, m_res;
+  int m_repeat;
+  Index m_threads;
+};
+
+}  // end namespace internal
+
+/** Measures the fastest GEMM blocking sizes for the \a rows x \a depth times \a depth x \a cols products of
+ * \a Scalar, and uses them for all the following products of the same class of shapes.
+ *
+ * The sizes are measured for the current number of threads (see setNbThreads()). Classes of shapes are defined
+ * by bucketing each dimension at 128, 512 and 2048. \a Scalar must be float, double, std::complex<float>, or
+ * std::complex<double>.
+ *
+ * Tuning runs a few dozen products of the given shape: the results can be saved with saveGemmBlockingProfile()
+ * and loaded back at startup with loadGemmBlockingProfile().
+ *
+ * \sa gemmBlockingAutotune(), clearGemmBlockingProfile(), computeProductBlockingSizes */
+template <typename Scalar>
+void tuneGemmBlocking(Index rows, Index cols, Index depth) {
+  EIGEN_STATIC_ASSERT((internal::gemm_blocking_profile_scalar<Scalar, Scalar>::Id >= 0),
+                      THE_GEMM_BLOCKING_CAN_ONLY_BE_TUNED_FOR_FLOAT_DOUBLE_AND_COMPLEX_SCALARS)
+  eigen_assert(rows > 0 && cols > 0 && depth > 0);
+  internal::gemm_blocking_profile::instance().insert(internal::gemm_blocking_tuner<Scalar>(rows, cols, depth).run());
+}
+
+/** Same as tuneGemmBlocking(), but only if the profile has no entry yet for the class of shapes of the \a rows x
+ * \a depth times \a depth x \a cols products of \a Scalar and their number of threads, e.g., because it was loaded
+ * by loadGemmBlockingProfile(). The dimensions are capped to 1024 for the measurements, whose results are used for
+ * the whole class.
+ *
+ * Products never tune their blocking sizes themselves: call this function ahead of time, e.g., at startup for the
+ * shapes of the application.
+ *
+ * \returns true if the blocking sizes were measured, and false if the profile already had an entry.
+ * \sa tuneGemmBlocking(), saveGemmBlockingProfile() */
+template <typename Scalar>
+bool gemmBlockingAutotune(Index rows, Index cols, Index depth) {
+  EIGEN_STATIC_ASSERT((internal::gemm_blocking_profile_scalar<Scalar, Scalar>::Id >= 0),
+                      THE_GEMM_BLOCKING_CAN_ONLY_BE_TUNED_FOR_FLOAT_DOUBLE_AND_COMPLEX_SCALARS)
+  eigen_assert(rows > 0 && cols > 0 && depth > 0);
+  typedef internal::gemm_blocking_profile Profile;
+  const Index max_size = 1024;
+  const Index m = numext::mini(rows, max_size), n = numext::mini(cols, max_size), k = numext::mini(depth, max_size);
+  const int k_class = Profile::shape_class(depth), m_class = Profile::shape_class(rows);
+  const int n_class = Profile::shape_class(cols);
+  // The tuner allocates and multiplies its operands, so the profile is looked up first, with the number of threads
+  // the products of the measured shape will use.
+  const int threads = internal::gemm_parallel_threads<true, internal::gebp_traits<Scalar, Scalar> >(m, n, k, false);
+  if (Profile::instance().contains(internal::gemm_blocking_profile_scalar<Scalar, Scalar>::Id, k_class, m_class,
+                                   n_class, threads))
+    return false;
+  Profile::entry e = internal::gemm_blocking_tuner<Scalar>(m, n, k).run();
+  e.k_class = k_class;
+  e.m_class = m_class;
+  e.n_class = n_class;
+  Profile::instance().insert(e);
+  return true;
+}
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_GEMM_BLOCKING_TUNER_H
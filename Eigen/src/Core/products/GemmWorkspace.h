@@ -0,0 +1,283 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GEMM_WORKSPACE_H
+#define EIGEN_GEMM_WORKSPACE_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+// The cache is opt-in: by default, the packing buffers are allocated by every product.
+#ifndef EIGEN_GEMM_WORKSPACE_CACHE_LIMIT
+#define EIGEN_GEMM_WORKSPACE_CACHE_LIMIT 0
+#endif
+
+// The cache is kept in thread local storage: without it, the buffers are allocated by every product.
+#ifdef EIGEN_AVOID_THREAD_LOCAL
+#define EIGEN_GEMM_WORKSPACE_CACHE_ENABLED 0
+#else
+#define EIGEN_GEMM_WORKSPACE_CACHE_ENABLED 1
+#endif
+
+namespace Eigen {
+
+namespace internal {
+
+/* Per-thread cache of the packing buffers of the level 3 products.
+ *
+ * The packed blocks of the lhs and rhs are too large to be allocated on the
+ * stack for all but small products, such that every call would otherwise go
+ * through malloc and free. Instead, each thread keeps a few buffers alive
+ * between products. A buffer is handed out by acquire() and given back by
+ * release(); the same thread may hold several buffers at once, e.g., the two
+ * packed blocks of a product.
+ *
+ * The total size of the buffers kept by a thread is bounded by
+ * gemmWorkspaceCacheLimit(), which is 0 unless enabled by the user. Requests
+ * that do not fit, or that exceed the number of slots, fall back to
+ * aligned_malloc. The cached buffers of 2 MB or more are memory-mapped when
+ * setLargeBufferThreshold() enables it.
+ *
+ * A buffer must be released by the thread which acquired it, see
+ * gemm_workspace_owner(): the cache of another thread would free it.
+ *
+ * Use gemm_workspace_acquire() and gemm_workspace_release(), which bypass the
+ * cache when EIGEN_AVOID_THREAD_LOCAL is defined.
+ */
+class gemm_workspace_cache : noncopyable {
+ public:
+  enum { NumSlots = 4 };
+
+#if EIGEN_GEMM_WORKSPACE_CACHE_ENABLED
+  static gemm_workspace_cache& instance() {
+    static thread_local gemm_workspace_cache cache;
+    return cache;
+  }
+#endif
+
+  static std::atomic<std::size_t>& limit() {
+    static std::atomic<std::size_t> value(EIGEN_GEMM_WORKSPACE_CACHE_LIMIT);
+    return value;
+  }
+
+  gemm_workspace_cache() : m_total(0) {
+    for (int i = 0; i < NumSlots; ++i) m_slots[i] = slot();
+  }
+
+  ~gemm_workspace_cache() {
+    for (int i = 0; i < NumSlots; ++i) aligned_free(m_slots[i].ptr);
+  }
+
+  void* acquire(std::size_t bytes) {
+    if (bytes == 0) return 0;
+    const std::size_t max_bytes = limit().load(std::memory_order_relaxed);
+    if (m_total > max_bytes) trim(max_bytes);
+    if (bytes > max_bytes) return aligned_malloc(bytes);
+
+    // Best fit among the free buffers, otherwise grow the largest free one.
+    slot* fit = 0;
+    slot* largest = 0;
+    for (int i = 0; i < NumSlots; ++i) {
+      slot& s = m_slots[i];
+      if (s.in_use) continue;
+      if (s.size >= bytes && (fit == 0 || s.size < fit->size)) fit = &s;
+      if (largest == 0 || s.size > largest->size) largest = &s;
+    }
+    if (fit == 0) {
+      if (largest == 0) return aligned_malloc(bytes);
+      if (m_total - largest->size + bytes > max_bytes) {
+        trim(0);
+        if (m_total + bytes > max_bytes) return aligned_malloc(bytes);
+      }
+      aligned_free(largest->ptr);
+      m_total -= largest->size;
+      *largest = slot();
+      // Buffers of a huge page or more are memory-mapped if large buffers are, see setLargeBufferThreshold().
+      const bool mapped =
+          bytes >= large_buffer_alignment && large_buffer_threshold().load(std::memory_order_relaxed) > 0;
+      largest->ptr = aligned_malloc(bytes, mapped ? LargeBufferMapped : LargeBufferAuto);
+      largest->size = bytes;
+      m_total += bytes;
+      fit = largest;
+    }
+    fit->in_use = true;
+    return fit->ptr;
+  }
+
+  void release(void* ptr) {
+    if (ptr == 0) return;
+    for (int i = 0; i < NumSlots; ++i) {
+      if (m_slots[i].ptr == ptr) {
+        eigen_internal_assert(m_slots[i].in_use);
+        m_slots[i].in_use = false;
+        return;
+      }
+    }
+    aligned_free(ptr);
+  }
+
+  // Frees the buffers which are not in use until at most max_bytes are kept.
+  void trim(std::size_t max_bytes) {
+    for (int i = 0; i < NumSlots && m_total > max_bytes; ++i) {
+      slot& s = m_slots[i];
+      if (s.in_use) continue;
+      aligned_free(s.ptr);
+      m_total -= s.size;
+      s = slot();
+    }
+  }
+
+  std::size_t size() const { return m_total; }
+
+ private:
+  struct slot {
+    slot() : ptr(0), size(0), in_use(false) {}
+    void* ptr;
+    std::size_t size;
+    bool in_use;
+  };
+
+  slot m_slots[NumSlots];
+  std::size_t m_total;
+};
+
+/** \internal \returns a buffer of \a bytes bytes from the GEMM workspace cache of the calling thread */
+inline void* gemm_workspace_acquire(std::size_t bytes) {
+#if EIGEN_GEMM_WORKSPACE_CACHE_ENABLED
+  return gemm_workspace_cache::instance().acquire(bytes);
+#else
+  return aligned_malloc(bytes);
+#endif
+}
+
+/** \internal \returns an identifier of the GEMM workspace cache of the calling thread, which is used to check that
+ * buffers are released by the thread which acquired them */
+inline const void* gemm_workspace_owner() {
+#if EIGEN_GEMM_WORKSPACE_CACHE_ENABLED
+  return &gemm_workspace_cache::instance();
+#else
+  return 0;
+#endif
+}
+
+/** \internal Checks that buffers acquired by the thread identified by \a owner are released by the calling thread */
+inline void gemm_workspace_check_owner(const void* owner) {
+  EIGEN_ONLY_USED_FOR_DEBUG(owner);
+  eigen_assert(owner == gemm_workspace_owner() && "GEMM workspace buffers must be released by their thread");
+}
+
+/** \internal Gives back a buffer returned by gemm_workspace_acquire() on the same thread */
+inline void gemm_workspace_release(void* ptr) {
+#if EIGEN_GEMM_WORKSPACE_CACHE_ENABLED
+  gemm_workspace_cache::instance().release(ptr);
+#else
+  aligned_free(ptr);
+#endif
+}
+
+/** \internal Allocates and constructs \a size objects of type T from the GEMM workspace cache of the calling thread.
+ */
+template <typename T>
+inline T* gemm_workspace_new(std::size_t size) {
+  check_size_for_overflow<T>(size);
+  T* result = static_cast<T*>(gemm_workspace_acquire(sizeof(T) * size));
+  if (NumTraits<T>::RequireInitialization && result) {
+    EIGEN_TRY { default_construct_elements_of_array(result, size); }
+    EIGEN_CATCH(...) {
+      gemm_workspace_release(result);
+      EIGEN_THROW;
+    }
+  }
+  return result;
+}
+
+/** \internal Destructs and gives back to the GEMM workspace cache objects allocated with gemm_workspace_new */
+template <typename T>
+inline void gemm_workspace_delete(T* ptr, std::size_t size) {
+  if (NumTraits<T>::RequireInitialization && ptr) destruct_elements_of_array<T>(ptr, size);
+  gemm_workspace_release(ptr);
+}
+
+// Counterpart of aligned_stack_memory_handler for buffers coming from the
+// GEMM workspace cache.
+template <typename T>
+class gemm_workspace_handler : noncopyable {
+ public:
+  gemm_workspace_handler(T* ptr, std::size_t size, bool cached) : m_ptr(ptr), m_size(size), m_cached(cached) {
+    if (NumTraits<T>::RequireInitialization && m_ptr && !m_cached)
+      Eigen::internal::default_construct_elements_of_array(m_ptr, size);
+  }
+  ~gemm_workspace_handler() {
+    if (m_cached)
+      gemm_workspace_delete(m_ptr, m_size);
+    else if (NumTraits<T>::RequireInitialization && m_ptr)
+      Eigen::internal::destruct_elements_of_array<T>(m_ptr, m_size);
+  }
+
+ protected:
+  T* m_ptr;
+  std::size_t m_size;
+  bool m_cached;
+};
+
+}  // end namespace internal
+
+/** \returns the maximal number of bytes of packing buffers that each thread keeps between two matrix-matrix products
+ * \sa setGemmWorkspaceCacheLimit(), releaseGemmWorkspace() */
+inline std::size_t gemmWorkspaceCacheLimit() {
+  return internal::gemm_workspace_cache::limit().load(std::memory_order_relaxed);
+}
+
+/** Sets the maximal number of bytes of packing buffers that each thread keeps between two matrix-matrix products
+ * (general, triangular and selfadjoint products, and triangular solves). Larger buffers are allocated and freed at
+ * each call. A value of 0 disables the cache. The default is given by \c EIGEN_GEMM_WORKSPACE_CACHE_LIMIT, which
+ * disables the cache unless it is defined.
+ *
+ * Threads shrink their cache to the new limit at their next product.
+ * \sa gemmWorkspaceCacheLimit(), releaseGemmWorkspace() */
+inline void setGemmWorkspaceCacheLimit(std::size_t bytes) {
+  internal::gemm_workspace_cache::limit().store(bytes, std::memory_order_relaxed);
+}
+
+/** Frees the packing buffers kept by the calling thread.
+ * \sa setGemmWorkspaceCacheLimit() */
+inline void releaseGemmWorkspace() {
+#if EIGEN_GEMM_WORKSPACE_CACHE_ENABLED
+  internal::gemm_workspace_cache::instance().trim(0);
+#endif
+}
+
+}  // end namespace Eigen
+
+/** \internal
+ *
+ * The macro ei_declare_gemm_workspace_variable(TYPE,NAME,SIZE,BUFFER) is analogue to
+ * ei_declare_aligned_stack_constructed_variable, except that the buffers which do not fit on the stack are taken
+ * from the GEMM workspace cache of the calling thread instead of being allocated on the heap.
+ */
+#ifdef EIGEN_ALLOCA
+
+#define ei_declare_gemm_workspace_variable(TYPE, NAME, SIZE, BUFFER)                                        \
+  Eigen::internal::check_size_for_overflow<TYPE>(SIZE);                                                     \
+  TYPE* NAME = (BUFFER) != 0 ? (BUFFER)                                                                     \
+                             : ((sizeof(TYPE) * SIZE <= EIGEN_STACK_ALLOCATION_LIMIT)                       \
+                                    ? reinterpret_cast<TYPE*>(EIGEN_ALIGNED_ALLOCA(sizeof(TYPE) * SIZE))    \
+                                    : Eigen::internal::gemm_workspace_new<TYPE>(SIZE));                     \
+  Eigen::internal::gemm_workspace_handler<TYPE> EIGEN_CAT(NAME, _workspace_handler)(                        \
+      (BUFFER) == 0 ? NAME : 0, SIZE, (BUFFER) == 0 && sizeof(TYPE) * SIZE > EIGEN_STACK_ALLOCATION_LIMIT)
+
+#else
+
+#define ei_declare_gemm_workspace_variable(TYPE, NAME, SIZE, BUFFER)                       \
+  Eigen::internal::check_size_for_overflow<TYPE>(SIZE);                                    \
+  TYPE* NAME = (BUFFER) != 0 ? (BUFFER) : Eigen::internal::gemm_workspace_new<TYPE>(SIZE); \
+  Eigen::internal::gemm_workspace_handler<TYPE> EIGEN_CAT(NAME, _workspace_handler)(       \
+      (BUFFER) == 0 ? NAME : 0, SIZE, (BUFFER) == 0)
+
+#endif
+
+#endif  // EIGEN_GEMM_WORKSPACE_H
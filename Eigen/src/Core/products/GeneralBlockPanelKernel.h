@@ -300,6 +300,38 @@ inline bool useSpecificBlockingSizes(Index& k, Index& m, Index& n) {
   return false;
 }
 
+// Blocking sizes of the runtime profile, see tuneGemmBlocking(). Only the
+// products of the scalar types which can be tuned, with KcFactor == 1, are
+// concerned.
+template <typename LhsScalar, typename RhsScalar, int KcFactor, typename Index,
+          bool Tunable = KcFactor == 1 && (gemm_blocking_profile_scalar<LhsScalar, RhsScalar>::Id >= 0)>
+struct tuned_blocking_sizes {
+  static bool run(Index&, Index&, Index&, Index) { return false; }
+};
+
+template <typename LhsScalar, typename RhsScalar, int KcFactor, typename Index>
+struct tuned_blocking_sizes<LhsScalar, RhsScalar, KcFactor, Index, true> {
+  static bool run(Index& k, Index& m, Index& n, Index num_threads) {
+    Eigen::Index kc, mc, nc;
+    gemm_blocking_override& forced = gemm_blocking_override::current();
+    if (forced.active) {
+      forced.threads = numext::maxi<Eigen::Index>(forced.threads, num_threads);
+      if (forced.kc == 0) return false;
+      kc = forced.kc;
+      mc = forced.mc;
+      nc = forced.nc;
+    } else {
+      if (!gemm_blocking_profile::instance().lookup(gemm_blocking_profile_scalar<LhsScalar, RhsScalar>::Id, k, m, n,
+                                                    num_threads, kc, mc, nc))
+        return false;
+    }
+    k = numext::mini<Index>(k, static_cast<Index>(kc));
+    m = numext::mini<Index>(m, static_cast<Index>(mc));
+    n = numext::mini<Index>(n, static_cast<Index>(nc));
+    return true;
+  }
+};
+
 /** \brief Computes the blocking parameters for a m x k times k x n matrix product
  *
  * \param[in,out] k Input: the third dimension of the product. Output: the blocking size along the same dimension.
@@ -313,13 +345,15 @@ inline bool useSpecificBlockingSizes(Index& k, Index& m, Index& n) {
  *
  * The blocking size parameters may be evaluated:
  *   - either by a heuristic based on cache sizes;
+ *   - or from the sizes measured at runtime by tuneGemmBlocking() or loaded by loadGemmBlockingProfile();
  *   - or using fixed prescribed values (for testing purposes).
  *
- * \sa setCpuCacheSizes */
+ * \sa setCpuCacheSizes, tuneGemmBlocking */
 
 template <typename LhsScalar, typename RhsScalar, int KcFactor, typename Index>
 void computeProductBlockingSizes(Index& k, Index& m, Index& n, Index num_threads = 1) {
-  if (!useSpecificBlockingSizes(k, m, n)) {
+  if (!useSpecificBlockingSizes(k, m, n) &&
+      !tuned_blocking_sizes<LhsScalar, RhsScalar, KcFactor, Index>::run(k, m, n, num_threads)) {
     evaluateProductBlockingSizesHeuristic<LhsScalar, RhsScalar, KcFactor, Index>(k, m, n, num_threads);
   }
 }
@@ -20,6 +20,53 @@ namespace internal {
 template <typename LhsScalar_, typename RhsScalar_>
 class level3_blocking;
 
+/* Epilogues of the matrix-matrix products.
+ *
+ * The kernels call epilogue.apply<Order>(data, incr, stride, row, col, rows, cols)
+ * once for each block of the result which holds its final value, while it is
+ * still in cache. The block is rows x cols, starts at data, and has the given
+ * storage order, inner and outer strides; row and col are its offsets in the
+ * result. Blocks are disjoint and, for parallel products, applied
+ * concurrently by the threads. See EpilogueProduct.
+ */
+struct gemm_no_epilogue {
+  template <int Order, typename Scalar, typename Index>
+  EIGEN_ALWAYS_INLINE void apply(Scalar*, Index, Index, Index, Index, Index, Index) const {}
+};
+
+// Epilogue of the transposed product computed for a row-major result.
+template <typename Epilogue>
+struct transposed_gemm_epilogue {
+  explicit transposed_gemm_epilogue(const Epilogue& epilogue) : m_epilogue(epilogue) {}
+  template <int Order, typename Scalar, typename Index>
+  EIGEN_ALWAYS_INLINE void apply(Scalar* data, Index incr, Index stride, Index row, Index col, Index rows,
+                                 Index cols) const {
+    m_epilogue.template apply<Order == ColMajor ? RowMajor : ColMajor>(data, incr, stride, col, row, cols, rows);
+  }
+  const Epilogue& m_epilogue;
+};
+
+// Epilogue of a sub-product starting at (row, col) in the result.
+template <typename Epilogue>
+struct offset_gemm_epilogue {
+  offset_gemm_epilogue(const Epilogue& epilogue, Index row, Index col)
+      : m_epilogue(epilogue), m_row(row), m_col(col) {}
+  template <int Order, typename Scalar, typename Index_>
+  EIGEN_ALWAYS_INLINE void apply(Scalar* data, Index_ incr, Index_ stride, Index_ row, Index_ col, Index_ rows,
+                                 Index_ cols) const {
+    m_epilogue.template apply<Order>(data, incr, stride, Index_(m_row + row), Index_(m_col + col), rows, cols);
+  }
+  const Epilogue& m_epilogue;
+  Index m_row, m_col;
+};
+
+// Defined in StrassenMatrixMatrix.h.
+template <typename LhsScalar, typename RhsScalar>
+struct strassen_gemm_scalar;
+template <typename Index, typename Scalar, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder,
+          bool ConjugateRhs, int ResStorageOrder>
+struct strassen_matrix_matrix_product;
+
 /* Specialization for a row-major destination matrix => simple transposition of the product */
 template <typename Index, typename LhsScalar, int LhsStorageOrder, bool ConjugateLhs, typename RhsScalar,
           int RhsStorageOrder, bool ConjugateRhs, int ResInnerStride>
@@ -38,6 +85,18 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
                                   ResInnerStride>::run(cols, rows, depth, rhs, rhsStride, lhs, lhsStride, res, resIncr,
                                                        resStride, alpha, blocking, info);
   }
+
+  template <typename Epilogue>
+  static EIGEN_STRONG_INLINE void run(Index rows, Index cols, Index depth, const LhsScalar* lhs, Index lhsStride,
+                                      const RhsScalar* rhs, Index rhsStride, ResScalar* res, Index resIncr,
+                                      Index resStride, ResScalar alpha, level3_blocking<RhsScalar, LhsScalar>& blocking,
+                                      GemmParallelInfo<Index>* info, const Epilogue& epilogue) {
+    general_matrix_matrix_product<Index, RhsScalar, RhsStorageOrder == RowMajor ? ColMajor : RowMajor, ConjugateRhs,
+                                  LhsScalar, LhsStorageOrder == RowMajor ? ColMajor : RowMajor, ConjugateLhs, ColMajor,
+                                  ResInnerStride>::run(cols, rows, depth, rhs, rhsStride, lhs, lhsStride, res, resIncr,
+                                                       resStride, alpha, blocking, info,
+                                                       transposed_gemm_epilogue<Epilogue>(epilogue));
+  }
 };
 
 /*  Specialization for a col-major destination matrix
@@ -52,6 +111,15 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
   static void run(Index rows, Index cols, Index depth, const LhsScalar* lhs_, Index lhsStride, const RhsScalar* rhs_,
                   Index rhsStride, ResScalar* res_, Index resIncr, Index resStride, ResScalar alpha,
                   level3_blocking<LhsScalar, RhsScalar>& blocking, GemmParallelInfo<Index>* info = 0) {
+    run(rows, cols, depth, lhs_, lhsStride, rhs_, rhsStride, res_, resIncr, resStride, alpha, blocking, info,
+        gemm_no_epilogue());
+  }
+
+  template <typename Epilogue>
+  static void run(Index rows, Index cols, Index depth, const LhsScalar* lhs_, Index lhsStride, const RhsScalar* rhs_,
+                  Index rhsStride, ResScalar* res_, Index resIncr, Index resStride, ResScalar alpha,
+                  level3_blocking<LhsScalar, RhsScalar>& blocking, GemmParallelInfo<Index>* info,
+                  const Epilogue& epilogue) {
     typedef const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> LhsMapper;
     typedef const_blas_data_mapper<RhsScalar, Index, RhsStorageOrder> RhsMapper;
     typedef blas_data_mapper<typename Traits::ResScalar, Index, ColMajor, Unaligned, ResInnerStride> ResMapper;
@@ -79,7 +147,7 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
       eigen_internal_assert(blockA != 0);
 
       std::size_t sizeB = kc * nc;
-      ei_declare_aligned_stack_constructed_variable(RhsScalar, blockB, sizeB, 0);
+      ei_declare_gemm_workspace_variable(RhsScalar, blockB, sizeB, 0);
 
       // For each horizontal panel of the rhs, and corresponding vertical panel of the lhs...
       for (Index k = 0; k < depth; k += kc) {
@@ -120,6 +188,10 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
 
           gebp(res.getSubMapper(info->task_info[i].lhs_start, 0), blockA + info->task_info[i].lhs_start * actual_kc,
                blockB, info->task_info[i].lhs_length, actual_kc, nc, alpha);
+          if (k + actual_kc == depth)
+            epilogue.template apply<ColMajor>(res_ + info->task_info[i].lhs_start * resIncr, resIncr, resStride,
+                                              info->task_info[i].lhs_start, Index(0), info->task_info[i].lhs_length,
+                                              nc);
         }
 
         // Then keep going as usual with the remaining B'
@@ -131,6 +203,8 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
 
           // C_j += A' * B'
           gebp(res.getSubMapper(0, j), blockA, blockB, rows, actual_kc, actual_nc, alpha);
+          if (k + actual_kc == depth)
+            epilogue.template apply<ColMajor>(res_ + j * resStride, resIncr, resStride, Index(0), j, rows, actual_nc);
         }
 
         // Release all the sub blocks A'_i of A' for the current thread,
@@ -146,8 +220,8 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
       std::size_t sizeA = kc * mc;
       std::size_t sizeB = kc * nc;
 
-      ei_declare_aligned_stack_constructed_variable(LhsScalar, blockA, sizeA, blocking.blockA());
-      ei_declare_aligned_stack_constructed_variable(RhsScalar, blockB, sizeB, blocking.blockB());
+      ei_declare_gemm_workspace_variable(LhsScalar, blockA, sizeA, blocking.blockA());
+      ei_declare_gemm_workspace_variable(RhsScalar, blockB, sizeB, blocking.blockB());
 
       const bool pack_rhs_once = mc != rows && kc == depth && nc == cols;
 
@@ -175,6 +249,11 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
 
             // Everything is packed, we can now call the panel * block kernel:
             gebp(res.getSubMapper(i2, j2), blockA, blockB, actual_mc, actual_kc, actual_nc, alpha);
+
+            // The block of the result is complete after the last panel of the depth.
+            if (k2 + actual_kc == depth)
+              epilogue.template apply<ColMajor>(res_ + i2 * resIncr + j2 * resStride, resIncr, resStride, i2, j2,
+                                                actual_mc, actual_nc);
           }
         }
       }
@@ -188,10 +267,16 @@ struct general_matrix_matrix_product<Index, LhsScalar, LhsStorageOrder, Conjugat
  **********************************************************************************/
 
 template <typename Scalar, typename Index, typename Gemm, typename Lhs, typename Rhs, typename Dest,
-          typename BlockingType>
+          typename BlockingType, typename Epilogue = gemm_no_epilogue>
 struct gemm_functor {
-  gemm_functor(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& actualAlpha, BlockingType& blocking)
-      : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_actualAlpha(actualAlpha), m_blocking(blocking) {}
+  gemm_functor(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& actualAlpha, BlockingType& blocking,
+               const Epilogue& epilogue = Epilogue())
+      : m_lhs(lhs),
+        m_rhs(rhs),
+        m_dest(dest),
+        m_actualAlpha(actualAlpha),
+        m_blocking(blocking),
+        m_epilogue(epilogue) {}
 
   void initParallelSession(Index num_threads) const {
     m_blocking.initParallel(m_lhs.rows(), m_rhs.cols(), m_lhs.cols(), num_threads);
@@ -201,19 +286,33 @@ struct gemm_functor {
   void operator()(Index row, Index rows, Index col = 0, Index cols = -1, GemmParallelInfo<Index>* info = 0) const {
     if (cols == -1) cols = m_rhs.cols();
 
+    run(row, rows, col, cols, info, m_epilogue);
+  }
+
+  typedef typename Gemm::Traits Traits;
+
+ protected:
+  void run(Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info,
+           const gemm_no_epilogue&) const {
     Gemm::run(rows, cols, m_lhs.cols(), &m_lhs.coeffRef(row, 0), m_lhs.outerStride(), &m_rhs.coeffRef(0, col),
               m_rhs.outerStride(), (Scalar*)&(m_dest.coeffRef(row, col)), m_dest.innerStride(), m_dest.outerStride(),
               m_actualAlpha, m_blocking, info);
   }
 
-  typedef typename Gemm::Traits Traits;
+  template <typename OtherEpilogue>
+  void run(Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info,
+           const OtherEpilogue& epilogue) const {
+    Gemm::run(rows, cols, m_lhs.cols(), &m_lhs.coeffRef(row, 0), m_lhs.outerStride(), &m_rhs.coeffRef(0, col),
+              m_rhs.outerStride(), (Scalar*)&(m_dest.coeffRef(row, col)), m_dest.innerStride(), m_dest.outerStride(),
+              m_actualAlpha, m_blocking, info, offset_gemm_epilogue<OtherEpilogue>(epilogue, row, col));
+  }
 
- protected:
   const Lhs& m_lhs;
   const Rhs& m_rhs;
   Dest& m_dest;
   Scalar m_actualAlpha;
   BlockingType& m_blocking;
+  Epilogue m_epilogue;
 };
 
 template <int StorageOrder, typename LhsScalar, typename RhsScalar, int MaxRows, int MaxCols, int MaxDepth,
@@ -302,9 +401,11 @@ class gemm_blocking_space<StorageOrder, LhsScalar_, RhsScalar_, MaxRows, MaxCols
 
   Index m_sizeA;
   Index m_sizeB;
+  const void* m_workspaceOwner;
 
  public:
-  gemm_blocking_space(Index rows, Index cols, Index depth, Index num_threads, bool l3_blocking) {
+  gemm_blocking_space(Index rows, Index cols, Index depth, Index num_threads, bool l3_blocking)
+      : m_workspaceOwner(0) {
     this->m_mc = Transpose ? cols : rows;
     this->m_nc = Transpose ? rows : cols;
     this->m_kc = depth;
@@ -334,11 +435,17 @@ class gemm_blocking_space<StorageOrder, LhsScalar_, RhsScalar_, MaxRows, MaxCols
   }
 
   void allocateA() {
-    if (this->m_blockA == 0) this->m_blockA = aligned_new<LhsScalar>(m_sizeA);
+    if (this->m_blockA == 0) {
+      this->m_blockA = gemm_workspace_new<LhsScalar>(m_sizeA);
+      m_workspaceOwner = gemm_workspace_owner();
+    }
   }
 
   void allocateB() {
-    if (this->m_blockB == 0) this->m_blockB = aligned_new<RhsScalar>(m_sizeB);
+    if (this->m_blockB == 0) {
+      this->m_blockB = gemm_workspace_new<RhsScalar>(m_sizeB);
+      m_workspaceOwner = gemm_workspace_owner();
+    }
   }
 
   void allocateAll() {
@@ -347,8 +454,10 @@ class gemm_blocking_space<StorageOrder, LhsScalar_, RhsScalar_, MaxRows, MaxCols
   }
 
   ~gemm_blocking_space() {
-    aligned_delete(this->m_blockA, m_sizeA);
-    aligned_delete(this->m_blockB, m_sizeB);
+    // the buffers go back to the workspace cache of the thread which allocated them
+    if (this->m_blockA != 0 || this->m_blockB != 0) gemm_workspace_check_owner(m_workspaceOwner);
+    gemm_workspace_delete(this->m_blockA, m_sizeA);
+    gemm_workspace_delete(this->m_blockB, m_sizeB);
   }
 };
 
@@ -385,10 +494,8 @@ struct generic_product_impl<Lhs, Rhs, DenseShape, DenseShape, GemmProduct>
     // I'm not sure it is still required.
     if ((rhs.rows() + dst.rows() + dst.cols()) < EIGEN_GEMM_TO_COEFFBASED_THRESHOLD && rhs.rows() > 0)
       lazyproduct::eval_dynamic(dst, lhs, rhs, internal::assign_op<typename Dst::Scalar, Scalar>());
-    else {
-      dst.setZero();
-      scaleAndAddTo(dst, lhs, rhs, Scalar(1));
-    }
+    else
+      scaleAndAssignTo(dst, lhs, rhs, Scalar(1), gemm_no_epilogue());
   }
 
   template <typename Dst>
@@ -409,26 +516,64 @@ struct generic_product_impl<Lhs, Rhs, DenseShape, DenseShape, GemmProduct>
 
   template <typename Dest>
   static void scaleAndAddTo(Dest& dst, const Lhs& a_lhs, const Rhs& a_rhs, const Scalar& alpha) {
+    scaleAndAddTo(dst, a_lhs, a_rhs, alpha, gemm_no_epilogue());
+  }
+
+  // Same as above, followed by the given epilogue (see gemm_no_epilogue),
+  // which is applied per block by the GEMM kernel, and at once otherwise.
+  template <typename Dest, typename Epilogue>
+  static void scaleAndAddTo(Dest& dst, const Lhs& a_lhs, const Rhs& a_rhs, const Scalar& alpha,
+                            const Epilogue& epilogue) {
+    scaleAndStoreTo(dst, a_lhs, a_rhs, alpha, epilogue, false);
+  }
+
+  // Same as above for dst = alpha * lhs * rhs, the previous values of dst being ignored.
+  template <typename Dest, typename Epilogue>
+  static void scaleAndAssignTo(Dest& dst, const Lhs& a_lhs, const Rhs& a_rhs, const Scalar& alpha,
+                               const Epilogue& epilogue) {
+    scaleAndStoreTo(dst, a_lhs, a_rhs, alpha, epilogue, true);
+  }
+
+ private:
+  template <typename Dest, typename Epilogue>
+  static void scaleAndStoreTo(Dest& dst, const Lhs& a_lhs, const Rhs& a_rhs, const Scalar& alpha,
+                              const Epilogue& epilogue, bool overwrite) {
     eigen_assert(dst.rows() == a_lhs.rows() && dst.cols() == a_rhs.cols());
-    if (a_lhs.cols() == 0 || a_lhs.rows() == 0 || a_rhs.cols() == 0) return;
-
-    if (dst.cols() == 1) {
-      // Fallback to GEMV if either the lhs or rhs is a runtime vector
-      typename Dest::ColXpr dst_vec(dst.col(0));
-      return internal::generic_product_impl<Lhs, typename Rhs::ConstColXpr, DenseShape, DenseShape,
-                                            GemvProduct>::scaleAndAddTo(dst_vec, a_lhs, a_rhs.col(0), alpha);
-    } else if (dst.rows() == 1) {
-      // Fallback to GEMV if either the lhs or rhs is a runtime vector
-      typename Dest::RowXpr dst_vec(dst.row(0));
-      return internal::generic_product_impl<typename Lhs::ConstRowXpr, Rhs, DenseShape, DenseShape,
-                                            GemvProduct>::scaleAndAddTo(dst_vec, a_lhs.row(0), a_rhs, alpha);
+    if (a_lhs.cols() == 0 || a_lhs.rows() == 0 || a_rhs.cols() == 0 || dst.cols() == 1 || dst.rows() == 1) {
+      if (overwrite) dst.setZero();
+      if (a_lhs.cols() != 0 && dst.cols() == 1) {
+        // Fallback to GEMV if either the lhs or rhs is a runtime vector
+        typename Dest::ColXpr dst_vec(dst.col(0));
+        internal::generic_product_impl<Lhs, typename Rhs::ConstColXpr, DenseShape, DenseShape,
+                                       GemvProduct>::scaleAndAddTo(dst_vec, a_lhs, a_rhs.col(0), alpha);
+      } else if (a_lhs.cols() != 0 && dst.rows() == 1) {
+        // Fallback to GEMV if either the lhs or rhs is a runtime vector
+        typename Dest::RowXpr dst_vec(dst.row(0));
+        internal::generic_product_impl<typename Lhs::ConstRowXpr, Rhs, DenseShape, DenseShape,
+                                       GemvProduct>::scaleAndAddTo(dst_vec, a_lhs.row(0), a_rhs, alpha);
+      }
+      if (dst.size() > 0)
+        epilogue.template apply<(Dest::Flags & RowMajorBit) ? RowMajor : ColMajor>(
+            dst.data(), dst.innerStride(), dst.outerStride(), Index(0), Index(0), dst.rows(), dst.cols());
+      return;
     }
 
+    EIGEN_INSTRUMENT_KERNEL("gemm", 2.0 * double(dst.rows()) * double(dst.cols()) * double(a_lhs.cols()),
+                            double(a_lhs.size() + a_rhs.size() + 2 * dst.size()) * double(sizeof(Scalar)));
     add_const_on_value_type_t<ActualLhsType> lhs = LhsBlasTraits::extract(a_lhs);
     add_const_on_value_type_t<ActualRhsType> rhs = RhsBlasTraits::extract(a_rhs);
 
     Scalar actualAlpha = combine_scalar_factors(alpha, a_lhs, a_rhs);
 
+    // Very large products may use Strassen-Winograd, see setGemmStrassenThreshold().
+    if (strassen(dst, lhs, rhs, actualAlpha, overwrite,
+                 bool_constant<bool(strassen_gemm_scalar<LhsScalar, RhsScalar>::value)>())) {
+      epilogue.template apply<(Dest::Flags & RowMajorBit) ? RowMajor : ColMajor>(
+          dst.data(), dst.innerStride(), dst.outerStride(), Index(0), Index(0), dst.rows(), dst.cols());
+      return;
+    }
+    if (overwrite) dst.setZero();
+
     typedef internal::gemm_blocking_space<(Dest::Flags & RowMajorBit) ? RowMajor : ColMajor, LhsScalar, RhsScalar,
                                           Dest::MaxRowsAtCompileTime, Dest::MaxColsAtCompileTime, MaxDepthAtCompileTime>
         BlockingType;
@@ -440,14 +585,33 @@ struct generic_product_impl<Lhs, Rhs, DenseShape, DenseShape, GemmProduct>
             bool(LhsBlasTraits::NeedToConjugate), RhsScalar,
             (ActualRhsTypeCleaned::Flags & RowMajorBit) ? RowMajor : ColMajor, bool(RhsBlasTraits::NeedToConjugate),
             (Dest::Flags & RowMajorBit) ? RowMajor : ColMajor, Dest::InnerStrideAtCompileTime>,
-        ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, BlockingType>
+        ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, BlockingType, Epilogue>
         GemmFunctor;
 
     BlockingType blocking(dst.rows(), dst.cols(), lhs.cols(), 1, true);
     internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime > 32 || Dest::MaxRowsAtCompileTime == Dynamic)>(
-        GemmFunctor(lhs, rhs, dst, actualAlpha, blocking), a_lhs.rows(), a_rhs.cols(), a_lhs.cols(),
+        GemmFunctor(lhs, rhs, dst, actualAlpha, blocking, epilogue), a_lhs.rows(), a_rhs.cols(), a_lhs.cols(),
         Dest::Flags & RowMajorBit);
   }
+
+  template <typename Dest, typename ActualLhs, typename ActualRhs>
+  static bool strassen(Dest&, const ActualLhs&, const ActualRhs&, const Scalar&, bool, false_type) {
+    return false;
+  }
+
+  template <typename Dest, typename ActualLhs, typename ActualRhs>
+  static bool strassen(Dest& dst, const ActualLhs& lhs, const ActualRhs& rhs, const Scalar& alpha, bool overwrite,
+                       true_type) {
+    return dst.innerStride() == 1 &&
+           strassen_matrix_matrix_product<
+               Index, Scalar, (ActualLhsTypeCleaned::Flags & RowMajorBit) ? RowMajor : ColMajor,
+               bool(LhsBlasTraits::NeedToConjugate), (ActualRhsTypeCleaned::Flags & RowMajorBit) ? RowMajor : ColMajor,
+               bool(RhsBlasTraits::NeedToConjugate),
+               (Dest::Flags & RowMajorBit) ? RowMajor : ColMajor>::run(dst.rows(), dst.cols(), lhs.cols(), lhs.data(),
+                                                                       lhs.outerStride(), rhs.data(), rhs.outerStride(),
+                                                                       dst.data(), dst.outerStride(), alpha,
+                                                                       overwrite);
+  }
 };
 
 }  // end namespace internal
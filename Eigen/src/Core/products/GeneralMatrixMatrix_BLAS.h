@@ -101,6 +101,15 @@ namespace internal {
                                                                                                                     \
       BLASFUNC(&transa, &transb, &m, &n, &k, (const BLASTYPE*)&numext::real_ref(alpha), (const BLASTYPE*)a, &lda,   \
                (const BLASTYPE*)b, &ldb, (const BLASTYPE*)&numext::real_ref(beta), (BLASTYPE*)res, &ldc);           \
+    }                                                                                                               \
+                                                                                                                    \
+    template <typename Epilogue>                                                                                    \
+    static void run(Index rows, Index cols, Index depth, const EIGTYPE* _lhs, Index lhsStride, const EIGTYPE* _rhs, \
+                    Index rhsStride, EIGTYPE* res, Index resIncr, Index resStride, EIGTYPE alpha,                   \
+                    level3_blocking<EIGTYPE, EIGTYPE>& blocking, GemmParallelInfo<Index>* info,                     \
+                    const Epilogue& epilogue) {                                                                     \
+      run(rows, cols, depth, _lhs, lhsStride, _rhs, rhsStride, res, resIncr, resStride, alpha, blocking, info);     \
+      epilogue.template apply<ColMajor>(res, resIncr, resStride, Index(0), Index(0), rows, cols);                   \
     }                                                                                                               \
   };
 
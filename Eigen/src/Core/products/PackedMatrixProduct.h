@@ -0,0 +1,229 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PACKED_MATRIX_PRODUCT_H
+#define EIGEN_PACKED_MATRIX_PRODUCT_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+/* Computes dst += alpha * op(L) * rhs, where L is the lower triangle of a
+ * packed matrix (see packed_storage) and op(L) is:
+ *  - L for Mode == Lower,
+ *  - L^* for Mode == Upper,
+ *  - the selfadjoint matrix whose lower part is L for Mode == SelfAdjoint,
+ * conjugated if Conj is true.
+ *
+ * Each panel of columns of L is gathered to a dense buffer once, and used by
+ * one (triangular) or two (selfadjoint) matrix products with the rhs.
+ */
+template <typename Scalar, int StorageUpLo, int Mode, bool Conj>
+struct packed_matrix_product {
+  template <typename Dest, typename Rhs, typename Alpha>
+  static void run(Dest& dst, const Scalar* data, Index size, const Rhs& rhs, const Alpha& alpha) {
+    typedef packed_storage<Scalar, StorageUpLo> Storage;
+    const Index bs = Storage::panel_size(size);
+    Matrix<Scalar, Dynamic, Dynamic> panel;
+    for (Index j = 0; j < size; j += bs) {
+      const Index cols = numext::mini(bs, size - j);
+      const Index rows = size - j;
+      const Index rs = rows - cols;
+      panel.resize(rows, cols);
+      Storage::gather_lower(data, size, j, j, panel);
+      if (Conj && NumTraits<Scalar>::IsComplex) panel = panel.conjugate();
+
+      if (Mode == Upper) {
+        dst.middleRows(j, cols).noalias() += alpha * panel.adjoint() * rhs.bottomRows(rows);
+        continue;
+      }
+      // Complete the diagonal block from its lower part.
+      if (Mode == SelfAdjoint)
+        for (Index k = 1; k < cols; ++k) panel.col(k).head(k) = panel.row(k).head(k).adjoint();
+      dst.bottomRows(rows).noalias() += alpha * panel * rhs.middleRows(j, cols);
+      if (Mode == SelfAdjoint && rs > 0)
+        dst.middleRows(j, cols).noalias() += alpha * panel.bottomRows(rs).adjoint() * rhs.bottomRows(rs);
+    }
+  }
+};
+
+/* Solves op(L) X = B in place, where op(L) is L if Mode contains Lower and L^*
+ * if Mode contains Upper, optionally with a unit diagonal. The panels of L are
+ * traversed forward for L and backward for L^*, such that both only read
+ * panels of columns of L.
+ */
+template <typename Scalar, int StorageUpLo, int Mode>
+struct packed_triangular_solver {
+  template <typename Rhs>
+  static void run(const Scalar* data, Index size, Rhs& other) {
+    typedef packed_storage<Scalar, StorageUpLo> Storage;
+    if (size == 0) return;
+    const Index bs = Storage::panel_size(size);
+    Matrix<Scalar, Dynamic, Dynamic> panel;
+    if (Mode & Lower) {
+      for (Index j = 0; j < size; j += bs) {
+        const Index cols = numext::mini(bs, size - j);
+        const Index rs = size - j - cols;
+        panel.resize(size - j, cols);
+        Storage::gather_lower(data, size, j, j, panel);
+        typename Rhs::RowsBlockXpr x1 = other.middleRows(j, cols);
+        panel.topRows(cols).template triangularView<Mode>().solveInPlace(x1);
+        if (rs > 0) other.bottomRows(rs).noalias() -= panel.bottomRows(rs) * x1;
+      }
+    } else {
+      for (Index j = (size - 1) / bs * bs; j >= 0; j -= bs) {
+        const Index cols = numext::mini(bs, size - j);
+        const Index rs = size - j - cols;
+        panel.resize(size - j, cols);
+        Storage::gather_lower(data, size, j, j, panel);
+        typename Rhs::RowsBlockXpr x1 = other.middleRows(j, cols);
+        if (rs > 0) x1.noalias() -= panel.bottomRows(rs).adjoint() * other.bottomRows(rs);
+        panel.topRows(cols).adjoint().template triangularView<Mode>().solveInPlace(x1);
+      }
+    }
+  }
+};
+
+template <typename Lhs, typename Rhs, int ProductTag>
+struct generic_product_impl<Lhs, Rhs, PackedTriangularShape, DenseShape, ProductTag>
+    : generic_product_impl_base<Lhs, Rhs,
+                                generic_product_impl<Lhs, Rhs, PackedTriangularShape, DenseShape, ProductTag>> {
+  typedef typename Product<Lhs, Rhs>::Scalar Scalar;
+
+  template <typename Dest>
+  static void scaleAndAddTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha) {
+    typename nested_eval<Rhs, Dynamic>::type actualRhs(rhs);
+    packed_matrix_product<typename Lhs::Scalar, Lhs::UpLo, Lhs::UpLo, false>::run(dst, lhs.data(), lhs.rows(),
+                                                                                  actualRhs, alpha);
+  }
+};
+
+template <typename Lhs, typename Rhs, int ProductTag>
+struct generic_product_impl<Lhs, Rhs, DenseShape, PackedTriangularShape, ProductTag>
+    : generic_product_impl_base<Lhs, Rhs,
+                                generic_product_impl<Lhs, Rhs, DenseShape, PackedTriangularShape, ProductTag>> {
+  typedef typename Product<Lhs, Rhs>::Scalar Scalar;
+
+  // dst^T += alpha * A^T * lhs^T, where L^T = conj(L)^*.
+  template <typename Dest>
+  static void scaleAndAddTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha) {
+    typename nested_eval<Lhs, Dynamic>::type actualLhs(lhs);
+    Transpose<Dest> dstT(dst);
+    packed_matrix_product<typename Rhs::Scalar, Rhs::UpLo, Rhs::UpLo == Lower ? Upper : Lower, true>::run(
+        dstT, rhs.data(), rhs.rows(), actualLhs.transpose(), alpha);
+  }
+};
+
+template <typename Lhs, typename Rhs, int ProductTag>
+struct generic_product_impl<Lhs, Rhs, PackedSelfAdjointShape, DenseShape, ProductTag>
+    : generic_product_impl_base<Lhs, Rhs,
+                                generic_product_impl<Lhs, Rhs, PackedSelfAdjointShape, DenseShape, ProductTag>> {
+  typedef typename Product<Lhs, Rhs>::Scalar Scalar;
+
+  template <typename Dest>
+  static void scaleAndAddTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha) {
+    typename nested_eval<Rhs, Dynamic>::type actualRhs(rhs);
+    packed_matrix_product<typename Lhs::Scalar, Lhs::UpLo, SelfAdjoint, false>::run(dst, lhs.data(), lhs.rows(),
+                                                                                    actualRhs, alpha);
+  }
+};
+
+template <typename Lhs, typename Rhs, int ProductTag>
+struct generic_product_impl<Lhs, Rhs, DenseShape, PackedSelfAdjointShape, ProductTag>
+    : generic_product_impl_base<Lhs, Rhs,
+                                generic_product_impl<Lhs, Rhs, DenseShape, PackedSelfAdjointShape, ProductTag>> {
+  typedef typename Product<Lhs, Rhs>::Scalar Scalar;
+
+  // dst^T += alpha * conj(A) * lhs^T
+  template <typename Dest>
+  static void scaleAndAddTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha) {
+    typename nested_eval<Lhs, Dynamic>::type actualLhs(lhs);
+    Transpose<Dest> dstT(dst);
+    packed_matrix_product<typename Rhs::Scalar, Rhs::UpLo, SelfAdjoint, true>::run(dstT, rhs.data(), rhs.rows(),
+                                                                                   actualLhs.transpose(), alpha);
+  }
+};
+
+// Dense ?= scalar * (packed * dense): the generic rule would scale a copy of the packed matrix, scale the rhs instead.
+template <typename DstXprType, typename Scalar_, int UpLo_, typename Rhs, typename AssignFunc, typename ScalarBis,
+          typename Plain>
+struct Assignment<DstXprType,
+                  CwiseBinaryOp<scalar_product_op<ScalarBis, Scalar_>,
+                                const CwiseNullaryOp<scalar_constant_op<ScalarBis>, Plain>,
+                                const Product<PackedTriangularMatrix<Scalar_, UpLo_>, Rhs, DefaultProduct>>,
+                  AssignFunc, Dense2Dense> {
+  typedef CwiseBinaryOp<scalar_product_op<ScalarBis, Scalar_>,
+                        const CwiseNullaryOp<scalar_constant_op<ScalarBis>, Plain>,
+                        const Product<PackedTriangularMatrix<Scalar_, UpLo_>, Rhs, DefaultProduct>>
+      SrcXprType;
+  static void run(DstXprType& dst, const SrcXprType& src, const AssignFunc& func) {
+    call_assignment_no_alias(dst, src.rhs().lhs() * (src.lhs().functor().m_other * src.rhs().rhs()), func);
+  }
+};
+
+template <typename DstXprType, typename Scalar_, int UpLo_, typename Rhs, typename AssignFunc, typename ScalarBis,
+          typename Plain>
+struct Assignment<DstXprType,
+                  CwiseBinaryOp<scalar_product_op<ScalarBis, Scalar_>,
+                                const CwiseNullaryOp<scalar_constant_op<ScalarBis>, Plain>,
+                                const Product<PackedSelfAdjointMatrix<Scalar_, UpLo_>, Rhs, DefaultProduct>>,
+                  AssignFunc, Dense2Dense> {
+  typedef CwiseBinaryOp<scalar_product_op<ScalarBis, Scalar_>,
+                        const CwiseNullaryOp<scalar_constant_op<ScalarBis>, Plain>,
+                        const Product<PackedSelfAdjointMatrix<Scalar_, UpLo_>, Rhs, DefaultProduct>>
+      SrcXprType;
+  static void run(DstXprType& dst, const SrcXprType& src, const AssignFunc& func) {
+    call_assignment_no_alias(dst, src.rhs().lhs() * (src.lhs().functor().m_other * src.rhs().rhs()), func);
+  }
+};
+
+}  // end namespace internal
+
+/** Solves \c *this * X = \a other in place, overwriting \a other by X.
+ *
+ * \warning The parameter is only marked 'const' to make the C++ compiler accept a temporary expression here.
+ * This function will const_cast it, so constness isn't honored here.
+ */
+template <typename Scalar_, int UpLo_>
+template <typename OtherDerived>
+void PackedTriangularMatrix<Scalar_, UpLo_>::solveInPlace(const MatrixBase<OtherDerived>& other) const {
+  eigen_assert(other.rows() == rows());
+  OtherDerived& x = other.const_cast_derived();
+  internal::packed_triangular_solver<Scalar, UpLo_, UpLo_>::run(this->data(), rows(), x);
+}
+
+/** Performs the rank K update of the selfadjoint matrix \c *this:
+ * \f$ this = this + \alpha u u^* \f$ where \a u is a vector or a matrix with K columns.
+ *
+ * \returns a reference to \c *this
+ */
+template <typename Scalar_, int UpLo_>
+template <typename DerivedU>
+PackedSelfAdjointMatrix<Scalar_, UpLo_>& PackedSelfAdjointMatrix<Scalar_, UpLo_>::rankUpdate(
+    const MatrixBase<DerivedU>& u, const RealScalar& alpha) {
+  eigen_assert(u.rows() == rows());
+  typedef typename Base::Storage Storage;
+  typename internal::nested_eval<DerivedU, Dynamic>::type actualU(u.derived());
+  const Index size = rows();
+  const Index bs = Storage::panel_size(size);
+  Matrix<Scalar, Dynamic, Dynamic> panel;
+  for (Index j = 0; j < size; j += bs) {
+    const Index cols = numext::mini(bs, size - j);
+    panel.resize(size - j, cols);
+    Storage::gather_lower(this->data(), size, j, j, panel);
+    panel.noalias() += alpha * actualU.bottomRows(size - j) * actualU.middleRows(j, cols).adjoint();
+    Storage::scatter_lower(this->data(), size, j, j, panel);
+  }
+  return *this;
+}
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_PACKED_MATRIX_PRODUCT_H
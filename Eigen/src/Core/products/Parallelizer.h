@@ -104,11 +104,19 @@ inline void manage_multi_threading(Action action, int* v) {
 }
 template <typename Index>
 struct GemmParallelInfo {};
+template <bool Condition, typename Traits, typename Index>
+int gemm_parallel_threads(Index /*unused*/, Index /*unused*/, Index /*unused*/, bool /*unused*/) {
+  return 1;
+}
 template <bool Condition, typename Functor, typename Index>
 EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index cols, Index /*unused*/,
                                           bool /*unused*/) {
   func(0, rows, 0, cols);
 }
+template <typename Functor>
+void parallelize_tasks(const Functor& func, int tasks) {
+  for (int i = 0; i < tasks; ++i) func(i);
+}
 
 #else
 
@@ -159,8 +167,9 @@ inline void manage_multi_threading(Action action, int* v) {
   }
 }
 
-template <bool Condition, typename Functor, typename Index>
-EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth, bool transpose) {
+// Returns the number of threads of parallelize_gemm below, or 1 if the product is run sequentially.
+template <bool Condition, typename Traits, typename Index>
+int gemm_parallel_threads(Index rows, Index cols, Index depth, bool transpose) {
   // Dynamically check whether we should even try to execute in parallel.
   // The conditions are:
   // - the max number of threads we can create is greater than 1
@@ -171,7 +180,7 @@ EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index
   // This first heuristic takes into account that the product kernel is fully optimized when working with nr columns at
   // once.
   Index size = transpose ? rows : cols;
-  Index pb_max_threads = std::max<Index>(1, size / Functor::Traits::nr);
+  Index pb_max_threads = std::max<Index>(1, size / Traits::nr);
 
   // compute the maximal number of threads from the total amount of work:
   double work = static_cast<double>(rows) * static_cast<double>(cols) * static_cast<double>(depth);
@@ -195,7 +204,13 @@ EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index
   ThreadPool* pool = getGemmThreadPool();
   dont_parallelize |= (pool == nullptr || pool->CurrentThreadId() != -1);
 #endif
-  if (dont_parallelize) return func(0, rows, 0, cols);
+  return dont_parallelize ? 1 : threads;
+}
+
+template <bool Condition, typename Functor, typename Index>
+EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth, bool transpose) {
+  const int threads = gemm_parallel_threads<Condition, typename Functor::Traits>(rows, cols, depth, transpose);
+  if (threads <= 1) return func(0, rows, 0, cols);
 
   func.initParallelSession(threads);
 
@@ -232,7 +247,7 @@ EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index
   }
 
 #elif defined(EIGEN_GEMM_THREADPOOL)
-  ei_declare_aligned_stack_constructed_variable(GemmParallelTaskInfo<Index>, meta_info, threads, 0);
+  ThreadPool* pool = getGemmThreadPool();
   Barrier barrier(threads);
   auto task = [=, &func, &barrier, &task_info](int i) {
     Index actual_threads = threads;
@@ -268,6 +283,40 @@ EIGEN_STRONG_INLINE void parallelize_gemm(const Functor& func, Index rows, Index
 #endif
 }
 
+// Runs func(0), ..., func(tasks - 1) on at most nbThreads() threads, unless we
+// already are inside a parallel session. The tasks are picked dynamically by
+// the threads, and must not run parallel products themselves.
+template <typename Functor>
+void parallelize_tasks(const Functor& func, int tasks) {
+  int threads = std::min<int>(nbThreads(), tasks);
+  bool dont_parallelize = threads <= 1;
+#if defined(EIGEN_HAS_OPENMP)
+  dont_parallelize |= omp_get_num_threads() > 1;
+#elif defined(EIGEN_GEMM_THREADPOOL)
+  ThreadPool* pool = getGemmThreadPool();
+  dont_parallelize |= (pool == nullptr || pool->CurrentThreadId() != -1);
+#endif
+  if (dont_parallelize) {
+    for (int i = 0; i < tasks; ++i) func(i);
+    return;
+  }
+
+#if defined(EIGEN_HAS_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+  for (int i = 0; i < tasks; ++i) func(i);
+#elif defined(EIGEN_GEMM_THREADPOOL)
+  std::atomic<int> next(0);
+  Barrier barrier(threads);
+  auto worker = [&func, &next, &barrier, tasks]() {
+    for (int i = next++; i < tasks; i = next++) func(i);
+    barrier.Notify();
+  };
+  for (int i = 0; i < threads - 1; ++i) pool->Schedule(worker);
+  worker();
+  barrier.Wait();
+#endif
+}
+
 #endif
 
 }  // end namespace internal
@@ -0,0 +1,399 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_QUANTIZED_MATRIX_MATRIX_H
+#define EIGEN_QUANTIZED_MATRIX_MATRIX_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+namespace Eigen {
+
+// The product of signed and unsigned 8-bit integers promotes to 32-bit
+// integers, such that a Matrix<int8_t> * Matrix<uint8_t> product accumulates
+// exactly into a Matrix<int32_t>. Other binary operations do not mix them.
+template <>
+struct ScalarBinaryOpTraits<std::int8_t, std::uint8_t, internal::scalar_product_op<std::int8_t, std::uint8_t>> {
+  typedef std::int32_t ReturnType;
+};
+template <>
+struct ScalarBinaryOpTraits<std::uint8_t, std::int8_t, internal::scalar_product_op<std::uint8_t, std::int8_t>> {
+  typedef std::int32_t ReturnType;
+};
+template <>
+struct ScalarBinaryOpTraits<std::int8_t, std::uint8_t, internal::scalar_conj_product_op<std::int8_t, std::uint8_t>> {
+  typedef std::int32_t ReturnType;
+};
+template <>
+struct ScalarBinaryOpTraits<std::uint8_t, std::int8_t, internal::scalar_conj_product_op<std::uint8_t, std::int8_t>> {
+  typedef std::int32_t ReturnType;
+};
+
+namespace internal {
+
+/* Integer GEMM for int8 x uint8 operands with int32 accumulation.
+ *
+ * The blocking follows general_matrix_matrix_product, but the packed layout
+ * groups the depth by 4: for each group of 4 consecutive k, the lhs panel
+ * stores the 4 bytes of each of its QuantizedGemmMr rows next to each other,
+ * and the rhs panel the 4 bytes of each of its QuantizedGemmNr columns. A
+ * 32-bit lane of a lhs packet thus holds a 4-term slice of a row, and
+ * broadcasting the 32-bit word of a rhs column yields the matching slice of
+ * the column. The depth is zero-padded to a multiple of 4.
+ *
+ * With AVX-VNNI or AVX512-VNNI, the 4-term dot products are accumulated by
+ * vpdpbusd. With AVX2, the bytes are widened to 16 bits and accumulated with
+ * pmaddwd, which is exact. pmaddubsw is not used since it saturates its
+ * 16-bit pairwise sums.
+ */
+enum { QuantizedGemmMr = 16, QuantizedGemmNr = 4, QuantizedGemmKr = 4 };
+
+template <typename Scalar, typename Index, typename DataMapper>
+void quantized_gemm_pack_lhs(Scalar* blockA, const DataMapper& lhs, Index depth, Index rows) {
+  const Index quads = (depth + QuantizedGemmKr - 1) / QuantizedGemmKr;
+  for (Index i = 0; i < rows; i += QuantizedGemmMr) {
+    const Index actual_rows = numext::mini<Index>(QuantizedGemmMr, rows - i);
+    for (Index q = 0; q < quads; ++q) {
+      const Index k = q * QuantizedGemmKr;
+      const Index actual_k = numext::mini<Index>(QuantizedGemmKr, depth - k);
+      for (Index r = 0; r < QuantizedGemmMr; ++r) {
+        for (Index t = 0; t < QuantizedGemmKr; ++t)
+          *blockA++ = (r < actual_rows && t < actual_k) ? lhs(i + r, k + t) : Scalar(0);
+      }
+    }
+  }
+}
+
+template <typename Scalar, typename Index, typename DataMapper>
+void quantized_gemm_pack_rhs(Scalar* blockB, const DataMapper& rhs, Index depth, Index cols) {
+  const Index quads = (depth + QuantizedGemmKr - 1) / QuantizedGemmKr;
+  for (Index j = 0; j < cols; j += QuantizedGemmNr) {
+    const Index actual_cols = numext::mini<Index>(QuantizedGemmNr, cols - j);
+    for (Index q = 0; q < quads; ++q) {
+      const Index k = q * QuantizedGemmKr;
+      const Index actual_k = numext::mini<Index>(QuantizedGemmKr, depth - k);
+      for (Index c = 0; c < QuantizedGemmNr; ++c) {
+        for (Index t = 0; t < QuantizedGemmKr; ++t)
+          *blockB++ = (c < actual_cols && t < actual_k) ? rhs(k + t, j + c) : Scalar(0);
+      }
+    }
+  }
+}
+
+#if defined(EIGEN_VECTORIZE_AVX2)
+
+#if defined(EIGEN_VECTORIZE_AVX512VNNI) && defined(EIGEN_VECTORIZE_AVX512VL)
+#define EIGEN_QUANTIZED_GEMM_DPBUSD(ACC, U, S) _mm256_dpbusd_epi32(ACC, U, S)
+#elif defined(EIGEN_VECTORIZE_AVXVNNI)
+#define EIGEN_QUANTIZED_GEMM_DPBUSD(ACC, U, S) _mm256_dpbusd_avx_epi32(ACC, U, S)
+#endif
+
+// Widens the bytes 0 and 2 (even) or 1 and 3 (odd) of each 32-bit lane to
+// 16-bit integers.
+template <typename Scalar>
+EIGEN_STRONG_INLINE __m256i quantized_gemm_widen_even(const __m256i& x) {
+  return NumTraits<Scalar>::IsSigned ? _mm256_srai_epi16(_mm256_slli_epi16(x, 8), 8)
+                                     : _mm256_and_si256(x, _mm256_set1_epi16(0xff));
+}
+
+template <typename Scalar>
+EIGEN_STRONG_INLINE __m256i quantized_gemm_widen_odd(const __m256i& x) {
+  return NumTraits<Scalar>::IsSigned ? _mm256_srai_epi16(x, 8) : _mm256_srli_epi16(x, 8);
+}
+
+// Accumulates the 4-term dot products of the 32-bit lanes of a and b into acc.
+template <typename LhsScalar, typename RhsScalar>
+struct quantized_gemm_dot4 {
+#ifdef EIGEN_QUANTIZED_GEMM_DPBUSD
+  // vpdpbusd multiplies unsigned bytes of its first operand with signed
+  // bytes of its second one.
+  static EIGEN_STRONG_INLINE __m256i run(const __m256i& acc, const __m256i& a, const __m256i& b) {
+    return NumTraits<LhsScalar>::IsSigned ? EIGEN_QUANTIZED_GEMM_DPBUSD(acc, b, a)
+                                          : EIGEN_QUANTIZED_GEMM_DPBUSD(acc, a, b);
+  }
+#else
+  static EIGEN_STRONG_INLINE __m256i run(const __m256i& acc, const __m256i& a, const __m256i& b) {
+    const __m256i even = _mm256_madd_epi16(quantized_gemm_widen_even<LhsScalar>(a),
+                                           quantized_gemm_widen_even<RhsScalar>(b));
+    const __m256i odd =
+        _mm256_madd_epi16(quantized_gemm_widen_odd<LhsScalar>(a), quantized_gemm_widen_odd<RhsScalar>(b));
+    return _mm256_add_epi32(acc, _mm256_add_epi32(even, odd));
+  }
+#endif
+};
+
+// Computes the QuantizedGemmMr x QuantizedGemmNr column-major tile
+// acc = A' * B' of a packed lhs and rhs panel.
+template <typename LhsScalar, typename RhsScalar, typename Index>
+EIGEN_DONT_INLINE void quantized_gemm_micro_kernel(const LhsScalar* a, const RhsScalar* b, Index quads,
+                                                   std::int32_t* acc) {
+  typedef quantized_gemm_dot4<LhsScalar, RhsScalar> Dot;
+  __m256i c00 = _mm256_setzero_si256(), c01 = c00, c02 = c00, c03 = c00;
+  __m256i c10 = c00, c11 = c00, c12 = c00, c13 = c00;
+  for (Index q = 0; q < quads; ++q) {
+    const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 32));
+    std::int32_t words[QuantizedGemmNr];
+    std::memcpy(words, b, sizeof(words));
+    __m256i bc = _mm256_set1_epi32(words[0]);
+    c00 = Dot::run(c00, a0, bc);
+    c10 = Dot::run(c10, a1, bc);
+    bc = _mm256_set1_epi32(words[1]);
+    c01 = Dot::run(c01, a0, bc);
+    c11 = Dot::run(c11, a1, bc);
+    bc = _mm256_set1_epi32(words[2]);
+    c02 = Dot::run(c02, a0, bc);
+    c12 = Dot::run(c12, a1, bc);
+    bc = _mm256_set1_epi32(words[3]);
+    c03 = Dot::run(c03, a0, bc);
+    c13 = Dot::run(c13, a1, bc);
+    a += QuantizedGemmMr * QuantizedGemmKr;
+    b += QuantizedGemmNr * QuantizedGemmKr;
+  }
+  __m256i* out = reinterpret_cast<__m256i*>(acc);
+  _mm256_storeu_si256(out + 0, c00);
+  _mm256_storeu_si256(out + 1, c10);
+  _mm256_storeu_si256(out + 2, c01);
+  _mm256_storeu_si256(out + 3, c11);
+  _mm256_storeu_si256(out + 4, c02);
+  _mm256_storeu_si256(out + 5, c12);
+  _mm256_storeu_si256(out + 6, c03);
+  _mm256_storeu_si256(out + 7, c13);
+}
+
+#undef EIGEN_QUANTIZED_GEMM_DPBUSD
+
+#else
+
+template <typename LhsScalar, typename RhsScalar, typename Index>
+void quantized_gemm_micro_kernel(const LhsScalar* a, const RhsScalar* b, Index quads, std::int32_t* acc) {
+  for (Index i = 0; i < QuantizedGemmMr * QuantizedGemmNr; ++i) acc[i] = 0;
+  for (Index q = 0; q < quads; ++q) {
+    for (Index c = 0; c < QuantizedGemmNr; ++c) {
+      for (Index r = 0; r < QuantizedGemmMr; ++r) {
+        std::int32_t sum = 0;
+        for (Index t = 0; t < QuantizedGemmKr; ++t)
+          sum += std::int32_t(a[r * QuantizedGemmKr + t]) * std::int32_t(b[c * QuantizedGemmKr + t]);
+        acc[c * QuantizedGemmMr + r] += sum;
+      }
+    }
+    a += QuantizedGemmMr * QuantizedGemmKr;
+    b += QuantizedGemmNr * QuantizedGemmKr;
+  }
+}
+
+#endif
+
+template <typename Index, typename LhsScalar, int LhsStorageOrder, typename RhsScalar, int RhsStorageOrder,
+          int ResInnerStride>
+struct quantized_general_matrix_matrix_product {
+  typedef std::int32_t ResScalar;
+
+  template <typename Epilogue>
+  static void run(Index rows, Index cols, Index depth, const LhsScalar* lhs_, Index lhsStride, const RhsScalar* rhs_,
+                  Index rhsStride, ResScalar* res_, Index resIncr, Index resStride, ResScalar alpha,
+                  level3_blocking<LhsScalar, RhsScalar>& blocking, const Epilogue& epilogue) {
+    typedef const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> LhsMapper;
+    typedef const_blas_data_mapper<RhsScalar, Index, RhsStorageOrder> RhsMapper;
+    typedef blas_data_mapper<ResScalar, Index, ColMajor, Unaligned, ResInnerStride> ResMapper;
+    LhsMapper lhs(lhs_, lhsStride);
+    RhsMapper rhs(rhs_, rhsStride);
+    ResMapper res(res_, resStride, resIncr);
+
+    const Index Mr = QuantizedGemmMr, Nr = QuantizedGemmNr, Kr = QuantizedGemmKr;
+    // Keep the depth blocks made of whole groups of Kr, only the last one is
+    // padded.
+    Index kc = (std::min)(depth, blocking.kc());
+    if (kc < depth) kc = numext::maxi<Index>(Kr, kc - kc % Kr);
+    const Index mc = (std::min)(rows, blocking.mc());
+    const Index nc = (std::min)(cols, blocking.nc());
+
+    const Index padded_kc = (kc + Kr - 1) / Kr * Kr;
+    const std::size_t sizeA = (mc + Mr - 1) / Mr * Mr * padded_kc;
+    const std::size_t sizeB = (nc + Nr - 1) / Nr * Nr * padded_kc;
+    ei_declare_gemm_workspace_variable(LhsScalar, blockA, sizeA, 0);
+    ei_declare_gemm_workspace_variable(RhsScalar, blockB, sizeB, 0);
+    EIGEN_ALIGN_MAX ResScalar acc[QuantizedGemmMr * QuantizedGemmNr];
+
+    for (Index i2 = 0; i2 < rows; i2 += mc) {
+      const Index actual_mc = (std::min)(i2 + mc, rows) - i2;
+      for (Index k2 = 0; k2 < depth; k2 += kc) {
+        const Index actual_kc = (std::min)(k2 + kc, depth) - k2;
+        const Index quads = (actual_kc + Kr - 1) / Kr;
+        quantized_gemm_pack_lhs(blockA, lhs.getSubMapper(i2, k2), actual_kc, actual_mc);
+        for (Index j2 = 0; j2 < cols; j2 += nc) {
+          const Index actual_nc = (std::min)(j2 + nc, cols) - j2;
+          quantized_gemm_pack_rhs(blockB, rhs.getSubMapper(k2, j2), actual_kc, actual_nc);
+          for (Index j = 0; j < actual_nc; j += Nr) {
+            const Index actual_nr = (std::min)(Nr, actual_nc - j);
+            for (Index i = 0; i < actual_mc; i += Mr) {
+              const Index actual_mr = (std::min)(Mr, actual_mc - i);
+              quantized_gemm_micro_kernel(blockA + i * quads * Kr, blockB + j * quads * Kr, quads, acc);
+              for (Index c = 0; c < actual_nr; ++c)
+                for (Index r = 0; r < actual_mr; ++r) res(i2 + i + r, j2 + j + c) += alpha * acc[c * Mr + r];
+            }
+          }
+          if (k2 + actual_kc == depth)
+            epilogue.template apply<ColMajor>(res_ + i2 * resIncr + j2 * resStride, resIncr, resStride, i2, j2,
+                                              actual_mc, actual_nc);
+        }
+      }
+    }
+  }
+};
+
+/* Dispatches the col-major int8 x uint8 products to the integer kernel. The
+ * row-major ones are transposed by the generic specialization. Threads of a
+ * parallel product work on disjoint column blocks and pack their own lhs.
+ */
+template <typename Index, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder, bool ConjugateRhs,
+          int ResInnerStride>
+struct general_matrix_matrix_product<Index, std::int8_t, LhsStorageOrder, ConjugateLhs, std::uint8_t, RhsStorageOrder,
+                                     ConjugateRhs, ColMajor, ResInnerStride>
+    : quantized_general_matrix_matrix_product<Index, std::int8_t, LhsStorageOrder, std::uint8_t, RhsStorageOrder,
+                                              ResInnerStride> {
+  typedef gebp_traits<std::int8_t, std::uint8_t> Traits;
+  typedef quantized_general_matrix_matrix_product<Index, std::int8_t, LhsStorageOrder, std::uint8_t, RhsStorageOrder,
+                                                  ResInnerStride>
+      Base;
+  static void run(Index rows, Index cols, Index depth, const std::int8_t* lhs, Index lhsStride, const std::uint8_t* rhs,
+                  Index rhsStride, std::int32_t* res, Index resIncr, Index resStride, std::int32_t alpha,
+                  level3_blocking<std::int8_t, std::uint8_t>& blocking, GemmParallelInfo<Index>* /*info*/ = 0) {
+    Base::run(rows, cols, depth, lhs, lhsStride, rhs, rhsStride, res, resIncr, resStride, alpha, blocking,
+              gemm_no_epilogue());
+  }
+  template <typename Epilogue>
+  static void run(Index rows, Index cols, Index depth, const std::int8_t* lhs, Index lhsStride, const std::uint8_t* rhs,
+                  Index rhsStride, std::int32_t* res, Index resIncr, Index resStride, std::int32_t alpha,
+                  level3_blocking<std::int8_t, std::uint8_t>& blocking, GemmParallelInfo<Index>* /*info*/,
+                  const Epilogue& epilogue) {
+    Base::run(rows, cols, depth, lhs, lhsStride, rhs, rhsStride, res, resIncr, resStride, alpha, blocking, epilogue);
+  }
+};
+
+template <typename Index, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder, bool ConjugateRhs,
+          int ResInnerStride>
+struct general_matrix_matrix_product<Index, std::uint8_t, LhsStorageOrder, ConjugateLhs, std::int8_t, RhsStorageOrder,
+                                     ConjugateRhs, ColMajor, ResInnerStride>
+    : quantized_general_matrix_matrix_product<Index, std::uint8_t, LhsStorageOrder, std::int8_t, RhsStorageOrder,
+                                              ResInnerStride> {
+  typedef gebp_traits<std::uint8_t, std::int8_t> Traits;
+  typedef quantized_general_matrix_matrix_product<Index, std::uint8_t, LhsStorageOrder, std::int8_t, RhsStorageOrder,
+                                                  ResInnerStride>
+      Base;
+  static void run(Index rows, Index cols, Index depth, const std::uint8_t* lhs, Index lhsStride, const std::int8_t* rhs,
+                  Index rhsStride, std::int32_t* res, Index resIncr, Index resStride, std::int32_t alpha,
+                  level3_blocking<std::uint8_t, std::int8_t>& blocking, GemmParallelInfo<Index>* /*info*/ = 0) {
+    Base::run(rows, cols, depth, lhs, lhsStride, rhs, rhsStride, res, resIncr, resStride, alpha, blocking,
+              gemm_no_epilogue());
+  }
+  template <typename Epilogue>
+  static void run(Index rows, Index cols, Index depth, const std::uint8_t* lhs, Index lhsStride, const std::int8_t* rhs,
+                  Index rhsStride, std::int32_t* res, Index resIncr, Index resStride, std::int32_t alpha,
+                  level3_blocking<std::uint8_t, std::int8_t>& blocking, GemmParallelInfo<Index>* /*info*/,
+                  const Epilogue& epilogue) {
+    Base::run(rows, cols, depth, lhs, lhsStride, rhs, rhsStride, res, resIncr, resStride, alpha, blocking, epilogue);
+  }
+};
+
+template <typename LhsScalar, typename RhsScalar>
+struct is_quantized_product
+    : std::integral_constant<bool, (std::is_same<LhsScalar, std::int8_t>::value &&
+                                    std::is_same<RhsScalar, std::uint8_t>::value) ||
+                                       (std::is_same<LhsScalar, std::uint8_t>::value &&
+                                        std::is_same<RhsScalar, std::int8_t>::value)> {};
+
+// Applies the zero points and scales to the raw products acc = lhs * rhs:
+//   dst(i,j) = scale(i,j) * (acc(i,j) - zb(j) * rowSums(i) - za(i) * colSums(j) + depth * za(i) * zb(j))
+// where rowSums and colSums are the sums of the rows of lhs and of the
+// columns of rhs.
+template <typename Lhs, typename Rhs, typename LhsZeroPoints, typename RhsZeroPoints, typename Acc, typename Func>
+void quantized_product_epilogue(const Lhs& lhs, const Rhs& rhs, const LhsZeroPoints& lhsZeroPoints,
+                                const RhsZeroPoints& rhsZeroPoints, const Acc& acc, Func func) {
+  eigen_assert(lhsZeroPoints.size() == lhs.rows() && rhsZeroPoints.size() == rhs.cols());
+  const Matrix<std::int32_t, Dynamic, 1> rowSums = lhs.template cast<std::int32_t>().rowwise().sum();
+  const Matrix<std::int32_t, 1, Dynamic> colSums = rhs.template cast<std::int32_t>().colwise().sum();
+  const std::int32_t depth = internal::convert_index<std::int32_t>(lhs.cols());
+  for (Index j = 0; j < acc.cols(); ++j) {
+    const std::int32_t zb = std::int32_t(rhsZeroPoints.coeff(j));
+    const std::int32_t colTerm = zb * depth;
+    for (Index i = 0; i < acc.rows(); ++i) {
+      const std::int32_t za = std::int32_t(lhsZeroPoints.coeff(i));
+      func(i, j, acc.coeff(i, j) - zb * rowSums.coeff(i) - za * (colSums.coeff(j) - colTerm));
+    }
+  }
+}
+
+}  // namespace internal
+
+/** \ingroup Core_Module
+ *
+ * Computes the product of two affine quantized matrices in 32-bit integers:
+ * \f[ dst_{ij} = \sum_k (lhs_{ik} - lz_i)(rhs_{kj} - rz_j) \f]
+ * where \a lhsZeroPoints holds one zero point \f$ lz_i \f$ per row of \a lhs,
+ * and \a rhsZeroPoints one zero point \f$ rz_j \f$ per column of \a rhs. Per
+ * tensor zero points are obtained with constant vectors.
+ *
+ * One operand must be of type \c int8_t and the other one of type \c uint8_t.
+ * The raw product runs the packed integer GEMM kernel, and the zero points are
+ * applied afterwards from the row and column sums of the operands. The result
+ * is exact as long as it fits in 32 bits.
+ *
+ * \sa quantizedProduct(const MatrixBase<Lhs>&, const MatrixBase<Rhs>&, const MatrixBase<LhsZeroPoints>&, const
+ * MatrixBase<RhsZeroPoints>&, const MatrixBase<LhsScales>&, const MatrixBase<RhsScales>&, MatrixBase<Dest>&)
+ */
+template <typename Lhs, typename Rhs, typename LhsZeroPoints, typename RhsZeroPoints, typename Dest>
+void quantizedProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs,
+                      const MatrixBase<LhsZeroPoints>& lhsZeroPoints, const MatrixBase<RhsZeroPoints>& rhsZeroPoints,
+                      MatrixBase<Dest>& dst) {
+  EIGEN_STATIC_ASSERT((internal::is_quantized_product<typename Lhs::Scalar, typename Rhs::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  EIGEN_STATIC_ASSERT((std::is_same<typename Dest::Scalar, std::int32_t>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  typename internal::nested_eval<Lhs, Dynamic>::type actualLhs(lhs.derived());
+  typename internal::nested_eval<Rhs, Dynamic>::type actualRhs(rhs.derived());
+  dst.derived().resize(lhs.rows(), rhs.cols());
+  dst.derived().noalias() = actualLhs * actualRhs;
+  internal::quantized_product_epilogue(actualLhs, actualRhs, lhsZeroPoints.derived(), rhsZeroPoints.derived(),
+                                       dst.derived(),
+                                       [&](Index i, Index j, std::int32_t value) { dst.coeffRef(i, j) = value; });
+}
+
+/** \ingroup Core_Module
+ *
+ * Computes the dequantized product of two affine quantized matrices:
+ * \f[ dst_{ij} = ls_i \, rs_j \sum_k (lhs_{ik} - lz_i)(rhs_{kj} - rz_j) \f]
+ * where \a lhsScales and \a lhsZeroPoints hold the scale \f$ ls_i \f$ and zero
+ * point \f$ lz_i \f$ of each row of \a lhs, and \a rhsScales and \a
+ * rhsZeroPoints the ones of each column of \a rhs. The zero point correction
+ * and the scaling are applied in a single pass over the 32-bit accumulators.
+ * The scalar type of \a dst is typically \c float.
+ */
+template <typename Lhs, typename Rhs, typename LhsZeroPoints, typename RhsZeroPoints, typename LhsScales,
+          typename RhsScales, typename Dest>
+void quantizedProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs,
+                      const MatrixBase<LhsZeroPoints>& lhsZeroPoints, const MatrixBase<RhsZeroPoints>& rhsZeroPoints,
+                      const MatrixBase<LhsScales>& lhsScales, const MatrixBase<RhsScales>& rhsScales,
+                      MatrixBase<Dest>& dst) {
+  EIGEN_STATIC_ASSERT((internal::is_quantized_product<typename Lhs::Scalar, typename Rhs::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  typedef typename Dest::Scalar DstScalar;
+  eigen_assert(lhsScales.size() == lhs.rows() && rhsScales.size() == rhs.cols());
+  typename internal::nested_eval<Lhs, Dynamic>::type actualLhs(lhs.derived());
+  typename internal::nested_eval<Rhs, Dynamic>::type actualRhs(rhs.derived());
+  const Matrix<std::int32_t, Dynamic, Dynamic> acc = actualLhs * actualRhs;
+  dst.derived().resize(lhs.rows(), rhs.cols());
+  internal::quantized_product_epilogue(
+      actualLhs, actualRhs, lhsZeroPoints.derived(), rhsZeroPoints.derived(), acc,
+      [&](Index i, Index j, std::int32_t value) {
+        dst.coeffRef(i, j) = DstScalar(lhsScales.coeff(i)) * DstScalar(rhsScales.coeff(j)) * DstScalar(value);
+      });
+}
+
+}  // namespace Eigen
+
+#endif  // EIGEN_QUANTIZED_MATRIX_MATRIX_H
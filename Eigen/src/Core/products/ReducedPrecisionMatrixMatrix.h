@@ -0,0 +1,216 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_REDUCED_PRECISION_MATRIX_MATRIX_H
+#define EIGEN_REDUCED_PRECISION_MATRIX_MATRIX_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+/* GEMM for bfloat16 and half operands with float accumulation.
+ *
+ * The generic gebp kernel accumulates in the scalar type of the result, which
+ * rounds every partial sum to 8 (bfloat16) or 11 (half) significant bits. Here
+ * the panels are packed in their 16-bit format, halving the bandwidth of the
+ * packed blocks with respect to float, and the micro-kernel converts each lhs
+ * packet and rhs coefficient to float in registers. The depth is not blocked,
+ * so that every coefficient of the result is accumulated over the whole depth
+ * in float and rounded only once, when alpha times the sum is added to the
+ * destination.
+ *
+ * The lhs panels hold Mr rows, two float packets, and the rhs panels Nr
+ * columns (see reduced_gemm_traits). Both are stored depth-major and
+ * zero-padded.
+ */
+template <typename Scalar>
+struct reduced_gemm_traits {
+#ifdef EIGEN_VECTORIZE_AVX
+  typedef typename packet_traits<float>::type FloatPacket;
+  enum { PacketSize = unpacket_traits<FloatPacket>::size };
+  typedef typename find_packet_by_size<Scalar, PacketSize>::type Packet;
+  static EIGEN_STRONG_INLINE FloatPacket load(const Scalar* a) { return pcast<Packet, FloatPacket>(ploadu<Packet>(a)); }
+#else
+  typedef float FloatPacket;
+  enum { PacketSize = 1 };
+  static EIGEN_STRONG_INLINE FloatPacket load(const Scalar* a) { return static_cast<float>(*a); }
+#endif
+  // 2 x Nr float accumulators, plus the lhs and rhs packets.
+  enum { Mr = 2 * PacketSize, Nr = EIGEN_ARCH_DEFAULT_NUMBER_OF_REGISTERS >= 32 ? 8 : 4 };
+};
+
+template <typename Scalar, typename Index, typename DataMapper>
+void reduced_gemm_pack_lhs(Scalar* blockA, const DataMapper& lhs, Index depth, Index rows) {
+  const Index Mr = reduced_gemm_traits<Scalar>::Mr;
+  for (Index i = 0; i < rows; i += Mr) {
+    const Index actual_rows = numext::mini<Index>(Mr, rows - i);
+    for (Index k = 0; k < depth; ++k) {
+      for (Index r = 0; r < actual_rows; ++r) *blockA++ = lhs(i + r, k);
+      for (Index r = actual_rows; r < Mr; ++r) *blockA++ = Scalar(0);
+    }
+  }
+}
+
+template <typename Scalar, typename Index, typename DataMapper>
+void reduced_gemm_pack_rhs(Scalar* blockB, const DataMapper& rhs, Index depth, Index cols) {
+  const Index Nr = reduced_gemm_traits<Scalar>::Nr;
+  for (Index j = 0; j < cols; j += Nr) {
+    const Index actual_cols = numext::mini<Index>(Nr, cols - j);
+    for (Index k = 0; k < depth; ++k) {
+      for (Index c = 0; c < actual_cols; ++c) *blockB++ = rhs(k, j + c);
+      for (Index c = actual_cols; c < Nr; ++c) *blockB++ = Scalar(0);
+    }
+  }
+}
+
+// Computes the Mr x Nr column-major tile acc = A' * B' of a packed lhs panel
+// and of a rhs panel already converted to float.
+template <typename Scalar, typename Index>
+EIGEN_DONT_INLINE void reduced_gemm_micro_kernel(const Scalar* a, const float* b, Index depth, float* acc) {
+  typedef reduced_gemm_traits<Scalar> Traits;
+  typedef typename Traits::FloatPacket FloatPacket;
+  const Index PacketSize = Traits::PacketSize, Mr = Traits::Mr, Nr = Traits::Nr;
+
+  FloatPacket c0[Traits::Nr], c1[Traits::Nr];
+  EIGEN_UNROLL_LOOP
+  for (Index c = 0; c < Nr; ++c) c0[c] = c1[c] = pset1<FloatPacket>(0.f);
+  for (Index k = 0; k < depth; ++k) {
+    const FloatPacket a0 = Traits::load(a);
+    const FloatPacket a1 = Traits::load(a + PacketSize);
+    EIGEN_UNROLL_LOOP
+    for (Index c = 0; c < Nr; ++c) {
+      const FloatPacket bc = pset1<FloatPacket>(b[c]);
+      c0[c] = pmadd(a0, bc, c0[c]);
+      c1[c] = pmadd(a1, bc, c1[c]);
+    }
+    a += Mr;
+    b += Nr;
+  }
+  EIGEN_UNROLL_LOOP
+  for (Index c = 0; c < Nr; ++c) {
+    pstoreu(acc + c * Mr, c0[c]);
+    pstoreu(acc + c * Mr + PacketSize, c1[c]);
+  }
+}
+
+template <typename Index, typename Scalar, int LhsStorageOrder, int RhsStorageOrder, int ResInnerStride>
+struct reduced_general_matrix_matrix_product {
+  typedef gebp_traits<Scalar, Scalar> Traits;
+
+  static void run(Index rows, Index cols, Index depth, const Scalar* lhs_, Index lhsStride, const Scalar* rhs_,
+                  Index rhsStride, Scalar* res_, Index resIncr, Index resStride, Scalar alpha,
+                  level3_blocking<Scalar, Scalar>& blocking, GemmParallelInfo<Index>* info = 0) {
+    run(rows, cols, depth, lhs_, lhsStride, rhs_, rhsStride, res_, resIncr, resStride, alpha, blocking, info,
+        gemm_no_epilogue());
+  }
+
+  template <typename Epilogue>
+  static void run(Index rows, Index cols, Index depth, const Scalar* lhs_, Index lhsStride, const Scalar* rhs_,
+                  Index rhsStride, Scalar* res_, Index resIncr, Index resStride, Scalar alpha,
+                  level3_blocking<Scalar, Scalar>& blocking, GemmParallelInfo<Index>* /*info*/,
+                  const Epilogue& epilogue) {
+    typedef const_blas_data_mapper<Scalar, Index, LhsStorageOrder> LhsMapper;
+    typedef const_blas_data_mapper<Scalar, Index, RhsStorageOrder> RhsMapper;
+    typedef blas_data_mapper<Scalar, Index, ColMajor, Unaligned, ResInnerStride> ResMapper;
+    LhsMapper lhs(lhs_, lhsStride);
+    RhsMapper rhs(rhs_, rhsStride);
+    ResMapper res(res_, resStride, resIncr);
+
+    const Index Mr = reduced_gemm_traits<Scalar>::Mr, Nr = reduced_gemm_traits<Scalar>::Nr;
+    // The whole depth is packed at once: shrink the row and column blocks such
+    // that the packed panels keep the size chosen by the blocking heuristic.
+    const Index actual_depth = numext::maxi<Index>(depth, 1);
+    const Index mc =
+        numext::mini(rows, numext::maxi<Index>(Mr, blocking.mc() * blocking.kc() / actual_depth / Mr * Mr));
+    const Index nc =
+        numext::mini(cols, numext::maxi<Index>(Nr, blocking.nc() * blocking.kc() / actual_depth / Nr * Nr));
+
+    const std::size_t sizeA = (mc + Mr - 1) / Mr * Mr * depth;
+    const std::size_t sizeB = (nc + Nr - 1) / Nr * Nr * depth;
+    ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, 0);
+    ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, 0);
+    ei_declare_gemm_workspace_variable(float, panelB, std::size_t(Nr * depth), 0);
+    EIGEN_ALIGN_MAX float acc[reduced_gemm_traits<Scalar>::Mr * reduced_gemm_traits<Scalar>::Nr];
+    const float falpha = static_cast<float>(alpha);
+
+    // A single column block is packed once for all the row blocks.
+    const bool pack_rhs_once = nc == cols;
+    if (pack_rhs_once) reduced_gemm_pack_rhs(blockB, rhs, depth, cols);
+
+    for (Index i2 = 0; i2 < rows; i2 += mc) {
+      const Index actual_mc = (std::min)(i2 + mc, rows) - i2;
+      reduced_gemm_pack_lhs(blockA, lhs.getSubMapper(i2, 0), depth, actual_mc);
+      for (Index j2 = 0; j2 < cols; j2 += nc) {
+        const Index actual_nc = (std::min)(j2 + nc, cols) - j2;
+        if (!pack_rhs_once) reduced_gemm_pack_rhs(blockB, rhs.getSubMapper(0, j2), depth, actual_nc);
+        for (Index j = 0; j < actual_nc; j += Nr) {
+          const Index actual_nr = (std::min)(Nr, actual_nc - j);
+          // The rhs panel is small and reused by all the lhs panels, convert
+          // it once.
+          const Scalar* b = blockB + j * depth;
+          for (Index k = 0; k < Nr * depth; ++k) panelB[k] = static_cast<float>(b[k]);
+          for (Index i = 0; i < actual_mc; i += Mr) {
+            const Index actual_mr = (std::min)(Mr, actual_mc - i);
+            reduced_gemm_micro_kernel(blockA + i * depth, panelB, depth, acc);
+            for (Index c = 0; c < actual_nr; ++c) {
+              for (Index r = 0; r < actual_mr; ++r) {
+                Scalar& dst = res(i2 + i + r, j2 + j + c);
+                dst = Scalar(static_cast<float>(dst) + falpha * acc[c * Mr + r]);
+              }
+            }
+          }
+        }
+        // The depth is not blocked: the block of the result is complete.
+        epilogue.template apply<ColMajor>(res_ + i2 * resIncr + j2 * resStride, resIncr, resStride, i2, j2, actual_mc,
+                                          actual_nc);
+      }
+    }
+  }
+};
+
+/* Dispatches the col-major bfloat16 and half products to the float
+ * accumulating kernel. The row-major ones are transposed by the generic
+ * specialization. Threads of a parallel product work on disjoint column blocks
+ * and pack their own lhs.
+ *
+ * The Power kernels already accumulate bfloat16 products in float, and the
+ * ARM half kernel uses the native half precision FMA, so these targets keep
+ * the generic path.
+ */
+#if !defined(EIGEN_VECTORIZE_ALTIVEC) && !defined(EIGEN_VECTORIZE_VSX)
+template <typename Index, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder, bool ConjugateRhs,
+          int ResInnerStride>
+struct general_matrix_matrix_product<Index, bfloat16, LhsStorageOrder, ConjugateLhs, bfloat16, RhsStorageOrder,
+                                     ConjugateRhs, ColMajor, ResInnerStride>
+    : reduced_general_matrix_matrix_product<Index, bfloat16, LhsStorageOrder, RhsStorageOrder, ResInnerStride> {};
+#endif
+
+#if EIGEN_ARCH_ARM64 && EIGEN_COMP_CLANG && defined(EIGEN_HAS_ARM64_FP16_VECTOR_ARITHMETIC) && \
+    EIGEN_HAS_ARM64_FP16_VECTOR_ARITHMETIC
+#define EIGEN_REDUCED_GEMM_NATIVE_HALF 1
+#else
+#define EIGEN_REDUCED_GEMM_NATIVE_HALF 0
+#endif
+
+#if !EIGEN_REDUCED_GEMM_NATIVE_HALF
+template <typename Index, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder, bool ConjugateRhs,
+          int ResInnerStride>
+struct general_matrix_matrix_product<Index, half, LhsStorageOrder, ConjugateLhs, half, RhsStorageOrder, ConjugateRhs,
+                                     ColMajor, ResInnerStride>
+    : reduced_general_matrix_matrix_product<Index, half, LhsStorageOrder, RhsStorageOrder, ResInnerStride> {};
+#endif
+
+#undef EIGEN_REDUCED_GEMM_NATIVE_HALF
+
+}  // namespace internal
+
+}  // namespace Eigen
+
+#endif  // EIGEN_REDUCED_PRECISION_MATRIX_MATRIX_H
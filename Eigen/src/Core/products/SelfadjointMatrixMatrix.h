@@ -315,8 +315,8 @@ product_selfadjoint_matrix<Scalar, Index, LhsStorageOrder, true, ConjugateLhs, R
   kc = (std::min)(kc, mc);
   std::size_t sizeA = kc * mc;
   std::size_t sizeB = kc * cols;
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockA, sizeA, blocking.blockA());
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, blocking.blockB());
+  ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, blocking.blockA());
+  ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, blocking.blockB());
 
   gebp_kernel<Scalar, Scalar, Index, ResMapper, Traits::mr, Traits::nr, ConjugateLhs, ConjugateRhs> gebp_kernel;
   symm_pack_lhs<Scalar, Index, Traits::mr, Traits::LhsProgress, LhsStorageOrder> pack_lhs;
@@ -394,8 +394,8 @@ product_selfadjoint_matrix<Scalar, Index, LhsStorageOrder, false, ConjugateLhs,
   Index mc = (std::min)(rows, blocking.mc());  // cache block size along the M direction
   std::size_t sizeA = kc * mc;
   std::size_t sizeB = kc * cols;
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockA, sizeA, blocking.blockA());
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, blocking.blockB());
+  ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, blocking.blockA());
+  ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, blocking.blockB());
 
   gebp_kernel<Scalar, Scalar, Index, ResMapper, Traits::mr, Traits::nr, ConjugateLhs, ConjugateRhs> gebp_kernel;
   gemm_pack_lhs<Scalar, Index, LhsMapper, Traits::mr, Traits::LhsProgress, typename Traits::LhsPacket4Packing,
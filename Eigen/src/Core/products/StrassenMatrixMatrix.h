@@ -0,0 +1,288 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_STRASSEN_MATRIX_MATRIX_H
+#define EIGEN_STRASSEN_MATRIX_MATRIX_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+#ifndef EIGEN_GEMM_STRASSEN_THRESHOLD
+// 0 == disabled
+#define EIGEN_GEMM_STRASSEN_THRESHOLD 0
+#endif
+
+namespace Eigen {
+
+namespace internal {
+
+inline std::atomic<Index>& gemm_strassen_threshold() {
+  static std::atomic<Index> value(EIGEN_GEMM_STRASSEN_THRESHOLD);
+  return value;
+}
+
+// Strassen-Winograd is only used for the float, double and complex products.
+template <typename LhsScalar, typename RhsScalar>
+struct strassen_gemm_scalar {
+  typedef typename NumTraits<LhsScalar>::Real RealScalar;
+  enum {
+    value = is_same<LhsScalar, RhsScalar>::value &&
+            (is_same<RealScalar, float>::value || is_same<RealScalar, double>::value)
+  };
+};
+
+// Block of a possibly row-major and conjugated operand.
+template <typename Scalar, typename Index, int StorageOrder, bool Conjugate>
+struct strassen_operand {
+  typedef Map<const Matrix<Scalar, Dynamic, Dynamic, StorageOrder>, 0, OuterStride<> > MapType;
+
+  strassen_operand(const Scalar* data_, Index stride_) : data(data_), stride(stride_) {}
+
+  strassen_operand block(Index i, Index j) const {
+    return strassen_operand(StorageOrder == ColMajor ? data + i + j * stride : data + i * stride + j, stride);
+  }
+  MapType map(Index rows, Index cols) const { return MapType(data, rows, cols, OuterStride<>(stride)); }
+
+  const Scalar* data;
+  Index stride;
+};
+
+/* Strassen-Winograd product C = alpha * op(A) * op(B) of a m x k times k x n
+ * product, for a col-major C.
+ *
+ * Each level splits the three dimensions in two, and computes the four blocks
+ * of C from 7 products of half size instead of 8, at the cost of 15 additions
+ * of blocks. The recursion stops when a dimension is below the threshold, and
+ * the remaining products are computed by the blocked GEMM kernel. Odd
+ * dimensions are handled by peeling the last row, column, or depth slice,
+ * whose products are computed by the GEMM kernel too.
+ *
+ * The sequential levels follow the schedule of Boyer, Dumas, Pernet and Zhou,
+ * "Memory efficient scheduling of Strassen-Winograd's matrix multiplication
+ * algorithm" (ISSAC 2009), which only needs two temporary blocks per level,
+ * the other intermediate results being stored in C. The recursion itself is
+ * sequential: the products at its leaves are large, and are computed by the
+ * parallel GEMM kernel, which keeps all the threads busy whatever their number.
+ */
+template <typename Scalar, typename Index>
+struct strassen_gemm {
+  typedef strassen_operand<Scalar, Index, ColMajor, false> Temp;
+  typedef Map<Matrix<Scalar, Dynamic, Dynamic>, 0, OuterStride<> > ResMap;
+
+  static bool split(Index m, Index n, Index k, Index threshold) {
+    return threshold > 0 && m >= threshold && n >= threshold && k >= threshold;
+  }
+
+  // Number of scalars of workspace needed by run().
+  static Index workspace(Index m, Index n, Index k, Index threshold) {
+    if (!split(m, n, k, threshold)) return 0;
+    const Index m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    return m2 * numext::maxi(k2, n2) + k2 * n2 + workspace(m2, n2, k2, threshold);
+  }
+
+  // C = alpha * op(A) * op(B) with the, possibly parallel, GEMM kernel, or C += ... if accumulate is true.
+  template <int LhsOrder, bool ConjLhs, int RhsOrder, bool ConjRhs>
+  static void classic(Index m, Index n, Index k, const strassen_operand<Scalar, Index, LhsOrder, ConjLhs>& A,
+                      const strassen_operand<Scalar, Index, RhsOrder, ConjRhs>& B, Scalar* C, Index ldc, Scalar alpha,
+                      bool accumulate) {
+    typedef typename strassen_operand<Scalar, Index, LhsOrder, ConjLhs>::MapType LhsMap;
+    typedef typename strassen_operand<Scalar, Index, RhsOrder, ConjRhs>::MapType RhsMap;
+    typedef gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic> BlockingType;
+    typedef gemm_functor<Scalar, Index,
+                         general_matrix_matrix_product<Index, Scalar, LhsOrder, ConjLhs, Scalar, RhsOrder, ConjRhs,
+                                                       ColMajor, 1>,
+                         LhsMap, RhsMap, ResMap, BlockingType>
+        GemmFunctor;
+    if (m == 0 || n == 0) return;
+    ResMap res(C, m, n, OuterStride<>(ldc));
+    if (!accumulate) res.setZero();
+    if (k == 0) return;
+    const LhsMap lhs = A.map(m, k);
+    const RhsMap rhs = B.map(k, n);
+    BlockingType blocking(m, n, k, 1, true);
+    parallelize_gemm<true>(GemmFunctor(lhs, rhs, res, alpha, blocking), m, n, k, false);
+  }
+
+  // dst = op(a) + op(b) or op(a) - op(b), the temporaries being never conjugated.
+  template <bool ConjA, bool ConjB, typename A, typename B>
+  static void add(Scalar* dst, Index rows, Index cols, const A& a, const B& b, bool subtract) {
+    ResMap d(dst, rows, cols, OuterStride<>(rows));
+    const typename A::MapType x = a.map(rows, cols);
+    const typename B::MapType y = b.map(rows, cols);
+    if (subtract) {
+      if (ConjA && ConjB)
+        d = (x - y).conjugate();
+      else if (ConjA)
+        d = x.conjugate() - y;
+      else if (ConjB)
+        d = x - y.conjugate();
+      else
+        d = x - y;
+    } else {
+      if (ConjA && ConjB)
+        d = (x + y).conjugate();
+      else if (ConjA)
+        d = x.conjugate() + y;
+      else if (ConjB)
+        d = x + y.conjugate();
+      else
+        d = x + y;
+    }
+  }
+
+  // Peels the odd last row, column and depth slice off the Strassen part, which is computed by compute_even.
+  template <int LhsOrder, bool ConjLhs, int RhsOrder, bool ConjRhs, typename EvenProduct>
+  static void peel(Index m, Index n, Index k, const strassen_operand<Scalar, Index, LhsOrder, ConjLhs>& A,
+                   const strassen_operand<Scalar, Index, RhsOrder, ConjRhs>& B, Scalar* C, Index ldc, Scalar alpha,
+                   const EvenProduct& compute_even) {
+    const Index me = m / 2 * 2, ne = n / 2 * 2, ke = k / 2 * 2;
+    compute_even();
+    if (k > ke) classic(me, ne, k - ke, A.block(0, ke), B.block(ke, 0), C, ldc, alpha, true);
+    if (n > ne) classic(me, n - ne, k, A, B.block(0, ne), C + ne * ldc, ldc, alpha, false);
+    if (m > me) classic(m - me, n, k, A.block(me, 0), B, C + me, ldc, alpha, false);
+  }
+
+  template <int LhsOrder, bool ConjLhs, int RhsOrder, bool ConjRhs>
+  static void run(Index m, Index n, Index k, const strassen_operand<Scalar, Index, LhsOrder, ConjLhs>& A,
+                  const strassen_operand<Scalar, Index, RhsOrder, ConjRhs>& B, Scalar* C, Index ldc, Scalar alpha,
+                  Index threshold, Scalar* work) {
+    if (!split(m, n, k, threshold)) {
+      classic(m, n, k, A, B, C, ldc, alpha, false);
+      return;
+    }
+    peel(m, n, k, A, B, C, ldc, alpha,
+         [&]() { run_even(m / 2, n / 2, k / 2, A, B, C, ldc, alpha, threshold, work); });
+  }
+
+ private:
+  // From P1, P3, P6 in c12, P7 in c21, and P5 in c22, computes U5 = P1 + P6 + P5 + P3 in c12, U3 = P1 + P6 + P7 in
+  // c21, and U7 = U3 + P5 in c22, column by column to read each block only once.
+  static void combine(const ResMap& p1, const ResMap& p3, ResMap& c12, ResMap& c21, ResMap& c22) {
+    for (Index j = 0; j < c12.cols(); ++j) {
+      c12.col(j) += p1.col(j);                // U2 = P1 + P6
+      c21.col(j) += c12.col(j);               // U3 = U2 + P7
+      c12.col(j) += c22.col(j) + p3.col(j);  // U5 = U2 + P5 + P3
+      c22.col(j) += c21.col(j);               // U7 = U3 + P5
+    }
+  }
+
+  template <int LhsOrder, bool ConjLhs, int RhsOrder, bool ConjRhs>
+  static void run_even(Index m2, Index n2, Index k2, const strassen_operand<Scalar, Index, LhsOrder, ConjLhs>& A,
+                       const strassen_operand<Scalar, Index, RhsOrder, ConjRhs>& B, Scalar* C, Index ldc,
+                       Scalar alpha, Index threshold, Scalar* work) {
+    typedef strassen_operand<Scalar, Index, LhsOrder, ConjLhs> LhsOperand;
+    typedef strassen_operand<Scalar, Index, RhsOrder, ConjRhs> RhsOperand;
+    const LhsOperand A11 = A, A12 = A.block(0, k2), A21 = A.block(m2, 0), A22 = A.block(m2, k2);
+    const RhsOperand B11 = B, B12 = B.block(0, n2), B21 = B.block(k2, 0), B22 = B.block(k2, n2);
+    Scalar* C11 = C;
+    Scalar* C12 = C + n2 * ldc;
+    Scalar* C21 = C + m2;
+    Scalar* C22 = C + m2 + n2 * ldc;
+    Scalar* X = work;
+    Scalar* Y = X + m2 * numext::maxi(k2, n2);
+    Scalar* next = Y + k2 * n2;
+    const Temp TX(X, m2), TY(Y, k2);
+    ResMap c11(C11, m2, n2, OuterStride<>(ldc)), c12(C12, m2, n2, OuterStride<>(ldc));
+    ResMap c21(C21, m2, n2, OuterStride<>(ldc)), c22(C22, m2, n2, OuterStride<>(ldc));
+
+    add<ConjLhs, ConjLhs>(X, m2, k2, A11, A21, true);  // S3 = A11 - A21
+    add<ConjRhs, ConjRhs>(Y, k2, n2, B22, B12, true);  // T3 = B22 - B12
+    run(m2, n2, k2, TX, TY, C21, ldc, alpha, threshold, next);  // P7 = S3 T3
+    add<ConjLhs, ConjLhs>(X, m2, k2, A21, A22, false);  // S1 = A21 + A22
+    add<ConjRhs, ConjRhs>(Y, k2, n2, B12, B11, true);   // T1 = B12 - B11
+    run(m2, n2, k2, TX, TY, C22, ldc, alpha, threshold, next);  // P5 = S1 T1
+    add<false, ConjLhs>(X, m2, k2, TX, A11, true);              // S2 = S1 - A11
+    add<ConjRhs, false>(Y, k2, n2, B22, TY, true);              // T2 = B22 - T1
+    run(m2, n2, k2, TX, TY, C12, ldc, alpha, threshold, next);  // P6 = S2 T2
+    add<ConjLhs, false>(X, m2, k2, A12, TX, true);              // S4 = A12 - S2
+    run(m2, n2, k2, TX, B22, C11, ldc, alpha, threshold, next);  // P3 = S4 B22
+    run(m2, n2, k2, A11, B11, X, m2, alpha, threshold, next);    // P1 = A11 B11
+    ResMap p1(X, m2, n2, OuterStride<>(m2));
+    combine(p1, c11, c12, c21, c22);
+    add<false, ConjRhs>(Y, k2, n2, TY, B21, true);               // T4 = T2 - B21
+    run(m2, n2, k2, A22, TY, C11, ldc, alpha, threshold, next);  // P4 = A22 T4
+    c21 -= c11;                                                  // U6 = U3 - P4
+    run(m2, n2, k2, A12, B21, C11, ldc, alpha, threshold, next);  // P2 = A12 B21
+    c11 += p1;                                                    // U1 = P1 + P2
+  }
+};
+
+/* Entry point of the products of generic_product_impl<..., GemmProduct>,
+ * dst = alpha * lhs * rhs if overwrite is true, as for "dst = lhs * rhs", and
+ * dst += alpha * lhs * rhs otherwise. Returns false, without doing anything,
+ * when the product is not large enough for Strassen-Winograd. A row-major
+ * destination is handled as the transposed product.
+ */
+template <typename Index, typename Scalar, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder,
+          bool ConjugateRhs, int ResStorageOrder>
+struct strassen_matrix_matrix_product {
+  static bool run(Index rows, Index cols, Index depth, const Scalar* lhs, Index lhsStride, const Scalar* rhs,
+                  Index rhsStride, Scalar* res, Index resStride, Scalar alpha, bool overwrite) {
+    return strassen_matrix_matrix_product<Index, Scalar, RhsStorageOrder == RowMajor ? ColMajor : RowMajor,
+                                          ConjugateRhs, LhsStorageOrder == RowMajor ? ColMajor : RowMajor,
+                                          ConjugateLhs, ColMajor>::run(cols, rows, depth, rhs, rhsStride, lhs,
+                                                                       lhsStride, res, resStride, alpha, overwrite);
+  }
+};
+
+template <typename Index, typename Scalar, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder,
+          bool ConjugateRhs>
+struct strassen_matrix_matrix_product<Index, Scalar, LhsStorageOrder, ConjugateLhs, RhsStorageOrder, ConjugateRhs,
+                                      ColMajor> {
+  typedef strassen_gemm<Scalar, Index> Strassen;
+
+  static bool run(Index rows, Index cols, Index depth, const Scalar* lhs, Index lhsStride, const Scalar* rhs,
+                  Index rhsStride, Scalar* res, Index resStride, Scalar alpha, bool overwrite) {
+    const Index threshold = gemm_strassen_threshold().load(std::memory_order_relaxed);
+    if (!Strassen::split(rows, cols, depth, threshold)) return false;
+
+    typedef typename Strassen::ResMap ResMap;
+    // The recursion overwrites its destination: when accumulating, compute the
+    // product in a temporary, and add it to res.
+    const Index size = (overwrite ? 0 : rows * cols) + Strassen::workspace(rows, cols, depth, threshold);
+    ei_declare_aligned_stack_constructed_variable(Scalar, work, size, 0);
+    Scalar* tmp = overwrite ? res : work;
+    const Index ldt = overwrite ? resStride : rows;
+    Scalar* recursion_work = overwrite ? work : work + rows * cols;
+    const strassen_operand<Scalar, Index, LhsStorageOrder, ConjugateLhs> A(lhs, lhsStride);
+    const strassen_operand<Scalar, Index, RhsStorageOrder, ConjugateRhs> B(rhs, rhsStride);
+    Strassen::run(rows, cols, depth, A, B, tmp, ldt, alpha, threshold, recursion_work);
+    if (!overwrite) ResMap(res, rows, cols, OuterStride<>(resStride)) += ResMap(tmp, rows, cols, OuterStride<>(rows));
+    return true;
+  }
+};
+
+}  // end namespace internal
+
+/** \returns the size from which the matrix-matrix products use the Strassen-Winograd algorithm, 0 if disabled.
+ * \sa setGemmStrassenThreshold() */
+inline Index gemmStrassenThreshold() { return internal::gemm_strassen_threshold().load(std::memory_order_relaxed); }
+
+/** Enables the Strassen-Winograd algorithm for the float, double and complex matrix-matrix products whose three
+ * dimensions are at least \a threshold, or disables it if \a threshold is 0. The default is given by
+ * \c EIGEN_GEMM_STRASSEN_THRESHOLD, and is 0.
+ *
+ * Each level of recursion replaces 8 products of half size by 7, down to products with a dimension below
+ * \a threshold, which are computed by the regular kernel. Values of 1000 to 4000 are typical, depending on the
+ * scalar type and on the hardware. The result is slightly less accurate than with the regular kernel, in the sense
+ * of a normwise rather than componentwise error bound.
+ *
+ * The recursion uses a workspace of at most a third of the total size of the two operands and of the result, that is
+ * two thirds of the size of the result for square matrices, plus a temporary of the size of the result when the
+ * product is added to the destination, as in "dst += lhs * rhs". The recursion is sequential, and the products at
+ * its leaves use all the threads given by setNbThreads(). Epilogues of MatrixBase::productWithEpilogue() are applied
+ * to the whole result at the end.
+ *
+ * \sa gemmStrassenThreshold() */
+inline void setGemmStrassenThreshold(Index threshold) {
+  eigen_assert(threshold >= 0);
+  internal::gemm_strassen_threshold().store(threshold, std::memory_order_relaxed);
+}
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_STRASSEN_MATRIX_MATRIX_H
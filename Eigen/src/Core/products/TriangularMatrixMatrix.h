@@ -110,8 +110,8 @@ EIGEN_DONT_INLINE void product_triangular_matrix_matrix<
   std::size_t sizeA = kc * mc;
   std::size_t sizeB = kc * cols;
 
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockA, sizeA, blocking.blockA());
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, blocking.blockB());
+  ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, blocking.blockA());
+  ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, blocking.blockB());
 
   // To work around an "error: member reference base type 'Matrix<...>
   // (Eigen::internal::constructor_without_unaligned_array_assert (*)())' is
@@ -242,8 +242,8 @@ EIGEN_DONT_INLINE void product_triangular_matrix_matrix<
   std::size_t sizeA = kc * mc;
   std::size_t sizeB = kc * cols + EIGEN_MAX_ALIGN_BYTES / sizeof(Scalar);
 
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockA, sizeA, blocking.blockA());
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, blocking.blockB());
+  ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, blocking.blockA());
+  ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, blocking.blockB());
 
   internal::constructor_without_unaligned_array_assert a;
   Matrix<Scalar, SmallPanelWidth, SmallPanelWidth, RhsStorageOrder> triangularBuffer(a);
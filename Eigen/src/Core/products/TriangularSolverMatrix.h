@@ -171,8 +171,8 @@ EIGEN_DONT_INLINE void triangular_solve_matrix<Scalar, Index, OnTheLeft, Mode, C
   std::size_t sizeA = kc * mc;
   std::size_t sizeB = kc * cols;
 
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockA, sizeA, blocking.blockA());
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, blocking.blockB());
+  ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, blocking.blockA());
+  ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, blocking.blockB());
 
   gebp_kernel<Scalar, Scalar, Index, OtherMapper, Traits::mr, Traits::nr, Conjugate, false> gebp_kernel;
   gemm_pack_lhs<Scalar, Index, TriMapper, Traits::mr, Traits::LhsProgress, typename Traits::LhsPacket4Packing,
@@ -306,8 +306,8 @@ EIGEN_DONT_INLINE void triangular_solve_matrix<Scalar, Index, OnTheRight, Mode,
   std::size_t sizeA = kc * mc;
   std::size_t sizeB = kc * size;
 
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockA, sizeA, blocking.blockA());
-  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, blocking.blockB());
+  ei_declare_gemm_workspace_variable(Scalar, blockA, sizeA, blocking.blockA());
+  ei_declare_gemm_workspace_variable(Scalar, blockB, sizeB, blocking.blockB());
 
   gebp_kernel<Scalar, Scalar, Index, LhsMapper, Traits::mr, Traits::nr, false, Conjugate> gebp_kernel;
   gemm_pack_rhs<Scalar, Index, RhsMapper, Traits::nr, RhsStorageOrder> pack_rhs;
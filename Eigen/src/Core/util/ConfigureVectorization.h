@@ -227,6 +227,9 @@
 #ifndef EIGEN_USE_SYCL
 #define EIGEN_VECTORIZE_AVX2
 #define EIGEN_VECTORIZE_AVX
+#ifdef __AVXVNNI__
+#define EIGEN_VECTORIZE_AVXVNNI
+#endif
 #endif
 #define EIGEN_VECTORIZE_SSE3
 #define EIGEN_VECTORIZE_SSSE3
@@ -269,6 +272,9 @@
 #ifdef __AVX512VL__
 #define EIGEN_VECTORIZE_AVX512VL
 #endif
+#ifdef __AVX512VNNI__
+#define EIGEN_VECTORIZE_AVX512VNNI
+#endif
 #ifdef __AVX512FP16__
 #ifdef __AVX512VL__
 #define EIGEN_VECTORIZE_AVX512FP16
@@ -558,6 +558,12 @@ struct TriangularShape {
 struct SelfAdjointShape {
   static std::string debugName() { return "SelfAdjointShape"; }
 };
+struct PackedTriangularShape {
+  static std::string debugName() { return "PackedTriangularShape"; }
+};
+struct PackedSelfAdjointShape {
+  static std::string debugName() { return "PackedSelfAdjointShape"; }
+};
 struct PermutationShape {
   static std::string debugName() { return "PermutationShape"; }
 };
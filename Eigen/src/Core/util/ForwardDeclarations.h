@@ -102,6 +102,7 @@ template <typename MatrixType>
 class Conjugate;
 template <typename NullaryOp, typename MatrixType>
 class CwiseNullaryOp;
+class Philox;
 template <typename UnaryOp, typename MatrixType>
 class CwiseUnaryOp;
 template <typename BinaryOp, typename Lhs, typename Rhs>
@@ -112,6 +113,8 @@ template <typename Decomposition, typename Rhstype>
 class Solve;
 template <typename XprType>
 class Inverse;
+template <typename Lhs, typename Rhs, typename Epilogue>
+class EpilogueProduct;
 
 template <typename Lhs, typename Rhs, int Option = DefaultProduct>
 class Product;
@@ -171,6 +174,10 @@ template <typename MatrixType, unsigned int Mode>
 class TriangularView;
 template <typename MatrixType, unsigned int Mode>
 class SelfAdjointView;
+template <typename Scalar, int UpLo = Lower>
+class PackedTriangularMatrix;
+template <typename Scalar, int UpLo = Lower>
+class PackedSelfAdjointMatrix;
 template <typename MatrixType>
 class SparseView;
 template <typename ExpressionType>
@@ -305,6 +312,8 @@ template <typename Scalar, typename NewType>
 struct scalar_cast_op;
 template <typename Scalar>
 struct scalar_random_op;
+template <typename Scalar, bool RowMajor>
+struct scalar_philox_random_op;
 template <typename Scalar>
 struct scalar_constant_op;
 template <typename Scalar>
@@ -441,6 +450,10 @@ template <typename MatrixType, int UpLo = Lower>
 class LLT;
 template <typename MatrixType, int UpLo = Lower>
 class LDLT;
+template <typename MatrixType>
+class PackedLLT;
+template <typename MatrixType>
+class PackedLDLT;
 template <typename VectorsType, typename CoeffsType, int Side = OnTheLeft>
 class HouseholderSequence;
 template <typename Scalar>
@@ -0,0 +1,387 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_INSTRUMENTATION_H
+#define EIGEN_INSTRUMENTATION_H
+
+// IWYU pragma: private
+#include "../InternalHeaderCheck.h"
+
+/** \internal
+ *
+ * Optional instrumentation of the allocations and of the main kernels, enabled by defining EIGEN_INSTRUMENTATION.
+ * Otherwise, the macros below expand to no-op statements and the instrumentation has no cost.
+ *
+ * - EIGEN_INSTRUMENT_KERNEL(NAME, FLOPS, BYTES) times the rest of the enclosing scope as a call of the kernel NAME,
+ *   a string literal, which executes FLOPS floating point operations and accesses BYTES bytes of memory.
+ * - EIGEN_INSTRUMENT_ALLOCATION(BYTES) and EIGEN_INSTRUMENT_DEALLOCATION() record a heap allocation or deallocation,
+ *   attributed to the innermost kernel or region of the calling thread.
+ *
+ * EIGEN_INSTRUMENT_REGION(NAME) is the public counterpart of EIGEN_INSTRUMENT_KERNEL, to time and attribute the
+ * allocations of a scope of the application.
+ */
+#if defined(EIGEN_INSTRUMENTATION) && !defined(EIGEN_GPU_COMPILE_PHASE)
+
+// The innermost kernel of each thread is kept in a thread_local stack, which a shared variable cannot replace.
+#ifdef EIGEN_AVOID_THREAD_LOCAL
+#error EIGEN_INSTRUMENTATION requires thread_local storage and cannot be used with EIGEN_AVOID_THREAD_LOCAL
+#endif
+
+#define EIGEN_INSTRUMENT_KERNEL(NAME, FLOPS, BYTES) \
+  Eigen::internal::instrumentation_scope EIGEN_CAT(eigen_instrumentation_scope_, __LINE__)(NAME, FLOPS, BYTES)
+#define EIGEN_INSTRUMENT_REGION(NAME) EIGEN_INSTRUMENT_KERNEL(NAME, 0, 0)
+#define EIGEN_INSTRUMENT_ALLOCATION(BYTES) Eigen::internal::instrumentation::instance().allocation(BYTES)
+#define EIGEN_INSTRUMENT_DEALLOCATION() Eigen::internal::instrumentation::instance().deallocation()
+
+namespace Eigen {
+
+/** \ingroup Core_Module
+ * Kind of an InstrumentationEvent. */
+enum InstrumentationEventKind { InstrumentedKernel, InstrumentedAllocation, InstrumentedDeallocation };
+
+/** \ingroup Core_Module
+ *
+ * \brief Event passed to the callback of setInstrumentationCallback()
+ *
+ * For a kernel, \c start and \c duration are in nanoseconds since the first event. For an allocation, \c bytes is
+ * the allocated size and \c name is the innermost kernel or region of the calling thread, or "(none)". For a
+ * deallocation, \c bytes is 0.
+ */
+struct InstrumentationEvent {
+  InstrumentationEventKind kind;
+  const char* name;
+  int thread;
+  long long start;
+  long long duration;
+  double flops;
+  double bytes;
+};
+
+/** \ingroup Core_Module
+ * Callback called for each instrumentation event, see setInstrumentationCallback(). */
+typedef void (*InstrumentationCallback)(const InstrumentationEvent& event, void* data);
+
+namespace internal {
+
+class instrumentation_scope;
+
+class instrumentation : noncopyable {
+ public:
+  struct kernel_stats {
+    std::string name;
+    long long calls;
+    long long nanoseconds;
+    double flops;
+    double bytes;
+    long long allocations;
+    double allocated_bytes;
+  };
+
+  // Never destroyed, since allocations may happen during the destruction of static objects.
+  static instrumentation& instance() {
+    static instrumentation* value = new instrumentation;
+    return *value;
+  }
+
+  static instrumentation_scope*& current_scope() {
+    static thread_local instrumentation_scope* scope = nullptr;
+    return scope;
+  }
+
+  static int thread_index() {
+    static std::atomic<int> next(0);
+    static thread_local int index = next++;
+    return index;
+  }
+
+  long long now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_origin).count();
+  }
+
+  inline void allocation(std::size_t bytes);
+  inline void deallocation();
+
+  void kernel(const char* name, long long start, long long duration, double flops, double bytes) {
+    const InstrumentationEvent event = {InstrumentedKernel, name, thread_index(), start, duration, flops, bytes};
+    std::lock_guard<std::mutex> lock(m_mutex);
+    kernel_stats& stats = find(name);
+    ++stats.calls;
+    stats.nanoseconds += duration;
+    stats.flops += flops;
+    stats.bytes += bytes;
+    record(event);
+  }
+
+  void set_callback(InstrumentationCallback callback, void* data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callback = callback;
+    m_callback_data = data;
+  }
+
+  void set_tracing(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tracing = enabled;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.clear();
+    m_trace.clear();
+    m_allocations = 0;
+    m_deallocations = 0;
+    m_allocated_bytes = 0;
+  }
+
+  std::vector<kernel_stats> stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+  std::vector<InstrumentationEvent> trace() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_trace;
+  }
+
+  void totals(long long& allocations, long long& deallocations, double& allocated_bytes) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    allocations = m_allocations;
+    deallocations = m_deallocations;
+    allocated_bytes = m_allocated_bytes;
+  }
+
+ private:
+  instrumentation()
+      : m_origin(std::chrono::steady_clock::now()),
+        m_callback(nullptr),
+        m_callback_data(nullptr),
+        m_tracing(false),
+        m_allocations(0),
+        m_deallocations(0),
+        m_allocated_bytes(0) {}
+
+  kernel_stats& find(const char* name) {
+    for (kernel_stats& stats : m_stats)
+      if (stats.name == name) return stats;
+    m_stats.push_back(kernel_stats{name, 0, 0, 0, 0, 0, 0});
+    return m_stats.back();
+  }
+
+  // Called with the mutex locked.
+  void record(const InstrumentationEvent& event) {
+    if (m_tracing) m_trace.push_back(event);
+    if (m_callback != nullptr) m_callback(event, m_callback_data);
+  }
+
+  const std::chrono::steady_clock::time_point m_origin;
+  mutable std::mutex m_mutex;
+  std::vector<kernel_stats> m_stats;
+  std::vector<InstrumentationEvent> m_trace;
+  InstrumentationCallback m_callback;
+  void* m_callback_data;
+  bool m_tracing;
+  long long m_allocations;
+  long long m_deallocations;
+  double m_allocated_bytes;
+
+  // Events raised by the instrumentation itself, e.g., by a callback using Eigen, are not recorded.
+  friend class instrumentation_guard;
+  static bool& busy() {
+    static thread_local bool value = false;
+    return value;
+  }
+};
+
+// Disables the recording of the events of the calling thread while an event is recorded.
+class instrumentation_guard : noncopyable {
+ public:
+  instrumentation_guard() : m_active(!instrumentation::busy()) { instrumentation::busy() = true; }
+  ~instrumentation_guard() {
+    if (m_active) instrumentation::busy() = false;
+  }
+  bool active() const { return m_active; }
+
+ private:
+  bool m_active;
+};
+
+// Times its lifetime as a call of a kernel, and makes the kernel the owner of the allocations of the thread.
+class instrumentation_scope : noncopyable {
+ public:
+  instrumentation_scope(const char* name, double flops, double bytes)
+      : m_name(name),
+        m_flops(flops),
+        m_bytes(bytes),
+        m_previous(instrumentation::current_scope()),
+        m_start(instrumentation::instance().now()) {
+    instrumentation::current_scope() = this;
+  }
+
+  ~instrumentation_scope() {
+    instrumentation::current_scope() = m_previous;
+    instrumentation& instr = instrumentation::instance();
+    const long long end = instr.now();
+    instrumentation_guard guard;
+    if (guard.active()) instr.kernel(m_name, m_start, end - m_start, m_flops, m_bytes);
+  }
+
+  const char* name() const { return m_name; }
+
+ private:
+  const char* m_name;
+  double m_flops;
+  double m_bytes;
+  instrumentation_scope* m_previous;
+  long long m_start;
+};
+
+inline void instrumentation::allocation(std::size_t bytes) {
+  instrumentation_guard guard;
+  if (!guard.active()) return;
+  const instrumentation_scope* scope = current_scope();
+  const char* name = scope != nullptr ? scope->name() : "(none)";
+  const InstrumentationEvent event = {InstrumentedAllocation, name, thread_index(), now(), 0, 0, double(bytes)};
+  std::lock_guard<std::mutex> lock(m_mutex);
+  kernel_stats& stats = find(name);
+  ++stats.allocations;
+  stats.allocated_bytes += double(bytes);
+  ++m_allocations;
+  m_allocated_bytes += double(bytes);
+  record(event);
+}
+
+inline void instrumentation::deallocation() {
+  instrumentation_guard guard;
+  if (!guard.active()) return;
+  const instrumentation_scope* scope = current_scope();
+  const InstrumentationEvent event = {InstrumentedDeallocation, scope != nullptr ? scope->name() : "(none)",
+                                      thread_index(), now(), 0, 0, 0};
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_deallocations;
+  record(event);
+}
+
+// Floating point operations of the LU and QR factorizations of a rows x cols matrix.
+inline double instrumentation_lu_flops(Index rows, Index cols) {
+  const double k = double((std::min)(rows, cols)), m = double((std::max)(rows, cols));
+  return m * k * k - k * k * k / 3;
+}
+
+inline double instrumentation_qr_flops(Index rows, Index cols) { return 2 * instrumentation_lu_flops(rows, cols); }
+
+inline std::string instrumentation_escape(const std::string& s) {
+  std::string result;
+  for (char c : s) {
+    if (c == '"' || c == '\\') result += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20) result += c;
+  }
+  return result;
+}
+
+inline std::string instrumentation_number(double value) {
+  // Integral values up to 2^53 are printed exactly.
+  if (value == double(static_cast<long long>(value)) && value < 9007199254740992.0 && value > -9007199254740992.0)
+    return std::to_string(static_cast<long long>(value));
+  return std::to_string(value);
+}
+
+}  // end namespace internal
+
+/** \ingroup Core_Module
+ * Sets a function called for every kernel call, allocation and deallocation, with \a data as second argument. The
+ * callback is called under a lock, and must not use %Eigen objects which allocate. A null callback removes it.
+ * \note Only available if EIGEN_INSTRUMENTATION is defined.
+ * \sa setInstrumentationTracing() */
+inline void setInstrumentationCallback(InstrumentationCallback callback, void* data = nullptr) {
+  internal::instrumentation::instance().set_callback(callback, data);
+}
+
+/** \ingroup Core_Module
+ * Enables or disables the recording of the events exported by instrumentationChromeTrace(). Disabled by default,
+ * since each event is kept in memory.
+ * \note Only available if EIGEN_INSTRUMENTATION is defined. */
+inline void setInstrumentationTracing(bool enabled) { internal::instrumentation::instance().set_tracing(enabled); }
+
+/** \ingroup Core_Module
+ * Clears the statistics and the recorded events.
+ * \note Only available if EIGEN_INSTRUMENTATION is defined. */
+inline void resetInstrumentation() { internal::instrumentation::instance().reset(); }
+
+/** \ingroup Core_Module
+ * \returns a table of the calls, time, floating point operations, memory traffic and heap allocations of each
+ * instrumented kernel and region since the last reset. Times are inclusive: the time of a factorization includes
+ * the time of its products. Allocations are attributed to the innermost kernel or region.
+ * \note Only available if EIGEN_INSTRUMENTATION is defined. */
+inline std::string instrumentationSummary() {
+  internal::instrumentation_guard guard;
+  const std::vector<internal::instrumentation::kernel_stats> stats = internal::instrumentation::instance().stats();
+  long long allocations, deallocations;
+  double allocated_bytes;
+  internal::instrumentation::instance().totals(allocations, deallocations, allocated_bytes);
+
+  auto column = [](std::string s, std::size_t width) {
+    return s.size() < width ? std::string(width - s.size(), ' ') + s : s;
+  };
+  std::string result = "kernel                            calls      time [ms]    GFLOP/s       GB/s    allocs"
+                       "   alloc [MB]\n";
+  for (const internal::instrumentation::kernel_stats& s : stats) {
+    const double seconds = double(s.nanoseconds) * 1e-9;
+    std::string name = s.name.size() < 28 ? s.name + std::string(28 - s.name.size(), ' ') : s.name;
+    result += name + column(std::to_string(s.calls), 11) + column(std::to_string(seconds * 1e3), 15) +
+              column(seconds > 0 && s.flops > 0 ? std::to_string(s.flops * 1e-9 / seconds) : "-", 11) +
+              column(seconds > 0 && s.bytes > 0 ? std::to_string(s.bytes * 1e-9 / seconds) : "-", 11) +
+              column(std::to_string(s.allocations), 10) + column(std::to_string(s.allocated_bytes / 1048576.0), 13) +
+              "\n";
+  }
+  result += "total: " + std::to_string(allocations) + " allocations (" + std::to_string(allocated_bytes / 1048576.0) +
+            " MB), " + std::to_string(deallocations) + " deallocations\n";
+  return result;
+}
+
+/** \ingroup Core_Module
+ * \returns the events recorded since setInstrumentationTracing(true) in the Chrome trace event format, which can be
+ * loaded in chrome://tracing or Perfetto. Kernels are complete events with their flops and bytes as arguments, and
+ * allocations are instant events.
+ * \note Only available if EIGEN_INSTRUMENTATION is defined. */
+inline std::string instrumentationChromeTrace() {
+  internal::instrumentation_guard guard;
+  const std::vector<InstrumentationEvent> trace = internal::instrumentation::instance().trace();
+  std::string result = "{\"traceEvents\":[";
+  bool first = true;
+  for (const InstrumentationEvent& e : trace) {
+    if (e.kind == InstrumentedDeallocation) continue;
+    result += first ? "\n" : ",\n";
+    first = false;
+    const std::string name = internal::instrumentation_escape(e.name);
+    const std::string ts = internal::instrumentation_number(double(e.start) * 1e-3);
+    const std::string tid = std::to_string(e.thread);
+    if (e.kind == InstrumentedKernel) {
+      result += "{\"name\":\"" + name + "\",\"cat\":\"kernel\",\"ph\":\"X\",\"pid\":0,\"tid\":" + tid +
+                ",\"ts\":" + ts + ",\"dur\":" + internal::instrumentation_number(double(e.duration) * 1e-3) +
+                ",\"args\":{\"flops\":" + internal::instrumentation_number(e.flops) +
+                ",\"bytes\":" + internal::instrumentation_number(e.bytes) + "}}";
+    } else {
+      result += "{\"name\":\"allocation\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":" + tid +
+                ",\"ts\":" + ts + ",\"args\":{\"site\":\"" + name +
+                "\",\"bytes\":" + internal::instrumentation_number(e.bytes) + "}}";
+    }
+  }
+  result += "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return result;
+}
+
+}  // end namespace Eigen
+
+#else
+
+#define EIGEN_INSTRUMENT_KERNEL(NAME, FLOPS, BYTES) (void)0
+#define EIGEN_INSTRUMENT_REGION(NAME) (void)0
+#define EIGEN_INSTRUMENT_ALLOCATION(BYTES) (void)0
+#define EIGEN_INSTRUMENT_DEALLOCATION() (void)0
+
+#endif  // EIGEN_INSTRUMENTATION
+
+#endif  // EIGEN_INSTRUMENTATION_H
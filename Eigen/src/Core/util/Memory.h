@@ -76,6 +76,10 @@
 
 #endif
 
+#ifndef EIGEN_LARGE_BUFFER_THRESHOLD
+#define EIGEN_LARGE_BUFFER_THRESHOLD 0
+#endif
+
 // IWYU pragma: private
 #include "../InternalHeaderCheck.h"
 
@@ -193,13 +197,234 @@ EIGEN_DEVICE_FUNC inline void* handmade_aligned_realloc(void* ptr, std::size_t n
   return aligned;
 }
 
+/*****************************************************************************
+*** Implementation of large buffer allocation                              ***
+*****************************************************************************/
+
+}  // end namespace internal
+
+/** Options of the memory mapping of large buffers, see setLargeBufferOptions(). */
+enum LargeBufferOptions {
+  /** Advises the kernel to back the buffers with transparent huge pages (\c MADV_HUGEPAGE). */
+  LargeBufferHugePages = 0x1,
+  /** Touches all the pages of the buffers when they are allocated, rather than on first access. */
+  LargeBufferPrefault = 0x2,
+  /** Interleaves the pages of the buffers over all the NUMA nodes, if the system has several nodes. */
+  LargeBufferInterleave = 0x4
+};
+
+/** Allocation policy of an individual buffer.
+ * \sa setLargeBufferThreshold() */
+enum LargeBufferPolicy {
+  /** The buffer is memory-mapped if its size is at least largeBufferThreshold(). */
+  LargeBufferAuto,
+  /** The buffer is memory-mapped whatever its size. */
+  LargeBufferMapped,
+  /** The buffer is allocated on the heap. */
+  LargeBufferHeap
+};
+
+namespace internal {
+
+#if EIGEN_OS_LINUX && defined(EIGEN_USE_LARGE_BUFFER_MMAP) && !defined(EIGEN_GPU_COMPILE_PHASE)
+#define EIGEN_LARGE_BUFFER_MMAP 1
+#else
+#define EIGEN_LARGE_BUFFER_MMAP 0
+#endif
+
+// Alignment of the memory-mapped buffers, and granularity of their size: the size of a huge page on x86-64 and
+// most aarch64 systems.
+const std::size_t large_buffer_alignment = std::size_t(1) << 21;
+
+inline std::atomic<std::size_t>& large_buffer_threshold() {
+  static std::atomic<std::size_t> value(EIGEN_LARGE_BUFFER_THRESHOLD);
+  return value;
+}
+
+inline std::atomic<int>& large_buffer_options() {
+  static std::atomic<int> value(LargeBufferHugePages);
+  return value;
+}
+
+inline bool use_large_buffer(std::size_t size, LargeBufferPolicy policy) {
+  if (policy == LargeBufferAuto) {
+    const std::size_t threshold = large_buffer_threshold().load(std::memory_order_relaxed);
+    return threshold > 0 && size >= threshold;
+  }
+  return policy == LargeBufferMapped;
+}
+
+#if EIGEN_LARGE_BUFFER_MMAP
+
+// Memory-mapped buffers currently allocated, so that aligned_free and aligned_realloc can recognize them.
+//
+// The buffers are aligned on large_buffer_alignment, so that the other pointers are rejected without looking the
+// table up. The table is an open addressing hash table with linear probing, which is read and updated without lock:
+// a slot goes from empty to used by a buffer, and then alternates between removed and used, such that a lookup can
+// stop at the first empty slot. A buffer is only added or removed by the thread which allocates or frees it.
+class large_buffer_registry : noncopyable {
+ public:
+  enum { Capacity = 4096 };
+
+  // Never destroyed, since buffers may be freed during the destruction of static objects.
+  static large_buffer_registry& instance() {
+    static large_buffer_registry* registry = new large_buffer_registry;
+    return *registry;
+  }
+
+  static bool may_contain(const void* ptr) {
+    return ptr != nullptr && (reinterpret_cast<std::size_t>(ptr) & (large_buffer_alignment - 1)) == 0;
+  }
+
+  // Returns false if the table is full.
+  bool add(void* ptr, std::size_t length) {
+    const std::size_t key = reinterpret_cast<std::size_t>(ptr);
+    for (std::size_t i = 0, slot = hash(key); i < Capacity; ++i, slot = (slot + 1) % Capacity) {
+      std::size_t current = m_keys[slot].load(std::memory_order_relaxed);
+      if (current != empty_key && current != removed_key) continue;
+      if (m_keys[slot].compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+        // The length is only read by the lookups of ptr, which happen after ptr is returned by large_buffer_malloc.
+        m_lengths[slot].store(length, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns the mapped length of ptr and removes it from the registry if remove is true, or 0 if ptr is not a
+  // memory-mapped buffer.
+  std::size_t find(const void* ptr, bool remove) {
+    if (!may_contain(ptr)) return 0;
+    const std::size_t key = reinterpret_cast<std::size_t>(ptr);
+    for (std::size_t i = 0, slot = hash(key); i < Capacity; ++i, slot = (slot + 1) % Capacity) {
+      const std::size_t current = m_keys[slot].load(std::memory_order_relaxed);
+      if (current == empty_key) return 0;
+      if (current != key) continue;
+      const std::size_t length = m_lengths[slot].load(std::memory_order_relaxed);
+      if (remove) m_keys[slot].store(removed_key, std::memory_order_relaxed);
+      return length;
+    }
+    return 0;
+  }
+
+ private:
+  static const std::size_t empty_key = 0;
+  static const std::size_t removed_key = 1;
+
+  static std::size_t hash(std::size_t key) { return ((key / large_buffer_alignment) * 2654435761u) % Capacity; }
+
+  large_buffer_registry() {
+    for (std::size_t i = 0; i < Capacity; ++i) {
+      m_keys[i].store(empty_key, std::memory_order_relaxed);
+      m_lengths[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<std::size_t> m_keys[Capacity];
+  std::atomic<std::size_t> m_lengths[Capacity];
+};
+
+/** \internal Maps \a size bytes aligned on large_buffer_alignment, with the options of setLargeBufferOptions().
+ * Returns null if the memory cannot be mapped. */
+inline void* large_buffer_malloc(std::size_t size) {
+  if (size > std::size_t(-1) - 2 * large_buffer_alignment) return nullptr;
+  check_that_malloc_is_allowed();
+  const std::size_t length = (size + large_buffer_alignment - 1) & ~(large_buffer_alignment - 1);
+  // Over-allocate, and unmap the unaligned head and the tail.
+  const std::size_t mapped = length + large_buffer_alignment;
+  void* base = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) return nullptr;
+  char* first = static_cast<char*>(base);
+  char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::size_t>(first) + large_buffer_alignment - 1) &
+                                          ~(large_buffer_alignment - 1));
+  if (aligned > first) ::munmap(first, std::size_t(aligned - first));
+  if (first + mapped > aligned + length) ::munmap(aligned + length, std::size_t(first + mapped - (aligned + length)));
+
+  const int options = large_buffer_options().load(std::memory_order_relaxed);
+#ifdef SYS_mbind
+  if (options & LargeBufferInterleave) {
+    // MPOL_INTERLEAVE over all the nodes, ignored on failure, e.g., on systems without NUMA support.
+    const unsigned long all_nodes = ~0ul;
+    ::syscall(SYS_mbind, aligned, length, 3, &all_nodes, sizeof(all_nodes) * CHAR_BIT, 0);
+  }
+#endif
+#ifdef MADV_HUGEPAGE
+  if (options & LargeBufferHugePages) ::madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+  if (options & LargeBufferPrefault) {
+    const std::size_t page = std::size_t(::sysconf(_SC_PAGESIZE));
+    for (std::size_t offset = 0; offset < length; offset += page) aligned[offset] = 0;
+  }
+  if (!large_buffer_registry::instance().add(aligned, length)) {
+    ::munmap(aligned, length);
+    return nullptr;
+  }
+  return aligned;
+}
+
+/** \internal Unmaps \a ptr if it was allocated by large_buffer_malloc. Returns false otherwise. */
+inline bool large_buffer_free(void* ptr) {
+  if (!large_buffer_registry::may_contain(ptr)) return false;
+  const std::size_t length = large_buffer_registry::instance().find(ptr, true);
+  if (length == 0) return false;
+  check_that_malloc_is_allowed();
+  ::munmap(ptr, length);
+  return true;
+}
+
+/** \internal Returns the mapped length of \a ptr if it was allocated by large_buffer_malloc, and 0 otherwise. */
+inline std::size_t large_buffer_capacity(const void* ptr) {
+  return large_buffer_registry::may_contain(ptr) ? large_buffer_registry::instance().find(ptr, false) : 0;
+}
+
+#endif  // EIGEN_LARGE_BUFFER_MMAP
+
+}  // end namespace internal
+
+/** \returns the size in bytes from which buffers are memory-mapped
+ * \sa setLargeBufferThreshold() */
+inline std::size_t largeBufferThreshold() { return internal::large_buffer_threshold().load(std::memory_order_relaxed); }
+
+/** Sets the size in bytes from which the buffers allocated by %Eigen, e.g., the coefficients of large dynamic-size
+ * matrices, are memory-mapped with \c mmap instead of being allocated with \c malloc. The mapped buffers are aligned
+ * on 2 MB, so that they can be backed by huge pages, see setLargeBufferOptions(). While the memory mapping is enabled,
+ * the packing buffers of the matrix-matrix products of 2 MB or more are mapped as well. A value of 0 disables the
+ * memory mapping. The default is given by \c EIGEN_LARGE_BUFFER_THRESHOLD (0).
+ *
+ * The memory mapping is only available on Linux, and must be enabled at compile time by defining
+ * \c EIGEN_USE_LARGE_BUFFER_MMAP in all the translation units. Otherwise, all the buffers are allocated on the heap.
+ * \sa largeBufferThreshold(), setLargeBufferOptions() */
+inline void setLargeBufferThreshold(std::size_t bytes) {
+  internal::large_buffer_threshold().store(bytes, std::memory_order_relaxed);
+}
+
+/** \returns the options of the memory mapping of large buffers, a combination of LargeBufferOptions
+ * \sa setLargeBufferOptions() */
+inline int largeBufferOptions() { return internal::large_buffer_options().load(std::memory_order_relaxed); }
+
+/** Sets the options of the memory mapping of large buffers, a combination of LargeBufferOptions. The options are
+ * applied to the buffers allocated afterwards. The default is \c LargeBufferHugePages.
+ * \sa largeBufferOptions(), setLargeBufferThreshold() */
+inline void setLargeBufferOptions(int options) {
+  internal::large_buffer_options().store(options, std::memory_order_relaxed);
+}
+
+namespace internal {
+
 /** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 or 32 bytes alignment depending on
  * the requirements. On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
  */
-EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size) {
+EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size, LargeBufferPolicy policy = LargeBufferAuto) {
   if (size == 0) return nullptr;
+  EIGEN_INSTRUMENT_ALLOCATION(size);
 
   void* result;
+#if EIGEN_LARGE_BUFFER_MMAP
+  // Falls back to the heap if the memory cannot be mapped.
+  if (use_large_buffer(size, policy) && (result = large_buffer_malloc(size)) != nullptr) return result;
+#else
+  EIGEN_UNUSED_VARIABLE(policy)
+#endif
 #if (EIGEN_DEFAULT_ALIGN_BYTES == 0) || EIGEN_MALLOC_ALREADY_ALIGNED
 
   check_that_malloc_is_allowed();
@@ -222,6 +447,10 @@ EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size) {
 
 /** \internal Frees memory allocated with aligned_malloc. */
 EIGEN_DEVICE_FUNC inline void aligned_free(void* ptr) {
+  if (ptr != nullptr) EIGEN_INSTRUMENT_DEALLOCATION();
+#if EIGEN_LARGE_BUFFER_MMAP
+  if (large_buffer_free(ptr)) return;
+#endif
 #if (EIGEN_DEFAULT_ALIGN_BYTES == 0) || EIGEN_MALLOC_ALREADY_ALIGNED
 
   if (ptr != nullptr) {
@@ -249,6 +478,19 @@ EIGEN_DEVICE_FUNC inline void* aligned_realloc(void* ptr, std::size_t new_size,
   }
 
   void* result;
+#if EIGEN_LARGE_BUFFER_MMAP
+  const std::size_t capacity = large_buffer_capacity(ptr);
+  if (capacity > 0 || use_large_buffer(new_size, LargeBufferAuto)) {
+    // A memory-mapped buffer is kept if it is large enough, and is otherwise moved to a new buffer.
+    if (capacity >= new_size && use_large_buffer(new_size, LargeBufferAuto)) return ptr;
+    result = aligned_malloc(new_size);
+    std::memcpy(result, ptr, (std::min)(new_size, old_size));
+    aligned_free(ptr);
+    return result;
+  }
+#endif
+  EIGEN_INSTRUMENT_ALLOCATION(new_size);
+  EIGEN_INSTRUMENT_DEALLOCATION();
 #if (EIGEN_DEFAULT_ALIGN_BYTES == 0) || EIGEN_MALLOC_ALREADY_ALIGNED
   EIGEN_UNUSED_VARIABLE(old_size)
 
@@ -279,6 +521,7 @@ EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc(std::size_t size) {
 template <>
 EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc<false>(std::size_t size) {
   if (size == 0) return nullptr;
+  EIGEN_INSTRUMENT_ALLOCATION(size);
 
   check_that_malloc_is_allowed();
   EIGEN_USING_STD(malloc)
@@ -297,6 +540,7 @@ EIGEN_DEVICE_FUNC inline void conditional_aligned_free(void* ptr) {
 template <>
 EIGEN_DEVICE_FUNC inline void conditional_aligned_free<false>(void* ptr) {
   if (ptr != nullptr) {
+    EIGEN_INSTRUMENT_DEALLOCATION();
     check_that_malloc_is_allowed();
     EIGEN_USING_STD(free)
     free(ptr);
@@ -317,6 +561,8 @@ EIGEN_DEVICE_FUNC inline void* conditional_aligned_realloc<false>(void* ptr, std
     conditional_aligned_free<false>(ptr);
     return nullptr;
   }
+  EIGEN_INSTRUMENT_ALLOCATION(new_size);
+  EIGEN_INSTRUMENT_DEALLOCATION();
 
   check_that_malloc_is_allowed();
   EIGEN_USING_STD(realloc)
@@ -471,23 +717,287 @@ EIGEN_DEVICE_FUNC inline T* conditional_aligned_realloc_new(T* pts, std::size_t
   return result;
 }
 
+/*****************************************************************************
+*** Memory arenas for the storage of plain objects                         ***
+*****************************************************************************/
+
+struct memory_arena_access;
+
+}  // end namespace internal
+
+/** \class MemoryArena
+ * \ingroup Core_Module
+ *
+ * \brief Bump allocator for the coefficients of dynamic-size matrices and arrays
+ *
+ * While a MemoryArena is installed on a thread by a ScopedMemoryArena, the coefficients of the dynamic-size plain
+ * objects created by this thread, including the temporaries of expressions, are taken from the arena instead of the
+ * heap. An allocation only bumps a pointer, and freeing the memory is a no-op except for the last allocation, which
+ * is given back to the arena. All the memory is released at once by reset() or by the destructor of the arena.
+ *
+ * The arena grows by blocks, each one at least twice as large as the previous. reset() merges them into a single
+ * block, so that repeating the same computation after a reset allocates from the heap only once.
+ *
+ * \code
+ * MemoryArena arena;
+ * for (const Request& request : requests) {
+ *   ScopedMemoryArena scope(&arena);
+ *   MatrixXd a = request.a * request.b + request.c;
+ *   result[request.id] = a.norm();
+ *   // a is destroyed before the arena is reset
+ * }
+ * \endcode
+ *
+ * \warning The objects allocated in an arena must be destroyed, or resized, before the arena is reset or destroyed,
+ * and on the thread which allocated them. In particular, an object allocated in an arena cannot be returned out of
+ * the scope of the arena. To copy a result to the heap, use a nested ScopedMemoryArena with a null arena. The arena
+ * is not thread-safe.
+ *
+ * Arenas can be disabled at compile time by defining \c EIGEN_NO_MEMORY_ARENA.
+ *
+ * \sa ScopedMemoryArena
+ */
+class MemoryArena : internal::noncopyable {
+ public:
+  /** Alignment of the allocations, in bytes. */
+  enum { Alignment = 64 };
+
+  /** Creates an empty arena, whose first block will hold at least \a blockSize bytes. */
+  explicit MemoryArena(std::size_t blockSize = 1 << 20) : m_blocks(nullptr), m_next_block_size(blockSize), m_used(0) {}
+
+  ~MemoryArena() { release(); }
+
+  /** \returns \a size bytes aligned on \c Alignment bytes. Throws std::bad_alloc if a new block cannot be allocated.
+   */
+  void* allocate(std::size_t size) {
+    const std::size_t bytes = round_up(size);
+    if (m_blocks == nullptr || std::size_t(m_blocks->end - m_blocks->top) < bytes) add_block(bytes);
+    void* result = m_blocks->top;
+    m_blocks->top += bytes;
+    m_used += bytes;
+    return result;
+  }
+
+  /** Gives back the \a size bytes at \a ptr, allocated by allocate(), if they are the last allocation of the arena.
+   * Otherwise, the memory is only released by reset(). */
+  void deallocate(void* ptr, std::size_t size) {
+    const std::size_t bytes = round_up(size);
+    if (m_blocks != nullptr && static_cast<char*>(ptr) + bytes == m_blocks->top) {
+      m_blocks->top -= bytes;
+      m_used -= bytes;
+    }
+  }
+
+  /** \returns whether \a ptr points to memory of this arena. */
+  bool owns(const void* ptr) const {
+    const char* p = static_cast<const char*>(ptr);
+    for (const block* b = m_blocks; b != nullptr; b = b->next)
+      if (p >= b->begin && p < b->end) return true;
+    return false;
+  }
+
+  /** Makes all the memory of the arena available again. If the arena has several blocks, they are replaced by a
+   * single block of their total size. */
+  void reset() {
+    if (m_blocks != nullptr && m_blocks->next != nullptr) {
+      const std::size_t total = capacity();
+      release();
+      m_next_block_size = total;
+      add_block(total);
+    } else if (m_blocks != nullptr) {
+      m_blocks->top = m_blocks->begin;
+    }
+    m_used = 0;
+  }
+
+  /** Frees all the blocks of the arena. */
+  void release() {
+    while (m_blocks != nullptr) {
+      block* next = m_blocks->next;
+      internal::handmade_aligned_free(m_blocks);
+      m_blocks = next;
+    }
+    m_used = 0;
+  }
+
+  /** \returns the number of bytes allocated since the last reset, including the alignment padding. */
+  std::size_t used() const { return m_used; }
+
+  /** \returns the total size in bytes of the blocks of the arena. */
+  std::size_t capacity() const {
+    std::size_t total = 0;
+    for (const block* b = m_blocks; b != nullptr; b = b->next) total += std::size_t(b->end - b->begin);
+    return total;
+  }
+
+ private:
+  // Header at the start of each block, followed by the memory handed out by allocate().
+  struct block {
+    block* next;
+    char* begin;
+    char* top;
+    char* end;
+  };
+
+  static std::size_t round_up(std::size_t size) {
+    return size == 0 ? std::size_t(Alignment) : (size + Alignment - 1) & ~std::size_t(Alignment - 1);
+  }
+
+  void add_block(std::size_t bytes) {
+    const std::size_t size = (std::max)(bytes, m_next_block_size);
+    const std::size_t header = round_up(sizeof(block));
+    void* memory = size <= std::size_t(-1) - header ? internal::handmade_aligned_malloc(header + size, Alignment)
+                                                    : nullptr;
+    if (memory == nullptr) internal::throw_std_bad_alloc();
+    block* b = static_cast<block*>(memory);
+    b->next = m_blocks;
+    b->begin = static_cast<char*>(memory) + header;
+    b->top = b->begin;
+    b->end = b->begin + size;
+    m_blocks = b;
+    m_next_block_size = 2 * size;
+  }
+
+  block* m_blocks;
+  std::size_t m_next_block_size;
+  std::size_t m_used;
+};
+
+/** \class ScopedMemoryArena
+ * \ingroup Core_Module
+ *
+ * \brief Installs a MemoryArena for the storage of the plain objects created by the current thread
+ *
+ * The arena is used until the ScopedMemoryArena is destroyed, after which the previously installed arena, if any, is
+ * restored. A null arena restores heap allocation in its scope, e.g., to copy a result computed in an arena.
+ *
+ * The arena is honored by the storage of dynamic-size matrices, arrays, tensors and sparse matrices, and thus by the
+ * temporaries of expressions. The internal buffers of products and decompositions keep using the heap or their own
+ * caches.
+ *
+ * \sa MemoryArena
+ */
+class ScopedMemoryArena : internal::noncopyable {
+ public:
+  explicit ScopedMemoryArena(MemoryArena* arena) : m_arena(arena), m_previous(current()) { current() = this; }
+
+  ~ScopedMemoryArena() { current() = m_previous; }
+
+  /** \returns the arena installed on the calling thread, or nullptr if plain objects are allocated on the heap. */
+  static MemoryArena* currentArena() { return current() != nullptr ? current()->m_arena : nullptr; }
+
+ private:
+  friend struct internal::memory_arena_access;
+
+#if defined(EIGEN_NO_MEMORY_ARENA) || defined(EIGEN_AVOID_THREAD_LOCAL)
+  static ScopedMemoryArena*& current() {
+    static ScopedMemoryArena* scope = nullptr;
+    return scope;
+  }
+#else
+  static ScopedMemoryArena*& current() {
+    static thread_local ScopedMemoryArena* scope = nullptr;
+    return scope;
+  }
+#endif
+
+  MemoryArena* m_arena;
+  ScopedMemoryArena* m_previous;
+};
+
+namespace internal {
+
+// Allocation and deallocation of the storage of plain objects through the arenas installed on the calling thread.
+struct memory_arena_access {
+  // Returns whether an arena is installed, and allocates size bytes from it if it is not null.
+  static bool allocate(std::size_t size, void*& result) {
+    ScopedMemoryArena* scope = ScopedMemoryArena::current();
+    if (scope == nullptr) return false;
+    result = scope->m_arena != nullptr ? scope->m_arena->allocate(size) : nullptr;
+    return result != nullptr;
+  }
+
+  // Returns whether ptr was allocated by one of the installed arenas.
+  static bool deallocate(void* ptr, std::size_t size) {
+    for (ScopedMemoryArena* scope = ScopedMemoryArena::current(); scope != nullptr; scope = scope->m_previous) {
+      if (scope->m_arena != nullptr && scope->m_arena->owns(ptr)) {
+        scope->m_arena->deallocate(ptr, size);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool active() { return ScopedMemoryArena::current() != nullptr; }
+};
+
+#if defined(EIGEN_NO_MEMORY_ARENA) || defined(EIGEN_AVOID_THREAD_LOCAL) || defined(EIGEN_GPU_COMPILE_PHASE)
+#define EIGEN_MEMORY_ARENA_ENABLED 0
+#else
+#define EIGEN_MEMORY_ARENA_ENABLED 1
+#endif
+
+/** \internal Allocates \a size bytes for the storage of a plain object, from the arena of the calling thread if any.
+ */
+template <bool Align>
+EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc_auto(std::size_t size) {
+#if EIGEN_MEMORY_ARENA_ENABLED
+  void* result;
+  if (memory_arena_access::allocate(size, result)) return result;
+#endif
+  return conditional_aligned_malloc<Align>(size);
+}
+
+/** \internal Frees memory allocated with conditional_aligned_malloc_auto */
+template <bool Align>
+EIGEN_DEVICE_FUNC inline void conditional_aligned_free_auto(void* ptr, std::size_t size) {
+#if EIGEN_MEMORY_ARENA_ENABLED
+  if (ptr != nullptr && memory_arena_access::active() && memory_arena_access::deallocate(ptr, size)) return;
+#else
+  EIGEN_UNUSED_VARIABLE(size)
+#endif
+  conditional_aligned_free<Align>(ptr);
+}
+
 template <typename T, bool Align>
 EIGEN_DEVICE_FUNC inline T* conditional_aligned_new_auto(std::size_t size) {
   if (size == 0) return 0;  // short-cut. Also fixes Bug 884
   check_size_for_overflow<T>(size);
-  T* result = static_cast<T*>(conditional_aligned_malloc<Align>(sizeof(T) * size));
+  T* result = static_cast<T*>(conditional_aligned_malloc_auto<Align>(sizeof(T) * size));
   if (NumTraits<T>::RequireInitialization) {
     EIGEN_TRY { default_construct_elements_of_array(result, size); }
     EIGEN_CATCH(...) {
-      conditional_aligned_free<Align>(result);
+      conditional_aligned_free_auto<Align>(result, sizeof(T) * size);
       EIGEN_THROW;
     }
   }
   return result;
 }
 
+template <typename T, bool Align>
+EIGEN_DEVICE_FUNC inline void conditional_aligned_delete_auto(T* ptr, std::size_t size) {
+  if (NumTraits<T>::RequireInitialization) destruct_elements_of_array<T>(ptr, size);
+  conditional_aligned_free_auto<Align>(ptr, sizeof(T) * size);
+}
+
 template <typename T, bool Align>
 EIGEN_DEVICE_FUNC inline T* conditional_aligned_realloc_new_auto(T* pts, std::size_t new_size, std::size_t old_size) {
+#if EIGEN_MEMORY_ARENA_ENABLED
+  if (memory_arena_access::active()) {
+    // The old or the new buffer may belong to an arena.
+    T* result = conditional_aligned_new_auto<T, Align>(new_size);
+    EIGEN_TRY {
+      std::size_t copy_size = (std::min)(old_size, new_size);
+      for (std::size_t i = 0; i < copy_size; ++i) result[i] = std::move(pts[i]);
+    }
+    EIGEN_CATCH(...) {
+      conditional_aligned_delete_auto<T, Align>(result, new_size);
+      EIGEN_THROW;
+    }
+    conditional_aligned_delete_auto<T, Align>(pts, old_size);
+    return result;
+  }
+#endif
   if (NumTraits<T>::RequireInitialization) {
     return conditional_aligned_realloc_new<T, Align>(pts, new_size, old_size);
   }
@@ -498,12 +1008,6 @@ EIGEN_DEVICE_FUNC inline T* conditional_aligned_realloc_new_auto(T* pts, std::si
       conditional_aligned_realloc<Align>(static_cast<void*>(pts), sizeof(T) * new_size, sizeof(T) * old_size));
 }
 
-template <typename T, bool Align>
-EIGEN_DEVICE_FUNC inline void conditional_aligned_delete_auto(T* ptr, std::size_t size) {
-  if (NumTraits<T>::RequireInitialization) destruct_elements_of_array<T>(ptr, size);
-  conditional_aligned_free<Align>(ptr);
-}
-
 /****************************************************************************/
 
 /** \internal Returns the index of the first element of the array that is well aligned with respect to the requested \a
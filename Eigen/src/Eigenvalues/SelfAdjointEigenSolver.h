@@ -416,6 +416,8 @@ EIGEN_DEVICE_FUNC SelfAdjointEigenSolver<MatrixType>& SelfAdjointEigenSolver<Mat
                "invalid option parameter");
   bool computeEigenvectors = (options & ComputeEigenvectors) == ComputeEigenvectors;
   Index n = matrix.cols();
+  // Iterative algorithm: only the time is measured.
+  EIGEN_INSTRUMENT_KERNEL("selfadjoint_eigensolver", 0, 0);
   m_eivalues.resize(n, 1);
 
   if (n == 1) {
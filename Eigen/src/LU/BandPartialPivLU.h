@@ -0,0 +1,236 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BAND_PARTIALLU_H
+#define EIGEN_BAND_PARTIALLU_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+template <typename Scalar_>
+class BandPartialPivLU;
+
+namespace internal {
+
+template <typename Scalar_>
+struct traits<BandPartialPivLU<Scalar_> > : traits<Matrix<Scalar_, Dynamic, Dynamic> > {
+  typedef MatrixXpr XprKind;
+  typedef SolverStorage StorageKind;
+  typedef int StorageIndex;
+  enum { Flags = 0 };
+};
+
+}  // end namespace internal
+
+/** \ingroup LU_Module
+ *
+ * \class BandPartialPivLU
+ *
+ * \brief LU decomposition of a square band matrix with partial pivoting
+ *
+ * \tparam Scalar_ the type of the coefficients
+ *
+ * This class computes the decomposition A = P L U of a band matrix with \c kl sub-diagonals and \c ku
+ * super-diagonals, as LAPACK's \c gbtrf. The row interchanges widen the band of U to kl+ku
+ * super-diagonals, while L keeps at most kl coefficients per column, so that the decomposition takes
+ * O(n kl (kl+ku)) operations and (2kl+ku+1) n coefficients of storage.
+ *
+ * Like PartialPivLU, this decomposition does not check the invertibility of A, but info() reports
+ * \c NumericalIssue when an exactly zero pivot is found.
+ *
+ * \sa class BandLLT, class PartialPivLU
+ */
+template <typename Scalar_>
+class BandPartialPivLU : public SolverBase<BandPartialPivLU<Scalar_> > {
+ public:
+  typedef SolverBase<BandPartialPivLU> Base;
+  friend class SolverBase<BandPartialPivLU>;
+
+  EIGEN_GENERIC_PUBLIC_INTERFACE(BandPartialPivLU)
+  typedef Matrix<Scalar, Dynamic, Dynamic> CoefficientsType;
+  typedef Transpositions<Dynamic, Dynamic, int> TranspositionType;
+
+  BandPartialPivLU() : m_subs(0), m_supers(0), m_isInitialized(false), m_info(Success) {}
+
+  template <typename Derived>
+  explicit BandPartialPivLU(const internal::BandMatrixBase<Derived>& matrix)
+      : m_subs(0), m_supers(0), m_isInitialized(false), m_info(Success) {
+    compute(matrix);
+  }
+
+  template <typename Derived>
+  BandPartialPivLU& compute(const internal::BandMatrixBase<Derived>& matrix);
+
+#ifdef EIGEN_PARSED_BY_DOXYGEN
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A. */
+  template <typename Rhs>
+  inline const Solve<BandPartialPivLU, Rhs> solve(const MatrixBase<Rhs>& b) const;
+#endif
+
+  template <typename Derived>
+  void solveInPlace(const MatrixBase<Derived>& bAndX) const;
+
+  /** \returns the band storage of the factors. U(i,j) and the multipliers L(i,j) are stored at
+   * (subs()+supers()+i-j, j), with U having subs()+supers() super-diagonals and L subs() sub-diagonals. */
+  inline const CoefficientsType& matrixLU() const {
+    eigen_assert(m_isInitialized && "BandPartialPivLU is not initialized.");
+    return m_lu;
+  }
+
+  /** \returns the row interchanges: row i was interchanged with row transpositionsP().coeff(i) at step i */
+  inline const TranspositionType& transpositionsP() const {
+    eigen_assert(m_isInitialized && "BandPartialPivLU is not initialized.");
+    return m_p;
+  }
+
+  inline Index subs() const { return m_subs; }
+  inline Index supers() const { return m_supers; }
+
+  /** \brief Reports whether previous computation was successful.
+   *
+   * \returns \c Success if computation was successful,
+   *          \c NumericalIssue if the matrix is singular.
+   */
+  ComputationInfo info() const {
+    eigen_assert(m_isInitialized && "BandPartialPivLU is not initialized.");
+    return m_info;
+  }
+
+  inline EIGEN_CONSTEXPR Index rows() const EIGEN_NOEXCEPT { return m_lu.cols(); }
+  inline EIGEN_CONSTEXPR Index cols() const EIGEN_NOEXCEPT { return m_lu.cols(); }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+  template <typename RhsType, typename DstType>
+  void _solve_impl(const RhsType& rhs, DstType& dst) const {
+    dst = rhs;
+    solveInPlace(dst);
+  }
+
+  template <bool Conjugate, typename RhsType, typename DstType>
+  void _solve_impl_transposed(const RhsType& rhs, DstType& dst) const;
+#endif
+
+ protected:
+  EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar)
+
+  CoefficientsType m_lu;
+  TranspositionType m_p;
+  Index m_subs, m_supers;
+  bool m_isInitialized;
+  ComputationInfo m_info;
+};
+
+template <typename Scalar_>
+template <typename Derived>
+BandPartialPivLU<Scalar_>& BandPartialPivLU<Scalar_>::compute(const internal::BandMatrixBase<Derived>& matrix) {
+  eigen_assert(matrix.rows() == matrix.cols());
+  const Index size = matrix.rows();
+  const Index kl = m_subs = matrix.subs();
+  const Index ku = m_supers = matrix.supers();
+  const Index kv = kl + ku;
+  const Index ld = 2 * kl + ku + 1;
+  typedef Map<CoefficientsType, 0, OuterStride<> > BlockMap;
+  typedef Map<Matrix<Scalar, 1, Dynamic>, 0, InnerStride<> > RowMap;
+
+  // The first kl rows hold the fill-in of U.
+  m_lu.resize(ld, size);
+  m_lu.topRows(kl).setZero();
+  m_lu.bottomRows(kv + 1) = matrix.coeffs();
+  m_p.resize(size);
+
+  // Right-looking algorithm of gbtf2: the rows of the band storage with a
+  // constant i are strided by ld-1, and so are the columns of a dense block.
+  m_info = Success;
+  Index ju = 0;  // last column of U modified by the previous interchanges
+  for (Index j = 0; j < size; ++j) {
+    const Index km = numext::mini(kl, size - 1 - j);
+    Index jp;
+    m_lu.col(j).segment(kv, km + 1).cwiseAbs().maxCoeff(&jp);
+    m_p.indices().coeffRef(j) = internal::convert_index<int>(j + jp);
+    if (m_lu.coeff(kv + jp, j) == Scalar(0)) {
+      m_info = NumericalIssue;
+      continue;
+    }
+    ju = numext::maxi(ju, numext::mini(j + ku + jp, size - 1));
+    if (jp != 0) {
+      RowMap(&m_lu.coeffRef(kv + jp, j), ju - j + 1, InnerStride<>(ld - 1))
+          .swap(RowMap(&m_lu.coeffRef(kv, j), ju - j + 1, InnerStride<>(ld - 1)));
+    }
+    if (km > 0) {
+      m_lu.col(j).segment(kv + 1, km) /= m_lu.coeff(kv, j);
+      if (ju > j)
+        BlockMap(&m_lu.coeffRef(kv, j + 1), km, ju - j, OuterStride<>(ld - 1)).noalias() -=
+            m_lu.col(j).segment(kv + 1, km) * RowMap(&m_lu.coeffRef(kv - 1, j + 1), ju - j, InnerStride<>(ld - 1));
+    }
+  }
+  m_isInitialized = true;
+  return *this;
+}
+
+/** \internal use x = lu_object.solve(x);
+ *
+ * This is the \em in-place version of solve().
+ *
+ * \warning The parameter is only marked 'const' to make the C++ compiler accept a temporary expression here.
+ * This function will const_cast it, so constness isn't honored here.
+ */
+template <typename Scalar_>
+template <typename Derived>
+void BandPartialPivLU<Scalar_>::solveInPlace(const MatrixBase<Derived>& bAndX) const {
+  eigen_assert(m_isInitialized && "BandPartialPivLU is not initialized.");
+  eigen_assert(rows() == bAndX.rows());
+  Derived& x = bAndX.const_cast_derived();
+  const Index size = rows();
+  const Index kv = m_subs + m_supers;
+  // L y = P^T b, applying the interchanges as they were found
+  for (Index j = 0; j < size - 1; ++j) {
+    const Index lm = numext::mini(m_subs, size - 1 - j);
+    const Index p = m_p.coeff(j);
+    if (p != j) x.row(j).swap(x.row(p));
+    if (lm > 0) x.middleRows(j + 1, lm).noalias() -= m_lu.col(j).segment(kv + 1, lm) * x.row(j);
+  }
+  // U x = y
+  for (Index j = size - 1; j >= 0; --j) {
+    const Index len = numext::mini(kv, j);
+    x.row(j) /= m_lu.coeff(kv, j);
+    if (len > 0) x.middleRows(j - len, len).noalias() -= m_lu.col(j).segment(kv - len, len) * x.row(j);
+  }
+}
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+template <typename Scalar_>
+template <bool Conjugate, typename RhsType, typename DstType>
+void BandPartialPivLU<Scalar_>::_solve_impl_transposed(const RhsType& rhs, DstType& dst) const {
+  // A^T = U^T L^T P^T
+  dst = rhs;
+  const Index size = rows();
+  const Index kv = m_subs + m_supers;
+  // U^T y = b
+  for (Index j = 0; j < size; ++j) {
+    const Index len = numext::mini(kv, j);
+    if (len > 0)
+      dst.row(j).noalias() -=
+          m_lu.col(j).segment(kv - len, len).transpose().template conjugateIf<Conjugate>() * dst.middleRows(j - len, len);
+    dst.row(j) /= (Conjugate ? numext::conj(m_lu.coeff(kv, j)) : m_lu.coeff(kv, j));
+  }
+  // L^T P^T x = y
+  for (Index j = size - 2; j >= 0; --j) {
+    const Index lm = numext::mini(m_subs, size - 1 - j);
+    if (lm > 0)
+      dst.row(j).noalias() -=
+          m_lu.col(j).segment(kv + 1, lm).transpose().template conjugateIf<Conjugate>() * dst.middleRows(j + 1, lm);
+    const Index p = m_p.coeff(j);
+    if (p != j) dst.row(j).swap(dst.row(p));
+  }
+}
+#endif
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_BAND_PARTIALLU_H
@@ -459,6 +459,8 @@ template <typename MatrixType, typename PermutationIndex>
 void FullPivLU<MatrixType, PermutationIndex>::computeInPlace() {
   eigen_assert(m_lu.rows() <= NumTraits<PermutationIndex>::highest() &&
                m_lu.cols() <= NumTraits<PermutationIndex>::highest());
+  EIGEN_INSTRUMENT_KERNEL("full_piv_lu", internal::instrumentation_lu_flops(m_lu.rows(), m_lu.cols()),
+                          2.0 * double(m_lu.size()) * double(sizeof(Scalar)));
 
   m_l1_norm = m_lu.cwiseAbs().colwise().sum().maxCoeff();
 
@@ -480,6 +480,8 @@ void partial_lu_inplace(MatrixType& lu, TranspositionType& row_transpositions,
 template <typename MatrixType, typename PermutationIndex>
 void PartialPivLU<MatrixType, PermutationIndex>::compute() {
   eigen_assert(m_lu.rows() < NumTraits<PermutationIndex>::highest());
+  EIGEN_INSTRUMENT_KERNEL("partial_piv_lu", internal::instrumentation_lu_flops(m_lu.rows(), m_lu.cols()),
+                          2.0 * double(m_lu.size()) * double(sizeof(Scalar)));
 
   if (m_lu.cols() > 0)
     m_l1_norm = m_lu.cwiseAbs().colwise().sum().maxCoeff();
@@ -493,6 +493,8 @@ void ColPivHouseholderQR<MatrixType, PermutationIndex>::computeInPlace() {
   Index rows = m_qr.rows();
   Index cols = m_qr.cols();
   Index size = m_qr.diagonalSize();
+  EIGEN_INSTRUMENT_KERNEL("col_piv_householder_qr", internal::instrumentation_qr_flops(rows, cols),
+                          2.0 * double(m_qr.size()) * double(sizeof(Scalar)));
 
   m_hCoeffs.resize(size);
 
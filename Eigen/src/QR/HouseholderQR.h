@@ -508,6 +508,8 @@ void HouseholderQR<MatrixType>::computeInPlace() {
   Index rows = m_qr.rows();
   Index cols = m_qr.cols();
   Index size = (std::min)(rows, cols);
+  EIGEN_INSTRUMENT_KERNEL("householder_qr", internal::instrumentation_qr_flops(rows, cols),
+                          2.0 * double(m_qr.size()) * double(sizeof(Scalar)));
 
   m_hCoeffs.resize(size);
 
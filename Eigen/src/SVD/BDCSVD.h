@@ -332,6 +332,8 @@ BDCSVD<MatrixType, Options>& BDCSVD<MatrixType, Options>::compute_impl(const Mat
                "=====================\n\n\n";
 #endif
   using std::abs;
+  // Iterative algorithm: only the time is measured.
+  EIGEN_INSTRUMENT_KERNEL("bdcsvd", 0, 0);
 
   allocate(matrix.rows(), matrix.cols(), computationOptions);
 
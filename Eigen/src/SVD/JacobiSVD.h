@@ -665,6 +665,8 @@ template <typename MatrixType, int Options>
 JacobiSVD<MatrixType, Options>& JacobiSVD<MatrixType, Options>::compute_impl(const MatrixType& matrix,
                                                                              unsigned int computationOptions) {
   using std::abs;
+  // Iterative algorithm: only the time is measured.
+  EIGEN_INSTRUMENT_KERNEL("jacobi_svd", 0, 0);
 
   allocate(matrix.rows(), matrix.cols(), computationOptions);
 
@@ -15,6 +15,18 @@
 
 namespace Eigen {
 
+// Snapshot of the counters of a worker thread, see ThreadPoolTempl::GetStats.
+// Counters are cumulative since the creation of the pool.
+struct ThreadPoolWorkerStats {
+  uint64_t tasks_executed = 0;  // Tasks run by the worker.
+  uint64_t local_steals = 0;    // Tasks stolen within the steal partition.
+  uint64_t global_steals = 0;   // Tasks stolen from any other worker.
+  uint64_t spin_phases = 0;     // Times the worker spun waiting for work.
+  uint64_t parks = 0;           // Times the worker blocked waiting for work.
+  uint64_t unparks = 0;         // Times the worker was woken up.
+  unsigned queue_size = 0;      // Approximate size of the worker queue.
+};
+
 template <typename Environment>
 class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
  public:
@@ -35,7 +47,9 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
         spinning_(0),
         done_(false),
         cancelled_(false),
-        ec_(waiters_) {
+        ec_(waiters_),
+        default_spin_policy_(),
+        spin_policy_(&default_spin_policy_) {
     waiters_.resize(num_threads_);
     // Calculate coprimes of all numbers [1, num_threads].
     // Coprimes are used for random walks over all threads in Steal
@@ -146,6 +160,56 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     ec_.Notify(true);
   }
 
+  // Tries to execute a single pending task on the calling thread. Worker
+  // threads of this pool pop from their own queue first and then steal from
+  // the other workers, any other thread can only steal. Returns false if no
+  // task was found. This lets a thread that waits for the completion of
+  // nested work (see TaskGroup) help instead of blocking.
+  bool TryRunPendingTask() {
+    if (num_threads_ == 0 || cancelled_) return false;
+    PerThread* pt = GetPerThread();
+    Task t;
+    if (pt->pool == this) {
+      t = thread_data_[pt->thread_id].queue.PopFront();
+      if (!t.f) t = LocalSteal();
+      if (!t.f) t = GlobalSteal();
+    } else {
+      // Per-thread random state is not available here, so do a plain scan.
+      for (int i = 0; i < num_threads_ && !t.f; ++i) {
+        t = thread_data_[i].queue.PopBack();
+      }
+    }
+    if (!t.f) return false;
+    env_.ExecuteTask(t);
+    return true;
+  }
+
+  // Replaces the policy deciding how idle workers spin before parking. The
+  // policy is owned by the caller and must outlive the pool. Passing nullptr
+  // restores the default FixedSpinPolicy. Has no effect if the pool was
+  // created with allow_spinning = false.
+  void SetSpinPolicy(ThreadPoolSpinPolicy* policy) {
+    spin_policy_.store(policy ? policy : &default_spin_policy_, std::memory_order_release);
+  }
+
+  // Returns a snapshot of the per-worker counters, indexed by thread id.
+  // Counters of different workers are not read atomically with respect to
+  // each other.
+  void GetStats(std::vector<ThreadPoolWorkerStats>* stats) const {
+    stats->resize(num_threads_);
+    for (int i = 0; i < num_threads_; ++i) {
+      const WorkerCounters& c = thread_data_[i].counters;
+      ThreadPoolWorkerStats& s = (*stats)[i];
+      s.tasks_executed = c.tasks_executed.load(std::memory_order_relaxed);
+      s.local_steals = c.local_steals.load(std::memory_order_relaxed);
+      s.global_steals = c.global_steals.load(std::memory_order_relaxed);
+      s.spin_phases = c.spin_phases.load(std::memory_order_relaxed);
+      s.parks = c.parks.load(std::memory_order_relaxed);
+      s.unparks = c.unparks.load(std::memory_order_relaxed);
+      s.queue_size = thread_data_[i].queue.Size();
+    }
+  }
+
   int NumThreads() const EIGEN_FINAL { return num_threads_; }
 
   int CurrentThreadId() const EIGEN_FINAL {
@@ -217,11 +281,29 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
 #endif
   };
 
+  // Counters are only written by the owning worker thread, so increments do
+  // not need read-modify-write atomics.
+  struct WorkerCounters {
+    constexpr WorkerCounters()
+        : tasks_executed(0), local_steals(0), global_steals(0), spin_phases(0), parks(0), unparks(0) {}
+    std::atomic<uint64_t> tasks_executed;
+    std::atomic<uint64_t> local_steals;
+    std::atomic<uint64_t> global_steals;
+    std::atomic<uint64_t> spin_phases;
+    std::atomic<uint64_t> parks;
+    std::atomic<uint64_t> unparks;
+  };
+
+  static EIGEN_STRONG_INLINE void Increment(std::atomic<uint64_t>* counter) {
+    counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
   struct ThreadData {
-    constexpr ThreadData() : thread(), steal_partition(0), queue() {}
+    constexpr ThreadData() : thread(), steal_partition(0), queue(), counters() {}
     std::unique_ptr<Thread> thread;
     std::atomic<unsigned> steal_partition;
     Queue queue;
+    WorkerCounters counters;
   };
 
   Environment env_;
@@ -232,10 +314,12 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   MaxSizeVector<EventCount::Waiter> waiters_;
   unsigned global_steal_partition_;
   std::atomic<unsigned> blocked_;
-  std::atomic<bool> spinning_;
+  std::atomic<int> spinning_;  // Number of spinning worker threads.
   std::atomic<bool> done_;
   std::atomic<bool> cancelled_;
   EventCount ec_;
+  FixedSpinPolicy default_spin_policy_;
+  std::atomic<ThreadPoolSpinPolicy*> spin_policy_;
 #ifndef EIGEN_THREAD_LOCAL
   std::unique_ptr<Barrier> init_barrier_;
   EIGEN_MUTEX per_thread_map_mutex_;  // Protects per_thread_map_.
@@ -259,12 +343,12 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     pt->rand = GlobalThreadIdHash();
     pt->thread_id = thread_id;
     Queue& q = thread_data_[thread_id].queue;
+    WorkerCounters& counters = thread_data_[thread_id].counters;
     EventCount::Waiter* waiter = &waiters_[thread_id];
-    // TODO(dvyukov,rmlarsen): The time spent in NonEmptyQueueIndex() is
-    // proportional to num_threads_ and we assume that new work is scheduled at
-    // a constant rate, so we set spin_count to 5000 / num_threads_. The
-    // constant was picked based on a fair dice roll, tune it.
-    const int spin_count = allow_spinning_ && num_threads_ > 0 ? 5000 / num_threads_ : 0;
+    // The number of spin iterations is decided by the spin policy. The
+    // default one assumes that the time spent in NonEmptyQueueIndex() is
+    // proportional to num_threads_ and that new work is scheduled at a
+    // constant rate, so it spins 5000 / num_threads_ times.
     if (num_threads_ == 1) {
       // For num_threads_ == 1 there is no point in going through the expensive
       // steal loop. Moreover, since NonEmptyQueueIndex() calls PopBack() on the
@@ -274,10 +358,17 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
       // pools tend to be used for.
       while (!cancelled_) {
         Task t = q.PopFront();
-        for (int i = 0; i < spin_count && !t.f; i++) {
-          if (!cancelled_.load(std::memory_order_relaxed)) {
-            t = q.PopFront();
+        if (!t.f && allow_spinning_) {
+          ThreadPoolSpinPolicy* policy = spin_policy_.load(std::memory_order_acquire);
+          const int spin_count = policy->SpinCount(num_threads_);
+          int i = 0;
+          for (; i < spin_count && !t.f; i++) {
+            if (!cancelled_.load(std::memory_order_relaxed)) {
+              t = q.PopFront();
+            }
           }
+          Increment(&counters.spin_phases);
+          policy->Update(i, t.f != nullptr);
         }
         if (!t.f) {
           if (!WaitForWork(waiter, &t)) {
@@ -286,6 +377,7 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
         }
         if (t.f) {
           env_.ExecuteTask(t);
+          Increment(&counters.tasks_executed);
         }
       }
     } else {
@@ -293,35 +385,56 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
         Task t = q.PopFront();
         if (!t.f) {
           t = LocalSteal();
-          if (!t.f) {
-            t = GlobalSteal();
-            if (!t.f) {
-              // Leave one thread spinning. This reduces latency.
-              if (allow_spinning_ && !spinning_ && !spinning_.exchange(true)) {
-                for (int i = 0; i < spin_count && !t.f; i++) {
-                  if (!cancelled_.load(std::memory_order_relaxed)) {
-                    t = GlobalSteal();
-                  } else {
-                    return;
-                  }
-                }
-                spinning_ = false;
-              }
-              if (!t.f) {
-                if (!WaitForWork(waiter, &t)) {
-                  return;
-                }
+          if (t.f) Increment(&counters.local_steals);
+        }
+        if (!t.f) {
+          t = GlobalSteal();
+          if (t.f) Increment(&counters.global_steals);
+        }
+        if (!t.f) {
+          // Leave a few threads (by default one) spinning. This reduces
+          // latency.
+          ThreadPoolSpinPolicy* policy = spin_policy_.load(std::memory_order_acquire);
+          if (allow_spinning_ && StartSpinning(policy->MaxSpinningThreads(num_threads_))) {
+            const int spin_count = policy->SpinCount(num_threads_);
+            int i = 0;
+            for (; i < spin_count && !t.f; i++) {
+              if (!cancelled_.load(std::memory_order_relaxed)) {
+                t = GlobalSteal();
+              } else {
+                spinning_--;
+                return;
               }
             }
+            spinning_--;
+            Increment(&counters.spin_phases);
+            policy->Update(i, t.f != nullptr);
+            if (t.f) Increment(&counters.global_steals);
+          }
+          if (!t.f) {
+            if (!WaitForWork(waiter, &t)) {
+              return;
+            }
           }
         }
         if (t.f) {
           env_.ExecuteTask(t);
+          Increment(&counters.tasks_executed);
         }
       }
     }
   }
 
+  // Registers the calling worker as spinning, unless `max_spinning` workers
+  // already are.
+  bool StartSpinning(int max_spinning) {
+    int spinning = spinning_.load(std::memory_order_relaxed);
+    while (spinning < max_spinning) {
+      if (spinning_.compare_exchange_weak(spinning, spinning + 1)) return true;
+    }
+    return false;
+  }
+
   // Steal tries to steal work from other worker threads in the range [start,
   // limit) in best-effort manner.
   Task Steal(unsigned start, unsigned limit) {
@@ -382,6 +495,7 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
         return false;
       } else {
         *t = thread_data_[victim].queue.PopBack();
+        if (t->f) Increment(&thread_data_[GetPerThread()->thread_id].counters.global_steals);
         return true;
       }
     }
@@ -411,7 +525,10 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
       ec_.Notify(true);
       return false;
     }
+    WorkerCounters& counters = thread_data_[GetPerThread()->thread_id].counters;
+    Increment(&counters.parks);
     ec_.CommitWait(waiter);
+    Increment(&counters.unparks);
     blocked_--;
     return true;
   }
@@ -0,0 +1,109 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// TaskGroup is a fork/join helper on top of ThreadPoolTempl. Tasks are forked
+// with Run() and joined with Wait(). Unlike Barrier::Wait, which parks the
+// calling thread, TaskGroup::Wait executes pending tasks of the pool while the
+// group is not done, so a worker thread can fork nested work and wait for it
+// without wasting itself or deadlocking the pool:
+//
+//   void Recurse(ThreadPool* pool, int depth) {
+//     if (depth == 0) return;
+//     TaskGroup group(pool);
+//     group.Run([=]() { Recurse(pool, depth - 1); });
+//     Recurse(pool, depth - 1);
+//     group.Wait();
+//   }
+//
+// Run() may be called by the thread that owns the group and by tasks of the
+// group. Wait() must only be called by the owning thread.
+
+#ifndef EIGEN_CXX11_THREADPOOL_TASK_GROUP_H
+#define EIGEN_CXX11_THREADPOOL_TASK_GROUP_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+template <typename Environment>
+class TaskGroupTempl {
+ public:
+  typedef ThreadPoolTempl<Environment> Pool;
+
+  explicit TaskGroupTempl(Pool* pool) : pool_(pool), state_(0), notified_(false) {}
+  ~TaskGroupTempl() { Wait(); }
+
+  // Forks `fn` as a task of this group.
+  template <typename Function>
+  void Run(Function&& fn) {
+    if (pool_->NumThreads() == 0) {
+      fn();
+      return;
+    }
+    unsigned int v = state_.fetch_add(2, std::memory_order_relaxed);
+    eigen_plain_assert(((v + 2) >> 1) != 0);
+    EIGEN_UNUSED_VARIABLE(v);
+    pool_->Schedule([this, fn]() mutable {
+      fn();
+      Done();
+    });
+  }
+
+  // Blocks until all tasks of the group, including the ones they forked,
+  // have completed. Pending tasks of the pool are executed meanwhile.
+  void Wait() {
+    const bool is_worker = pool_->CurrentThreadId() != -1;
+    while ((state_.load(std::memory_order_acquire) >> 1) != 0) {
+      if (pool_->TryRunPendingTask()) continue;
+      if (is_worker) {
+        // Remaining tasks run on other workers and may still fork work that
+        // we can help with, keep polling.
+        EIGEN_THREAD_YIELD();
+        continue;
+      }
+      // Nothing to help with from the outside, park until the last task
+      // of the group is done.
+      unsigned int v = state_.fetch_or(1, std::memory_order_acq_rel);
+      if ((v >> 1) == 0) {
+        state_.store(0, std::memory_order_relaxed);
+        return;
+      }
+      EIGEN_MUTEX_LOCK l(mu_);
+      while (!notified_) {
+        cv_.wait(l);
+      }
+      notified_ = false;
+      state_.store(0, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+ private:
+  void Done() {
+    unsigned int v = state_.fetch_sub(2, std::memory_order_acq_rel) - 2;
+    // Only touch the mutex if the owner is parked, otherwise it may already
+    // have returned from Wait() and destroyed the group.
+    if (v != 1) return;
+    EIGEN_MUTEX_LOCK l(mu_);
+    eigen_plain_assert(!notified_);
+    notified_ = true;
+    cv_.notify_all();
+  }
+
+  Pool* pool_;
+  EIGEN_MUTEX mu_;
+  EIGEN_CONDVAR cv_;
+  std::atomic<unsigned int> state_;  // pending count << 1, low bit is waiter flag
+  bool notified_;
+};
+
+typedef TaskGroupTempl<StlThreadEnvironment> TaskGroup;
+
+}  // namespace Eigen
+
+#endif  // EIGEN_CXX11_THREADPOOL_TASK_GROUP_H
@@ -30,6 +30,22 @@ class ThreadPoolInterface {
     Schedule(fn);
   }
 
+  // Submits fn(i) for every i in [0, num_tasks). All tasks share a single
+  // heap-allocated copy of fn, and each submitted closure only holds a pointer
+  // and an index, which fits in the small buffer of std::function. This avoids
+  // one heap allocation per task when submitting many fine-grained tasks.
+  void ScheduleBulk(int num_tasks, std::function<void(int)> fn) {
+    if (num_tasks <= 0) return;
+    BulkContext* ctx = new BulkContext(num_tasks, std::move(fn));
+    for (int i = 0; i < num_tasks; ++i) {
+      Schedule([ctx, i]() {
+        ctx->fn(i);
+        // Delete the shared context after the last task.
+        if (ctx->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) delete ctx;
+      });
+    }
+  }
+
   // If implemented, stop processing the closures that have been enqueued.
   // Currently running closures may still be processed.
   // If not implemented, does nothing.
@@ -43,6 +59,13 @@ class ThreadPoolInterface {
   virtual int CurrentThreadId() const = 0;
 
   virtual ~ThreadPoolInterface() {}
+
+ private:
+  struct BulkContext {
+    BulkContext(int num_tasks, std::function<void(int)> f) : pending(num_tasks), fn(std::move(f)) {}
+    std::atomic<int> pending;
+    std::function<void(int)> fn;
+  };
 };
 
 }  // namespace Eigen
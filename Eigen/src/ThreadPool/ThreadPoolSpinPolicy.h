@@ -0,0 +1,97 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CXX11_THREADPOOL_THREAD_POOL_SPIN_POLICY_H
+#define EIGEN_CXX11_THREADPOOL_THREAD_POOL_SPIN_POLICY_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+// ThreadPoolSpinPolicy decides how idle worker threads of a ThreadPoolTempl
+// spin looking for new work before they park. Spinning reduces the latency of
+// newly scheduled tasks at the expense of CPU time. A policy is shared by all
+// workers of a pool and must be thread-safe.
+class ThreadPoolSpinPolicy {
+ public:
+  virtual ~ThreadPoolSpinPolicy() {}
+
+  // Maximum number of worker threads spinning at the same time.
+  virtual int MaxSpinningThreads(int /*num_threads*/) { return 1; }
+
+  // Number of steal attempts an idle worker does before parking.
+  virtual int SpinCount(int num_threads) = 0;
+
+  // Reports the outcome of a spin phase: `iterations` steal attempts were made
+  // and `found_work` tells whether a task was found before giving up.
+  virtual void Update(int /*iterations*/, bool /*found_work*/) {}
+};
+
+// Spins a fixed number of steal attempts. This is the default policy of the
+// pool, with 5000 attempts divided by the number of threads.
+class FixedSpinPolicy : public ThreadPoolSpinPolicy {
+ public:
+  explicit FixedSpinPolicy(int total_spin_count = 5000, int max_spinning_threads = 1)
+      : total_spin_count_(total_spin_count), max_spinning_threads_(max_spinning_threads) {}
+
+  int MaxSpinningThreads(int /*num_threads*/) override { return max_spinning_threads_; }
+
+  int SpinCount(int num_threads) override { return num_threads > 0 ? total_spin_count_ / num_threads : 0; }
+
+ private:
+  const int total_spin_count_;
+  const int max_spinning_threads_;
+};
+
+// Adapts the spin count to the observed arrival rate of new tasks, within the
+// [min_spin_count, max_spin_count] budget. When a spinning worker finds work
+// in the second half of its spin window, tasks arrive slightly too slowly to
+// be caught reliably and the window doubles. When it gives up without finding
+// work, spinning was wasted CPU time and the window halves. Latency critical
+// services with steady traffic thus converge to spinning long enough to catch
+// the next task, while batch jobs with bursty submissions quickly stop
+// burning CPU between bursts. The minimum must be at least 1: a worker that
+// does not spin never finds work while spinning, so the window would never
+// grow again.
+class AdaptiveSpinPolicy : public ThreadPoolSpinPolicy {
+ public:
+  AdaptiveSpinPolicy(int min_spin_count, int max_spin_count, int max_spinning_threads = 1)
+      : min_spin_count_(min_spin_count),
+        max_spin_count_(max_spin_count),
+        max_spinning_threads_(max_spinning_threads),
+        spin_count_(min_spin_count) {
+    eigen_plain_assert(1 <= min_spin_count && min_spin_count <= max_spin_count);
+  }
+
+  int MaxSpinningThreads(int /*num_threads*/) override { return max_spinning_threads_; }
+
+  int SpinCount(int /*num_threads*/) override { return spin_count_.load(std::memory_order_relaxed); }
+
+  void Update(int iterations, bool found_work) override {
+    const int current = spin_count_.load(std::memory_order_relaxed);
+    int next = current;
+    if (found_work) {
+      if (2 * iterations >= current) next = numext::mini(max_spin_count_, 2 * current);
+    } else {
+      next = numext::maxi(min_spin_count_, current / 2);
+    }
+    // Concurrent updates may overwrite each other, which is fine for a
+    // heuristic.
+    if (next != current) spin_count_.store(next, std::memory_order_relaxed);
+  }
+
+ private:
+  const int min_spin_count_;
+  const int max_spin_count_;
+  const int max_spinning_threads_;
+  std::atomic<int> spin_count_;
+};
+
+}  // namespace Eigen
+
+#endif  // EIGEN_CXX11_THREADPOOL_THREAD_POOL_SPIN_POLICY_H
@@ -0,0 +1,90 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares batches of small products:
+//  - a loop over Matrix<float,8,8> products (fixed size, lazy product),
+//  - a loop over dynamic-size products (general GEMM path),
+//  - batchedGemm on a CompactBatch,
+//  - batchedGemm on arrays of pointers.
+//
+// g++ -O3 -DNDEBUG -march=native -I.. bench_batched_gemm.cpp -o bench_batched_gemm
+
+#include "BenchTimer.h"
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/BatchedLinearAlgebra>
+
+#include <iostream>
+#include <vector>
+
+using namespace Eigen;
+
+#ifndef SCALAR
+#define SCALAR float
+#endif
+
+#ifndef SIZE
+#define SIZE 8
+#endif
+
+typedef SCALAR Scalar;
+typedef Matrix<Scalar, SIZE, SIZE> FixedMatrix;
+typedef Matrix<Scalar, Dynamic, Dynamic> DynamicMatrix;
+
+const int tries = 5, rep = 20;
+
+void report(const char* label, const BenchTimer& t, Index batch_size) {
+  const double seconds = t.best(REAL_TIMER) / rep;
+  const double flops = 2.0 * SIZE * SIZE * SIZE * batch_size;
+  std::cout << label << 1e9 * seconds / batch_size << " ns/product, " << 1e-9 * flops / seconds << " GFLOPS"
+            << std::endl;
+}
+
+int main() {
+  const Index batch_size = 10000;
+  std::cout << "batch of " << batch_size << " " << SIZE << "x" << SIZE << " products, " << CompactBatch<Scalar>::LaneCount
+            << " lanes" << std::endl;
+
+  std::vector<FixedMatrix, aligned_allocator<FixedMatrix> > fa(batch_size), fb(batch_size), fc(batch_size);
+  std::vector<DynamicMatrix> da(batch_size), db(batch_size), dc(batch_size);
+  CompactBatch<Scalar> ca(batch_size, SIZE, SIZE), cb(batch_size, SIZE, SIZE), cc(batch_size, SIZE, SIZE);
+  std::vector<const Scalar*> pa(batch_size), pb(batch_size);
+  std::vector<Scalar*> pc(batch_size);
+  for (Index i = 0; i < batch_size; ++i) {
+    fa[i].setRandom();
+    fb[i].setRandom();
+    da[i] = fa[i];
+    db[i] = fb[i];
+    dc[i].resize(SIZE, SIZE);
+    ca.set(i, fa[i]);
+    cb.set(i, fb[i]);
+    pa[i] = da[i].data();
+    pb[i] = db[i].data();
+    pc[i] = dc[i].data();
+  }
+
+  BenchTimer t;
+  BENCH(t, tries, rep, for (Index i = 0; i < batch_size; ++i) fc[i].noalias() = fa[i] * fb[i]);
+  report("Matrix<" EIGEN_MAKESTRING(SCALAR) "," EIGEN_MAKESTRING(SIZE) "," EIGEN_MAKESTRING(SIZE) "> loop: ", t,
+         batch_size);
+
+  BENCH(t, tries, rep, for (Index i = 0; i < batch_size; ++i) dc[i].noalias() = da[i] * db[i]);
+  report("dynamic-size loop:         ", t, batch_size);
+
+  BENCH(t, tries, rep, batchedGemm(ca, cb, cc));
+  report("compact batchedGemm:       ", t, batch_size);
+
+  BENCH(t, tries, rep,
+        batchedGemm<Scalar>(batch_size, SIZE, SIZE, SIZE, Scalar(1), pa.data(), SIZE, pb.data(), SIZE, Scalar(0),
+                            pc.data(), SIZE));
+  report("pointer-array batchedGemm: ", t, batch_size);
+
+  Scalar err = 0;
+  for (Index i = 0; i < batch_size; ++i) err = numext::maxi(err, (cc.get(i) - fc[i]).cwiseAbs().maxCoeff());
+  std::cout << "max error: " << err << std::endl;
+  return 0;
+}
@@ -0,0 +1,116 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares GEMM and a transposed copy of large matrices when the buffers are
+// allocated on the heap, memory-mapped with regular pages, and memory-mapped
+// with transparent huge pages (see setLargeBufferThreshold()). On Linux, the
+// data TLB misses are counted with perf_event_open if it is permitted.
+//
+// g++ -O3 -DNDEBUG -march=native -DEIGEN_USE_LARGE_BUFFER_MMAP -I.. bench_large_buffers.cpp -o bench_large_buffers
+//
+// ./bench_large_buffers [size]
+
+#include "BenchTimer.h"
+
+#include <Eigen/Core>
+
+#include <iostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Eigen;
+
+// Counts the data TLB load misses of the calling thread, if available.
+class TlbMissCounter {
+ public:
+  TlbMissCounter() : m_fd(-1) {
+#ifdef __linux__
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+  ~TlbMissCounter() {
+#ifdef __linux__
+    if (m_fd >= 0) close(m_fd);
+#endif
+  }
+  bool available() const { return m_fd >= 0; }
+  void start() {
+#ifdef __linux__
+    if (m_fd < 0) return;
+    ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+  long long stop() {
+    long long count = -1;
+#ifdef __linux__
+    if (m_fd < 0 || ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0) != 0 || read(m_fd, &count, sizeof(count)) != sizeof(count))
+      count = -1;
+#endif
+    return count;
+  }
+
+ private:
+  int m_fd;
+};
+
+void run(const char* name, Index n) {
+  releaseGemmWorkspace();
+  MatrixXd a = MatrixXd::Random(n, n), b = MatrixXd::Random(n, n), c(n, n);
+  TlbMissCounter tlb;
+  BenchTimer t;
+
+  tlb.start();
+  BENCH(t, 3, 1, c.noalias() = a * b);
+  long long gemm_misses = tlb.stop();
+  const double gemm_time = t.best(REAL_TIMER);
+
+  tlb.start();
+  BENCH(t, 3, 1, c = a.transpose());
+  long long transpose_misses = tlb.stop();
+  const double transpose_time = t.best(REAL_TIMER);
+
+  std::cout << name << ": gemm " << gemm_time << " s (" << 2e-9 * double(n) * double(n) * double(n) / gemm_time
+            << " GFLOPS), transpose " << transpose_time << " s";
+  if (tlb.available())
+    std::cout << ", dTLB load misses: gemm " << gemm_misses << ", transpose " << transpose_misses;
+  std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const Index n = argc > 1 ? std::atol(argv[1]) : 2048;
+  std::cout << n << "x" << n << " double matrices, " << double(n * n * sizeof(double)) / (1 << 20) << " MB each"
+            << std::endl;
+
+  setLargeBufferThreshold(0);
+  setLargeBufferOptions(0);
+  run("heap                 ", n);
+
+  setLargeBufferThreshold(2 << 20);
+  run("mmap, regular pages  ", n);
+
+  setLargeBufferOptions(LargeBufferHugePages);
+  run("mmap, huge pages     ", n);
+
+  setLargeBufferOptions(LargeBufferHugePages | LargeBufferPrefault);
+  run("mmap, huge, prefault ", n);
+  return 0;
+}
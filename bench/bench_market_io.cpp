@@ -0,0 +1,90 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Measures saveMarket and loadMarket on a random sparse matrix, and compares
+// loadMarket with a line by line std::getline + sscanf reader.
+//
+// g++ -O3 -DNDEBUG -std=c++17 -I.. bench_market_io.cpp -o bench_market_io
+// g++ -O3 -DNDEBUG -std=c++17 -DEIGEN_GEMM_THREADPOOL -pthread -I.. bench_market_io.cpp -o bench_market_io
+//
+// ./bench_market_io [rows [nnz_per_column [threads]]]
+
+#include "BenchTimer.h"
+
+#include <Eigen/SparseCore>
+#include <unsupported/Eigen/SparseExtra>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Eigen;
+
+typedef SparseMatrix<double> SpMat;
+
+bool getlineLoadMarket(SpMat& mat, const std::string& filename) {
+  std::ifstream in(filename.c_str());
+  if (!in) return false;
+  std::string line;
+  while (std::getline(in, line) && line[0] == '%') {
+  }
+  long rows, cols, nnz;
+  if (std::sscanf(line.c_str(), "%ld %ld %ld", &rows, &cols, &nnz) != 3) return false;
+  std::vector<Triplet<double> > entries;
+  entries.reserve(nnz);
+  while (std::getline(in, line)) {
+    int i, j;
+    double value;
+    if (std::sscanf(line.c_str(), "%d %d %lg", &i, &j, &value) == 3)
+      entries.push_back(Triplet<double>(i - 1, j - 1, value));
+  }
+  mat.resize(rows, cols);
+  mat.setFromTriplets(entries.begin(), entries.end());
+  return Index(entries.size()) == nnz;
+}
+
+int main(int argc, char** argv) {
+  const Index rows = argc > 1 ? std::atol(argv[1]) : 200000;
+  const Index nnz_per_col = argc > 2 ? std::atol(argv[2]) : 50;
+#ifdef EIGEN_GEMM_THREADPOOL
+  const int threads = argc > 3 ? std::atoi(argv[3]) : 4;
+  ThreadPool pool(threads);
+  setGemmThreadPool(&pool);
+#endif
+  std::cout << "threads: " << nbThreads() << std::endl;
+
+  std::vector<Triplet<double> > entries;
+  entries.reserve(rows * nnz_per_col);
+  for (Index j = 0; j < rows; ++j)
+    for (Index k = 0; k < nnz_per_col; ++k)
+      entries.push_back(Triplet<double>(internal::random<Index>(0, rows - 1), j, internal::random<double>()));
+  SpMat m(rows, rows), m1, m2;
+  m.setFromTriplets(entries.begin(), entries.end());
+
+  const std::string filename = "bench_market_io.mtx";
+  BenchTimer t;
+  BENCH(t, 1, 1, saveMarket(m, filename));
+  std::ifstream size_check(filename.c_str(), std::ios::binary | std::ios::ate);
+  const double megabytes = double(size_check.tellg()) / (1 << 20);
+  std::cout << m.nonZeros() << " nonzeros, " << megabytes << " MB" << std::endl;
+  std::cout << "saveMarket:              " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  BENCH(t, 3, 1, loadMarket(m1, filename));
+  std::cout << "loadMarket:              " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  BENCH(t, 3, 1, getlineLoadMarket(m2, filename));
+  std::cout << "getline + sscanf reader: " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  if (!m1.isApprox(m) || !m2.isApprox(m)) std::cerr << "error: mismatch" << std::endl;
+  std::remove(filename.c_str());
+  return 0;
+}
@@ -0,0 +1,59 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Compares heap and MemoryArena allocation of the dynamic-size matrices and
+// temporaries of a request-like workload of small expressions.
+//
+// g++ -O3 -DNDEBUG -I.. bench_memory_arena.cpp -o bench_memory_arena
+//
+// ./bench_memory_arena [size [requests]]
+
+#include "BenchTimer.h"
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+#include <iostream>
+
+using namespace Eigen;
+
+// A few expressions creating short-lived dynamic matrices, vectors and product temporaries.
+double request(const MatrixXd& a, const MatrixXd& b, const VectorXd& v) {
+  MatrixXd c = a * b + b.transpose();
+  MatrixXd d = (c.array() * a.array()).matrix() * (a - b);
+  VectorXd w = d * v + c.transpose() * v;
+  MatrixXd e = d.topRows(a.rows() / 2) + c.bottomRows(a.rows() / 2);
+  VectorXd x = e.transpose() * w.head(a.rows() / 2);
+  PartialPivLU<MatrixXd> lu(c + MatrixXd::Identity(a.rows(), a.cols()) * double(a.rows()));
+  VectorXd y = lu.solve(w);
+  return x.sum() + y.squaredNorm() + d.norm();
+}
+
+int main(int argc, char** argv) {
+  const Index size = argc > 1 ? std::atol(argv[1]) : 12;
+  const int requests = argc > 2 ? std::atoi(argv[2]) : 10000;
+  MatrixXd a = MatrixXd::Random(size, size), b = MatrixXd::Random(size, size);
+  VectorXd v = VectorXd::Random(size);
+
+  double heap_result = 0, arena_result = 0;
+  BenchTimer heap, arena_timer;
+  BENCH(heap, 5, 1, for (int k = 0; k < requests; ++k) heap_result += request(a, b, v));
+
+  MemoryArena arena;
+  BENCH(arena_timer, 5, 1, for (int k = 0; k < requests; ++k) {
+    ScopedMemoryArena scope(&arena);
+    arena_result += request(a, b, v);
+    arena.reset();
+  });
+
+  std::cout << requests << " requests on " << size << "x" << size << " matrices" << std::endl;
+  std::cout << "heap:  " << heap.best(REAL_TIMER) * 1e6 / requests << " us per request" << std::endl;
+  std::cout << "arena: " << arena_timer.best(REAL_TIMER) * 1e6 / requests << " us per request, "
+            << arena.capacity() << " bytes" << std::endl;
+  if (std::abs(heap_result - arena_result) > 1e-6 * std::abs(heap_result)) std::cerr << "error: mismatch" << std::endl;
+  return 0;
+}
@@ -0,0 +1,96 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Measures saveText and loadText on a random dense matrix, and compares them
+// with operator<< and a line by line std::getline + std::stringstream reader.
+//
+// g++ -O3 -DNDEBUG -std=c++17 -I.. bench_text_io.cpp -o bench_text_io
+// g++ -O3 -DNDEBUG -std=c++17 -DEIGEN_GEMM_THREADPOOL -pthread -I.. bench_text_io.cpp -o bench_text_io
+//
+// ./bench_text_io [rows [cols [threads]]]
+
+#include "BenchTimer.h"
+
+#include <Eigen/Core>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Eigen;
+
+bool streamSaveText(const MatrixXd& m, const std::string& filename) {
+  std::ofstream out(filename.c_str());
+  out << m.format(IOFormat(FullPrecision, DontAlignCols, ",", "\n")) << "\n";
+  return bool(out);
+}
+
+bool getlineLoadText(MatrixXd& m, const std::string& filename) {
+  std::ifstream in(filename.c_str());
+  if (!in) return false;
+  std::vector<double> values;
+  std::string line, token;
+  Index rows = 0;
+  while (std::getline(in, line)) {
+    std::stringstream s(line);
+    while (std::getline(s, token, ',')) values.push_back(std::stod(token));
+    ++rows;
+  }
+  if (rows == 0) return false;
+  m = Map<Matrix<double, Dynamic, Dynamic, RowMajor> >(values.data(), rows, Index(values.size()) / rows);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const Index rows = argc > 1 ? std::atol(argv[1]) : 200000;
+  const Index cols = argc > 2 ? std::atol(argv[2]) : 20;
+#ifdef EIGEN_GEMM_THREADPOOL
+  const int threads = argc > 3 ? std::atoi(argv[3]) : 4;
+  ThreadPool pool(threads);
+  setGemmThreadPool(&pool);
+#endif
+  std::cout << "threads: " << nbThreads() << std::endl;
+
+  MatrixXd m = MatrixXd::Random(rows, cols), m1, m2;
+  const std::string filename = "bench_text_io.csv";
+  BenchTimer t;
+  BENCH(t, 3, 1, saveText(filename, m));
+  std::ifstream size_check(filename.c_str(), std::ios::binary | std::ios::ate);
+  const double megabytes = double(size_check.tellg()) / (1 << 20);
+  std::cout << rows << "x" << cols << ", " << megabytes << " MB" << std::endl;
+  std::cout << "saveText:                " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  BENCH(t, 3, 1, loadText(filename, m1));
+  std::cout << "loadText:                " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  BENCH(t, 3, 1, getlineLoadText(m2, filename));
+  std::cout << "getline + stringstream:  " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  BENCH(t, 3, 1, streamSaveText(m, filename));
+  std::cout << "operator<<:              " << t.best(REAL_TIMER) << " s, " << megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  const std::string raw = "bench_text_io.bin";
+  BENCH(t, 3, 1, saveRaw(raw, m));
+  const double raw_megabytes = double(m.size() * sizeof(double)) / (1 << 20);
+  std::cout << "saveRaw:                 " << t.best(REAL_TIMER) << " s, " << raw_megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+  BENCH(t, 3, 1, loadRaw(raw, m2));
+  std::cout << "loadRaw:                 " << t.best(REAL_TIMER) << " s, " << raw_megabytes / t.best(REAL_TIMER)
+            << " MB/s" << std::endl;
+
+  if (m1 != m || m2 != m) std::cerr << "error: mismatch" << std::endl;
+  std::remove(filename.c_str());
+  std::remove(raw.c_str());
+  return 0;
+}
@@ -0,0 +1,67 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Measures the per-task overhead of submitting fine-grained tasks to the
+// non-blocking thread pool:
+//  - closures larger than the small buffer of std::function (heap allocated),
+//  - closures that fit in the small buffer,
+//  - ThreadPoolInterface::ScheduleBulk (one allocation per submission).
+//
+// g++ -O3 -DNDEBUG -I.. -pthread thread_pool_schedule.cpp -o thread_pool_schedule
+
+#define EIGEN_USE_THREADS
+#include "BenchTimer.h"
+
+#include <Eigen/ThreadPool>
+
+#include <iostream>
+
+using namespace Eigen;
+
+template <typename Submit>
+void bench(const char* label, int num_threads, int num_tasks, Submit submit) {
+  ThreadPool pool(num_threads);
+  BenchTimer t;
+  const int tries = 10;
+  for (int k = 0; k < tries; ++k) {
+    Barrier barrier(num_tasks);
+    t.start();
+    submit(pool, barrier, num_tasks);
+    barrier.Wait();
+    t.stop();
+  }
+  std::cout << label << " (" << num_threads << " threads): " << 1e9 * t.best(REAL_TIMER) / num_tasks << " ns/task"
+            << std::endl;
+}
+
+int main() {
+  const int num_tasks = 1 << 18;
+  for (int num_threads : {1, 4, 16}) {
+    bench("large closure    ", num_threads, num_tasks, [](ThreadPool& pool, Barrier& barrier, int n) {
+      for (int i = 0; i < n; ++i) {
+        Index a = i, b = i + 1;
+        pool.Schedule([&barrier, a, b]() {
+          EIGEN_UNUSED_VARIABLE(a);
+          EIGEN_UNUSED_VARIABLE(b);
+          barrier.Notify();
+        });
+      }
+    });
+    bench("small closure    ", num_threads, num_tasks, [](ThreadPool& pool, Barrier& barrier, int n) {
+      for (int i = 0; i < n; ++i) {
+        pool.Schedule([&barrier, i]() {
+          EIGEN_UNUSED_VARIABLE(i);
+          barrier.Notify();
+        });
+      }
+    });
+    bench("ScheduleBulk     ", num_threads, num_tasks, [](ThreadPool& pool, Barrier& barrier, int n) {
+      pool.ScheduleBulk(n, [&barrier](int) { barrier.Notify(); });
+    });
+  }
+  return 0;
+}
@@ -344,6 +344,31 @@ void BLASFUNC(zgemm)(const char *, const char *, const int *, const int *, const
 void BLASFUNC(xgemm)(const char *, const char *, const int *, const int *, const int *, const double *, const double *,
                      const int *, const double *, const int *, const double *, double *, const int *);
 
+void BLASFUNC(sgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const float *,
+                                   const float *, const int *, const int *, const float *, const int *, const int *,
+                                   const float *, float *, const int *, const int *, const int *);
+void BLASFUNC(dgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const double *,
+                                   const double *, const int *, const int *, const double *, const int *, const int *,
+                                   const double *, double *, const int *, const int *, const int *);
+void BLASFUNC(cgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const float *,
+                                   const float *, const int *, const int *, const float *, const int *, const int *,
+                                   const float *, float *, const int *, const int *, const int *);
+void BLASFUNC(zgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const double *,
+                                   const double *, const int *, const int *, const double *, const int *, const int *,
+                                   const double *, double *, const int *, const int *, const int *);
+void BLASFUNC(sgemm_batch)(const char *, const char *, const int *, const int *, const int *, const float *,
+                           const float *const *, const int *, const float *const *, const int *, const float *,
+                           float *const *, const int *, const int *, const int *);
+void BLASFUNC(dgemm_batch)(const char *, const char *, const int *, const int *, const int *, const double *,
+                           const double *const *, const int *, const double *const *, const int *, const double *,
+                           double *const *, const int *, const int *, const int *);
+void BLASFUNC(cgemm_batch)(const char *, const char *, const int *, const int *, const int *, const float *,
+                           const float *const *, const int *, const float *const *, const int *, const float *,
+                           float *const *, const int *, const int *, const int *);
+void BLASFUNC(zgemm_batch)(const char *, const char *, const int *, const int *, const int *, const double *,
+                           const double *const *, const int *, const double *const *, const int *, const double *,
+                           double *const *, const int *, const int *, const int *);
+
 void BLASFUNC(cgemm3m)(char *, char *, int *, int *, int *, float *, float *, int *, float *, int *, float *, float *,
                        int *);
 void BLASFUNC(zgemm3m)(char *, char *, int *, int *, int *, double *, double *, int *, double *, int *, double *,
@@ -464,6 +489,35 @@ void BLASFUNC(zher2m)(const char *, const char *, const char *, const int *, con
 void BLASFUNC(xher2m)(const char *, const char *, const char *, const int *, const int *, const double *,
                       const double *, const int *, const double *, const int *, const double *, double *, const int *);
 
+/* Batched gemm with the CBLAS calling convention. The layout and transpose arguments take the values of the
+   CBLAS_LAYOUT and CBLAS_TRANSPOSE enums (CblasRowMajor = 101, CblasColMajor = 102, CblasNoTrans = 111,
+   CblasTrans = 112, CblasConjTrans = 113), and complex scalars are passed by address. */
+void cblas_sgemm_batch(int, const int *, const int *, const int *, const int *, const int *, const float *,
+                       const float **, const int *, const float **, const int *, const float *, float **,
+                       const int *, int, const int *);
+void cblas_sgemm_batch_strided(int, int, int, int, int, int, float, const float *, int, int, const float *, int, int,
+                               float, float *, int, int, int);
+void cblas_dgemm_batch(int, const int *, const int *, const int *, const int *, const int *, const double *,
+                       const double **, const int *, const double **, const int *, const double *, double **,
+                       const int *, int, const int *);
+void cblas_dgemm_batch_strided(int, int, int, int, int, int, double, const double *, int, int, const double *, int, int,
+                               double, double *, int, int, int);
+void cblas_cgemm_batch(int, const int *, const int *, const int *, const int *, const int *, const void *,
+                       const void **, const int *, const void **, const int *, const void *, void **, const int *, int,
+                       const int *);
+void cblas_cgemm_batch_strided(int, int, int, int, int, int, const void *, const void *, int, int, const void *, int,
+                               int, const void *, void *, int, int, int);
+void cblas_zgemm_batch(int, const int *, const int *, const int *, const int *, const int *, const void *,
+                       const void **, const int *, const void **, const int *, const void *, void **, const int *, int,
+                       const int *);
+void cblas_zgemm_batch_strided(int, int, int, int, int, int, const void *, const void *, int, int, const void *, int,
+                               int, const void *, void *, int, int, int);
+
+/* Threading of the level 3 routines, see README.txt. */
+int eigen_blas_get_max_threads(void);
+int eigen_blas_get_num_threads(void);
+void eigen_blas_set_num_threads(int);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,129 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// CBLAS interface of the batched gemm routines ?gemm_batch_ and ?gemm_batch_strided_ of level3_impl.h.
+//
+// A row-major product C = op(A) * op(B) is computed as the column-major product C^T = op(B)^T * op(A)^T, so that
+// both layouts map onto the column-major routines without copies.
+
+#include <vector>
+
+#include "blas.h"
+
+namespace {
+
+enum { CblasRowMajor = 101, CblasColMajor = 102, CblasNoTrans = 111, CblasTrans = 112, CblasConjTrans = 113 };
+
+char trans_char(int trans) {
+  return trans == CblasNoTrans ? 'N' : trans == CblasTrans ? 'T' : trans == CblasConjTrans ? 'C' : '?';
+}
+
+void layout_error(const char* name) {
+  int info = 1;
+  xerbla_(name, &info);
+}
+
+template <typename T, typename Func>
+void gemm_batch_strided(Func func, const char* name, int layout, int transa, int transb, int m, int n, int k,
+                        const T* alpha, const T* a, int lda, int stridea, const T* b, int ldb, int strideb,
+                        const T* beta, T* c, int ldc, int stridec, int batch_size) {
+  const char opa = trans_char(transa), opb = trans_char(transb);
+  if (layout == CblasColMajor)
+    func(&opa, &opb, &m, &n, &k, alpha, a, &lda, &stridea, b, &ldb, &strideb, beta, c, &ldc, &stridec, &batch_size);
+  else if (layout == CblasRowMajor)
+    func(&opb, &opa, &n, &m, &k, alpha, b, &ldb, &strideb, a, &lda, &stridea, beta, c, &ldc, &stridec, &batch_size);
+  else
+    layout_error(name);
+}
+
+template <typename T, typename Func>
+void gemm_batch(Func func, const char* name, int layout, const int* transa, const int* transb, const int* m,
+                const int* n, const int* k, const T* alpha, const T* const* a, const int* lda, const T* const* b,
+                const int* ldb, const T* beta, T* const* c, const int* ldc, int group_count, const int* group_size) {
+  std::vector<char> opa(group_count > 0 ? group_count : 0), opb(opa.size());
+  for (int g = 0; g < group_count; ++g) {
+    opa[g] = trans_char(transa[g]);
+    opb[g] = trans_char(transb[g]);
+  }
+  if (layout == CblasColMajor)
+    func(opa.data(), opb.data(), m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, &group_count, group_size);
+  else if (layout == CblasRowMajor)
+    func(opb.data(), opa.data(), n, m, k, alpha, b, ldb, a, lda, beta, c, ldc, &group_count, group_size);
+  else
+    layout_error(name);
+}
+
+}  // namespace
+
+extern "C" {
+
+void cblas_sgemm_batch_strided(int layout, int transa, int transb, int m, int n, int k, float alpha, const float* a,
+                               int lda, int stridea, const float* b, int ldb, int strideb, float beta, float* c,
+                               int ldc, int stridec, int batch_size) {
+  gemm_batch_strided<float>(&BLASFUNC(sgemm_batch_strided), "cblas_sgemm_batch_strided", layout, transa, transb, m, n,
+                            k, &alpha, a, lda, stridea, b, ldb, strideb, &beta, c, ldc, stridec, batch_size);
+}
+
+void cblas_dgemm_batch_strided(int layout, int transa, int transb, int m, int n, int k, double alpha, const double* a,
+                               int lda, int stridea, const double* b, int ldb, int strideb, double beta, double* c,
+                               int ldc, int stridec, int batch_size) {
+  gemm_batch_strided<double>(&BLASFUNC(dgemm_batch_strided), "cblas_dgemm_batch_strided", layout, transa, transb, m,
+                             n, k, &alpha, a, lda, stridea, b, ldb, strideb, &beta, c, ldc, stridec, batch_size);
+}
+
+void cblas_cgemm_batch_strided(int layout, int transa, int transb, int m, int n, int k, const void* alpha,
+                               const void* a, int lda, int stridea, const void* b, int ldb, int strideb,
+                               const void* beta, void* c, int ldc, int stridec, int batch_size) {
+  gemm_batch_strided<float>(&BLASFUNC(cgemm_batch_strided), "cblas_cgemm_batch_strided", layout, transa, transb, m, n,
+                            k, static_cast<const float*>(alpha), static_cast<const float*>(a), lda, stridea,
+                            static_cast<const float*>(b), ldb, strideb, static_cast<const float*>(beta),
+                            static_cast<float*>(c), ldc, stridec, batch_size);
+}
+
+void cblas_zgemm_batch_strided(int layout, int transa, int transb, int m, int n, int k, const void* alpha,
+                               const void* a, int lda, int stridea, const void* b, int ldb, int strideb,
+                               const void* beta, void* c, int ldc, int stridec, int batch_size) {
+  gemm_batch_strided<double>(&BLASFUNC(zgemm_batch_strided), "cblas_zgemm_batch_strided", layout, transa, transb, m,
+                             n, k, static_cast<const double*>(alpha), static_cast<const double*>(a), lda, stridea,
+                             static_cast<const double*>(b), ldb, strideb, static_cast<const double*>(beta),
+                             static_cast<double*>(c), ldc, stridec, batch_size);
+}
+
+void cblas_sgemm_batch(int layout, const int* transa, const int* transb, const int* m, const int* n, const int* k,
+                       const float* alpha, const float** a, const int* lda, const float** b, const int* ldb,
+                       const float* beta, float** c, const int* ldc, int group_count, const int* group_size) {
+  gemm_batch<float>(&BLASFUNC(sgemm_batch), "cblas_sgemm_batch", layout, transa, transb, m, n, k, alpha, a, lda, b,
+                    ldb, beta, c, ldc, group_count, group_size);
+}
+
+void cblas_dgemm_batch(int layout, const int* transa, const int* transb, const int* m, const int* n, const int* k,
+                       const double* alpha, const double** a, const int* lda, const double** b, const int* ldb,
+                       const double* beta, double** c, const int* ldc, int group_count, const int* group_size) {
+  gemm_batch<double>(&BLASFUNC(dgemm_batch), "cblas_dgemm_batch", layout, transa, transb, m, n, k, alpha, a, lda, b,
+                     ldb, beta, c, ldc, group_count, group_size);
+}
+
+// Complex scalars are passed by address: alpha and beta point to arrays of group_count complex numbers, and the
+// matrices are arrays of complex numbers.
+void cblas_cgemm_batch(int layout, const int* transa, const int* transb, const int* m, const int* n, const int* k,
+                       const void* alpha, const void** a, const int* lda, const void** b, const int* ldb,
+                       const void* beta, void** c, const int* ldc, int group_count, const int* group_size) {
+  gemm_batch<float>(&BLASFUNC(cgemm_batch), "cblas_cgemm_batch", layout, transa, transb, m, n, k,
+                    static_cast<const float*>(alpha), reinterpret_cast<const float* const*>(a), lda,
+                    reinterpret_cast<const float* const*>(b), ldb, static_cast<const float*>(beta),
+                    reinterpret_cast<float* const*>(c), ldc, group_count, group_size);
+}
+
+void cblas_zgemm_batch(int layout, const int* transa, const int* transb, const int* m, const int* n, const int* k,
+                       const void* alpha, const void** a, const int* lda, const void** b, const int* ldb,
+                       const void* beta, void** c, const int* ldc, int group_count, const int* group_size) {
+  gemm_batch<double>(&BLASFUNC(zgemm_batch), "cblas_zgemm_batch", layout, transa, transb, m, n, k,
+                     static_cast<const double*>(alpha), reinterpret_cast<const double* const*>(a), lda,
+                     reinterpret_cast<const double* const*>(b), ldb, static_cast<const double*>(beta),
+                     reinterpret_cast<double* const*>(c), ldc, group_count, group_size);
+}
+}
@@ -21,6 +21,7 @@
 #include "../Eigen/Core"
 #include "../Eigen/Jacobi"
 
+#include <atomic>
 #include <complex>
 
 #ifndef SCALAR
@@ -60,12 +61,18 @@
 
 #define DIAG(X) (((X) == 'N' || (X) == 'n') ? NUNIT : ((X) == 'U' || (X) == 'u') ? UNIT : INVALID)
 
+// The helpers below have internal linkage: the library links objects compiled for several ISAs (see dispatch.cpp),
+// which must not share a single copy of them.
+namespace {
+
 inline bool check_op(const char* op) { return OP(*op) != 0xff; }
 
 inline bool check_side(const char* side) { return SIDE(*side) != 0xff; }
 
 inline bool check_uplo(const char* uplo) { return UPLO(*uplo) != 0xff; }
 
+}  // namespace
+
 typedef SCALAR Scalar;
 typedef Eigen::NumTraits<Scalar>::Real RealScalar;
 typedef std::complex<RealScalar> Complex;
@@ -81,6 +88,8 @@ typedef Eigen::Map<const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, E
 typedef Eigen::Map<Eigen::Matrix<Scalar, Eigen::Dynamic, 1>, 0, Eigen::InnerStride<Eigen::Dynamic> > StridedVectorType;
 typedef Eigen::Map<Eigen::Matrix<Scalar, Eigen::Dynamic, 1> > CompactVectorType;
 
+namespace {
+
 template <typename T>
 Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor>, 0, Eigen::OuterStride<> > matrix(
     T* data, int rows, int cols, int stride) {
@@ -143,6 +152,60 @@ T* copy_back(T* x_cpy, T* x, int n, int incx) {
   return x_cpy;
 }
 
+}  // namespace
+
+namespace Eigen {
+namespace internal {
+
+// Multithreading of the level 3 routines.
+//
+// With EIGEN_BLAS_THREADPOOL (see CMakeLists.txt), the level 3 routines run on a ThreadPool of
+// eigen_blas_get_max_threads() threads created at first use, and eigen_blas_set_num_threads() bounds the number of
+// threads of the subsequent calls. The same code runs on OpenMP threads when the library is compiled with OpenMP,
+// and serially otherwise. The symbols of the ISA variants are local to each of them (see CMakeLists.txt), so that
+// each variant has its own pool.
+
+// Must be called by each level 3 routine before it runs any parallel code.
+inline void blas_init_threads() {
+#if defined(EIGEN_GEMM_THREADPOOL)
+  static ThreadPool pool(eigen_blas_get_max_threads());
+  static const bool pool_is_set = (setGemmThreadPool(&pool), true);
+  EIGEN_UNUSED_VARIABLE(pool_is_set);
+#endif
+#if defined(EIGEN_GEMM_THREADPOOL) || defined(EIGEN_HAS_OPENMP)
+  static std::atomic<int> applied(-1);
+  const int threads = eigen_blas_get_num_threads();
+  if (applied.exchange(threads) != threads) setNbThreads(threads);
+#endif
+}
+
+// Returns the number of parallel slices, multiple of granularity, of an operation on size rows or columns that
+// performs work multiply-adds. As in parallelize_gemm, a slice should have at least 50000 of them.
+inline int blas_slice_count(int size, int granularity, double work) {
+  const double kMinTaskSize = 50000;
+  const double slices =
+      numext::mini(double(nbThreads()), numext::mini(double(size / granularity), work / kMinTaskSize));
+  return slices > 1 ? int(slices) : 1;
+}
+
+// Calls func(start, length) on consecutive slices covering [0, size), in parallel if the operation is large enough.
+template <typename Func>
+void blas_parallel_slices(int size, int granularity, double work, const Func& func) {
+  int slices = blas_slice_count(size, granularity, work);
+  if (slices == 1) return func(0, size);
+  const int slice = (size / slices + granularity - 1) / granularity * granularity;
+  slices = (size + slice - 1) / slice;
+  parallelize_tasks(
+      [&](int i) {
+        const int start = i * slice;
+        func(start, numext::mini(slice, size - start));
+      },
+      slices);
+}
+
+}  // namespace internal
+}  // namespace Eigen
+
 #ifndef EIGEN_BLAS_FUNC_SUFFIX
 #define EIGEN_BLAS_FUNC_SUFFIX _
 #endif
@@ -150,4 +213,15 @@ T* copy_back(T* x_cpy, T* x, int n, int incx) {
 #define EIGEN_BLAS_FUNC_NAME(X) EIGEN_CAT(SCALAR_SUFFIX, EIGEN_CAT(X, EIGEN_BLAS_FUNC_SUFFIX))
 #define EIGEN_BLAS_FUNC(X) extern "C" void EIGEN_BLAS_FUNC_NAME(X)
 
+// Routines that have ISA-specific variants selected at runtime when the
+// library is built with EIGEN_BLAS_DISPATCH (see dispatch.cpp). The baseline
+// build names them with EIGEN_BLAS_DISPATCH_FUNC_SUFFIX, so that the public
+// name is left to the dispatcher.
+#ifndef EIGEN_BLAS_DISPATCH_FUNC_SUFFIX
+#define EIGEN_BLAS_DISPATCH_FUNC_SUFFIX EIGEN_BLAS_FUNC_SUFFIX
+#endif
+
+#define EIGEN_BLAS_DISPATCH_FUNC(X) \
+  extern "C" void EIGEN_CAT(SCALAR_SUFFIX, EIGEN_CAT(X, EIGEN_BLAS_DISPATCH_FUNC_SUFFIX))
+
 #endif  // EIGEN_BLAS_COMMON_H
@@ -13,8 +13,14 @@
 #define REAL_SCALAR_SUFFIX d
 #define ISCOMPLEX 1
 
+#include "level2_impl.h"
+#include "level3_impl.h"
+
+// The ISA variants of the library (see dispatch.cpp) only define the dispatched routines of level2_impl.h and
+// level3_impl.h.
+#ifndef EIGEN_BLAS_DISPATCH_VARIANT
 #include "level1_impl.h"
 #include "level1_cplx_impl.h"
-#include "level2_impl.h"
 #include "level2_cplx_impl.h"
-#include "level3_impl.h"
+
+#endif  // EIGEN_BLAS_DISPATCH_VARIANT
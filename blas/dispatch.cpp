@@ -0,0 +1,130 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Runtime selection of the ISA specific variants of the level 2 and level 3
+// kernels, compiled when the library is configured with EIGEN_BLAS_DISPATCH.
+//
+// The baseline objects define <p>gemm_default_ and friends, while the AVX2 and
+// AVX-512 objects define <p>gemm_avx2_ and <p>gemm_avx512_. The public entry
+// points below pick the best variant supported by the CPU on first call. The
+// environment variable EIGEN_BLAS_ISA (default, avx2 or avx512) caps the
+// selection, which is handy to compare variants on the same machine.
+
+#include <cstdlib>
+#include <cstring>
+
+#include "blas.h"
+
+namespace {
+
+enum BlasIsa { IsaDefault = 0, IsaAvx2 = 1, IsaAvx512 = 2 };
+
+BlasIsa detect_isa() {
+  BlasIsa isa = IsaDefault;
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    isa = IsaAvx2;
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw"))
+      isa = IsaAvx512;
+  }
+
+  const char* requested = std::getenv("EIGEN_BLAS_ISA");
+  if (requested) {
+    BlasIsa cap = isa;
+    if (std::strcmp(requested, "default") == 0)
+      cap = IsaDefault;
+    else if (std::strcmp(requested, "avx2") == 0)
+      cap = IsaAvx2;
+    else if (std::strcmp(requested, "avx512") == 0)
+      cap = IsaAvx512;
+    if (cap < isa) isa = cap;
+  }
+  return isa;
+}
+
+BlasIsa selected_isa() {
+  static const BlasIsa isa = detect_isa();
+  return isa;
+}
+
+template <typename Func>
+Func select(Func default_variant, Func avx2_variant, Func avx512_variant) {
+  switch (selected_isa()) {
+    case IsaAvx512:
+      return avx512_variant;
+    case IsaAvx2:
+      return avx2_variant;
+    default:
+      return default_variant;
+  }
+}
+
+}  // namespace
+
+#define EIGEN_BLAS_DISPATCH_VARIANTS(NAME, PARAMS)          \
+  extern "C" void NAME##_default_ PARAMS;                   \
+  extern "C" void NAME##_avx2_ PARAMS;                      \
+  extern "C" void NAME##_avx512_ PARAMS;
+
+#define EIGEN_BLAS_DISPATCH_ENTRY(NAME, PARAMS, ARGS)                                                        \
+  EIGEN_BLAS_DISPATCH_VARIANTS(NAME, PARAMS)                                                                 \
+  extern "C" void NAME##_ PARAMS {                                                                           \
+    typedef void(*functype) PARAMS;                                                                          \
+    static const functype func = select<functype>(&NAME##_default_, &NAME##_avx2_, &NAME##_avx512_);         \
+    func ARGS;                                                                                               \
+  }
+
+#define EIGEN_BLAS_DISPATCH_GEMM(P, T)                                                                            \
+  EIGEN_BLAS_DISPATCH_ENTRY(P##gemm,                                                                              \
+                            (const char *opa, const char *opb, const int *m, const int *n, const int *k,          \
+                             const T *alpha, const T *a, const int *lda, const T *b, const int *ldb,              \
+                             const T *beta, T *c, const int *ldc),                                                \
+                            (opa, opb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))                             \
+  EIGEN_BLAS_DISPATCH_ENTRY(P##gemm_batch_strided,                                                                \
+                            (const char *opa, const char *opb, const int *m, const int *n, const int *k,          \
+                             const T *alpha, const T *a, const int *lda, const int *stridea, const T *b,          \
+                             const int *ldb, const int *strideb, const T *beta, T *c, const int *ldc,             \
+                             const int *stridec, const int *batch_size),                                          \
+                            (opa, opb, m, n, k, alpha, a, lda, stridea, b, ldb, strideb, beta, c, ldc, stridec,   \
+                             batch_size))                                                                         \
+  EIGEN_BLAS_DISPATCH_ENTRY(P##gemm_batch,                                                                        \
+                            (const char *opa, const char *opb, const int *m, const int *n, const int *k,          \
+                             const T *alpha, const T *const *a, const int *lda, const T *const *b,                \
+                             const int *ldb, const T *beta, T *const *c, const int *ldc, const int *group_count,  \
+                             const int *group_size),                                                              \
+                            (opa, opb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, group_count, group_size))    \
+  EIGEN_BLAS_DISPATCH_ENTRY(P##gemv,                                                                              \
+                            (const char *opa, const int *m, const int *n, const T *alpha, const T *a,             \
+                             const int *lda, const T *b, const int *incb, const T *beta, T *c, const int *incc),  \
+                            (opa, m, n, alpha, a, lda, b, incb, beta, c, incc))                                   \
+  EIGEN_BLAS_DISPATCH_ENTRY(P##trsm,                                                                              \
+                            (const char *side, const char *uplo, const char *opa, const char *diag, const int *m, \
+                             const int *n, const T *alpha, const T *a, const int *lda, T *b, const int *ldb),     \
+                            (side, uplo, opa, diag, m, n, alpha, a, lda, b, ldb))                                 \
+  EIGEN_BLAS_DISPATCH_ENTRY(P##trsv,                                                                              \
+                            (const char *uplo, const char *opa, const char *diag, const int *n, const T *a,       \
+                             const int *lda, T *b, const int *incb),                                              \
+                            (uplo, opa, diag, n, a, lda, b, incb))
+
+// Complex routines take their arguments as pointers to the real type.
+EIGEN_BLAS_DISPATCH_GEMM(s, float)
+EIGEN_BLAS_DISPATCH_GEMM(d, double)
+EIGEN_BLAS_DISPATCH_GEMM(c, float)
+EIGEN_BLAS_DISPATCH_GEMM(z, double)
+
+// Returns the name of the ISA variant used by the dispatched routines.
+extern "C" const char *eigen_blas_dispatch_isa() {
+  switch (selected_isa()) {
+    case IsaAvx512:
+      return "avx512";
+    case IsaAvx2:
+      return "avx2";
+    default:
+      return "default";
+  }
+}
@@ -13,11 +13,15 @@
 #define SCALAR_SUFFIX_UP "D"
 #define ISCOMPLEX 0
 
+#include "level2_impl.h"
+#include "level3_impl.h"
+
+// The ISA variants of the library (see dispatch.cpp) only define the dispatched routines of level2_impl.h and
+// level3_impl.h.
+#ifndef EIGEN_BLAS_DISPATCH_VARIANT
 #include "level1_impl.h"
 #include "level1_real_impl.h"
-#include "level2_impl.h"
 #include "level2_real_impl.h"
-#include "level3_impl.h"
 
 extern "C" double EIGEN_BLAS_FUNC_NAME(sdot)(int* n, float* x, int* incx, float* y, int* incy) {
   if (*n <= 0) return 0;
@@ -41,3 +45,5 @@ extern "C" double EIGEN_BLAS_FUNC_NAME(sdot)(int* n, float* x, int* incx, float*
   else
     return 0;
 }
+
+#endif  // EIGEN_BLAS_DISPATCH_VARIANT
@@ -9,10 +9,12 @@
 
 #include "common.h"
 
+namespace {
 struct scalar_norm1_op {
   typedef RealScalar result_type;
   inline RealScalar operator()(const Scalar &a) const { return Eigen::numext::norm1(a); }
 };
+}  // namespace
 namespace Eigen {
 namespace internal {
 template <>
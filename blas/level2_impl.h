@@ -9,6 +9,8 @@
 
 #include "common.h"
 
+namespace {
+
 template <typename Index, typename Scalar, int StorageOrder, bool ConjugateLhs, bool ConjugateRhs>
 struct general_matrix_vector_product_wrapper {
   static void run(Index rows, Index cols, const Scalar *lhs, Index lhsStride, const Scalar *rhs, Index rhsIncr,
@@ -23,7 +25,9 @@ struct general_matrix_vector_product_wrapper {
   }
 };
 
-EIGEN_BLAS_FUNC(gemv)
+}  // namespace
+
+EIGEN_BLAS_DISPATCH_FUNC(gemv)
 (const char *opa, const int *m, const int *n, const RealScalar *palpha, const RealScalar *pa, const int *lda,
  const RealScalar *pb, const int *incb, const RealScalar *pbeta, RealScalar *pc, const int *incc) {
   typedef void (*functype)(int, int, const Scalar *, int, const Scalar *, int, Scalar *, int, Scalar);
@@ -82,7 +86,7 @@ EIGEN_BLAS_FUNC(gemv)
   if (actual_c != c) delete[] copy_back(actual_c, c, actual_m, *incc);
 }
 
-EIGEN_BLAS_FUNC(trsv)
+EIGEN_BLAS_DISPATCH_FUNC(trsv)
 (const char *uplo, const char *opa, const char *diag, const int *n, const RealScalar *pa, const int *lda,
  RealScalar *pb, const int *incb) {
   typedef void (*functype)(int, const Scalar *, int, Scalar *);
@@ -150,6 +154,9 @@ EIGEN_BLAS_FUNC(trsv)
   if (actual_b != b) delete[] copy_back(actual_b, b, *n, *incb);
 }
 
+// The other routines are not dispatched, see dispatch.cpp.
+#ifndef EIGEN_BLAS_DISPATCH_VARIANT
+
 EIGEN_BLAS_FUNC(trmv)
 (const char *uplo, const char *opa, const char *diag, const int *n, const RealScalar *pa, const int *lda,
  RealScalar *pb, const int *incb) {
@@ -614,3 +621,5 @@ EIGEN_BLAS_FUNC(tpsv)(char *uplo, char *opa, char *diag, int *n, RealScalar *pap
 
   if (actual_x != x) delete[] copy_back(actual_x, x, *n, *incx);
 }
+
+#endif  // EIGEN_BLAS_DISPATCH_VARIANT
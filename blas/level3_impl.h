@@ -6,23 +6,92 @@
 // This Source Code Form is subject to the terms of the Mozilla
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#include <algorithm>
 #include <iostream>
+#include <vector>
 #include "common.h"
 
-EIGEN_BLAS_FUNC(gemm)
-(const char *opa, const char *opb, const int *m, const int *n, const int *k, const RealScalar *palpha,
- const RealScalar *pa, const int *lda, const RealScalar *pb, const int *ldb, const RealScalar *pbeta, RealScalar *pc,
- const int *ldc) {
-  //   std::cerr << "in gemm " << *opa << " " << *opb << " " << *m << " " << *n << " " << *k << " " << *lda << " " <<
-  //   *ldb << " " << *ldc << " " << *palpha << " " << *pbeta << "\n";
+// The level 3 routines run on several threads when the library is built with threading (see common.h): gemm
+// through parallelize_gemm, whose threads share the packed blocks of op(a), and the other routines by updating
+// independent slices of rows or columns of their result with the serial kernels.
+
+namespace {
+
+using Eigen::DenseIndex;
+
+typedef Eigen::internal::gebp_traits<Scalar, Scalar> Traits;
+typedef Eigen::internal::level3_blocking<Scalar, Scalar> Level3Blocking;
+typedef Eigen::internal::gemm_blocking_space<Eigen::ColMajor, Scalar, Scalar, Eigen::Dynamic, Eigen::Dynamic,
+                                             Eigen::Dynamic>
+    GemmBlocking;
+typedef Eigen::internal::gemm_blocking_space<Eigen::ColMajor, Scalar, Scalar, Eigen::Dynamic, Eigen::Dynamic,
+                                             Eigen::Dynamic, 4>
+    TriangularBlocking;
+
+// Slices of rows are multiples of a cache line, so that the threads do not write to the same lines.
+const int row_granularity = (std::max)(1, int(64 / sizeof(Scalar)));
+const int col_granularity = Traits::nr;
+
+typedef void (*gemm_functype)(DenseIndex, DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *,
+                              DenseIndex, Scalar *, DenseIndex, DenseIndex, Scalar, Level3Blocking &,
+                              Eigen::internal::GemmParallelInfo<DenseIndex> *);
+
+// Computes the rows x cols block at (row, col) of c += alpha * op(a) * op(b), as required by parallelize_gemm.
+struct gemm_block_functor {
+  typedef ::Traits Traits;
+
+  gemm_block_functor(gemm_functype func, int rows, int cols, int depth, const Scalar *lhs, int lhsStride,
+                     bool lhsTransposed, const Scalar *rhs, int rhsStride, bool rhsTransposed, Scalar *res,
+                     int resStride, Scalar alpha, GemmBlocking &blocking)
+      : m_func(func),
+        m_rows(rows),
+        m_cols(cols),
+        m_depth(depth),
+        m_lhs(lhs),
+        m_lhsStride(lhsStride),
+        m_lhsTransposed(lhsTransposed),
+        m_rhs(rhs),
+        m_rhsStride(rhsStride),
+        m_rhsTransposed(rhsTransposed),
+        m_res(res),
+        m_resStride(resStride),
+        m_alpha(alpha),
+        m_blocking(blocking) {}
+
+  void initParallelSession(DenseIndex num_threads) const {
+    m_blocking.initParallel(m_rows, m_cols, m_depth, num_threads);
+    m_blocking.allocateA();
+  }
+
+  void operator()(DenseIndex row, DenseIndex rows, DenseIndex col, DenseIndex cols,
+                  Eigen::internal::GemmParallelInfo<DenseIndex> *info = 0) const {
+    const Scalar *lhs = m_lhs + (m_lhsTransposed ? row * m_lhsStride : row);
+    const Scalar *rhs = m_rhs + (m_rhsTransposed ? col : col * m_rhsStride);
+    m_func(rows, cols, m_depth, lhs, m_lhsStride, rhs, m_rhsStride, m_res + row + col * m_resStride, 1, m_resStride,
+           m_alpha, m_blocking, info);
+  }
+
+  gemm_functype m_func;
+  DenseIndex m_rows, m_cols, m_depth;
+  const Scalar *m_lhs;
+  DenseIndex m_lhsStride;
+  bool m_lhsTransposed;
+  const Scalar *m_rhs;
+  DenseIndex m_rhsStride;
+  bool m_rhsTransposed;
+  Scalar *m_res;
+  DenseIndex m_resStride;
+  Scalar m_alpha;
+  GemmBlocking &m_blocking;
+};
+
+// c = alpha*op(a)*op(b) + beta*c with checked arguments, where code = OP(opa) | (OP(opb) << 2). The product runs on
+// all the threads if parallel is true.
+void gemm_run(int code, int m, int n, int k, Scalar alpha, const Scalar *a, int lda, const Scalar *b, int ldb,
+              Scalar beta, Scalar *c, int ldc, bool parallel) {
   using Eigen::ColMajor;
-  using Eigen::DenseIndex;
-  using Eigen::Dynamic;
   using Eigen::RowMajor;
-  typedef void (*functype)(DenseIndex, DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex,
-                           Scalar *, DenseIndex, DenseIndex, Scalar, Eigen::internal::level3_blocking<Scalar, Scalar> &,
-                           Eigen::internal::GemmParallelInfo<DenseIndex> *);
-  static const functype func[12] = {
+  static const gemm_functype func[12] = {
       // array index: NOTR  | (NOTR << 2)
       (Eigen::internal::general_matrix_matrix_product<DenseIndex, Scalar, ColMajor, false, Scalar, ColMajor, false,
                                                       ColMajor, 1>::run),
@@ -54,50 +123,140 @@ EIGEN_BLAS_FUNC(gemm)
                                                       ColMajor, 1>::run),
       0};
 
+  if (m == 0 || n == 0) return;
+
+  if (beta != Scalar(1)) {
+    if (beta == Scalar(0))
+      matrix(c, m, n, ldc).setZero();
+    else
+      matrix(c, m, n, ldc) *= beta;
+  }
+
+  if (k == 0) return;
+
+  GemmBlocking blocking(m, n, k, 1, true);
+  gemm_block_functor product(func[code], m, n, k, a, lda, (code & 3) != NOTR, b, ldb, (code >> 2) != NOTR, c, ldc,
+                             alpha, blocking);
+  if (parallel)
+    Eigen::internal::parallelize_gemm<true>(product, DenseIndex(m), DenseIndex(n), DenseIndex(k), false);
+  else
+    product(0, m, 0, n);
+}
+
+// Checks the arguments of gemm, and returns the position of the first invalid one, or 0.
+int gemm_check(char opa, char opb, int m, int n, int k, int lda, int ldb, int ldc) {
+  if (OP(opa) == INVALID) return 1;
+  if (OP(opb) == INVALID) return 2;
+  if (m < 0) return 3;
+  if (n < 0) return 4;
+  if (k < 0) return 5;
+  if (lda < std::max(1, (OP(opa) == NOTR) ? m : k)) return 8;
+  if (ldb < std::max(1, (OP(opb) == NOTR) ? k : n)) return 10;
+  if (ldc < std::max(1, m)) return 13;
+  return 0;
+}
+
+// Computes the count independent products product(i, parallel): concurrently if there are enough of them to keep
+// all the threads busy, and one after the other on all the threads otherwise.
+template <typename Product>
+void gemm_batch_run(int count, const Product &product) {
+  if (count >= Eigen::nbThreads())
+    Eigen::internal::parallelize_tasks([&](int i) { product(i, false); }, count);
+  else
+    for (int i = 0; i < count; ++i) product(i, true);
+}
+
+}  // namespace
+
+EIGEN_BLAS_DISPATCH_FUNC(gemm)
+(const char *opa, const char *opb, const int *m, const int *n, const int *k, const RealScalar *palpha,
+ const RealScalar *pa, const int *lda, const RealScalar *pb, const int *ldb, const RealScalar *pbeta, RealScalar *pc,
+ const int *ldc) {
+  //   std::cerr << "in gemm " << *opa << " " << *opb << " " << *m << " " << *n << " " << *k << " " << *lda << " " <<
+  //   *ldb << " " << *ldc << " " << *palpha << " " << *pbeta << "\n";
   const Scalar *a = reinterpret_cast<const Scalar *>(pa);
   const Scalar *b = reinterpret_cast<const Scalar *>(pb);
   Scalar *c = reinterpret_cast<Scalar *>(pc);
   Scalar alpha = *reinterpret_cast<const Scalar *>(palpha);
   Scalar beta = *reinterpret_cast<const Scalar *>(pbeta);
 
-  int info = 0;
-  if (OP(*opa) == INVALID)
-    info = 1;
-  else if (OP(*opb) == INVALID)
-    info = 2;
-  else if (*m < 0)
-    info = 3;
-  else if (*n < 0)
-    info = 4;
-  else if (*k < 0)
-    info = 5;
-  else if (*lda < std::max(1, (OP(*opa) == NOTR) ? *m : *k))
-    info = 8;
-  else if (*ldb < std::max(1, (OP(*opb) == NOTR) ? *k : *n))
-    info = 10;
-  else if (*ldc < std::max(1, *m))
-    info = 13;
+  int info = gemm_check(*opa, *opb, *m, *n, *k, *lda, *ldb, *ldc);
   if (info) return xerbla_(SCALAR_SUFFIX_UP "GEMM ", &info);
 
-  if (*m == 0 || *n == 0) return;
+  Eigen::internal::blas_init_threads();
+  gemm_run(OP(*opa) | (OP(*opb) << 2), *m, *n, *k, alpha, a, *lda, b, *ldb, beta, c, *ldc, true);
+}
 
-  if (beta != Scalar(1)) {
-    if (beta == Scalar(0))
-      matrix(c, *m, *n, *ldc).setZero();
-    else
-      matrix(c, *m, *n, *ldc) *= beta;
-  }
+// c(i) = alpha*op(a(i))*op(b(i)) + beta*c(i) for i < batch_size, where a(i) = a + i*stridea, b(i) = b + i*strideb
+// and c(i) = c + i*stridec.
+EIGEN_BLAS_DISPATCH_FUNC(gemm_batch_strided)
+(const char *opa, const char *opb, const int *m, const int *n, const int *k, const RealScalar *palpha,
+ const RealScalar *pa, const int *lda, const int *stridea, const RealScalar *pb, const int *ldb, const int *strideb,
+ const RealScalar *pbeta, RealScalar *pc, const int *ldc, const int *stridec, const int *batch_size) {
+  const Scalar *a = reinterpret_cast<const Scalar *>(pa);
+  const Scalar *b = reinterpret_cast<const Scalar *>(pb);
+  Scalar *c = reinterpret_cast<Scalar *>(pc);
+  Scalar alpha = *reinterpret_cast<const Scalar *>(palpha);
+  Scalar beta = *reinterpret_cast<const Scalar *>(pbeta);
 
-  if (*k == 0) return;
+  int info = gemm_check(*opa, *opb, *m, *n, *k, *lda, *ldb, *ldc);
+  // shift the positions of ldb and ldc past the strides
+  if (info == 10)
+    info = 11;
+  else if (info == 13)
+    info = 15;
+  else if (info == 0 && *stridea < 0)
+    info = 9;
+  else if (info == 0 && *strideb < 0)
+    info = 12;
+  else if (info == 0 && *batch_size > 1 && DenseIndex(*stridec) < DenseIndex(*ldc) * *n)
+    info = 16;
+  else if (info == 0 && *batch_size < 0)
+    info = 17;
+  if (info) return xerbla_(SCALAR_SUFFIX_UP "GEMM_BATCH_STRIDED", &info);
+
+  Eigen::internal::blas_init_threads();
+  const int code = OP(*opa) | (OP(*opb) << 2);
+  gemm_batch_run(*batch_size, [&](int i, bool parallel) {
+    gemm_run(code, *m, *n, *k, alpha, a + DenseIndex(i) * *stridea, *lda, b + DenseIndex(i) * *strideb, *ldb, beta,
+             c + DenseIndex(i) * *stridec, *ldc, parallel);
+  });
+}
 
-  Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic> blocking(*m, *n, *k, 1,
-                                                                                                     true);
+// c(i) = alpha(g)*op(a(i))*op(b(i)) + beta(g)*c(i) for the group_size(g) consecutive products of each group g, which
+// share the arguments of index g of the other arrays.
+EIGEN_BLAS_DISPATCH_FUNC(gemm_batch)
+(const char *opa_array, const char *opb_array, const int *m_array, const int *n_array, const int *k_array,
+ const RealScalar *palpha_array, const RealScalar *const *pa_array, const int *lda_array,
+ const RealScalar *const *pb_array, const int *ldb_array, const RealScalar *pbeta_array, RealScalar *const *pc_array,
+ const int *ldc_array, const int *group_count, const int *group_size) {
+  const Scalar *alpha_array = reinterpret_cast<const Scalar *>(palpha_array);
+  const Scalar *beta_array = reinterpret_cast<const Scalar *>(pbeta_array);
 
-  int code = OP(*opa) | (OP(*opb) << 2);
-  func[code](*m, *n, *k, a, *lda, b, *ldb, c, 1, *ldc, alpha, blocking, 0);
+  int info = 0;
+  if (*group_count < 0) info = 14;
+  for (int g = 0; info == 0 && g < *group_count; ++g) {
+    info = gemm_check(opa_array[g], opb_array[g], m_array[g], n_array[g], k_array[g], lda_array[g], ldb_array[g],
+                      ldc_array[g]);
+    if (info == 0 && group_size[g] < 0) info = 15;
+  }
+  if (info) return xerbla_(SCALAR_SUFFIX_UP "GEMM_BATCH", &info);
+
+  // index of the first product of each group
+  std::vector<int> first(*group_count + 1, 0);
+  for (int g = 0; g < *group_count; ++g) first[g + 1] = first[g] + group_size[g];
+
+  Eigen::internal::blas_init_threads();
+  gemm_batch_run(first.back(), [&](int i, bool parallel) {
+    const int g = int(std::upper_bound(first.begin(), first.end(), i) - first.begin()) - 1;
+    gemm_run(OP(opa_array[g]) | (OP(opb_array[g]) << 2), m_array[g], n_array[g], k_array[g], alpha_array[g],
+             reinterpret_cast<const Scalar *>(pa_array[i]), lda_array[g],
+             reinterpret_cast<const Scalar *>(pb_array[i]), ldb_array[g], beta_array[g],
+             reinterpret_cast<Scalar *>(pc_array[i]), ldc_array[g], parallel);
+  });
 }
 
-EIGEN_BLAS_FUNC(trsm)
+EIGEN_BLAS_DISPATCH_FUNC(trsm)
 (const char *side, const char *uplo, const char *opa, const char *diag, const int *m, const int *n,
  const RealScalar *palpha, const RealScalar *pa, const int *lda, RealScalar *pb, const int *ldb) {
   //   std::cerr << "in trsm " << *side << " " << *uplo << " " << *opa << " " << *diag << " " << *m << "," << *n << " "
@@ -222,19 +381,26 @@ EIGEN_BLAS_FUNC(trsm)
 
   int code = OP(*opa) | (SIDE(*side) << 2) | (UPLO(*uplo) << 3) | (DIAG(*diag) << 4);
 
+  // The columns (left) or the rows (right) of b are solved independently.
+  Eigen::internal::blas_init_threads();
   if (SIDE(*side) == LEFT) {
-    Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic, 4> blocking(*m, *n, *m, 1,
-                                                                                                          false);
-    func[code](*m, *n, a, *lda, b, 1, *ldb, blocking);
+    Eigen::internal::blas_parallel_slices(*n, col_granularity, 0.5 * *m * *m * *n, [&](int j, int cols) {
+      TriangularBlocking blocking(*m, cols, *m, 1, false);
+      func[code](*m, cols, a, *lda, b + DenseIndex(j) * *ldb, 1, *ldb, blocking);
+      if (alpha != Scalar(1)) matrix(b + DenseIndex(j) * *ldb, *m, cols, *ldb) *= alpha;
+    });
   } else {
-    Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic, 4> blocking(*m, *n, *n, 1,
-                                                                                                          false);
-    func[code](*n, *m, a, *lda, b, 1, *ldb, blocking);
+    Eigen::internal::blas_parallel_slices(*m, row_granularity, 0.5 * *m * *n * *n, [&](int i, int rows) {
+      TriangularBlocking blocking(rows, *n, *n, 1, false);
+      func[code](*n, rows, a, *lda, b + i, 1, *ldb, blocking);
+      if (alpha != Scalar(1)) matrix(b + i, rows, *n, *ldb) *= alpha;
+    });
   }
-
-  if (alpha != Scalar(1)) matrix(b, *m, *n, *ldb) *= alpha;
 }
 
+// The other routines are not dispatched, see dispatch.cpp.
+#ifndef EIGEN_BLAS_DISPATCH_VARIANT
+
 // b = alpha*op(a)*b  for side = 'L'or'l'
 // b = alpha*b*op(a)  for side = 'R'or'r'
 EIGEN_BLAS_FUNC(trmm)
@@ -361,21 +527,51 @@ EIGEN_BLAS_FUNC(trmm)
 
   if (*m == 0 || *n == 0) return;
 
-  // FIXME find a way to avoid this copy
-  Eigen::Matrix<Scalar, Dynamic, Dynamic, ColMajor> tmp = matrix(b, *m, *n, *ldb);
-  matrix(b, *m, *n, *ldb).setZero();
-
+  // The columns (left) or the rows (right) of b are updated independently.
+  // FIXME find a way to avoid the copies of the slices
+  Eigen::internal::blas_init_threads();
   if (SIDE(*side) == LEFT) {
-    Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic, 4> blocking(*m, *n, *m, 1,
-                                                                                                          false);
-    func[code](*m, *n, *m, a, *lda, tmp.data(), tmp.outerStride(), b, 1, *ldb, alpha, blocking);
+    Eigen::internal::blas_parallel_slices(*n, col_granularity, 0.5 * *m * *m * *n, [&](int j, int cols) {
+      Scalar *slice = b + DenseIndex(j) * *ldb;
+      Eigen::Matrix<Scalar, Dynamic, Dynamic, ColMajor> tmp = matrix(slice, *m, cols, *ldb);
+      matrix(slice, *m, cols, *ldb).setZero();
+      TriangularBlocking blocking(*m, cols, *m, 1, false);
+      func[code](*m, cols, *m, a, *lda, tmp.data(), tmp.outerStride(), slice, 1, *ldb, alpha, blocking);
+    });
+  } else {
+    Eigen::internal::blas_parallel_slices(*m, row_granularity, 0.5 * *m * *n * *n, [&](int i, int rows) {
+      Eigen::Matrix<Scalar, Dynamic, Dynamic, ColMajor> tmp = matrix(b + i, rows, *n, *ldb);
+      matrix(b + i, rows, *n, *ldb).setZero();
+      TriangularBlocking blocking(rows, *n, *n, 1, false);
+      func[code](rows, *n, *n, tmp.data(), tmp.outerStride(), a, *lda, b + i, 1, *ldb, alpha, blocking);
+    });
+  }
+}
+
+namespace {
+
+typedef void (*symm_functype)(DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *,
+                              DenseIndex, DenseIndex, const Scalar &, Level3Blocking &);
+
+// c += alpha*a*b (left) or c += alpha*b*a (right) for a selfadjoint matrix a, where run is the corresponding
+// product_selfadjoint_matrix kernel. The columns (left) or the rows (right) of c are computed independently.
+void symm_run(symm_functype run, bool left, int m, int n, Scalar alpha, const Scalar *a, int lda, const Scalar *b,
+              int ldb, Scalar *c, int ldc) {
+  if (left) {
+    Eigen::internal::blas_parallel_slices(n, col_granularity, double(m) * m * n, [&](int j, int cols) {
+      GemmBlocking blocking(m, cols, m, 1, false);
+      run(m, cols, a, lda, b + DenseIndex(j) * ldb, ldb, c + DenseIndex(j) * ldc, 1, ldc, alpha, blocking);
+    });
   } else {
-    Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic, 4> blocking(*m, *n, *n, 1,
-                                                                                                          false);
-    func[code](*m, *n, *n, tmp.data(), tmp.outerStride(), a, *lda, b, 1, *ldb, alpha, blocking);
+    Eigen::internal::blas_parallel_slices(m, row_granularity, double(m) * n * n, [&](int i, int rows) {
+      GemmBlocking blocking(rows, n, n, 1, false);
+      run(rows, n, b + i, ldb, a, lda, c + i, 1, ldc, alpha, blocking);
+    });
   }
 }
 
+}  // namespace
+
 // c = alpha*a*b + beta*c  for side = 'L'or'l'
 // c = alpha*b*a + beta*c  for side = 'R'or'r
 EIGEN_BLAS_FUNC(symm)
@@ -415,15 +611,16 @@ EIGEN_BLAS_FUNC(symm)
 
   if (*m == 0 || *n == 0) return;
 
-  int size = (SIDE(*side) == LEFT) ? (*m) : (*n);
   using Eigen::ColMajor;
   using Eigen::DenseIndex;
   using Eigen::Dynamic;
   using Eigen::Lower;
   using Eigen::RowMajor;
   using Eigen::Upper;
+  Eigen::internal::blas_init_threads();
 #if ISCOMPLEX
   // FIXME add support for symmetric complex matrix
+  int size = (SIDE(*side) == LEFT) ? (*m) : (*n);
   Eigen::Matrix<Scalar, Dynamic, Dynamic, ColMajor> matA(size, size);
   if (UPLO(*uplo) == UP) {
     matA.triangularView<Upper>() = matrix(a, size, size, *lda);
@@ -437,36 +634,75 @@ EIGEN_BLAS_FUNC(symm)
   else if (SIDE(*side) == RIGHT)
     matrix(c, *m, *n, *ldc) += alpha * matrix(b, *m, *n, *ldb) * matA;
 #else
-  Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic> blocking(*m, *n, size, 1,
-                                                                                                     false);
-
+  symm_functype run;
   if (SIDE(*side) == LEFT)
     if (UPLO(*uplo) == UP)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, RowMajor, true, false, ColMajor, false, false,
-                                                  ColMajor, 1>::run(*m, *n, a, *lda, b, *ldb, c, 1, *ldc, alpha,
-                                                                    blocking);
-    else if (UPLO(*uplo) == LO)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, true, false, ColMajor, false, false,
-                                                  ColMajor, 1>::run(*m, *n, a, *lda, b, *ldb, c, 1, *ldc, alpha,
-                                                                    blocking);
-    else
-      return;
-  else if (SIDE(*side) == RIGHT)
-    if (UPLO(*uplo) == UP)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, false, false, RowMajor, true, false,
-                                                  ColMajor, 1>::run(*m, *n, b, *ldb, a, *lda, c, 1, *ldc, alpha,
-                                                                    blocking);
-    else if (UPLO(*uplo) == LO)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, false, false, ColMajor, true, false,
-                                                  ColMajor, 1>::run(*m, *n, b, *ldb, a, *lda, c, 1, *ldc, alpha,
-                                                                    blocking);
+      run = Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, RowMajor, true, false, ColMajor, false,
+                                                        false, ColMajor, 1>::run;
     else
-      return;
+      run = Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, true, false, ColMajor, false,
+                                                        false, ColMajor, 1>::run;
+  else if (UPLO(*uplo) == UP)
+    run = Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, false, false, RowMajor, true, false,
+                                                      ColMajor, 1>::run;
   else
-    return;
+    run = Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, false, false, ColMajor, true, false,
+                                                      ColMajor, 1>::run;
+
+  symm_run(run, SIDE(*side) == LEFT, *m, *n, alpha, a, *lda, b, *ldb, c, *ldc);
 #endif
 }
 
+namespace {
+
+typedef void (*rank_update_functype)(int, int, const Scalar *, int, const Scalar *, int, Scalar *, int,
+                                     const Scalar &);
+
+// Adds alpha*lhs*rhs to the UpLo triangular part of the size x size matrix res, where lhs is size x depth and rhs is
+// depth x size. In parallel, the triangle is cut into slices of columns of about the same area, and each slice is
+// the triangular product of its diagonal block plus a general product for the part above (Upper) or below (Lower)
+// this block.
+template <int LhsStorageOrder, bool ConjLhs, int RhsStorageOrder, bool ConjRhs, int UpLo>
+void rank_update(int size, int depth, const Scalar *lhs, int lhsStride, const Scalar *rhs, int rhsStride, Scalar *res,
+                 int resStride, const Scalar &alpha) {
+  using Eigen::ColMajor;
+  typedef Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, LhsStorageOrder, ConjLhs,
+                                                                    Scalar, RhsStorageOrder, ConjRhs, ColMajor, 1, UpLo>
+      Triangular;
+  typedef Eigen::internal::general_matrix_matrix_product<DenseIndex, Scalar, LhsStorageOrder, ConjLhs, Scalar,
+                                                         RhsStorageOrder, ConjRhs, ColMajor, 1>
+      General;
+  auto lhs_row = [&](int i) { return lhs + (LhsStorageOrder == ColMajor ? DenseIndex(i) : DenseIndex(i) * lhsStride); };
+  auto rhs_col = [&](int j) { return rhs + (RhsStorageOrder == ColMajor ? DenseIndex(j) * rhsStride : DenseIndex(j)); };
+
+  const int slices = Eigen::internal::blas_slice_count(size, col_granularity, 0.5 * size * size * depth);
+  // first column of the slice t, such that the first t slices hold about t/slices of the triangle
+  auto first_col = [&](int t) {
+    if (t == slices) return size;
+    const double f = UpLo == Eigen::Upper ? std::sqrt(double(t) / slices) : 1 - std::sqrt(double(slices - t) / slices);
+    return int(f * size) / col_granularity * col_granularity;
+  };
+  Eigen::internal::parallelize_tasks(
+      [&](int t) {
+        const int j = first_col(t);
+        const int cols = first_col(t + 1) - j;
+        if (cols <= 0) return;
+        GemmBlocking blocking(cols, cols, depth, 1, false);
+        Triangular::run(cols, depth, lhs_row(j), lhsStride, rhs_col(j), rhsStride, res + j + DenseIndex(j) * resStride,
+                        1, resStride, alpha, blocking);
+        const int row = UpLo == Eigen::Upper ? 0 : j + cols;
+        const int rows = UpLo == Eigen::Upper ? j : size - j - cols;
+        if (rows > 0) {
+          GemmBlocking rect_blocking(rows, cols, depth, 1, false);
+          General::run(rows, cols, depth, lhs_row(row), lhsStride, rhs_col(j), rhsStride,
+                       res + row + DenseIndex(j) * resStride, 1, resStride, alpha, rect_blocking, 0);
+        }
+      },
+      slices);
+}
+
+}  // namespace
+
 // c = alpha*a*a' + beta*c  for op = 'N'or'n'
 // c = alpha*a'*a + beta*c  for op = 'T'or't','C'or'c'
 EIGEN_BLAS_FUNC(syrk)
@@ -481,28 +717,20 @@ EIGEN_BLAS_FUNC(syrk)
   using Eigen::RowMajor;
   using Eigen::Upper;
 #if !ISCOMPLEX
-  typedef void (*functype)(DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *,
-                           DenseIndex, DenseIndex, const Scalar &, Eigen::internal::level3_blocking<Scalar, Scalar> &);
-  static const functype func[8] = {
+  static const rank_update_functype func[8] = {
       // array index: NOTR  | (UP << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, ColMajor, false, Scalar, RowMajor,
-                                                                 Conj, ColMajor, 1, Upper>::run),
+      (rank_update<ColMajor, false, RowMajor, Conj, Upper>),
       // array index: TR    | (UP << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, RowMajor, false, Scalar, ColMajor,
-                                                                 Conj, ColMajor, 1, Upper>::run),
+      (rank_update<RowMajor, false, ColMajor, Conj, Upper>),
       // array index: ADJ   | (UP << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, RowMajor, Conj, Scalar, ColMajor,
-                                                                 false, ColMajor, 1, Upper>::run),
+      (rank_update<RowMajor, Conj, ColMajor, false, Upper>),
       0,
       // array index: NOTR  | (LO << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, ColMajor, false, Scalar, RowMajor,
-                                                                 Conj, ColMajor, 1, Lower>::run),
+      (rank_update<ColMajor, false, RowMajor, Conj, Lower>),
       // array index: TR    | (LO << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, RowMajor, false, Scalar, ColMajor,
-                                                                 Conj, ColMajor, 1, Lower>::run),
+      (rank_update<RowMajor, false, ColMajor, Conj, Lower>),
       // array index: ADJ   | (LO << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, RowMajor, Conj, Scalar, ColMajor,
-                                                                 false, ColMajor, 1, Lower>::run),
+      (rank_update<RowMajor, Conj, ColMajor, false, Lower>),
       0};
 #endif
 
@@ -540,6 +768,7 @@ EIGEN_BLAS_FUNC(syrk)
 
   if (*n == 0 || *k == 0) return;
 
+  Eigen::internal::blas_init_threads();
 #if ISCOMPLEX
   // FIXME add support for symmetric complex matrix
   if (UPLO(*uplo) == UP) {
@@ -558,11 +787,8 @@ EIGEN_BLAS_FUNC(syrk)
           alpha * matrix(a, *k, *n, *lda).transpose() * matrix(a, *k, *n, *lda);
   }
 #else
-  Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic> blocking(*n, *n, *k, 1,
-                                                                                                     false);
-
   int code = OP(*op) | (UPLO(*uplo) << 2);
-  func[code](*n, *k, a, *lda, a, *lda, c, 1, *ldc, alpha, blocking);
+  func[code](*n, *k, a, *lda, a, *lda, c, *ldc, alpha);
 #endif
 }
 
@@ -613,6 +839,8 @@ EIGEN_BLAS_FUNC(syr2k)
 
   if (*k == 0) return;
 
+  Eigen::internal::blas_init_threads();
+
   if (OP(*op) == NOTR) {
     if (UPLO(*uplo) == UP) {
       matrix(c, *n, *n, *ldc).triangularView<Upper>() +=
@@ -680,19 +908,16 @@ EIGEN_BLAS_FUNC(hemm)
   using Eigen::RowMajor;
   using Eigen::Upper;
 
-  int size = (SIDE(*side) == LEFT) ? (*m) : (*n);
-  Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic> blocking(*m, *n, size, 1,
-                                                                                                     false);
-
+  Eigen::internal::blas_init_threads();
   if (SIDE(*side) == LEFT) {
     if (UPLO(*uplo) == UP)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, RowMajor, true, Conj, ColMajor, false, false,
-                                                  ColMajor, 1>::run(*m, *n, a, *lda, b, *ldb, c, 1, *ldc, alpha,
-                                                                    blocking);
+      symm_run(Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, RowMajor, true, Conj, ColMajor, false,
+                                                           false, ColMajor, 1>::run,
+               true, *m, *n, alpha, a, *lda, b, *ldb, c, *ldc);
     else if (UPLO(*uplo) == LO)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, true, false, ColMajor, false, false,
-                                                  ColMajor, 1>::run(*m, *n, a, *lda, b, *ldb, c, 1, *ldc, alpha,
-                                                                    blocking);
+      symm_run(Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, true, false, ColMajor, false,
+                                                           false, ColMajor, 1>::run,
+               true, *m, *n, alpha, a, *lda, b, *ldb, c, *ldc);
     else
       return;
   } else if (SIDE(*side) == RIGHT) {
@@ -704,9 +929,9 @@ EIGEN_BLAS_FUNC(hemm)
 RowMajor,true,Conj,  ColMajor, 1>
 ::run(*m, *n, b, *ldb, a, *lda, c, 1, *ldc, alpha, blocking);*/
     else if (UPLO(*uplo) == LO)
-      Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, false, false, ColMajor, true, false,
-                                                  ColMajor, 1>::run(*m, *n, b, *ldb, a, *lda, c, 1, *ldc, alpha,
-                                                                    blocking);
+      symm_run(Eigen::internal::product_selfadjoint_matrix<Scalar, DenseIndex, ColMajor, false, false, ColMajor, true,
+                                                           false, ColMajor, 1>::run,
+               false, *m, *n, alpha, a, *lda, b, *ldb, c, *ldc);
     else
       return;
   } else {
@@ -729,24 +954,18 @@ EIGEN_BLAS_FUNC(herk)
   using Eigen::StrictlyLower;
   using Eigen::StrictlyUpper;
   using Eigen::Upper;
-  typedef void (*functype)(DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *,
-                           DenseIndex, DenseIndex, const Scalar &, Eigen::internal::level3_blocking<Scalar, Scalar> &);
-  static const functype func[8] = {
+  static const rank_update_functype func[8] = {
       // array index: NOTR  | (UP << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, ColMajor, false, Scalar, RowMajor,
-                                                                 Conj, ColMajor, 1, Upper>::run),
+      (rank_update<ColMajor, false, RowMajor, Conj, Upper>),
       0,
       // array index: ADJ   | (UP << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, RowMajor, Conj, Scalar, ColMajor,
-                                                                 false, ColMajor, 1, Upper>::run),
+      (rank_update<RowMajor, Conj, ColMajor, false, Upper>),
       0,
       // array index: NOTR  | (LO << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, ColMajor, false, Scalar, RowMajor,
-                                                                 Conj, ColMajor, 1, Lower>::run),
+      (rank_update<ColMajor, false, RowMajor, Conj, Lower>),
       0,
       // array index: ADJ   | (LO << 2)
-      (Eigen::internal::general_matrix_matrix_triangular_product<DenseIndex, Scalar, RowMajor, Conj, Scalar, ColMajor,
-                                                                 false, ColMajor, 1, Lower>::run),
+      (rank_update<RowMajor, Conj, ColMajor, false, Lower>),
       0};
 
   const Scalar *a = reinterpret_cast<const Scalar *>(pa);
@@ -792,9 +1011,8 @@ EIGEN_BLAS_FUNC(herk)
   }
 
   if (*k > 0 && alpha != RealScalar(0)) {
-    Eigen::internal::gemm_blocking_space<ColMajor, Scalar, Scalar, Dynamic, Dynamic, Dynamic> blocking(*n, *n, *k, 1,
-                                                                                                       false);
-    func[code](*n, *k, a, *lda, a, *lda, c, 1, *ldc, alpha, blocking);
+    Eigen::internal::blas_init_threads();
+    func[code](*n, *k, a, *lda, a, *lda, c, *ldc, alpha);
     matrix(c, *n, *n, *ldc).diagonal().imag().setZero();
   }
 }
@@ -854,6 +1072,8 @@ EIGEN_BLAS_FUNC(her2k)
 
   if (*k == 0) return;
 
+  Eigen::internal::blas_init_threads();
+
   if (OP(*op) == NOTR) {
     if (UPLO(*uplo) == UP) {
       matrix(c, *n, *n, *ldc).triangularView<Upper>() +=
@@ -876,3 +1096,5 @@ EIGEN_BLAS_FUNC(her2k)
 }
 
 #endif  // ISCOMPLEX
+
+#endif  // EIGEN_BLAS_DISPATCH_VARIANT
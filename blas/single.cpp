@@ -12,12 +12,18 @@
 #define SCALAR_SUFFIX_UP "S"
 #define ISCOMPLEX 0
 
+#include "level2_impl.h"
+#include "level3_impl.h"
+
+// The ISA variants of the library (see dispatch.cpp) only define the dispatched routines of level2_impl.h and
+// level3_impl.h.
+#ifndef EIGEN_BLAS_DISPATCH_VARIANT
 #include "level1_impl.h"
 #include "level1_real_impl.h"
-#include "level2_impl.h"
 #include "level2_real_impl.h"
-#include "level3_impl.h"
 
 float EIGEN_BLAS_FUNC_NAME(dsdot)(int* n, float* alpha, float* x, int* incx, float* y, int* incy) {
   return double(*alpha) + BLASFUNC(dsdot)(n, x, incx, y, incy);
 }
+
+#endif  // EIGEN_BLAS_DISPATCH_VARIANT
@@ -0,0 +1,59 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Number of threads of the level 3 routines.
+//
+// The maximal number of threads is read once from the environment variable EIGEN_BLAS_NUM_THREADS, and defaults to
+// the number of hardware threads. It is 1 if the library is built without threading. The level 3 routines query
+// eigen_blas_get_num_threads() at each call, see blas_init_threads() in common.h.
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "blas.h"
+
+namespace {
+
+int max_threads() {
+  static const int threads = [] {
+#if defined(EIGEN_GEMM_THREADPOOL) || defined(_OPENMP)
+    const char* requested = std::getenv("EIGEN_BLAS_NUM_THREADS");
+    int n = requested ? std::atoi(requested) : 0;
+#if defined(_OPENMP)
+    if (n <= 0) n = omp_get_max_threads();
+#else
+    if (n <= 0) n = int(std::thread::hardware_concurrency());
+#endif
+    return n > 0 ? n : 1;
+#else
+    return 1;
+#endif
+  }();
+  return threads;
+}
+
+std::atomic<int>& num_threads() {
+  static std::atomic<int> threads(max_threads());
+  return threads;
+}
+
+}  // namespace
+
+extern "C" int eigen_blas_get_max_threads() { return max_threads(); }
+
+extern "C" int eigen_blas_get_num_threads() { return num_threads(); }
+
+// Sets the number of threads of the subsequent calls to the level 3 routines, up to eigen_blas_get_max_threads().
+// A non-positive value restores the maximal number of threads. This must not be called while a level 3 routine runs.
+extern "C" void eigen_blas_set_num_threads(int threads) {
+  num_threads() = (threads <= 0 || threads > max_threads()) ? max_threads() : threads;
+}
@@ -15,4 +15,5 @@
 
 #include "cholesky.inc"
 #include "lu.inc"
+#include "qr.inc"
 #include "svd.inc"
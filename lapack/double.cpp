@@ -14,5 +14,6 @@
 
 #include "cholesky.inc"
 #include "lu.inc"
+#include "qr.inc"
 #include "eigenvalues.inc"
 #include "svd.inc"
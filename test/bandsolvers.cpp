@@ -0,0 +1,129 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+
+using Eigen::internal::BandMatrix;
+using Eigen::internal::TridiagonalMatrix;
+
+// Fills the band of m with random coefficients.
+template <typename BandType>
+void random_band(BandType& m) {
+  m.diagonal().setRandom();
+  for (Index i = 1; i <= m.supers(); ++i) m.diagonal(i).setRandom();
+  for (Index i = 1; i <= m.subs(); ++i) m.diagonal(-i).setRandom();
+}
+
+template <typename Scalar>
+void band_llt(Index size, Index kd, Index cols) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  // A diagonally dominant selfadjoint band matrix, stored by its lower part.
+  BandMatrix<Scalar> lower(size, size, 0, kd);
+  random_band(lower);
+  lower.diagonal().setConstant(Scalar(RealScalar(3 * kd + 1)));
+  MatrixType ref = lower.toDenseMatrix();
+  ref.template triangularView<StrictlyUpper>() = ref.adjoint();
+
+  const MatrixType b = MatrixType::Random(size, cols);
+  const VectorType v = VectorType::Random(size);
+
+  BandLLT<Scalar> llt(lower);
+  VERIFY_IS_EQUAL(llt.info(), Success);
+  VERIFY_IS_EQUAL(llt.bandwidth(), kd);
+  VERIFY_IS_APPROX(ref * llt.solve(b), b);
+  VERIFY_IS_APPROX(ref * llt.solve(v), v);
+  VERIFY_IS_APPROX(ref.transpose() * MatrixType(llt.transpose().solve(b)), b);
+  // The band of L is the one of the dense factor.
+  const MatrixType l = ref.llt().matrixL();
+  for (Index d = 0; d <= kd; ++d)
+    VERIFY_IS_APPROX(llt.matrixLLT().row(d).head(size - d), l.diagonal(-d).transpose());
+
+  // The same matrix stored by its upper part.
+  BandMatrix<Scalar, Dynamic, Dynamic, Dynamic, Dynamic, SelfAdjoint> upper(size, size, kd, 0);
+  upper.diagonal() = lower.diagonal();
+  for (Index d = 1; d <= kd; ++d) upper.diagonal(d) = lower.diagonal(-d).conjugate();
+  BandLLT<Scalar> ullt(upper);
+  VERIFY_IS_EQUAL(ullt.info(), Success);
+  VERIFY_IS_APPROX(ullt.matrixLLT(), llt.matrixLLT());
+
+  // Failure
+  lower.diagonal()(size - 1) = Scalar(-1);
+  VERIFY_IS_EQUAL(llt.compute(lower).info(), NumericalIssue);
+}
+
+// Partial pivoting is backward stable in practice, independently of the
+// conditioning of the random band matrices.
+template <typename MatrixType, typename SolutionType, typename RhsType>
+bool small_residual(const MatrixType& a, const SolutionType& x, const RhsType& b) {
+  typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+  return (a * x - b).norm() <= RealScalar(10 * a.rows()) * NumTraits<RealScalar>::epsilon() * a.norm() * x.norm();
+}
+
+template <typename Scalar>
+void band_lu(Index size, Index kl, Index ku, Index cols) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+
+  BandMatrix<Scalar> m(size, size, ku, kl);
+  random_band(m);
+  const MatrixType ref = m.toDenseMatrix();
+  const MatrixType b = MatrixType::Random(size, cols);
+  const VectorType v = VectorType::Random(size);
+
+  BandPartialPivLU<Scalar> lu(m);
+  VERIFY_IS_EQUAL(lu.info(), Success);
+  VERIFY_IS_EQUAL(lu.matrixLU().rows(), 2 * kl + ku + 1);
+  VERIFY(small_residual(ref, MatrixType(lu.solve(b)), b));
+  VERIFY(small_residual(ref, VectorType(lu.solve(v)), v));
+  VERIFY(small_residual(MatrixType(ref.transpose()), MatrixType(lu.transpose().solve(b)), b));
+  VERIFY(small_residual(MatrixType(ref.adjoint()), MatrixType(lu.adjoint().solve(b)), b));
+
+  // Every step pivots when the diagonal vanishes.
+  if (kl > 0) {
+    m.diagonal().setZero();
+    BandPartialPivLU<Scalar> plu(m);
+    if (plu.info() == Success) VERIFY(small_residual(MatrixType(m.toDenseMatrix()), MatrixType(plu.solve(b)), b));
+  }
+
+  // A singular matrix
+  m.col(size / 2).setZero();
+  VERIFY_IS_EQUAL(lu.compute(m).info(), NumericalIssue);
+}
+
+template <typename Scalar>
+void band_lu_tridiagonal(Index size) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  TridiagonalMatrix<Scalar, Dynamic, 0> t(size);
+  t.diagonal().setConstant(Scalar(4));
+  t.super().setRandom();
+  t.sub().setRandom();
+  const MatrixType b = MatrixType::Random(size, 2);
+  BandPartialPivLU<Scalar> lu(t);
+  VERIFY_IS_EQUAL(lu.info(), Success);
+  VERIFY_IS_APPROX(MatrixType(t.toDenseMatrix() * lu.solve(b)), b);
+}
+
+EIGEN_DECLARE_TEST(bandsolvers) {
+  for (int i = 0; i < g_repeat; ++i) {
+    const Index size = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index kd = internal::random<Index>(0, numext::mini<Index>(size - 1, 30));
+    const Index kl = internal::random<Index>(0, numext::mini<Index>(size - 1, 20));
+    const Index ku = internal::random<Index>(0, numext::mini<Index>(size - 1, 20));
+    const Index cols = internal::random<Index>(1, 10);
+    CALL_SUBTEST_1(band_llt<float>(size, kd, cols));
+    CALL_SUBTEST_2(band_llt<double>(size, kd, cols));
+    CALL_SUBTEST_3(band_llt<std::complex<double> >(size, kd, cols));
+    CALL_SUBTEST_4(band_lu<double>(size, kl, ku, cols));
+    CALL_SUBTEST_5(band_lu<std::complex<float> >(size, kl, ku, cols));
+    CALL_SUBTEST_6(band_lu_tridiagonal<double>(internal::random<Index>(2, EIGEN_TEST_MAX_SIZE)));
+  }
+}
@@ -0,0 +1,376 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Tests of the batched gemm routines of the Eigen BLAS library, and of their threading when it is configured with
+// EIGEN_BLAS_THREADPOOL.
+
+#include <cstdlib>
+#include "main.h"
+#include "../blas/blas.h"
+
+// Argument errors are reported through xerbla, which replaces the weak definition of the library.
+static int g_xerbla_info = 0;
+static std::string g_xerbla_name;
+extern "C" void xerbla_(const char* name, int* info) {
+  g_xerbla_info = *info;
+  g_xerbla_name = name;
+}
+
+enum { CblasRowMajor = 101, CblasColMajor = 102, CblasNoTrans = 111, CblasTrans = 112, CblasConjTrans = 113 };
+
+template <typename Scalar>
+struct blas_gemm_batch;
+
+#define EIGEN_TEST_BLAS_GEMM_BATCH(SCALAR, REAL, PREFIX, CBLAS_SCALAR, CBLAS_PTR)                                     \
+  template <>                                                                                                        \
+  struct blas_gemm_batch<SCALAR> {                                                                                   \
+    static void strided(char opa, char opb, int m, int n, int k, SCALAR alpha, const SCALAR* a, int lda, int sa,     \
+                        const SCALAR* b, int ldb, int sb, SCALAR beta, SCALAR* c, int ldc, int sc, int count) {      \
+      BLASFUNC(PREFIX##gemm_batch_strided)                                                                           \
+      (&opa, &opb, &m, &n, &k, reinterpret_cast<const REAL*>(&alpha), reinterpret_cast<const REAL*>(a), &lda, &sa,   \
+       reinterpret_cast<const REAL*>(b), &ldb, &sb, reinterpret_cast<const REAL*>(&beta), reinterpret_cast<REAL*>(c), \
+       &ldc, &sc, &count);                                                                                           \
+    }                                                                                                                \
+    static void grouped(const char* opa, const char* opb, const int* m, const int* n, const int* k,                  \
+                        const SCALAR* alpha, const SCALAR* const* a, const int* lda, const SCALAR* const* b,         \
+                        const int* ldb, const SCALAR* beta, SCALAR* const* c, const int* ldc, int groups,            \
+                        const int* sizes) {                                                                          \
+      BLASFUNC(PREFIX##gemm_batch)                                                                                   \
+      (opa, opb, m, n, k, reinterpret_cast<const REAL*>(alpha), reinterpret_cast<const REAL* const*>(a), lda,        \
+       reinterpret_cast<const REAL* const*>(b), ldb, reinterpret_cast<const REAL*>(beta),                            \
+       reinterpret_cast<REAL* const*>(c), ldc, &groups, sizes);                                                      \
+    }                                                                                                                \
+    static void cblas_strided(int layout, int opa, int opb, int m, int n, int k, SCALAR alpha, const SCALAR* a,      \
+                              int lda, int sa, const SCALAR* b, int ldb, int sb, SCALAR beta, SCALAR* c, int ldc,    \
+                              int sc, int count) {                                                                   \
+      cblas_##PREFIX##gemm_batch_strided(layout, opa, opb, m, n, k, CBLAS_SCALAR(alpha), a, lda, sa, b, ldb, sb,     \
+                                         CBLAS_SCALAR(beta), c, ldc, sc, count);                                     \
+    }                                                                                                                \
+    static void cblas_grouped(int layout, const int* opa, const int* opb, const int* m, const int* n, const int* k,  \
+                              const SCALAR* alpha, const SCALAR** a, const int* lda, const SCALAR** b,               \
+                              const int* ldb, const SCALAR* beta, SCALAR** c, const int* ldc, int groups,            \
+                              const int* sizes) {                                                                    \
+      cblas_##PREFIX##gemm_batch(layout, opa, opb, m, n, k, alpha, CBLAS_PTR(a), lda, CBLAS_PTR(b), ldb, beta,       \
+                                 CBLAS_PTR(c), ldc, groups, sizes);                                                  \
+    }                                                                                                                \
+  };
+
+// The real CBLAS routines take the scalars by value, the complex ones by address.
+#define EIGEN_TEST_BLAS_BY_VALUE(x) x
+#define EIGEN_TEST_BLAS_BY_ADDRESS(x) &x
+#define EIGEN_TEST_BLAS_SAME_PTR(x) x
+#define EIGEN_TEST_BLAS_VOID_PTR(x) reinterpret_cast<decltype(void_ptr(x))>(x)
+
+template <typename T>
+const void** void_ptr(const T**);
+template <typename T>
+void** void_ptr(T**);
+
+EIGEN_TEST_BLAS_GEMM_BATCH(float, float, s, EIGEN_TEST_BLAS_BY_VALUE, EIGEN_TEST_BLAS_SAME_PTR)
+EIGEN_TEST_BLAS_GEMM_BATCH(double, double, d, EIGEN_TEST_BLAS_BY_VALUE, EIGEN_TEST_BLAS_SAME_PTR)
+EIGEN_TEST_BLAS_GEMM_BATCH(std::complex<float>, float, c, EIGEN_TEST_BLAS_BY_ADDRESS, EIGEN_TEST_BLAS_VOID_PTR)
+EIGEN_TEST_BLAS_GEMM_BATCH(std::complex<double>, double, z, EIGEN_TEST_BLAS_BY_ADDRESS, EIGEN_TEST_BLAS_VOID_PTR)
+
+#undef EIGEN_TEST_BLAS_GEMM_BATCH
+
+template <typename Scalar>
+struct gemm_problem {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+
+  char opa, opb;
+  int m, n, k;
+  Scalar alpha, beta;
+
+  static char random_op() {
+    const char ops[] = {'N', 'T', 'C'};
+    return ops[internal::random<int>(0, 2)];
+  }
+
+  static MatrixType op(char trans, const MatrixType& x) {
+    return trans == 'N' ? x : trans == 'T' ? MatrixType(x.transpose()) : MatrixType(x.adjoint());
+  }
+
+  gemm_problem(int max_size)
+      : opa(random_op()),
+        opb(random_op()),
+        m(internal::random<int>(0, max_size)),
+        n(internal::random<int>(0, max_size)),
+        k(internal::random<int>(0, max_size)),
+        alpha(internal::random<Scalar>()),
+        beta(internal::random<int>(0, 1) ? internal::random<Scalar>() : Scalar(0)) {}
+
+  // Dimensions of the stored operands.
+  int a_rows() const { return opa == 'N' ? m : k; }
+  int a_cols() const { return opa == 'N' ? k : m; }
+  int b_rows() const { return opb == 'N' ? k : n; }
+  int b_cols() const { return opb == 'N' ? n : k; }
+
+  MatrixType reference(const MatrixType& a, const MatrixType& b, const MatrixType& c) const {
+    MatrixType res = beta * c;
+    if (k > 0) res.noalias() += alpha * op(opa, a) * op(opb, b);
+    return res;
+  }
+};
+
+// Maps the i-th of the col-major matrices of a strided batch with leading dimension ld.
+template <typename Scalar>
+Map<Matrix<Scalar, Dynamic, Dynamic>, 0, OuterStride<> > batch_matrix(Scalar* data, int i, int stride, int rows,
+                                                                      int cols, int ld) {
+  return Map<Matrix<Scalar, Dynamic, Dynamic>, 0, OuterStride<> >(data + Index(i) * stride, rows, cols,
+                                                                  OuterStride<>(ld));
+}
+
+template <typename Scalar>
+void gemm_batch_strided(int max_size, int max_count) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  const gemm_problem<Scalar> p(max_size);
+  const int count = internal::random<int>(0, max_count);
+  const int lda = (std::max)(1, p.a_rows()) + internal::random<int>(0, 2);
+  const int ldb = (std::max)(1, p.b_rows()) + internal::random<int>(0, 2);
+  const int ldc = (std::max)(1, p.m) + internal::random<int>(0, 2);
+  const int sa = lda * p.a_cols() + internal::random<int>(0, 3);
+  const int sb = ldb * p.b_cols() + internal::random<int>(0, 3);
+  const int sc = ldc * p.n + internal::random<int>(0, 3);
+
+  const VectorType a = VectorType::Random(Index(sa) * count + 1), b = VectorType::Random(Index(sb) * count + 1);
+  VectorType c = VectorType::Random(Index(sc) * count + 1);
+  const VectorType c0 = c;
+  blas_gemm_batch<Scalar>::strided(p.opa, p.opb, p.m, p.n, p.k, p.alpha, a.data(), lda, sa, b.data(), ldb, sb, p.beta,
+                                   c.data(), ldc, sc, count);
+  for (int i = 0; i < count; ++i) {
+    const MatrixType ai = batch_matrix(const_cast<Scalar*>(a.data()), i, sa, p.a_rows(), p.a_cols(), lda);
+    const MatrixType bi = batch_matrix(const_cast<Scalar*>(b.data()), i, sb, p.b_rows(), p.b_cols(), ldb);
+    const MatrixType ci = batch_matrix(const_cast<Scalar*>(c0.data()), i, sc, p.m, p.n, ldc);
+    VERIFY_IS_APPROX(MatrixType(batch_matrix(c.data(), i, sc, p.m, p.n, ldc)), p.reference(ai, bi, ci));
+  }
+
+  // The same products with the CBLAS interface, in both layouts. A row-major matrix is the col-major storage of its
+  // transpose, so that the transposed problem is computed on the same data.
+  const int trans[] = {CblasNoTrans, CblasTrans, CblasConjTrans};
+  const int cblas_opa = trans[p.opa == 'N' ? 0 : p.opa == 'T' ? 1 : 2];
+  const int cblas_opb = trans[p.opb == 'N' ? 0 : p.opb == 'T' ? 1 : 2];
+  VectorType d = c0;
+  blas_gemm_batch<Scalar>::cblas_strided(CblasColMajor, cblas_opa, cblas_opb, p.m, p.n, p.k, p.alpha, a.data(), lda,
+                                         sa, b.data(), ldb, sb, p.beta, d.data(), ldc, sc, count);
+  VERIFY_IS_APPROX(d, c);
+  // C^T = op(B)^T op(A)^T: with the row-major layout, the stored B and A are read as the transposed operands.
+  d = c0;
+  blas_gemm_batch<Scalar>::cblas_strided(CblasRowMajor, cblas_opb, cblas_opa, p.n, p.m, p.k, p.alpha, b.data(), ldb,
+                                         sb, a.data(), lda, sa, p.beta, d.data(), ldc, sc, count);
+  for (int i = 0; i < count; ++i) {
+    const MatrixType ai = batch_matrix(const_cast<Scalar*>(a.data()), i, sa, p.a_rows(), p.a_cols(), lda);
+    const MatrixType bi = batch_matrix(const_cast<Scalar*>(b.data()), i, sb, p.b_rows(), p.b_cols(), ldb);
+    const MatrixType ci = batch_matrix(const_cast<Scalar*>(c0.data()), i, sc, p.m, p.n, ldc);
+    // Row-major n x m results are stored as col-major m x n matrices.
+    VERIFY_IS_APPROX(MatrixType(batch_matrix(d.data(), i, sc, p.m, p.n, ldc)), p.reference(ai, bi, ci));
+  }
+}
+
+template <typename Scalar>
+void gemm_batch_grouped(int max_size) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RowMajor> RowMatrixType;
+  const int groups = internal::random<int>(0, 4);
+  std::vector<gemm_problem<Scalar> > problems;
+  std::vector<char> opa, opb;
+  std::vector<int> m, n, k, lda, ldb, ldc, sizes, cblas_opa, cblas_opb;
+  std::vector<Scalar> alpha, beta;
+  for (int g = 0; g < groups; ++g) {
+    const gemm_problem<Scalar> p(max_size);
+    problems.push_back(p);
+    opa.push_back(p.opa);
+    opb.push_back(p.opb);
+    cblas_opa.push_back(p.opa == 'N' ? CblasNoTrans : p.opa == 'T' ? CblasTrans : CblasConjTrans);
+    cblas_opb.push_back(p.opb == 'N' ? CblasNoTrans : p.opb == 'T' ? CblasTrans : CblasConjTrans);
+    m.push_back(p.m);
+    n.push_back(p.n);
+    k.push_back(p.k);
+    alpha.push_back(p.alpha);
+    beta.push_back(p.beta);
+    lda.push_back((std::max)(1, p.a_rows()));
+    ldb.push_back((std::max)(1, p.b_rows()));
+    ldc.push_back((std::max)(1, p.m));
+    sizes.push_back(internal::random<int>(0, 5));
+  }
+
+  // Col-major matrices of each product, its group being group[i].
+  std::vector<int> group;
+  std::vector<MatrixType> a, b, c0;
+  for (int g = 0; g < groups; ++g)
+    for (int i = 0; i < sizes[g]; ++i) {
+      const gemm_problem<Scalar>& p = problems[g];
+      group.push_back(g);
+      a.push_back(MatrixType::Random(lda[g], p.a_cols()));
+      b.push_back(MatrixType::Random(ldb[g], p.b_cols()));
+      c0.push_back(MatrixType::Random(ldc[g], p.n));
+    }
+  const size_t count = group.size();
+
+  std::vector<MatrixType> c = c0;
+  std::vector<const Scalar*> pa(count), pb(count);
+  std::vector<Scalar*> pc(count);
+  for (size_t i = 0; i < count; ++i) {
+    pa[i] = a[i].data();
+    pb[i] = b[i].data();
+    pc[i] = c[i].data();
+  }
+  blas_gemm_batch<Scalar>::grouped(opa.data(), opb.data(), m.data(), n.data(), k.data(), alpha.data(), pa.data(),
+                                   lda.data(), pb.data(), ldb.data(), beta.data(), pc.data(), ldc.data(), groups,
+                                   sizes.data());
+  for (size_t i = 0; i < count; ++i) {
+    const gemm_problem<Scalar>& p = problems[group[i]];
+    VERIFY_IS_APPROX(MatrixType(c[i].topRows(p.m)),
+                     p.reference(a[i].topRows(p.a_rows()), b[i].topRows(p.b_rows()), c0[i].topRows(p.m)));
+  }
+
+  // CBLAS, col-major layout: same results, up to the rounding of the kernels, which may depend on the alignment of
+  // the results.
+  std::vector<MatrixType> d = c0;
+  for (size_t i = 0; i < count; ++i) pc[i] = d[i].data();
+  blas_gemm_batch<Scalar>::cblas_grouped(CblasColMajor, cblas_opa.data(), cblas_opb.data(), m.data(), n.data(),
+                                         k.data(), alpha.data(), pa.data(), lda.data(), pb.data(), ldb.data(),
+                                         beta.data(), pc.data(), ldc.data(), groups, sizes.data());
+  for (size_t i = 0; i < count; ++i) VERIFY_IS_APPROX(d[i], c[i]);
+
+  // CBLAS, row-major layout, with the problems stored as row-major matrices.
+  std::vector<RowMatrixType> ra(count), rb(count), rc(count);
+  std::vector<int> rlda, rldb, rldc;
+  for (int g = 0; g < groups; ++g) {
+    const gemm_problem<Scalar>& p = problems[g];
+    rlda.push_back((std::max)(1, p.a_cols()));
+    rldb.push_back((std::max)(1, p.b_cols()));
+    rldc.push_back((std::max)(1, p.n));
+  }
+  for (size_t i = 0; i < count; ++i) {
+    const gemm_problem<Scalar>& p = problems[group[i]];
+    ra[i] = a[i].topRows(p.a_rows());
+    rb[i] = b[i].topRows(p.b_rows());
+    rc[i] = c0[i].topRows(p.m);
+    // Pads the empty matrices so that their data pointers are not null.
+    if (ra[i].size() == 0) ra[i].resize(1, 1);
+    if (rb[i].size() == 0) rb[i].resize(1, 1);
+    if (rc[i].size() == 0) rc[i].resize(1, 1);
+    pa[i] = ra[i].data();
+    pb[i] = rb[i].data();
+    pc[i] = rc[i].data();
+  }
+  blas_gemm_batch<Scalar>::cblas_grouped(CblasRowMajor, cblas_opa.data(), cblas_opb.data(), m.data(), n.data(),
+                                         k.data(), alpha.data(), pa.data(), rlda.data(), pb.data(), rldb.data(),
+                                         beta.data(), pc.data(), rldc.data(), groups, sizes.data());
+  for (size_t i = 0; i < count; ++i) {
+    const gemm_problem<Scalar>& p = problems[group[i]];
+    if (p.m > 0 && p.n > 0) VERIFY_IS_APPROX(MatrixType(rc[i]), MatrixType(c[i].topRows(p.m)));
+  }
+}
+
+// Invalid arguments are reported through xerbla, with the position of the faulty argument.
+template <typename Scalar>
+void gemm_batch_arguments() {
+  typedef blas_gemm_batch<Scalar> Blas;
+  Scalar a[16], b[16], c[64];
+  const Scalar one(1);
+  std::fill(c, c + 64, Scalar(0));
+
+  struct expected_error {
+    char opa, opb;
+    int m, n, k, lda, sa, ldb, sb, ldc, sc, count, info;
+  };
+  const expected_error errors[] = {
+      {'X', 'N', 2, 2, 2, 2, 4, 2, 4, 2, 4, 2, 1},   {'N', 'X', 2, 2, 2, 2, 4, 2, 4, 2, 4, 2, 2},
+      {'N', 'N', -1, 2, 2, 2, 4, 2, 4, 2, 4, 2, 3},  {'N', 'N', 2, -1, 2, 2, 4, 2, 4, 2, 4, 2, 4},
+      {'N', 'N', 2, 2, -1, 2, 4, 2, 4, 2, 4, 2, 5},  {'N', 'N', 2, 2, 2, 1, 4, 2, 4, 2, 4, 2, 8},
+      {'N', 'N', 2, 2, 2, 2, -1, 2, 4, 2, 4, 2, 9},  {'N', 'N', 2, 2, 2, 2, 4, 1, 4, 2, 4, 2, 11},
+      {'N', 'N', 2, 2, 2, 2, 4, 2, -1, 2, 4, 2, 12}, {'N', 'N', 2, 2, 2, 2, 4, 2, 4, 1, 4, 2, 15},
+      {'N', 'N', 2, 2, 2, 2, 4, 2, 4, 2, 3, 2, 16},  {'N', 'N', 2, 2, 2, 2, 4, 2, 4, 2, 4, -1, 17},
+  };
+  for (const expected_error& e : errors) {
+    g_xerbla_info = 0;
+    Blas::strided(e.opa, e.opb, e.m, e.n, e.k, one, a, e.lda, e.sa, b, e.ldb, e.sb, one, c, e.ldc, e.sc, e.count);
+    VERIFY_IS_EQUAL(g_xerbla_info, e.info);
+    VERIFY(g_xerbla_name.find("GEMM_BATCH_STRIDED") != std::string::npos);
+  }
+
+  // ldc * n does not fit in an int: the stride of C is too small, whatever the overflow.
+  g_xerbla_info = 0;
+  Blas::strided('N', 'N', 1, 1 << 16, 0, one, a, 1, 0, b, 1, 0, one, c, 1 << 16, 1 << 30, 2);
+  VERIFY_IS_EQUAL(g_xerbla_info, 16);
+
+  // Overlapping results are allowed for a single product.
+  g_xerbla_info = 0;
+  Blas::strided('N', 'N', 2, 2, 2, one, a, 2, 0, b, 2, 0, one, c, 2, 0, 1);
+  VERIFY_IS_EQUAL(g_xerbla_info, 0);
+
+  const char N = 'N', X = 'X';
+  const int two = 2, one_int = 1, negative = -1;
+  const Scalar* pa = a;
+  const Scalar* pb = b;
+  Scalar* pc = c;
+  g_xerbla_info = 0;
+  Blas::grouped(&N, &N, &two, &two, &two, &one, &pa, &two, &pb, &two, &one, &pc, &two, -1, &one_int);
+  VERIFY_IS_EQUAL(g_xerbla_info, 14);
+  Blas::grouped(&N, &N, &two, &two, &two, &one, &pa, &two, &pb, &two, &one, &pc, &two, 1, &negative);
+  VERIFY_IS_EQUAL(g_xerbla_info, 15);
+  Blas::grouped(&X, &N, &two, &two, &two, &one, &pa, &two, &pb, &two, &one, &pc, &two, 1, &one_int);
+  VERIFY_IS_EQUAL(g_xerbla_info, 1);
+  Blas::grouped(&N, &N, &two, &two, &two, &one, &pa, &one_int, &pb, &two, &one, &pc, &two, 1, &one_int);
+  VERIFY_IS_EQUAL(g_xerbla_info, 8);
+  VERIFY(g_xerbla_name.find("GEMM_BATCH") != std::string::npos);
+
+  // An invalid layout is reported as the first argument.
+  g_xerbla_info = 0;
+  Blas::cblas_strided(0, CblasNoTrans, CblasNoTrans, 2, 2, 2, one, a, 2, 4, b, 2, 4, one, c, 2, 4, 1);
+  VERIFY_IS_EQUAL(g_xerbla_info, 1);
+  VERIFY(g_xerbla_name.find("cblas_") == 0);
+  const int notrans = CblasNoTrans;
+  g_xerbla_info = 0;
+  Blas::cblas_grouped(0, &notrans, &notrans, &two, &two, &two, &one, &pa, &two, &pb, &two, &one, &pc, &two, 1,
+                      &one_int);
+  VERIFY_IS_EQUAL(g_xerbla_info, 1);
+  // An invalid transposition is reported at its position in the Fortran interface.
+  g_xerbla_info = 0;
+  Blas::cblas_strided(CblasColMajor, 0, CblasNoTrans, 2, 2, 2, one, a, 2, 4, b, 2, 4, one, c, 2, 4, 1);
+  VERIFY_IS_EQUAL(g_xerbla_info, 1);
+}
+
+template <typename Scalar>
+void gemm_batch_all() {
+  gemm_batch_strided<Scalar>(20, 10);
+  gemm_batch_grouped<Scalar>(20);
+  gemm_batch_arguments<Scalar>();
+}
+
+// With a library configured with EIGEN_BLAS_THREADPOOL, the products are computed concurrently when there are
+// enough of them, and one after the other on all the threads otherwise.
+template <typename Scalar>
+void gemm_batch_threads() {
+  VERIFY(eigen_blas_get_max_threads() >= 1);
+  const int max_threads = eigen_blas_get_max_threads();
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    eigen_blas_set_num_threads(threads);
+    VERIFY_IS_EQUAL(eigen_blas_get_num_threads(), threads);
+    // fewer and more products than threads
+    gemm_batch_strided<Scalar>(300, 1);
+    gemm_batch_strided<Scalar>(64, 4 * max_threads);
+    gemm_batch_grouped<Scalar>(150);
+  }
+  eigen_blas_set_num_threads(0);
+  VERIFY_IS_EQUAL(eigen_blas_get_num_threads(), max_threads);
+}
+
+EIGEN_DECLARE_TEST(blas_gemm_batch) {
+  // Read at the first call of the library: a threaded library uses 4 threads, a serial one ignores it.
+  setenv("EIGEN_BLAS_NUM_THREADS", "4", 0);
+  for (int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(gemm_batch_all<float>());
+    CALL_SUBTEST_2(gemm_batch_all<double>());
+    CALL_SUBTEST_3(gemm_batch_all<std::complex<float> >());
+    CALL_SUBTEST_4(gemm_batch_all<std::complex<double> >());
+  }
+  CALL_SUBTEST_5(gemm_batch_threads<double>());
+  CALL_SUBTEST_5(gemm_batch_threads<std::complex<float> >());
+}
@@ -0,0 +1,78 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Transpose all the non-square matrices in place.
+#define EIGEN_INPLACE_TRANSPOSE_THRESHOLD 0
+#include "main.h"
+
+template <typename MatrixType>
+MatrixType reference_transpose(const MatrixType& m) {
+  MatrixType res(m.cols(), m.rows());
+  for (Index i = 0; i < m.rows(); ++i)
+    for (Index j = 0; j < m.cols(); ++j) res(j, i) = m(i, j);
+  return res;
+}
+
+template <typename MatrixType>
+void check_inplace_transpose(Index rows, Index cols) {
+  MatrixType m = MatrixType::Random(rows, cols);
+  const MatrixType ref = reference_transpose(m);
+  const typename MatrixType::Scalar* data = m.data();
+  m.transposeInPlace();
+  VERIFY_IS_EQUAL(m, ref);
+  VERIFY(m.data() == data);
+}
+
+// Large matrices use the blocked transpose kernels.
+template <typename Scalar>
+void blocked_transpose() {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RowMajor> RowMatrixType;
+  const Index rows = internal::random<Index>(16, 300), cols = internal::random<Index>(16, 300);
+  const MatrixType m = MatrixType::Random(rows, cols);
+  const MatrixType ref = reference_transpose(m);
+
+  MatrixType t = m.transpose();
+  VERIFY_IS_EQUAL(t, ref);
+  const RowMatrixType rm = m;
+  RowMatrixType rt = rm.transpose();
+  VERIFY_IS_EQUAL(MatrixType(rt), ref);
+  rt = m.transpose();
+  VERIFY_IS_EQUAL(MatrixType(rt), ref);
+
+  // Blocks with outer strides
+  const MatrixType big = MatrixType::Random(rows + 7, cols + 5);
+  MatrixType bt = MatrixType::Random(cols + 9, rows + 3);
+  const MatrixType bt0 = bt;
+  bt.block(2, 1, cols, rows) = big.block(3, 4, rows, cols).transpose();
+  VERIFY_IS_EQUAL(MatrixType(bt.block(2, 1, cols, rows)), reference_transpose(MatrixType(big.block(3, 4, rows, cols))));
+  VERIFY_IS_EQUAL(bt.topRows(2), bt0.topRows(2));
+  VERIFY_IS_EQUAL(bt.leftCols(1), bt0.leftCols(1));
+  VERIFY_IS_EQUAL(bt.bottomRows(7), bt0.bottomRows(7));
+  VERIFY_IS_EQUAL(bt.rightCols(2), bt0.rightCols(2));
+
+  // In place, including dimensions without small divisors.
+  check_inplace_transpose<MatrixType>(rows, cols);
+  check_inplace_transpose<RowMatrixType>(rows, cols);
+  check_inplace_transpose<MatrixType>(32 * 9, 7);
+  check_inplace_transpose<RowMatrixType>(5, 16 * 13);
+  // Dimensions without divisors large enough, transposed through a temporary.
+  check_inplace_transpose<MatrixType>(97, 61);
+  check_inplace_transpose<MatrixType>(16 * 3, 7);
+  check_inplace_transpose<RowMatrixType>(5, 8 * 7);
+  check_inplace_transpose<MatrixType>(1, cols);
+  check_inplace_transpose<MatrixType>(0, cols);
+}
+
+EIGEN_DECLARE_TEST(blocked_transpose) {
+  for (int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(blocked_transpose<float>());
+    CALL_SUBTEST_1(blocked_transpose<double>());
+    CALL_SUBTEST_2(blocked_transpose<std::complex<float> >());
+    CALL_SUBTEST_2(blocked_transpose<int>());
+  }
+}
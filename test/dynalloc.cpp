@@ -7,6 +7,8 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+// Exercises the memory mapping of large buffers, see check_large_buffers().
+#define EIGEN_USE_LARGE_BUFFER_MMAP
 #include "main.h"
 
 #if EIGEN_MAX_ALIGN_BYTES > 0
@@ -111,12 +113,85 @@ void check_custom_new_delete() {
 #endif
 }
 
+void check_large_buffers() {
+  const std::size_t threshold = largeBufferThreshold();
+  const int options = largeBufferOptions();
+  const std::size_t mb = std::size_t(1) << 20;
+  setLargeBufferThreshold(4 * mb);
+
+  for (int k = 0; k < 4; ++k) {
+    setLargeBufferOptions(k == 0 ? 0 : k == 1 ? LargeBufferHugePages : k == 2 ? LargeBufferPrefault : 7);
+    // Below and above the threshold.
+    for (std::size_t size : {3 * mb, 4 * mb, 5 * mb + 7}) {
+      char *p = static_cast<char *>(internal::aligned_malloc(size));
+      VERIFY(std::uintptr_t(p) % ALIGNMENT == 0);
+#if EIGEN_LARGE_BUFFER_MMAP
+      VERIFY_IS_EQUAL(std::uintptr_t(p) % (2 * mb) == 0, size >= 4 * mb);
+#endif
+      std::memset(p, 1, size);
+      // Reallocation, within or across the threshold.
+      for (std::size_t new_size : {size + mb, size / 2, std::size_t(100)}) {
+        p = static_cast<char *>(internal::aligned_realloc(p, new_size, size));
+        VERIFY(std::uintptr_t(p) % ALIGNMENT == 0);
+        for (std::size_t j = 0; j < (std::min)(size, new_size); j += 4093) VERIFY_IS_EQUAL(int(p[j]), 1);
+        std::memset(p, 1, new_size);
+        size = new_size;
+      }
+      internal::aligned_free(p);
+    }
+  }
+
+  // Per call policies.
+  void *mapped = internal::aligned_malloc(100, LargeBufferMapped);
+  void *heap = internal::aligned_malloc(8 * mb, LargeBufferHeap);
+#if EIGEN_LARGE_BUFFER_MMAP
+  VERIFY(internal::large_buffer_capacity(mapped) == 2 * mb);
+  VERIFY(internal::large_buffer_capacity(heap) == 0);
+#endif
+  internal::aligned_free(mapped);
+  internal::aligned_free(heap);
+
+  // Many buffers alive at once, freed in an order which leaves removed slots in the registry.
+  std::vector<void *> buffers;
+  for (int round = 0; round < 3; ++round) {
+    while (buffers.size() < 200) buffers.push_back(internal::aligned_malloc(100, LargeBufferMapped));
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+#if EIGEN_LARGE_BUFFER_MMAP
+      VERIFY(internal::large_buffer_capacity(buffers[i]) == 2 * mb);
+#endif
+      if (i % 3 != 0) internal::aligned_free(buffers[i]);
+    }
+    std::vector<void *> kept;
+    for (std::size_t i = 0; i < buffers.size(); i += 3) kept.push_back(buffers[i]);
+    buffers.swap(kept);
+  }
+  for (void *p : buffers) internal::aligned_free(p);
+
+  // Dynamic-size matrices.
+  MatrixXd m = MatrixXd::Constant(1024, 1024, 2.0);
+  m.conservativeResize(1024, 512);
+  VERIFY_IS_EQUAL(m.sum(), 2.0 * 1024 * 512);
+  m.conservativeResize(1024, 1536);
+  VERIFY_IS_EQUAL(m.leftCols(512).sum(), 2.0 * 1024 * 512);
+  setLargeBufferThreshold(0);
+  MatrixXd m2 = m.leftCols(512) * 2.0;
+#if EIGEN_LARGE_BUFFER_MMAP
+  VERIFY(internal::large_buffer_capacity(m.data()) > 0);
+  VERIFY(internal::large_buffer_capacity(m2.data()) == 0);
+#endif
+  m.resize(0, 0);
+
+  setLargeBufferThreshold(threshold);
+  setLargeBufferOptions(options);
+}
+
 EIGEN_DECLARE_TEST(dynalloc) {
   // low level dynamic memory allocation
   CALL_SUBTEST(check_handmade_aligned_malloc());
   CALL_SUBTEST(check_aligned_malloc());
   CALL_SUBTEST(check_aligned_new());
   CALL_SUBTEST(check_aligned_stack_alloc());
+  CALL_SUBTEST(check_large_buffers());
 
   for (int i = 0; i < g_repeat * 100; ++i) {
     CALL_SUBTEST(check_custom_new_delete<Vector4f>());
@@ -840,11 +840,101 @@ void check_tutorial_examples() {
   }
 }
 
+template <typename MatrixType>
+void check_indexed_view_packets() {
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  const Index rows = internal::random<Index>(20, 200), cols = internal::random<Index>(20, 200);
+  const MatrixType A = MatrixType::Random(rows, cols);
+
+  // sorted runs of consecutive indices, arbitrary indices, and indices with duplicates
+  std::vector<int> runs, arbitrary, duplicates;
+  for (int i = 0; i < rows; i += internal::random<int>(1, 3))
+    for (int k = internal::random<int>(1, 12); k > 0 && i < rows; --k) runs.push_back(i++);
+  for (int k = internal::random<int>(1, 100); k > 0; --k) arbitrary.push_back(internal::random<int>(0, int(rows) - 1));
+  for (int k = 0; k < 50; ++k) duplicates.push_back(internal::random<int>(0, 3));
+  ArrayXi colIdx = ArrayXi::LinSpaced(cols / 2, int(cols) - 1, 0);
+
+#ifdef EIGEN_VECTORIZE
+  // gathers are evaluated by packets
+  typedef internal::evaluator<MatrixType> DstEvaluator;
+  typedef internal::evaluator<decltype(A(runs, colIdx))> SrcEvaluator;
+  typedef internal::copy_using_evaluator_traits<DstEvaluator, SrcEvaluator, internal::assign_op<Scalar, Scalar>>
+      GatherTraits;
+  VERIFY(int(GatherTraits::Traversal) == int(SliceVectorizedTraversal));
+  // and so are scatters into an expression with direct access
+  typedef MatrixType& MatrixRef;
+  typedef internal::evaluator<decltype(std::declval<MatrixRef>()(runs, colIdx))> ScatterEvaluator;
+  typedef internal::copy_using_evaluator_traits<ScatterEvaluator, DstEvaluator, internal::assign_op<Scalar, Scalar>>
+      ScatterTraits;
+  VERIFY(int(ScatterTraits::Traversal) == int(SliceVectorizedTraversal));
+#endif
+
+  const std::vector<int>* sets[] = {&runs, &arbitrary, &duplicates};
+  for (const std::vector<int>* idx : sets) {
+    const Index n = Index(idx->size());
+    MatrixType ref(n, cols), ref2(n, colIdx.size());
+    for (Index j = 0; j < cols; ++j)
+      for (Index i = 0; i < n; ++i) ref(i, j) = A((*idx)[i], j);
+    for (Index j = 0; j < colIdx.size(); ++j)
+      for (Index i = 0; i < n; ++i) ref2(i, j) = A((*idx)[i], colIdx(j));
+
+    // gather
+    VERIFY_IS_CWISE_EQUAL(MatrixType(A(*idx, all)), ref);
+    VERIFY_IS_CWISE_EQUAL(MatrixType(A(*idx, colIdx)), ref2);
+    VERIFY_IS_CWISE_EQUAL(MatrixType(A.transpose()(all, *idx)), MatrixType(ref.transpose()));
+    VERIFY_IS_APPROX(MatrixType(A(*idx, all) * Scalar(2) + A(*idx, all)), MatrixType(Scalar(3) * ref));
+    VectorType v = A.col(0);
+    VERIFY_IS_CWISE_EQUAL(VectorType(v(*idx)), VectorType(ref.col(0)));
+
+    // scatter, the last duplicated index wins as in the coefficient-wise assignment
+    MatrixType B = A, Bref = A;
+    const MatrixType X = MatrixType::Random(n, cols);
+    B(*idx, all) = X;
+    for (Index j = 0; j < cols; ++j)
+      for (Index i = 0; i < n; ++i) Bref((*idx)[i], j) = X(i, j);
+    VERIFY_IS_CWISE_EQUAL(B, Bref);
+    VectorType w = VectorType::Zero(rows), wref = VectorType::Zero(rows);
+    w(*idx) = X.col(1);
+    for (Index i = 0; i < n; ++i) wref((*idx)[i]) = X(i, 1);
+    VERIFY_IS_CWISE_EQUAL(w, wref);
+    w(*idx) += X.col(1);
+    for (Index i = 0; i < n; ++i) wref((*idx)[i]) += X(i, 1);
+    VERIFY_IS_CWISE_EQUAL(w, wref);
+    // through a transposed block
+    MatrixType C = A;
+    C.block(0, 0, rows, cols).transpose()(all, *idx) = X.transpose();
+    VERIFY_IS_CWISE_EQUAL(C, Bref);
+    // and into an expression without direct access
+    MatrixType D = A.colwise().reverse();
+    D.colwise().reverse()(*idx, all) = X;
+    VERIFY_IS_CWISE_EQUAL(MatrixType(D.colwise().reverse()), Bref);
+  }
+
+  // fixed sizes are inner-vectorized, and compound assignments still accumulate into duplicated indices
+  typedef Matrix<Scalar, 8, 1> Vector8;
+  const std::array<int, 8> fixedIdx = {{3, 3, 0, 7, 1, 1, 1, 6}};
+  const Vector8 y = Vector8::Random();
+  Vector8 z = Vector8::Random(), zref = z;
+  z(fixedIdx) += y;
+  for (int i = 0; i < 8; ++i) zref(fixedIdx[i]) += y(i);
+  VERIFY_IS_APPROX(z, zref);
+  z(fixedIdx) = y;
+  for (int i = 0; i < 8; ++i) zref(fixedIdx[i]) = y(i);
+  VERIFY_IS_CWISE_EQUAL(z, zref);
+}
+
 EIGEN_DECLARE_TEST(indexed_view) {
   for (int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_1(check_indexed_view());
   }
   CALL_SUBTEST_1(check_tutorial_examples());
+  for (int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_2(check_indexed_view_packets<MatrixXf>());
+    CALL_SUBTEST_2((check_indexed_view_packets<Matrix<double, Dynamic, Dynamic, RowMajor>>()));
+    CALL_SUBTEST_2(check_indexed_view_packets<MatrixXcf>());
+    CALL_SUBTEST_2(check_indexed_view_packets<MatrixXi>());
+  }
 
   // static checks of some internals:
   STATIC_CHECK((internal::is_valid_index_type<int>::value));
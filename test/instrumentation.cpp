@@ -0,0 +1,133 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_INSTRUMENTATION
+#include "main.h"
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+#include <Eigen/QR>
+
+typedef internal::instrumentation::kernel_stats KernelStats;
+
+KernelStats find_stats(const char* name) {
+  for (const KernelStats& s : internal::instrumentation::instance().stats())
+    if (s.name == name) return s;
+  return KernelStats{name, 0, 0, 0, 0, 0, 0};
+}
+
+struct EventCounts {
+  long long kernels = 0;
+  long long allocations = 0;
+  long long deallocations = 0;
+};
+
+void count_events(const InstrumentationEvent& event, void* data) {
+  EventCounts& counts = *static_cast<EventCounts*>(data);
+  if (event.kind == InstrumentedKernel) ++counts.kernels;
+  if (event.kind == InstrumentedAllocation) ++counts.allocations;
+  if (event.kind == InstrumentedDeallocation) ++counts.deallocations;
+}
+
+void test_kernels() {
+  resetInstrumentation();
+  const Index n = 64;
+  MatrixXd a = MatrixXd::Random(n, n), b = MatrixXd::Random(n, n), c(n, n);
+  c.noalias() = a * b;
+  KernelStats gemm = find_stats("gemm");
+  VERIFY_IS_EQUAL(gemm.calls, 1);
+  VERIFY_IS_EQUAL(gemm.flops, 2.0 * n * n * n);
+  VERIFY(gemm.bytes > 0);
+
+  VectorXd x = VectorXd::Random(n), y(n);
+  y.noalias() = a * x;
+  VERIFY_IS_EQUAL(find_stats("gemv").calls, 1);
+  VERIFY_IS_EQUAL(find_stats("gemv").flops, 2.0 * n * n);
+
+  MatrixXd spd = a * a.transpose() + MatrixXd::Identity(n, n) * double(n);
+  LLT<MatrixXd> llt(spd);
+  VERIFY_IS_EQUAL(find_stats("llt").calls, 1);
+  VERIFY_IS_APPROX(find_stats("llt").flops, double(n) * n * n / 3);
+
+  PartialPivLU<MatrixXd> lu(a);
+  VERIFY_IS_EQUAL(find_stats("partial_piv_lu").calls, 1);
+  VERIFY_IS_APPROX(find_stats("partial_piv_lu").flops, 2.0 * n * n * n / 3);
+
+  HouseholderQR<MatrixXd> qr(a);
+  VERIFY_IS_EQUAL(find_stats("householder_qr").calls, 1);
+  VERIFY_IS_APPROX(find_stats("householder_qr").flops, 4.0 * n * n * n / 3);
+
+  // Kernels called by the factorizations are recorded as well.
+  VERIFY(find_stats("gemm").calls >= 1);
+
+  std::string summary = instrumentationSummary();
+  VERIFY(summary.find("gemm") != std::string::npos);
+  VERIFY(summary.find("partial_piv_lu") != std::string::npos);
+
+  resetInstrumentation();
+  VERIFY_IS_EQUAL(find_stats("gemm").calls, 0);
+}
+
+void test_allocations() {
+  resetInstrumentation();
+  EventCounts counts;
+  setInstrumentationCallback(count_events, &counts);
+  {
+    EIGEN_INSTRUMENT_REGION("test_region");
+    MatrixXf m(31, 17);
+    m.setZero();
+    VERIFY_IS_EQUAL(counts.allocations, 1);
+  }
+  setInstrumentationCallback(nullptr);
+  KernelStats region = find_stats("test_region");
+  VERIFY_IS_EQUAL(region.calls, 1);
+  VERIFY_IS_EQUAL(region.allocations, 1);
+  VERIFY_IS_EQUAL(region.allocated_bytes, double(31 * 17 * sizeof(float)));
+  VERIFY_IS_EQUAL(counts.allocations, 1);
+  VERIFY_IS_EQUAL(counts.deallocations, 1);
+  VERIFY_IS_EQUAL(counts.kernels, 1);
+
+  // Outside of a region, allocations are attributed to "(none)".
+  VectorXd v(100);
+  v.setOnes();
+  VERIFY_IS_EQUAL(find_stats("(none)").allocations, 1);
+
+  // Without a callback, the counts are not updated.
+  MatrixXd m(5, 5);
+  m.setZero();
+  VERIFY_IS_EQUAL(counts.allocations, 1);
+}
+
+void test_trace() {
+  resetInstrumentation();
+  setInstrumentationTracing(true);
+  {
+    EIGEN_INSTRUMENT_REGION("traced \"region\"");
+    MatrixXd a = MatrixXd::Random(40, 40), b = MatrixXd::Random(40, 40);
+    MatrixXd c = a * b;
+    VERIFY(c.allFinite());
+  }
+  setInstrumentationTracing(false);
+  std::string trace = instrumentationChromeTrace();
+  VERIFY(trace.find("\"traceEvents\"") != std::string::npos);
+  VERIFY(trace.find("\"name\":\"gemm\"") != std::string::npos);
+  VERIFY(trace.find("\"ph\":\"X\"") != std::string::npos);
+  VERIFY(trace.find("\"ph\":\"i\"") != std::string::npos);
+  VERIFY(trace.find("traced \\\"region\\\"") != std::string::npos);
+
+  // Events are not recorded once tracing is disabled.
+  MatrixXd d(10, 10);
+  d.setZero();
+  VERIFY_IS_EQUAL(instrumentationChromeTrace(), trace);
+  resetInstrumentation();
+  VERIFY(instrumentationChromeTrace().find("\"ph\"") == std::string::npos);
+}
+
+EIGEN_DECLARE_TEST(instrumentation) {
+  CALL_SUBTEST_1(test_kernels());
+  CALL_SUBTEST_2(test_allocations());
+  CALL_SUBTEST_3(test_trace());
+}
@@ -48,6 +48,137 @@ static void check_ostream() {
   check_ostream_impl<Scalar>::run();
 }
 
+template <typename MatrixType>
+static void check_text_roundtrip(const MatrixType& m) {
+  std::ostringstream ss;
+  VERIFY(writeText(ss, m));
+  const std::string text = ss.str();
+  MatrixType m2;
+  VERIFY(parseText(text.data(), text.data() + text.size(), m2));
+  VERIFY_IS_EQUAL(m2.rows(), m.rows());
+  VERIFY_IS_EQUAL(m2.cols(), m.cols());
+  // The shortest representations read back exactly.
+  VERIFY(m2.matrix() == m.matrix());
+
+  const std::string filename = GetTestTempFilename("io_text.txt");
+  const IOFormat spaces(FullPrecision, DontAlignCols, " ", "\n");
+  VERIFY(saveText(filename, m, spaces));
+  MatrixType m3;
+  VERIFY(loadText(filename, m3, ' '));
+  VERIFY(m3.matrix() == m.matrix());
+}
+
+static void check_text_parse() {
+  const char text[] = "\n 1, 2.5 ,-3e2\r\n\n4\t,+5,  6  \n\n";
+  MatrixXd m;
+  VERIFY(parseText(text, text + sizeof(text) - 1, m));
+  Matrix<double, 2, 3> expected;
+  expected << 1, 2.5, -300, 4, 5, 6;
+  VERIFY_IS_EQUAL(m, expected);
+
+  Matrix<double, 2, 3> fixed;
+  VERIFY(parseText(text, text + sizeof(text) - 1, fixed));
+  VERIFY_IS_EQUAL(fixed, expected);
+  Matrix3d wrong_size;
+  VERIFY(!parseText(text, text + sizeof(text) - 1, wrong_size));
+
+  const char whitespace[] = "1 2.5\t-3e2\n4  5 6";
+  VERIFY(parseText(whitespace, whitespace + sizeof(whitespace) - 1, m, ' '));
+  VERIFY_IS_EQUAL(m, expected);
+
+  MatrixXi mi;
+  const char integers[] = "-2147483648,2147483647\n0,-0";
+  VERIFY(parseText(integers, integers + sizeof(integers) - 1, mi));
+  VERIFY_IS_EQUAL(mi(0, 0), (std::numeric_limits<int>::min)());
+  VERIFY_IS_EQUAL(mi(0, 1), (std::numeric_limits<int>::max)());
+  VERIFY_IS_EQUAL(mi(1, 1), 0);
+
+  const char* invalid[] = {"1,2\n3", "1,,2", "1,2,", "1,x", "1.5e", "2147483648", "1;2"};
+  for (const char* s : invalid) {
+    MatrixXd md;
+    VERIFY(!parseText(s, s + std::strlen(s), md) || !parseText(s, s + std::strlen(s), mi));
+  }
+  VERIFY(!parseText(invalid[0], invalid[0] + 5, m));
+  VERIFY(!parseText(invalid[1], invalid[1] + 4, m));
+  VERIFY(!parseText(invalid[3], invalid[3] + 3, m));
+  VERIFY(!parseText(invalid[5], invalid[5] + 10, mi));
+
+  MatrixXd empty(3, 3);
+  VERIFY(parseText(text, text, empty));
+  VERIFY_IS_EQUAL(empty.size(), 0);
+  VERIFY(!loadText(GetTestTempFilename("io_does_not_exist.txt"), m));
+}
+
+static void check_text_format() {
+  Matrix<float, 2, 2> m;
+  m << 0.1f, -2, 1e-30f, 3.5f;
+  std::ostringstream ss;
+  VERIFY(writeText(ss, m));
+  VERIFY_IS_EQUAL(ss.str(), std::string("0.1,-2\n1e-30,3.5\n"));
+
+  std::ostringstream ss2;
+  VERIFY(writeText(ss2, m, IOFormat(2, 0, ", ", ";\n", "[", "]", "{", "}")));
+  VERIFY_IS_EQUAL(ss2.str(), std::string("{[0.1, -2];\n[1e-30, 3.5]}"));
+
+  Vector3i v(-7, 0, 42);
+  std::ostringstream ss3;
+  VERIFY(writeText(ss3, v.transpose()));
+  VERIFY_IS_EQUAL(ss3.str(), std::string("-7,0,42\n"));
+}
+
+template <typename MatrixType>
+static void check_raw(const MatrixType& m) {
+  typedef typename MatrixType::Scalar Scalar;
+  const std::string filename = GetTestTempFilename("io_raw.bin");
+  VERIFY(saveRaw(filename, m));
+  std::vector<Scalar> buffer(m.size());
+  VERIFY(loadRaw(filename, Map<MatrixType>(buffer.data(), m.rows(), m.cols())));
+  VERIFY_IS_EQUAL(Map<MatrixType>(buffer.data(), m.rows(), m.cols()), m);
+
+  // Blocks are read and written with strides.
+  MatrixType big = MatrixType::Zero(m.rows() + 3, m.cols() + 2);
+  VERIFY(loadRaw(filename, big.block(1, 2, m.rows(), m.cols())));
+  VERIFY_IS_EQUAL(big.block(1, 2, m.rows(), m.cols()), m);
+  VERIFY(saveRaw(filename, big.block(1, 2, m.rows(), m.cols()) * Scalar(2)));
+  MatrixType m2(m.rows(), m.cols());
+  VERIFY(loadRaw(filename, m2));
+  VERIFY_IS_EQUAL(m2, m * Scalar(2));
+
+  // Size mismatch.
+  MatrixType wrong(m.rows() + 1, m.cols());
+  VERIFY(!loadRaw(filename, wrong));
+  VERIFY(!loadRaw(GetTestTempFilename("io_does_not_exist.bin"), m2));
+}
+
+// Counts the evaluations of the coefficients of a nullary expression.
+struct counting_functor {
+  Index* calls;
+  double operator()(Index i, Index j) const {
+    ++*calls;
+    return double(i - 2 * j);
+  }
+};
+
+static void check_raw_product() {
+  // A product is evaluated once, and not for each column written.
+  const Index rows = 50, depth = 30, cols = 40;
+  Index calls = 0;
+  const counting_functor f = {&calls};
+  const MatrixXd rhs = MatrixXd::Random(depth, cols);
+  const std::string filename = GetTestTempFilename("io_raw_product.bin");
+  VERIFY(saveRaw(filename, MatrixXd::NullaryExpr(rows, depth, f) * rhs));
+  VERIFY(calls <= rows * depth);
+  MatrixXd m(rows, cols);
+  VERIFY(loadRaw(filename, m));
+  VERIFY_IS_APPROX(m, MatrixXd(MatrixXd::NullaryExpr(rows, depth, f) * rhs));
+}
+
+static void check_text_large() {
+  // Several chunks of lines.
+  MatrixXd m = MatrixXd::Random(30000, 7);
+  check_text_roundtrip(m);
+}
+
 EIGEN_DECLARE_TEST(rand) {
   CALL_SUBTEST(check_ostream<bool>());
   CALL_SUBTEST(check_ostream<float>());
@@ -60,4 +191,19 @@ EIGEN_DECLARE_TEST(rand) {
   CALL_SUBTEST(check_ostream<Eigen::numext::uint32_t>());
   CALL_SUBTEST(check_ostream<Eigen::numext::int64_t>());
   CALL_SUBTEST(check_ostream<Eigen::numext::uint64_t>());
+
+  for (int i = 0; i < g_repeat; i++) {
+    const Index rows = internal::random<Index>(1, 50), cols = internal::random<Index>(1, 50);
+    CALL_SUBTEST(check_text_roundtrip(MatrixXd::Random(rows, cols).eval()));
+    CALL_SUBTEST(check_text_roundtrip(Matrix<float, Dynamic, Dynamic, RowMajor>::Random(rows, cols).eval()));
+    CALL_SUBTEST(check_text_roundtrip(ArrayXXi::Random(rows, cols).eval()));
+    CALL_SUBTEST(check_text_roundtrip(Matrix<int64_t, Dynamic, 1>::Random(rows).eval()));
+    CALL_SUBTEST(check_raw(MatrixXf::Random(rows, cols).eval()));
+    CALL_SUBTEST(check_raw(Matrix<double, Dynamic, Dynamic, RowMajor>::Random(rows, cols).eval()));
+    CALL_SUBTEST(check_raw(MatrixXcd::Random(rows, cols).eval()));
+  }
+  CALL_SUBTEST(check_text_parse());
+  CALL_SUBTEST(check_text_format());
+  CALL_SUBTEST(check_text_large());
+  CALL_SUBTEST(check_raw_product());
 }
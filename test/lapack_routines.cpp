@@ -0,0 +1,295 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Tests of the QR, least squares and symmetric eigenvalue routines of the Eigen LAPACK library.
+
+#include "main.h"
+#include <Eigen/QR>
+#include <Eigen/Eigenvalues>
+
+// Argument errors are reported through xerbla, which replaces the weak definition of the library.
+static int g_xerbla_info = 0;
+extern "C" void xerbla_(const char*, int* info) { g_xerbla_info = *info; }
+
+template <typename Scalar>
+struct lapack_qr;
+
+#define EIGEN_TEST_LAPACK_QR(SCALAR, PREFIX, MQR, GQR, ADJOINT)                                                      \
+  extern "C" void PREFIX##geqrf_(int*, int*, SCALAR*, int*, SCALAR*, SCALAR*, int*, int*);                         \
+  extern "C" void PREFIX##MQR##_(char*, char*, int*, int*, int*, SCALAR*, int*, SCALAR*, SCALAR*, int*, SCALAR*, \
+                                 int*, int*);                                                                      \
+  extern "C" void PREFIX##GQR##_(int*, int*, int*, SCALAR*, int*, SCALAR*, SCALAR*, int*, int*);                   \
+  extern "C" void PREFIX##gels_(char*, int*, int*, int*, SCALAR*, int*, SCALAR*, int*, SCALAR*, int*, int*);       \
+  template <>                                                                                                      \
+  struct lapack_qr<SCALAR> {                                                                                       \
+    static const char adjoint = ADJOINT;                                                                           \
+    static int geqrf(int m, int n, SCALAR* a, int lda, SCALAR* tau, SCALAR* work, int lwork) {                     \
+      int info;                                                                                                    \
+      PREFIX##geqrf_(&m, &n, a, &lda, tau, work, &lwork, &info);                                                   \
+      return info;                                                                                                 \
+    }                                                                                                              \
+    static int mqr(char side, char trans, int m, int n, int k, SCALAR* a, int lda, SCALAR* tau, SCALAR* c,        \
+                   int ldc, SCALAR* work, int lwork) {                                                             \
+      int info;                                                                                                    \
+      PREFIX##MQR##_(&side, &trans, &m, &n, &k, a, &lda, tau, c, &ldc, work, &lwork, &info);                       \
+      return info;                                                                                                 \
+    }                                                                                                              \
+    static int gqr(int m, int n, int k, SCALAR* a, int lda, SCALAR* tau, SCALAR* work, int lwork) {               \
+      int info;                                                                                                    \
+      PREFIX##GQR##_(&m, &n, &k, a, &lda, tau, work, &lwork, &info);                                               \
+      return info;                                                                                                 \
+    }                                                                                                              \
+    static int gels(char trans, int m, int n, int nrhs, SCALAR* a, int lda, SCALAR* b, int ldb, SCALAR* work,     \
+                    int lwork) {                                                                                   \
+      int info;                                                                                                    \
+      PREFIX##gels_(&trans, &m, &n, &nrhs, a, &lda, b, &ldb, work, &lwork, &info);                                 \
+      return info;                                                                                                 \
+    }                                                                                                              \
+  };
+
+EIGEN_TEST_LAPACK_QR(float, s, ormqr, orgqr, 'T')
+EIGEN_TEST_LAPACK_QR(double, d, ormqr, orgqr, 'T')
+EIGEN_TEST_LAPACK_QR(std::complex<float>, c, unmqr, ungqr, 'C')
+EIGEN_TEST_LAPACK_QR(std::complex<double>, z, unmqr, ungqr, 'C')
+
+#undef EIGEN_TEST_LAPACK_QR
+
+template <typename Scalar>
+struct lapack_syevd;
+
+#define EIGEN_TEST_LAPACK_SYEVD(SCALAR, PREFIX)                                                                     \
+  extern "C" void PREFIX##syevd_(char*, char*, int*, SCALAR*, int*, SCALAR*, SCALAR*, int*, int*, int*, int*);   \
+  template <>                                                                                                     \
+  struct lapack_syevd<SCALAR> {                                                                                   \
+    static int run(char jobz, char uplo, int n, SCALAR* a, int lda, SCALAR* w, SCALAR* work, int lwork, int* iwork, \
+                   int liwork) {                                                                                  \
+      int info;                                                                                                   \
+      PREFIX##syevd_(&jobz, &uplo, &n, a, &lda, w, work, &lwork, iwork, &liwork, &info);                          \
+      return info;                                                                                                \
+    }                                                                                                             \
+  };
+
+EIGEN_TEST_LAPACK_SYEVD(float, s)
+EIGEN_TEST_LAPACK_SYEVD(double, d)
+
+#undef EIGEN_TEST_LAPACK_SYEVD
+
+// Returns the size of the workspace returned by a workspace query.
+template <typename Scalar>
+int query_size(const Scalar& work) {
+  return int(numext::real(work));
+}
+
+// GEQRF, ORGQR/UNGQR and ORMQR/UNMQR on a m x n matrix stored with a leading dimension larger than m.
+template <typename Scalar>
+void lapack_qr_factorization(int m, int n) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef lapack_qr<Scalar> Lapack;
+  const int k = (std::min)(m, n);
+  const int lda = m + 3;
+
+  const MatrixType A = MatrixType::Random(m, n);
+  MatrixType storage = MatrixType::Random(lda, n);
+  storage.topRows(m) = A;
+  VectorType tau(k);
+  Scalar size;
+  VERIFY_IS_EQUAL(Lapack::geqrf(m, n, storage.data(), lda, tau.data(), &size, -1), 0);
+  VERIFY(query_size(size) >= (std::max)(1, n));
+  VectorType work(query_size(size));
+  VERIFY_IS_EQUAL(Lapack::geqrf(m, n, storage.data(), lda, tau.data(), work.data(), int(work.size())), 0);
+
+  // R is the one computed by HouseholderQR.
+  const HouseholderQR<MatrixType> qr(A);
+  const MatrixType R = storage.topRows(k).template triangularView<Upper>();
+  VERIFY_IS_APPROX(R, MatrixType(qr.matrixQR().topRows(k).template triangularView<Upper>()));
+
+  // The first k columns of Q are orthonormal, and Q R = A.
+  MatrixType Q = storage.topLeftCorner(m, k);
+  VERIFY_IS_EQUAL(Lapack::gqr(m, k, k, Q.data(), m, tau.data(), &size, -1), 0);
+  work.resize(query_size(size));
+  VERIFY_IS_EQUAL(Lapack::gqr(m, k, k, Q.data(), m, tau.data(), work.data(), int(work.size())), 0);
+  VERIFY_IS_APPROX(MatrixType(Q.adjoint() * Q), MatrixType::Identity(k, k));
+  VERIFY_IS_APPROX(MatrixType(Q * R), A);
+
+  // op(Q) * C and C * op(Q) match the Householder sequence of HouseholderQR.
+  const MatrixType fullQ = qr.householderQ();
+  const int p = internal::random<int>(1, 20);
+  const char ops[] = {'N', Lapack::adjoint};
+  for (char op : ops) {
+    const MatrixType opQ = op == 'N' ? fullQ : MatrixType(fullQ.adjoint());
+    MatrixType C = MatrixType::Random(m, p);
+    const MatrixType left = opQ * C;
+    VERIFY_IS_EQUAL(Lapack::mqr('L', op, m, p, k, storage.data(), lda, tau.data(), C.data(), m, &size, -1), 0);
+    VERIFY(query_size(size) >= (std::max)(1, p));
+    work.resize(query_size(size));
+    VERIFY_IS_EQUAL(
+        Lapack::mqr('L', op, m, p, k, storage.data(), lda, tau.data(), C.data(), m, work.data(), int(work.size())), 0);
+    VERIFY_IS_APPROX(C, left);
+
+    MatrixType D = MatrixType::Random(p, m);
+    const MatrixType right = D * opQ;
+    work.resize((std::max)(1, p));
+    VERIFY_IS_EQUAL(
+        Lapack::mqr('R', op, p, m, k, storage.data(), lda, tau.data(), D.data(), p, work.data(), int(work.size())), 0);
+    VERIFY_IS_APPROX(D, right);
+  }
+}
+
+// GELS for the four combinations of a tall or wide matrix and of its transposition.
+template <typename Scalar>
+void lapack_least_squares(int m, int n) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef lapack_qr<Scalar> Lapack;
+  const int nrhs = internal::random<int>(1, 5);
+  const int ldb = (std::max)(m, n) + 2;
+
+  const char ops[] = {'N', Lapack::adjoint};
+  for (char op : ops) {
+    const MatrixType A = MatrixType::Random(m, n);
+    // op(A) is rows x cols.
+    const MatrixType opA = op == 'N' ? A : MatrixType(A.adjoint());
+    const int rows = int(opA.rows()), cols = int(opA.cols());
+    const MatrixType B = MatrixType::Random(rows, nrhs);
+
+    MatrixType a = A;
+    MatrixType b = MatrixType::Zero(ldb, nrhs);
+    b.topRows(rows) = B;
+    Scalar size;
+    VERIFY_IS_EQUAL(Lapack::gels(op, m, n, nrhs, a.data(), m, b.data(), ldb, &size, -1), 0);
+    VectorType work(query_size(size));
+    VERIFY_IS_EQUAL(Lapack::gels(op, m, n, nrhs, a.data(), m, b.data(), ldb, work.data(), int(work.size())), 0);
+    const MatrixType X = b.topRows(cols);
+
+    if (rows >= cols) {
+      // Least squares solution: the residual is orthogonal to the range of op(A).
+      const MatrixType residual = opA * X - B;
+      VERIFY_IS_MUCH_SMALLER_THAN((opA.adjoint() * residual).norm(), opA.norm() * B.norm());
+      VERIFY_IS_APPROX(X, MatrixType(opA.householderQr().solve(B)));
+    } else {
+      // Minimum norm solution of the underdetermined system.
+      VERIFY_IS_APPROX(MatrixType(opA * X), B);
+      VERIFY_IS_APPROX(X, MatrixType(opA.completeOrthogonalDecomposition().solve(B)));
+    }
+  }
+
+  // A rank deficient matrix is reported through info.
+  MatrixType a = MatrixType::Random(m, n);
+  const int zero = internal::random<int>(0, (std::min)(m, n) - 1);
+  a.col(zero).setZero();
+  a.row(zero).setZero();
+  MatrixType b = MatrixType::Random(ldb, nrhs);
+  VectorType work((std::min)(m, n) + (std::max)((std::min)(m, n), nrhs));
+  VERIFY(Lapack::gels('N', m, n, nrhs, a.data(), m, b.data(), ldb, work.data(), int(work.size())) > 0);
+}
+
+// Invalid arguments are reported through info and xerbla.
+template <typename Scalar>
+void lapack_qr_arguments() {
+  typedef lapack_qr<Scalar> Lapack;
+  Scalar a[16], tau[4], work[16], c[16];
+
+  g_xerbla_info = 0;
+  VERIFY_IS_EQUAL(Lapack::geqrf(-1, 4, a, 4, tau, work, 16), -1);
+  VERIFY_IS_EQUAL(g_xerbla_info, 1);
+  VERIFY_IS_EQUAL(Lapack::geqrf(4, 4, a, 3, tau, work, 16), -4);
+  VERIFY_IS_EQUAL(g_xerbla_info, 4);
+  VERIFY_IS_EQUAL(Lapack::geqrf(4, 4, a, 4, tau, work, 2), -7);
+  VERIFY_IS_EQUAL(g_xerbla_info, 7);
+
+  VERIFY_IS_EQUAL(Lapack::mqr('X', 'N', 4, 4, 4, a, 4, tau, c, 4, work, 16), -1);
+  VERIFY_IS_EQUAL(Lapack::mqr('L', 'X', 4, 4, 4, a, 4, tau, c, 4, work, 16), -2);
+  VERIFY_IS_EQUAL(Lapack::mqr('L', 'N', 4, 4, 5, a, 4, tau, c, 4, work, 16), -5);
+  VERIFY_IS_EQUAL(Lapack::mqr('L', 'N', 4, 4, 4, a, 4, tau, c, 3, work, 16), -10);
+  VERIFY_IS_EQUAL(g_xerbla_info, 10);
+
+  VERIFY_IS_EQUAL(Lapack::gqr(4, 5, 4, a, 4, tau, work, 16), -2);
+  VERIFY_IS_EQUAL(Lapack::gqr(4, 4, 5, a, 4, tau, work, 16), -3);
+  VERIFY_IS_EQUAL(g_xerbla_info, 3);
+
+  VERIFY_IS_EQUAL(Lapack::gels('X', 4, 4, 1, a, 4, c, 4, work, 16), -1);
+  VERIFY_IS_EQUAL(Lapack::gels('N', 4, 4, 1, a, 4, c, 3, work, 16), -8);
+  VERIFY_IS_EQUAL(Lapack::gels('N', 4, 4, 1, a, 4, c, 4, work, 1), -10);
+  VERIFY_IS_EQUAL(g_xerbla_info, 10);
+
+  // Empty problems are valid.
+  g_xerbla_info = 0;
+  VERIFY_IS_EQUAL(Lapack::geqrf(0, 4, a, 1, tau, work, 4), 0);
+  VERIFY_IS_EQUAL(Lapack::gqr(4, 0, 0, a, 4, tau, work, 1), 0);
+  VERIFY_IS_EQUAL(g_xerbla_info, 0);
+}
+
+// SYEVD on the upper or lower triangle, the other one holding garbage.
+template <typename Scalar>
+void lapack_symmetric_eigenvalues(int n) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef lapack_syevd<Scalar> Lapack;
+  const MatrixType R = MatrixType::Random(n, n);
+  const MatrixType A = R + R.adjoint();
+  const SelfAdjointEigenSolver<MatrixType> eig(A);
+  const int lda = n + 1;
+
+  const char uplos[] = {'U', 'L'};
+  for (char uplo : uplos) {
+    MatrixType a = MatrixType::Random(lda, n);
+    if (uplo == 'U')
+      a.topRows(n).template triangularView<Upper>() = A;
+    else
+      a.topRows(n).template triangularView<Lower>() = A;
+    VectorType w(n);
+    Scalar size;
+    int isize;
+    VERIFY_IS_EQUAL(Lapack::run('V', uplo, n, a.data(), lda, w.data(), &size, -1, &isize, -1), 0);
+    VectorType work(query_size(size));
+    Matrix<int, Dynamic, 1> iwork(isize);
+    VERIFY_IS_EQUAL(Lapack::run('V', uplo, n, a.data(), lda, w.data(), work.data(), int(work.size()), iwork.data(),
+                                int(iwork.size())),
+                    0);
+    const MatrixType V = a.topRows(n);
+    VERIFY_IS_APPROX(w, eig.eigenvalues());
+    VERIFY_IS_APPROX(MatrixType(V.transpose() * V), MatrixType::Identity(n, n));
+    VERIFY_IS_APPROX(MatrixType(A * V), MatrixType(V * w.asDiagonal()));
+  }
+
+  // Eigenvalues only, with the minimal workspace.
+  MatrixType a = A;
+  VectorType w(n), work(2 * n + 1);
+  int iwork = 0;
+  VERIFY_IS_EQUAL(Lapack::run('N', 'L', n, a.data(), n, w.data(), work.data(), int(work.size()), &iwork, 1), 0);
+  VERIFY_IS_APPROX(w, eig.eigenvalues());
+
+  g_xerbla_info = 0;
+  VERIFY_IS_EQUAL(Lapack::run('X', 'L', n, a.data(), n, w.data(), work.data(), int(work.size()), &iwork, 1), -1);
+  VERIFY_IS_EQUAL(Lapack::run('N', 'L', n, a.data(), n - 1, w.data(), work.data(), int(work.size()), &iwork, 1), -5);
+  VERIFY_IS_EQUAL(g_xerbla_info, 5);
+  VERIFY_IS_EQUAL(Lapack::run('V', 'L', n, a.data(), n, w.data(), work.data(), int(work.size()), &iwork, 1), -8);
+}
+
+template <typename Scalar>
+void lapack_qr_routines() {
+  const int m = internal::random<int>(1, 120), n = internal::random<int>(1, 120);
+  lapack_qr_factorization<Scalar>(m, n);
+  lapack_qr_factorization<Scalar>(n, m);
+  // Well conditioned least squares problems.
+  const int small = internal::random<int>(1, 40), large = small + internal::random<int>(10, 80);
+  lapack_least_squares<Scalar>(large, small);
+  lapack_least_squares<Scalar>(small, large);
+  lapack_qr_arguments<Scalar>();
+}
+
+EIGEN_DECLARE_TEST(lapack_routines) {
+  for (int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(lapack_qr_routines<float>());
+    CALL_SUBTEST_2(lapack_qr_routines<double>());
+    CALL_SUBTEST_3(lapack_qr_routines<std::complex<float> >());
+    CALL_SUBTEST_4(lapack_qr_routines<std::complex<double> >());
+    CALL_SUBTEST_5(lapack_symmetric_eigenvalues<float>(internal::random<int>(2, 80)));
+    CALL_SUBTEST_5(lapack_symmetric_eigenvalues<double>(internal::random<int>(2, 80)));
+  }
+}
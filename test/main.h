@@ -781,6 +781,20 @@ std::string type_name<std::complex<int> >() {
 
 using namespace Eigen;
 
+/**
+ * Path of a temporary file of the tests.
+ *
+ * @param filename name of the file
+ * @return filename in the directory given by the environment variable TEST_TMPDIR if set, or in the current directory
+ */
+inline std::string GetTestTempFilename(const char* filename) {
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  if (test_tmpdir == nullptr) {
+    return std::string(filename);
+  }
+  return std::string(test_tmpdir) + std::string("/") + std::string(filename);
+}
+
 /**
  * Set number of repetitions for unit test from input string.
  *
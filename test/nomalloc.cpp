@@ -203,6 +203,114 @@ void test_reference(const MatrixType& m) {
   VERIFY_RAISES_ASSERT(Ref r13 = r10);  // r10 has more dynamic strides
 }
 
+template <typename Scalar>
+void test_gemm_workspace() {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
+  const Index n = 128;
+  MatrixX a = MatrixX::Random(n, n), b = MatrixX::Random(n, n), c(n, n), x(n, n);
+  a = a + a.adjoint() + MatrixX::Identity(n, n) * Scalar(n);
+  const MatrixX ref_gemm = a * b;
+  const MatrixX ref_symm = MatrixX(a.template selfadjointView<Lower>()) * b;
+  const MatrixX ref_trsm = MatrixX(a.template triangularView<Lower>()).inverse() * b;
+
+  // The cache is opt-in. Once enabled, the first products fill the workspace
+  // cache of this thread, and the next ones shall not allocate.
+  const std::size_t limit = gemmWorkspaceCacheLimit();
+  VERIFY_IS_EQUAL(limit, std::size_t(EIGEN_GEMM_WORKSPACE_CACHE_LIMIT));
+  setGemmWorkspaceCacheLimit(std::size_t(16) << 20);
+  c.noalias() = a * b;
+  c.noalias() = a.template selfadjointView<Lower>() * b;
+  x = b;
+  a.template triangularView<Lower>().solveInPlace(x);
+  VERIFY(internal::gemm_workspace_cache::instance().size() > 0);
+
+  internal::set_is_malloc_allowed(false);
+  c.noalias() = a * b;
+  VERIFY_IS_APPROX(c, ref_gemm);
+  c.noalias() = a.template selfadjointView<Lower>() * b;
+  VERIFY_IS_APPROX(c, ref_symm);
+  x = b;
+  a.template triangularView<Lower>().solveInPlace(x);
+  VERIFY_IS_APPROX(x, ref_trsm);
+  internal::set_is_malloc_allowed(true);
+
+  releaseGemmWorkspace();
+  VERIFY_IS_EQUAL(internal::gemm_workspace_cache::instance().size(), std::size_t(0));
+
+  // Without cache, the buffers are allocated by every product.
+  setGemmWorkspaceCacheLimit(0);
+  c.noalias() = a * b;
+  VERIFY_IS_APPROX(c, ref_gemm);
+  VERIFY_IS_EQUAL(internal::gemm_workspace_cache::instance().size(), std::size_t(0));
+  internal::set_is_malloc_allowed(false);
+  VERIFY_RAISES_ASSERT(c.noalias() = a * b);
+  internal::set_is_malloc_allowed(true);
+  setGemmWorkspaceCacheLimit(limit);
+}
+
+template <typename Scalar>
+void test_memory_arena() {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
+  typedef Matrix<Scalar, Dynamic, 1> VectorX;
+  const Index n = 16;
+  const MatrixX a = MatrixX::Random(n, n), b = MatrixX::Random(n, n);
+  const VectorX v = VectorX::Random(n);
+  const MatrixX ref = (a + b) * (a - b).transpose() + (a.array() * b.array()).matrix();
+  const VectorX ref_v = (a * v).cwiseAbs() + v;
+
+  MemoryArena arena(256);
+  VERIFY(ScopedMemoryArena::currentArena() == nullptr);
+  MatrixX heap_result, before = a;
+  for (int k = 0; k < 3; ++k) {
+    ScopedMemoryArena scope(&arena);
+    VERIFY(ScopedMemoryArena::currentArena() == &arena);
+    // The first iteration grows the arena, the next ones shall not allocate.
+    if (k > 0) internal::set_is_malloc_allowed(false);
+    MatrixX c = (a + b) * (a - b).transpose();
+    c += (a.array() * b.array()).matrix();
+    VERIFY(arena.owns(c.data()));
+    VERIFY_IS_APPROX(c, ref);
+    VectorX w = (a * v).cwiseAbs() + v;
+    VERIFY_IS_APPROX(w, ref_v);
+    c.conservativeResize(n + 3, n);
+    VERIFY(arena.owns(c.data()));
+    VERIFY_IS_APPROX(c.topRows(n), ref);
+    internal::set_is_malloc_allowed(true);
+    VERIFY(arena.used() > 0);
+
+    // Copy of the result to the heap.
+    {
+      ScopedMemoryArena heap(nullptr);
+      VERIFY(ScopedMemoryArena::currentArena() == nullptr);
+      heap_result = c.topRows(n);
+      VERIFY(!arena.owns(heap_result.data()));
+    }
+    // Objects allocated before the arena was installed are freed on the heap.
+    before.resize(0, 0);
+    c.resize(0, 0);
+    w.resize(0);
+    arena.reset();
+    VERIFY_IS_EQUAL(arena.used(), std::size_t(0));
+  }
+  VERIFY(ScopedMemoryArena::currentArena() == nullptr);
+  VERIFY_IS_APPROX(heap_result, ref);
+  VERIFY(arena.capacity() > 0);
+
+  // Only the last allocation is given back before a reset.
+  {
+    ScopedMemoryArena scope(&arena);
+    const std::size_t used = arena.used();
+    { VectorX x(n); }
+    VERIFY_IS_EQUAL(arena.used(), used);
+    VectorX y(n);
+    { VectorX x(n); }
+    VERIFY(arena.used() > used);
+    y.resize(0);
+  }
+  arena.release();
+  VERIFY_IS_EQUAL(arena.capacity(), std::size_t(0));
+}
+
 EIGEN_DECLARE_TEST(nomalloc) {
   // create some dynamic objects
   Eigen::MatrixXd M1 = MatrixXd::Random(3, 3);
@@ -228,4 +336,12 @@ EIGEN_DECLARE_TEST(nomalloc) {
 
   // freeing is now possible
   Eigen::internal::set_is_malloc_allowed(true);
+
+#if EIGEN_GEMM_WORKSPACE_CACHE_ENABLED
+  CALL_SUBTEST_9(test_gemm_workspace<float>());
+  CALL_SUBTEST_10(test_gemm_workspace<std::complex<double> >());
+#endif
+
+  CALL_SUBTEST_11(test_memory_arena<float>());
+  CALL_SUBTEST_11(test_memory_arena<std::complex<double> >());
 }
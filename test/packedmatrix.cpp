@@ -0,0 +1,168 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/Cholesky>
+
+template <typename Scalar, int UpLo>
+void packed_triangular(Index size, Index cols) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef PackedTriangularMatrix<Scalar, UpLo> PackedType;
+
+  MatrixType m = MatrixType::Random(size, size);
+  // Keep the triangular matrix well conditioned.
+  m.diagonal().array() += Scalar(2 * size);
+  const MatrixType ref = m.template triangularView<UpLo>();
+
+  PackedType p(m);
+  VERIFY_IS_EQUAL(p.rows(), size);
+  VERIFY_IS_EQUAL(p.coeffs().size(), size * (size + 1) / 2);
+  VERIFY_IS_EQUAL(p.toDenseMatrix(), ref);
+  MatrixType d = p;
+  VERIFY_IS_EQUAL(d, ref);
+  for (Index k = 0; k < 5; ++k) {
+    const Index i = internal::random<Index>(0, size - 1), j = internal::random<Index>(0, size - 1);
+    VERIFY_IS_EQUAL(p.coeff(i, j), ref.coeff(i, j));
+  }
+  if (UpLo == Lower)
+    VERIFY_IS_EQUAL(p.coeffs().head(size), ref.col(0));
+  else
+    VERIFY_IS_EQUAL(p.coeffs().tail(size), ref.col(size - 1));
+
+  const MatrixType b = MatrixType::Random(size, cols);
+  const MatrixType c = MatrixType::Random(cols, size);
+  const VectorType v = VectorType::Random(size);
+  const Scalar s = internal::random<Scalar>();
+
+  VERIFY_IS_APPROX(MatrixType(p * b), ref * b);
+  VERIFY_IS_APPROX(VectorType(p * v), ref * v);
+  VERIFY_IS_APPROX(MatrixType(c * p), c * ref);
+  VERIFY_IS_APPROX(MatrixType(v.transpose() * p), v.transpose() * ref);
+  MatrixType r = b;
+  r.noalias() += s * (p * b);
+  VERIFY_IS_APPROX(r, b + s * ref * b);
+  MatrixType rc = c;
+  rc.noalias() -= s * (c * p);
+  VERIFY_IS_APPROX(rc, c - s * c * ref);
+  VERIFY_IS_APPROX(MatrixType(p * (b + b)), ref * (b + b));
+
+  VERIFY_IS_APPROX(ref * p.solve(b), b);
+  VectorType x = v;
+  p.solveInPlace(x);
+  VERIFY_IS_APPROX(ref * x, v);
+
+  p.coeffRef(size - 1, size - 1) = Scalar(1);
+  VERIFY_IS_EQUAL(p.coeff(size - 1, size - 1), Scalar(1));
+}
+
+template <typename Scalar, int UpLo>
+void packed_selfadjoint(Index size, Index cols) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef PackedSelfAdjointMatrix<Scalar, UpLo> PackedType;
+
+  const MatrixType a = MatrixType::Random(size, size);
+  MatrixType ref = a * a.adjoint();
+  ref.diagonal().array() += Scalar(1);
+  // The other part is not read.
+  MatrixType m = ref;
+  m.template triangularView<UpLo == Lower ? StrictlyUpper : StrictlyLower>() = MatrixType::Random(size, size);
+
+  PackedType p(m);
+  VERIFY_IS_APPROX(p.toDenseMatrix(), ref);
+  for (Index k = 0; k < 5; ++k) {
+    const Index i = internal::random<Index>(0, size - 1), j = internal::random<Index>(0, size - 1);
+    VERIFY_IS_APPROX(p.coeff(i, j), ref.coeff(i, j));
+  }
+
+  const MatrixType b = MatrixType::Random(size, cols);
+  const MatrixType c = MatrixType::Random(cols, size);
+  const VectorType v = VectorType::Random(size);
+  VERIFY_IS_APPROX(MatrixType(p * b), ref * b);
+  VERIFY_IS_APPROX(VectorType(p * v), ref * v);
+  VERIFY_IS_APPROX(MatrixType(c * p), c * ref);
+  VERIFY_IS_APPROX(MatrixType(v.adjoint() * p), v.adjoint() * ref);
+  VERIFY_IS_APPROX(MatrixType(b.adjoint() * (p * b)), b.adjoint() * ref * b);
+
+  // Rank updates
+  const RealScalar alpha = internal::random<RealScalar>();
+  PackedType q = p;
+  q.rankUpdate(b, alpha);
+  VERIFY_IS_APPROX(q.toDenseMatrix(), ref + alpha * b * b.adjoint());
+  q = PackedType(ref);
+  q.rankUpdate(v);
+  VERIFY_IS_APPROX(q.toDenseMatrix(), ref + v * v.adjoint());
+
+  // Cholesky decompositions
+  PackedLLT<PackedType> llt = p.llt();
+  VERIFY_IS_EQUAL(llt.info(), Success);
+  VERIFY_IS_APPROX(llt.reconstructedMatrix(), ref);
+  VERIFY_IS_APPROX(ref * llt.solve(b), b);
+  VERIFY_IS_APPROX(ref.transpose() * MatrixType(llt.transpose().solve(b)), b);
+  VERIFY_IS_APPROX(ref.adjoint() * llt.adjoint().solve(v), v);
+  typedef PackedTriangularMatrix<Scalar, UpLo> PackedFactorType;
+  const MatrixType l = ref.llt().matrixL();
+  if (UpLo == Lower)
+    VERIFY_IS_APPROX(PackedFactorType(l).coeffs(), llt.matrixLLT().coeffs());
+  else
+    VERIFY_IS_APPROX(PackedFactorType(MatrixType(l.adjoint())).coeffs(), llt.matrixLLT().coeffs());
+
+  PackedLDLT<PackedType> ldlt = p.ldlt();
+  VERIFY_IS_EQUAL(ldlt.info(), Success);
+  VERIFY_IS_APPROX(ldlt.reconstructedMatrix(), ref);
+  VERIFY_IS_APPROX(ref * ldlt.solve(b), b);
+  VERIFY_IS_APPROX(ref.transpose() * VectorType(ldlt.transpose().solve(v)), v);
+  VERIFY((ldlt.vectorD().real().array() > RealScalar(0)).all());
+
+  // LDLT of a negative definite matrix
+  PackedLDLT<PackedType> nldlt(PackedType(MatrixType(-ref)));
+  VERIFY_IS_EQUAL(nldlt.info(), Success);
+  VERIFY_IS_APPROX(ref * nldlt.solve(b), MatrixType(-b));
+
+  // In place decomposition of a moved matrix
+  PackedType moved = p;
+  PackedLLT<PackedType> inplace(std::move(moved));
+  VERIFY_IS_EQUAL(inplace.info(), Success);
+  VERIFY_IS_APPROX(ref * inplace.solve(v), v);
+
+  // Failures
+  MatrixType indefinite = ref;
+  indefinite(size / 2, size / 2) = -RealScalar(1e3) * ref.norm();
+  VERIFY_IS_EQUAL(PackedType(indefinite).llt().info(), NumericalIssue);
+  VERIFY_IS_EQUAL(PackedType(MatrixType::Zero(size, size)).ldlt().info(), NumericalIssue);
+}
+
+template <int>
+void packed_empty() {
+  PackedSelfAdjointMatrix<double> p(0);
+  VERIFY_IS_EQUAL(p.coeffs().size(), 0);
+  VERIFY_IS_EQUAL(MatrixXd(p * MatrixXd(0, 3)).cols(), 3);
+  VERIFY_IS_EQUAL(p.llt().info(), Success);
+  VERIFY_IS_EQUAL(p.llt().solve(VectorXd(0)).size(), 0);
+}
+
+EIGEN_DECLARE_TEST(packedmatrix) {
+  for (int i = 0; i < g_repeat; ++i) {
+    const Index size = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index cols = internal::random<Index>(1, 20);
+    CALL_SUBTEST_1((packed_triangular<float, Lower>(size, cols)));
+    CALL_SUBTEST_1((packed_triangular<float, Upper>(size, cols)));
+    CALL_SUBTEST_2((packed_triangular<std::complex<double>, Lower>(size, cols)));
+    CALL_SUBTEST_2((packed_triangular<std::complex<double>, Upper>(size, cols)));
+    CALL_SUBTEST_3((packed_selfadjoint<double, Lower>(size, cols)));
+    CALL_SUBTEST_3((packed_selfadjoint<double, Upper>(size, cols)));
+    CALL_SUBTEST_4((packed_selfadjoint<std::complex<float>, Lower>(size, cols)));
+    CALL_SUBTEST_4((packed_selfadjoint<std::complex<float>, Upper>(size, cols)));
+  }
+  // Several panels
+  CALL_SUBTEST_5((packed_selfadjoint<double, Lower>(internal::random<Index>(300, 400), 3)));
+  CALL_SUBTEST_5((packed_selfadjoint<std::complex<double>, Upper>(internal::random<Index>(300, 400), 3)));
+  CALL_SUBTEST_5((packed_triangular<double, Upper>(internal::random<Index>(300, 400), 3)));
+  CALL_SUBTEST_6(packed_empty<0>());
+}
@@ -1685,6 +1685,30 @@ void packetmath_scatter_gather() {
       VERIFY(test::isApproxAbs(data1[i], buffer[i * 7], refvalue) && "pgather_partial");
     }
   }
+
+  // Arbitrary offsets, with a repeated one for which the last coefficient wins.
+  Index offsets[PacketSize];
+  for (int i = 0; i < PacketSize; ++i) offsets[i] = internal::random<Index>(0, PacketSize * 20 - 1);
+  offsets[PacketSize - 1] = offsets[0];
+  for (int i = 0; i < PacketSize * 20; ++i) {
+    buffer[i] = internal::random<Scalar>() / RealScalar(PacketSize);
+  }
+  packet = internal::pgather_indexed<Scalar, Packet>(buffer, offsets);
+  internal::pstore(data1, packet);
+  for (int i = 0; i < PacketSize; ++i) {
+    VERIFY(test::isApproxAbs(data1[i], buffer[offsets[i]], refvalue) && "pgather_indexed");
+  }
+
+  EIGEN_ALIGN_MAX Scalar expected[PacketSize * 20] = {};
+  for (int i = 0; i < PacketSize * 20; ++i) buffer[i] = Scalar(0);
+  for (int i = 0; i < PacketSize; ++i) {
+    data1[i] = internal::random<Scalar>() / RealScalar(PacketSize);
+    expected[offsets[i]] = data1[i];
+  }
+  internal::pscatter_indexed<Scalar, Packet>(buffer, internal::pload<Packet>(data1), offsets);
+  for (int i = 0; i < PacketSize * 20; ++i) {
+    VERIFY(test::isApproxAbs(buffer[i], expected[i], refvalue) && "pscatter_indexed");
+  }
 }
 
 namespace Eigen {
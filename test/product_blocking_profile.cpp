@@ -0,0 +1,145 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+#include <cstdio>
+
+typedef internal::gemm_blocking_profile Profile;
+
+template <typename Scalar>
+void check_products(Index rows, Index cols, Index depth) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RowMajor> RowMatrixType;
+  const MatrixType a = MatrixType::Random(rows, depth);
+  const MatrixType b = MatrixType::Random(depth, cols);
+  const MatrixType ref = a.lazyProduct(b);
+  VERIFY_IS_APPROX(MatrixType(a * b), ref);
+  VERIFY_IS_APPROX(RowMatrixType(a * b), ref);
+  MatrixType c = ref;
+  c.noalias() -= a.adjoint().adjoint() * b;
+  VERIFY(c.cwiseAbs().maxCoeff() <= test_precision<Scalar>() * ref.cwiseAbs().maxCoeff());
+}
+
+template <typename Scalar>
+void tuned_blocking() {
+  const Index rows = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+  const Index cols = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+  const Index depth = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+  clearGemmBlockingProfile();
+  tuneGemmBlocking<Scalar>(rows, cols, depth);
+  const std::vector<Profile::entry> entries = Profile::instance().entries();
+  VERIFY_IS_EQUAL(entries.size(), std::size_t(1));
+  const Profile::entry& e = entries[0];
+  VERIFY_IS_EQUAL(e.scalar, int(internal::gemm_blocking_profile_scalar<Scalar, Scalar>::Id));
+  VERIFY_IS_EQUAL(e.k_class, Profile::shape_class(depth));
+  VERIFY_IS_EQUAL(e.m_class, Profile::shape_class(rows));
+  VERIFY_IS_EQUAL(e.n_class, Profile::shape_class(cols));
+  VERIFY(e.kc > 0 && e.kc <= depth && e.mc > 0 && e.mc <= rows && e.nc > 0 && e.nc <= cols);
+
+  Index k = depth, m = rows, n = cols;
+  internal::computeProductBlockingSizes<Scalar, Scalar>(k, m, n, Index(e.threads));
+  VERIFY_IS_EQUAL(k, e.kc);
+  VERIFY_IS_EQUAL(m, e.mc);
+  VERIFY_IS_EQUAL(n, e.nc);
+
+  check_products<Scalar>(rows, cols, depth);
+  clearGemmBlockingProfile();
+}
+
+void write_file(const std::string& filename, const char* content) {
+  std::FILE* file = std::fopen(filename.c_str(), "w");
+  VERIFY(file != 0);
+  std::fputs(content, file);
+  std::fclose(file);
+}
+
+template <typename LhsScalar, typename RhsScalar, int KcFactor>
+Vector3i blocking_sizes(Index k, Index m, Index n) {
+  internal::computeProductBlockingSizes<LhsScalar, RhsScalar, KcFactor>(k, m, n);
+  return Vector3i(int(k), int(m), int(n));
+}
+
+void profile_file() {
+  clearGemmBlockingProfile();
+  const Vector3i heuristic_double = blocking_sizes<double, double, 1>(300, 200, 400);
+  const Vector3i heuristic_large = blocking_sizes<float, float, 1>(1000, 200, 400);
+  const Vector3i heuristic_trsm = blocking_sizes<float, float, 4>(300, 200, 400);
+  // Blocks much smaller than the heuristic ones, for all the shapes of class
+  // (1, 1, 1) and a single thread.
+  const std::string filename = GetTestTempFilename("gemm_blocking_profile.txt");
+  write_file(filename, "# comment\nfloat 1 1 1 1 16 32 12\ncdouble 1 1 1 1 24 8 8\n");
+  VERIFY(loadGemmBlockingProfile(filename.c_str()));
+  VERIFY_IS_EQUAL(Profile::instance().entries().size(), std::size_t(2));
+
+  VERIFY_IS_EQUAL((blocking_sizes<float, float, 1>(300, 200, 400)), Vector3i(16, 32, 12));
+  // Other scalar types, shape classes, and the triangular kernels keep the heuristic.
+  VERIFY_IS_EQUAL((blocking_sizes<double, double, 1>(300, 200, 400)), heuristic_double);
+  VERIFY_IS_EQUAL((blocking_sizes<float, float, 1>(1000, 200, 400)), heuristic_large);
+  VERIFY_IS_EQUAL((blocking_sizes<float, float, 4>(300, 200, 400)), heuristic_trsm);
+
+  check_products<float>(200, 400, 300);
+  check_products<std::complex<double> >(137, 200, 150);
+
+  // Round trip.
+  const std::string copy = GetTestTempFilename("gemm_blocking_profile_copy.txt");
+  VERIFY(saveGemmBlockingProfile(copy.c_str()));
+  clearGemmBlockingProfile();
+  VERIFY(Profile::instance().empty());
+  VERIFY(loadGemmBlockingProfile(copy.c_str()));
+  const std::vector<Profile::entry> entries = Profile::instance().entries();
+  VERIFY_IS_EQUAL(entries.size(), std::size_t(2));
+  VERIFY_IS_EQUAL(entries[1].scalar, 3);
+  VERIFY_IS_EQUAL(entries[1].kc, 24);
+
+  // Errors leave the profile unchanged.
+  VERIFY(!loadGemmBlockingProfile(GetTestTempFilename("gemm_blocking_profile_missing.txt").c_str()));
+  write_file(filename, "float 0 0 0 1 16 16 16\nhalf 0 0 0 1 16 16 16\n");
+  VERIFY(!loadGemmBlockingProfile(filename.c_str()));
+  write_file(filename, "float 0 0 5 1 16 16 16\n");
+  VERIFY(!loadGemmBlockingProfile(filename.c_str()));
+  write_file(filename, "double 0 0 0 1 16 0 16\n");
+  VERIFY(!loadGemmBlockingProfile(filename.c_str()));
+  VERIFY_IS_EQUAL(Profile::instance().entries().size(), std::size_t(2));
+
+  std::remove(filename.c_str());
+  std::remove(copy.c_str());
+  clearGemmBlockingProfile();
+}
+
+void autotune() {
+  clearGemmBlockingProfile();
+  // Products never tune their blocking sizes themselves.
+  check_products<double>(150, 140, 130);
+  VERIFY(Profile::instance().empty());
+
+  VERIFY(gemmBlockingAutotune<double>(150, 140, 130));
+  VERIFY_IS_EQUAL(Profile::instance().entries().size(), std::size_t(1));
+  // The same class is not tuned again.
+  VERIFY(!gemmBlockingAutotune<double>(200, 300, 250));
+  VERIFY_IS_EQUAL(Profile::instance().entries().size(), std::size_t(1));
+  // Nor the classes loaded from a profile.
+  Profile::entry e = Profile::instance().entries()[0];
+  e.scalar = int(internal::gemm_blocking_profile_scalar<float, float>::Id);
+  Profile::instance().insert(e);
+  VERIFY(!gemmBlockingAutotune<float>(150, 140, 130));
+  // Large shapes are measured on a capped shape, and recorded for their own class.
+  VERIFY(gemmBlockingAutotune<float>(3000, 8, 8));
+  VERIFY_IS_EQUAL(Profile::instance().entries().size(), std::size_t(3));
+  VERIFY_IS_EQUAL(Profile::instance().entries()[2].m_class, 3);
+  check_products<double>(150, 140, 130);
+  clearGemmBlockingProfile();
+}
+
+EIGEN_DECLARE_TEST(product_blocking_profile) {
+  for (int i = 0; i < g_repeat; ++i) {
+    CALL_SUBTEST_1(tuned_blocking<float>());
+    CALL_SUBTEST_2(tuned_blocking<std::complex<double> >());
+  }
+  CALL_SUBTEST_3(profile_file());
+  CALL_SUBTEST_3(autotune());
+}
@@ -0,0 +1,146 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+// Records the blocks passed to the epilogue by adding 1 to each coefficient.
+struct count_epilogue {
+  template <typename Block>
+  void operator()(Block& block, Index row, Index col) const {
+    VERIFY(row >= 0 && col >= 0);
+    block.array() += typename Block::Scalar(1);
+  }
+};
+
+template <typename Scalar>
+struct square_op {
+  Scalar operator()(const Scalar& x) const { return x * x; }
+};
+
+template <typename Scalar, int Options>
+void epilogue_products(Index rows, Index cols, Index depth) {
+  typedef Matrix<Scalar, Dynamic, Dynamic, Options> MatrixType;
+  typedef Matrix<Scalar, Dynamic, Dynamic> ColMatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef Matrix<Scalar, 1, Dynamic> RowVectorType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  const ColMatrixType a = ColMatrixType::Random(rows, depth);
+  const MatrixType b = MatrixType::Random(depth, cols);
+  const VectorType col_bias = VectorType::Random(rows);
+  const RowVectorType row_bias = RowVectorType::Random(cols);
+  const Scalar s = internal::random<Scalar>();
+  const ColMatrixType ref = a * b;
+
+  MatrixType c(rows, cols);
+  c.noalias() = a.productWithEpilogue(b, epilogue::bias(col_bias));
+  VERIFY_IS_APPROX(c, MatrixType(ref.colwise() + col_bias));
+  c.noalias() = a.productWithEpilogue(b, epilogue::bias(row_bias));
+  VERIFY_IS_APPROX(c, MatrixType(ref.rowwise() + row_bias));
+  c.noalias() = a.productWithEpilogue(b, epilogue::scale(s));
+  VERIFY_IS_APPROX(c, MatrixType(s * ref));
+  c.noalias() = a.productWithEpilogue(b, epilogue::unary(square_op<Scalar>()));
+  VERIFY_IS_APPROX(c, MatrixType(ref.cwiseProduct(ref)));
+  c.noalias() = a.productWithEpilogue(b, epilogue::bias(col_bias).then(epilogue::scale(s)));
+  VERIFY_IS_APPROX(c, MatrixType(s * (ref.colwise() + col_bias)));
+
+  // Each coefficient is passed exactly once to the epilogue.
+  c.noalias() = a.productWithEpilogue(b, count_epilogue());
+  VERIFY_IS_APPROX(c, MatrixType(ref.array() + Scalar(1)));
+
+  // Aliasing, blocks, and expressions as operands.
+  ColMatrixType d = ColMatrixType::Random(rows, rows);
+  const ColMatrixType dref = d * d;
+  d = d.productWithEpilogue(d, epilogue::scale(Scalar(2)));
+  VERIFY_IS_APPROX(d, ColMatrixType(Scalar(2) * dref));
+
+  MatrixType e = MatrixType::Zero(rows + 3, cols + 2);
+  e.block(1, 2, rows, cols).noalias() = (Scalar(2) * a).productWithEpilogue(b, epilogue::bias(col_bias));
+  VERIFY_IS_APPROX(MatrixType(e.block(1, 2, rows, cols)), MatrixType((Scalar(2) * ref).colwise() + col_bias));
+  VERIFY_IS_EQUAL(e.row(0).norm() + e.col(0).norm(), RealScalar(0));
+
+  c.noalias() = a.adjoint().adjoint().productWithEpilogue(b.transpose().transpose(), epilogue::scale(s));
+  VERIFY_IS_APPROX(c, MatrixType(s * ref));
+
+  // As an operand of another expression.
+  VERIFY_IS_APPROX(MatrixType(a.productWithEpilogue(b, epilogue::scale(Scalar(2))) + ref),
+                   MatrixType(Scalar(3) * ref));
+}
+
+template <typename Scalar>
+void real_epilogues(Index rows, Index cols, Index depth) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  const MatrixType a = MatrixType::Random(rows, depth);
+  const MatrixType b = MatrixType::Random(depth, cols);
+  const VectorType bias = VectorType::Random(rows);
+  const MatrixType ref = a * b;
+
+  MatrixType c(rows, cols);
+  c.noalias() = a.productWithEpilogue(b, epilogue::bias(bias).then(epilogue::relu()));
+  VERIFY_IS_APPROX(c, MatrixType((ref.colwise() + bias).cwiseMax(Scalar(0))));
+
+  // Conversion of the result to another scalar type.
+  Matrix<double, Dynamic, Dynamic> converted(rows, cols);
+  c.noalias() = a.productWithEpilogue(b, epilogue::relu().then(epilogue::cast(converted)));
+  VERIFY_IS_APPROX(converted, ref.cwiseMax(Scalar(0)).template cast<double>());
+  VERIFY_IS_APPROX(c, MatrixType(ref.cwiseMax(Scalar(0))));
+}
+
+template <int>
+void fixed_size_epilogues() {
+  const Matrix4f a = Matrix4f::Random();
+  const Matrix4f b = Matrix4f::Random();
+  const Vector4f bias = Vector4f::Random();
+  Matrix4f c;
+  c.noalias() = a.productWithEpilogue(b, epilogue::bias(bias).then(epilogue::relu()));
+  VERIFY_IS_APPROX(c, Matrix4f(((a * b).colwise() + bias).cwiseMax(0.f)));
+
+  const Vector4f v = Vector4f::Random();
+  const Vector4f r = a.productWithEpilogue(v, epilogue::scale(2.f));
+  VERIFY_IS_APPROX(r, Vector4f(2.f * a * v));
+
+  // Runtime vectors and empty products take the GEMV and early paths.
+  const MatrixXf x = MatrixXf::Random(200, 150);
+  const MatrixXf y = MatrixXf::Random(150, 1);
+  MatrixXf z;
+  z.noalias() = x.productWithEpilogue(y, count_epilogue());
+  VERIFY_IS_APPROX(z, MatrixXf((x * y).array() + 1.f));
+  z.noalias() = y.transpose().productWithEpilogue(x.transpose(), count_epilogue());
+  VERIFY_IS_APPROX(z, MatrixXf((y.transpose() * x.transpose()).array() + 1.f));
+  z.noalias() = MatrixXf(200, 0).productWithEpilogue(MatrixXf(0, 100), count_epilogue());
+  VERIFY_IS_APPROX(z, MatrixXf::Ones(200, 100));
+}
+
+template <typename Scalar>
+void large_epilogues() {
+  // Many row and column blocks, and all the threads when enabled.
+  const Index rows = internal::random<Index>(300, 600);
+  const Index cols = internal::random<Index>(300, 600);
+  const Index depth = internal::random<Index>(300, 600);
+  epilogue_products<Scalar, ColMajor>(rows, cols, depth);
+  epilogue_products<Scalar, RowMajor>(rows, cols, depth);
+}
+
+EIGEN_DECLARE_TEST(product_epilogue) {
+  for (int i = 0; i < g_repeat; ++i) {
+    const Index rows = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index cols = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index depth = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    CALL_SUBTEST_1((epilogue_products<float, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_1((epilogue_products<float, RowMajor>(rows, cols, depth)));
+    CALL_SUBTEST_2((epilogue_products<double, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_3((epilogue_products<std::complex<float>, RowMajor>(rows, cols, depth)));
+    CALL_SUBTEST_4((epilogue_products<int, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_5((epilogue_products<bfloat16, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_1(real_epilogues<float>(rows, cols, depth));
+    CALL_SUBTEST_2(real_epilogues<double>(rows, cols, depth));
+  }
+  CALL_SUBTEST_6(fixed_size_epilogues<0>());
+  CALL_SUBTEST_7(large_epilogues<float>());
+  CALL_SUBTEST_7(large_epilogues<std::complex<double> >());
+}
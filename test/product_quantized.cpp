@@ -0,0 +1,107 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+template <typename MatrixType>
+MatrixType random_full_range(Index rows, Index cols) {
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType m(rows, cols);
+  for (Index j = 0; j < cols; ++j)
+    for (Index i = 0; i < rows; ++i)
+      m(i, j) = Scalar(internal::random<int>(NumTraits<Scalar>::lowest(), NumTraits<Scalar>::highest()));
+  return m;
+}
+
+template <typename LhsScalar, typename RhsScalar, int LhsOrder, int RhsOrder, int ResOrder>
+void quantized_product(Index rows, Index cols, Index depth) {
+  typedef Matrix<LhsScalar, Dynamic, Dynamic, LhsOrder> LhsType;
+  typedef Matrix<RhsScalar, Dynamic, Dynamic, RhsOrder> RhsType;
+  typedef Matrix<std::int32_t, Dynamic, Dynamic, ResOrder> ResType;
+  typedef Matrix<std::int32_t, Dynamic, Dynamic> RefType;
+
+  const LhsType lhs = random_full_range<LhsType>(rows, depth);
+  const RhsType rhs = random_full_range<RhsType>(depth, cols);
+  const RefType ref = lhs.template cast<std::int32_t>() * rhs.template cast<std::int32_t>();
+
+  // Extreme values must not saturate.
+  ResType res = lhs * rhs;
+  VERIFY_IS_EQUAL(res, ref);
+
+  // Accumulation and blocks.
+  res.noalias() += lhs * rhs;
+  res.noalias() -= lhs * rhs;
+  res.noalias() += lhs * rhs;
+  VERIFY_IS_EQUAL(res, RefType(2 * ref));
+  if (rows > 2 && cols > 2 && depth > 2) {
+    ResType sub = lhs.block(1, 1, rows - 2, depth - 2) * rhs.block(1, 2, depth - 2, cols - 2);
+    const RefType sub_ref = lhs.block(1, 1, rows - 2, depth - 2).template cast<std::int32_t>() *
+                            rhs.block(1, 2, depth - 2, cols - 2).template cast<std::int32_t>();
+    VERIFY_IS_EQUAL(sub, sub_ref);
+  }
+}
+
+template <int>
+void quantized_product_epilogues(Index rows, Index cols, Index depth) {
+  typedef Matrix<std::uint8_t, Dynamic, Dynamic> Activations;
+  typedef Matrix<std::int8_t, Dynamic, Dynamic> Weights;
+  typedef Matrix<std::int32_t, Dynamic, Dynamic> AccType;
+
+  const Activations lhs = random_full_range<Activations>(rows, depth);
+  const Weights rhs = random_full_range<Weights>(depth, cols);
+  Matrix<std::int32_t, Dynamic, 1> lhsZeroPoints(rows);
+  Matrix<std::int32_t, Dynamic, 1> rhsZeroPoints(cols);
+  for (Index i = 0; i < rows; ++i) lhsZeroPoints(i) = internal::random<int>(0, 255);
+  for (Index j = 0; j < cols; ++j) rhsZeroPoints(j) = internal::random<int>(-128, 127);
+
+  AccType ref(rows, cols);
+  for (Index j = 0; j < cols; ++j)
+    for (Index i = 0; i < rows; ++i)
+      ref(i, j) = ((lhs.row(i).template cast<std::int32_t>().array() - lhsZeroPoints(i)).matrix() *
+                   (rhs.col(j).template cast<std::int32_t>().array() - rhsZeroPoints(j)).matrix())
+                      .value();
+
+  AccType res;
+  quantizedProduct(lhs, rhs, lhsZeroPoints, rhsZeroPoints, res);
+  VERIFY_IS_EQUAL(res, ref);
+
+  // Per-tensor zero point for the weights.
+  quantizedProduct(lhs, rhs, lhsZeroPoints, Matrix<std::int32_t, Dynamic, 1>::Zero(cols), res);
+  VERIFY_IS_EQUAL(res, AccType((lhs.template cast<std::int32_t>().colwise() - lhsZeroPoints) *
+                               rhs.template cast<std::int32_t>()));
+
+  // Dequantization.
+  const VectorXf lhsScales = VectorXf::Random(rows).cwiseAbs();
+  const VectorXf rhsScales = VectorXf::Random(cols).cwiseAbs();
+  MatrixXf dequantized;
+  quantizedProduct(lhs, rhs, lhsZeroPoints, rhsZeroPoints, lhsScales, rhsScales, dequantized);
+  VERIFY_IS_APPROX(dequantized, MatrixXf(lhsScales.asDiagonal() * ref.cast<float>() * rhsScales.asDiagonal()));
+}
+
+EIGEN_DECLARE_TEST(product_quantized) {
+  for (int i = 0; i < g_repeat; ++i) {
+    const Index rows = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index cols = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index depth = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    CALL_SUBTEST_1((quantized_product<std::int8_t, std::uint8_t, ColMajor, ColMajor, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_1((quantized_product<std::int8_t, std::uint8_t, RowMajor, ColMajor, RowMajor>(rows, cols, depth)));
+    CALL_SUBTEST_2((quantized_product<std::uint8_t, std::int8_t, ColMajor, RowMajor, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_2((quantized_product<std::uint8_t, std::int8_t, RowMajor, RowMajor, RowMajor>(rows, cols, depth)));
+    CALL_SUBTEST_3(quantized_product_epilogues<0>(rows, cols, depth));
+  }
+  // Large depth and sizes not multiple of the kernel blocks.
+  CALL_SUBTEST_1((quantized_product<std::int8_t, std::uint8_t, ColMajor, ColMajor, ColMajor>(67, 45, 1031)));
+  CALL_SUBTEST_2((quantized_product<std::uint8_t, std::int8_t, RowMajor, ColMajor, ColMajor>(513, 7, 300)));
+
+  // Only products mix signed and unsigned 8-bit integers.
+  typedef internal::scalar_sum_op<std::int8_t, std::uint8_t> SumOp;
+  typedef internal::scalar_difference_op<std::uint8_t, std::int8_t> DifferenceOp;
+  STATIC_CHECK((internal::has_ReturnType<ScalarBinaryOpTraits<std::int8_t, std::uint8_t>>::value));
+  STATIC_CHECK((internal::has_ReturnType<ScalarBinaryOpTraits<std::uint8_t, std::int8_t>>::value));
+  STATIC_CHECK((!internal::has_ReturnType<ScalarBinaryOpTraits<std::int8_t, std::uint8_t, SumOp>>::value));
+  STATIC_CHECK((!internal::has_ReturnType<ScalarBinaryOpTraits<std::uint8_t, std::int8_t, DifferenceOp>>::value));
+}
@@ -0,0 +1,76 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+// Every coefficient must be the float product rounded once, up to the
+// rounding of the float sums themselves.
+template <typename Result, typename Reference>
+void verify_rounded_once(const Result& res, const Reference& ref, float absRef) {
+  typedef typename Result::Scalar Scalar;
+  const float eps = static_cast<float>(std::numeric_limits<Scalar>::epsilon());
+  const float tiny = static_cast<float>((std::numeric_limits<Scalar>::min)());
+  for (Index j = 0; j < ref.cols(); ++j)
+    for (Index i = 0; i < ref.rows(); ++i)
+      VERIFY(numext::abs(static_cast<float>(res(i, j)) - ref(i, j)) <=
+             eps / 2 * numext::abs(ref(i, j)) + tiny + 1e-5f * absRef);
+}
+
+template <typename Scalar, int LhsOrder, int RhsOrder, int ResOrder>
+void reduced_precision_product(Index rows, Index cols, Index depth) {
+  typedef Matrix<Scalar, Dynamic, Dynamic, LhsOrder> LhsType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RhsOrder> RhsType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, ResOrder> ResType;
+
+  const LhsType lhs = MatrixXf::Random(rows, depth).cast<Scalar>();
+  const RhsType rhs = MatrixXf::Random(depth, cols).cast<Scalar>();
+  const MatrixXf ref = lhs.template cast<float>() * rhs.template cast<float>();
+  const float absRef = (lhs.template cast<float>().cwiseAbs() * rhs.template cast<float>().cwiseAbs()).maxCoeff();
+
+  ResType res = lhs * rhs;
+  verify_rounded_once(res, ref, absRef);
+
+  // alpha and accumulation into the destination.
+  const ResType init = MatrixXf::Random(rows, cols).cast<Scalar>();
+  res = init;
+  res.noalias() += Scalar(0.5f) * lhs * rhs;
+  verify_rounded_once(res, MatrixXf(init.template cast<float>() + 0.5f * ref), absRef + 1.f);
+
+  if (rows > 2 && cols > 2 && depth > 2) {
+    ResType sub = lhs.block(1, 1, rows - 2, depth - 2) * rhs.block(1, 2, depth - 2, cols - 2);
+    const MatrixXf sub_ref = lhs.block(1, 1, rows - 2, depth - 2).template cast<float>() *
+                             rhs.block(1, 2, depth - 2, cols - 2).template cast<float>();
+    verify_rounded_once(sub, sub_ref, absRef);
+  }
+}
+
+template <typename Scalar>
+void reduced_precision_accumulation(Index rows, Index cols) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  // Summing ones in bfloat16 or half stalls at 256 or 2048, the float sum is
+  // exact and rounded once.
+  const Index depth = 3000;
+  MatrixType res = MatrixType::Ones(rows, depth) * MatrixType::Ones(depth, cols);
+  VERIFY_IS_EQUAL(res, MatrixType::Constant(rows, cols, Scalar(float(depth))));
+}
+
+EIGEN_DECLARE_TEST(product_reduced_precision) {
+  for (int i = 0; i < g_repeat; ++i) {
+    const Index rows = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index cols = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    const Index depth = internal::random<Index>(1, EIGEN_TEST_MAX_SIZE);
+    CALL_SUBTEST_1((reduced_precision_product<bfloat16, ColMajor, ColMajor, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_1((reduced_precision_product<bfloat16, RowMajor, ColMajor, RowMajor>(rows, cols, depth)));
+    CALL_SUBTEST_2((reduced_precision_product<half, ColMajor, RowMajor, ColMajor>(rows, cols, depth)));
+    CALL_SUBTEST_2((reduced_precision_product<half, RowMajor, RowMajor, RowMajor>(rows, cols, depth)));
+  }
+  CALL_SUBTEST_1(reduced_precision_accumulation<bfloat16>(37, 21));
+  CALL_SUBTEST_2(reduced_precision_accumulation<half>(37, 21));
+  // Large depth and sizes not multiple of the kernel blocks.
+  CALL_SUBTEST_1((reduced_precision_product<bfloat16, ColMajor, ColMajor, ColMajor>(67, 45, 1031)));
+  CALL_SUBTEST_2((reduced_precision_product<half, RowMajor, ColMajor, ColMajor>(513, 7, 300)));
+}
@@ -0,0 +1,101 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_GEMM_THREADPOOL
+#include "main.h"
+
+// Strassen-Winograd only satisfies a normwise error bound.
+template <typename Derived, typename OtherDerived>
+bool strassen_is_approx(const MatrixBase<Derived>& a, const MatrixBase<OtherDerived>& b) {
+  typedef typename Derived::RealScalar RealScalar;
+  return (a - b).norm() <= RealScalar(100) * NumTraits<RealScalar>::epsilon() * numext::maxi(a.norm(), b.norm());
+}
+
+// Reference product computed by the regular kernel.
+template <typename Lhs, typename Rhs>
+typename Product<Lhs, Rhs>::PlainObject classic_product(const Lhs& lhs, const Rhs& rhs) {
+  const Index threshold = gemmStrassenThreshold();
+  setGemmStrassenThreshold(0);
+  typename Product<Lhs, Rhs>::PlainObject res = lhs * rhs;
+  setGemmStrassenThreshold(threshold);
+  return res;
+}
+
+template <typename Scalar>
+void strassen_products(Index rows, Index cols, Index depth) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RowMajor> RowMatrixType;
+
+  const MatrixType a = MatrixType::Random(rows, depth);
+  const MatrixType b = MatrixType::Random(depth, cols);
+  const RowMatrixType at = a.adjoint();
+  const RowMatrixType br = b;
+  const Scalar s = internal::random<Scalar>();
+  const MatrixType ref = classic_product(a, b);
+
+  VERIFY(strassen_is_approx(MatrixType(a * b), ref));
+  VERIFY(strassen_is_approx(RowMatrixType(a * b), ref));
+  VERIFY(strassen_is_approx(MatrixType(at.adjoint() * br), ref));
+  VERIFY(strassen_is_approx(MatrixType((s * a) * b.conjugate()), classic_product(MatrixType(s * a), b.conjugate())));
+
+  MatrixType c = MatrixType::Random(rows, cols);
+  MatrixType c_ref = c + ref;
+  c.noalias() += a * b;
+  VERIFY(strassen_is_approx(c, c_ref));
+  // The previous values of the destination are ignored by an assignment.
+  c.noalias() = a * b;
+  VERIFY(strassen_is_approx(c, ref));
+
+  MatrixType d = MatrixType::Zero(rows + 2, cols + 3);
+  d.block(2, 1, rows, cols).noalias() -= at.adjoint() * b;
+  VERIFY(strassen_is_approx(MatrixType(-d.block(2, 1, rows, cols)), ref));
+  VERIFY_IS_EQUAL(d.row(0).norm() + d.col(0).norm(), typename MatrixType::RealScalar(0));
+
+  // Epilogues are applied once to the whole result.
+  c.noalias() = a.productWithEpilogue(b, epilogue::scale(Scalar(2)));
+  VERIFY(strassen_is_approx(c, MatrixType(Scalar(2) * ref)));
+}
+
+template <typename Scalar>
+void strassen_sizes() {
+  const Index threshold = internal::random<Index>(16, 64);
+  setGemmStrassenThreshold(threshold);
+  VERIFY_IS_EQUAL(gemmStrassenThreshold(), threshold);
+  // Zero, one and two levels of recursion, with odd dimensions.
+  strassen_products<Scalar>(internal::random<Index>(threshold, 4 * threshold),
+                            internal::random<Index>(threshold, 4 * threshold),
+                            internal::random<Index>(threshold, 4 * threshold));
+  strassen_products<Scalar>(2 * threshold + 1, 2 * threshold + 1, 2 * threshold + 1);
+  strassen_products<Scalar>(threshold - 1, 4 * threshold, 4 * threshold);
+  strassen_products<Scalar>(4 * threshold + 3, 2 * threshold, 5 * threshold + 1);
+  setGemmStrassenThreshold(0);
+}
+
+void strassen_threads() {
+  // The products at the leaves of the recursion use all the threads, including
+  // more than the 7 products of a level.
+  static ThreadPool pool(8);
+  setGemmThreadPool(&pool);
+  setGemmStrassenThreshold(48);
+  for (int t = 1; t <= 8; t *= 2) {
+    setNbThreads(t);
+    strassen_products<double>(257, 200, 301);
+    strassen_products<std::complex<float> >(150, 230, 199);
+  }
+  setGemmStrassenThreshold(0);
+}
+
+EIGEN_DECLARE_TEST(product_strassen) {
+  VERIFY_IS_EQUAL(gemmStrassenThreshold(), Index(0));
+  for (int i = 0; i < g_repeat; ++i) {
+    CALL_SUBTEST_1(strassen_sizes<float>());
+    CALL_SUBTEST_2(strassen_sizes<double>());
+    CALL_SUBTEST_3(strassen_sizes<std::complex<float> >());
+    CALL_SUBTEST_4(strassen_sizes<std::complex<double> >());
+  }
+  CALL_SUBTEST_5(strassen_threads());
+}
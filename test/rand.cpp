@@ -185,6 +185,82 @@ void check_histogram<bool>(int) {
   VERIFY(numext::abs(p - 0.5) < 0.05);
 }
 
+void check_philox_known_answers() {
+  // Known answer tests of the reference implementation of Philox4x32-10.
+  uint32_t out[4];
+  Philox(0).block(0, out);
+  VERIFY_IS_EQUAL(out[0], 0x6627e8d5u);
+  VERIFY_IS_EQUAL(out[1], 0xe169c58du);
+  VERIFY_IS_EQUAL(out[2], 0xbc57ac4cu);
+  VERIFY_IS_EQUAL(out[3], 0x9b00dbd8u);
+  Philox(~uint64_t(0), ~uint64_t(0)).block(~uint64_t(0), out);
+  VERIFY_IS_EQUAL(out[0], 0x408f276du);
+  VERIFY_IS_EQUAL(out[1], 0x41c83b0eu);
+  VERIFY_IS_EQUAL(out[2], 0xa20bc7c6u);
+  VERIFY_IS_EQUAL(out[3], 0x6d5451fdu);
+  Philox(0x299f31d0a4093822ull, 0x0370734413198a2eull).block(0x85a308d3243f6a88ull, out);
+  VERIFY_IS_EQUAL(out[0], 0xd16cfe09u);
+  VERIFY_IS_EQUAL(out[1], 0x94fdccebu);
+  VERIFY_IS_EQUAL(out[2], 0x5001e420u);
+  VERIFY_IS_EQUAL(out[3], 0x24126ea1u);
+}
+
+template <typename MatrixType>
+void check_philox(Index rows, Index cols) {
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic, MatrixType::IsRowMajor ? RowMajor : ColMajor> DynamicMatrixType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, MatrixType::IsRowMajor ? ColMajor : RowMajor> OtherMatrixType;
+  const Philox gen(internal::random<uint64_t>(), internal::random<uint64_t>());
+
+  // The expression is repeatable and setRandom gives the same matrix, whatever the number of threads.
+  MatrixType m1 = MatrixType::Random(rows, cols, gen);
+  MatrixType m2 = MatrixType::Random(rows, cols, gen);
+  VERIFY_IS_CWISE_EQUAL(m1, m2);
+  m2.setZero();
+  m2.setRandom(gen);
+  VERIFY_IS_CWISE_EQUAL(m1, m2);
+
+  // Coefficients only depend on their index in storage order.
+  OtherMatrixType m3 = OtherMatrixType::Random(cols, rows, gen);
+  VERIFY_IS_CWISE_EQUAL(m1, m3.transpose());
+  const Index r = internal::random<Index>(0, rows - 1), c = internal::random<Index>(0, cols - 1);
+  const Index br = internal::random<Index>(1, rows - r), bc = internal::random<Index>(1, cols - c);
+  DynamicMatrixType b = MatrixType::Random(rows, cols, gen).block(r, c, br, bc);
+  VERIFY_IS_CWISE_EQUAL(b, m1.block(r, c, br, bc));
+
+  // Blocks and strided maps of a matrix are filled by the expression evaluator.
+  DynamicMatrixType m4 = DynamicMatrixType::Zero(rows + 3, cols + 3);
+  m4.block(1, 2, rows, cols).setRandom(gen);
+  VERIFY_IS_CWISE_EQUAL(m4.block(1, 2, rows, cols), m1);
+  VERIFY_IS_EQUAL(m4.row(0).cwiseAbs().sum(), Scalar(0));
+  Matrix<Scalar, Dynamic, 1> buffer(2 * rows * cols);
+  Map<MatrixType, 0, Stride<Dynamic, Dynamic> > map(
+      buffer.data(), rows, cols,
+      Stride<Dynamic, Dynamic>(2 * (MatrixType::IsRowMajor ? cols : rows), 2));
+  map.setRandom(gen);
+  VERIFY_IS_CWISE_EQUAL(map, m1);
+
+  // Different streams and seeds give different matrices.
+  if (rows * cols > 16) {
+    VERIFY((MatrixType::Random(rows, cols, gen.withStream(gen.stream() + 1)).array() != m1.array()).any());
+    VERIFY((MatrixType::Random(rows, cols, Philox(gen.seed() + 1, gen.stream())).array() != m1.array()).any());
+  }
+}
+
+template <typename Scalar>
+void check_philox_distribution() {
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  const Index size = 1 << 17;
+  VectorType v(size);
+  v.setRandom(Philox(internal::random<uint64_t>()));
+  VERIFY((v.array() >= Scalar(-1)).all());
+  VERIFY((v.array() < Scalar(1)).all());
+  VERIFY(numext::abs(v.mean()) < Scalar(0.02));
+  VERIFY(numext::abs(v.cwiseAbs().mean() - Scalar(0.5)) < Scalar(0.02));
+  // a vector does not need to be evaluated to be nested
+  VERIFY_IS_APPROX(VectorType::Random(size, Philox(3)).sum(), VectorType(VectorType::Random(size, Philox(3))).sum());
+}
+
 EIGEN_DECLARE_TEST(rand) {
   int64_t int64_ref = NumTraits<int64_t>::highest() / 10;
   // the minimum guarantees that these conversions are safe
@@ -297,4 +373,23 @@ EIGEN_DECLARE_TEST(rand) {
   CALL_SUBTEST_15(check_histogram<SafeScalar<float>>(/*bins=*/1024));
   CALL_SUBTEST_15(check_histogram<SafeScalar<half>>(/*bins=*/512));
   CALL_SUBTEST_15(check_histogram<SafeScalar<bfloat16>>(/*bins=*/64));
+
+  CALL_SUBTEST_16(check_philox_known_answers());
+  for (int i = 0; i < g_repeat; i++) {
+    const Index rows = internal::random<Index>(1, 300), cols = internal::random<Index>(1, 300);
+    EIGEN_UNUSED_VARIABLE(rows);
+    EIGEN_UNUSED_VARIABLE(cols);
+    CALL_SUBTEST_16(check_philox<MatrixXf>(rows, cols));
+    CALL_SUBTEST_16((check_philox<Matrix<double, Dynamic, Dynamic, RowMajor>>(rows, cols)));
+    CALL_SUBTEST_16(check_philox<MatrixXcf>(rows, cols));
+    CALL_SUBTEST_16(check_philox<MatrixXcd>(rows, cols));
+    CALL_SUBTEST_17((check_philox<Matrix<int, Dynamic, Dynamic, RowMajor>>(rows, cols)));
+    CALL_SUBTEST_17((check_philox<Matrix<int64_t, Dynamic, Dynamic>>(rows, cols)));
+    CALL_SUBTEST_17((check_philox<Matrix<half, Dynamic, Dynamic>>(rows, cols)));
+    CALL_SUBTEST_17((check_philox<Matrix<int8_t, Dynamic, Dynamic>>(rows, cols)));
+  }
+  CALL_SUBTEST_16(check_philox<MatrixXf>(600, 500));
+  CALL_SUBTEST_17(check_philox<Matrix4d>(4, 4));
+  CALL_SUBTEST_16(check_philox_distribution<float>());
+  CALL_SUBTEST_16(check_philox_distribution<double>());
 }
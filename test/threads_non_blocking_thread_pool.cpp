@@ -164,10 +164,109 @@ static void test_pool_partitions() {
   }
 }
 
+static void test_schedule_bulk() {
+  const int kThreads = 4;
+  const int kTasks = 1000;
+  ThreadPool tp(kThreads);
+  std::vector<std::atomic<int>> hits(kTasks);
+  for (int i = 0; i < kTasks; ++i) hits[i] = 0;
+  Barrier barrier(kTasks);
+  tp.ScheduleBulk(kTasks, [&](int i) {
+    hits[i]++;
+    barrier.Notify();
+  });
+  barrier.Wait();
+  for (int i = 0; i < kTasks; ++i) {
+    VERIFY_IS_EQUAL(hits[i].load(), 1);
+  }
+  // Empty submissions are a no-op.
+  tp.ScheduleBulk(0, [](int) { VERIFY(false); });
+}
+
+// Counts how often it is consulted and otherwise forwards to an adaptive
+// policy.
+class CountingSpinPolicy : public AdaptiveSpinPolicy {
+ public:
+  CountingSpinPolicy() : AdaptiveSpinPolicy(10, 1000, 2), updates(0) {}
+  void Update(int iterations, bool found_work) override {
+    VERIFY_LE(iterations, 1000);
+    updates++;
+    AdaptiveSpinPolicy::Update(iterations, found_work);
+  }
+  std::atomic<int> updates;
+};
+
+static void test_spin_policy_and_stats() {
+  const int kThreads = 4;
+  const int kTasks = 1000;
+  CountingSpinPolicy policy;
+  {
+    ThreadPool tp(kThreads);
+    tp.SetSpinPolicy(&policy);
+    for (int iter = 0; iter < 10; ++iter) {
+      Barrier barrier(kTasks);
+      for (int i = 0; i < kTasks; ++i) {
+        tp.Schedule([&]() { barrier.Notify(); });
+      }
+      barrier.Wait();
+    }
+    // Wait until all workers are idle, so that the counters are stable.
+    std::vector<ThreadPoolWorkerStats> stats;
+    uint64_t executed = 0;
+    while (executed != static_cast<uint64_t>(10 * kTasks)) {
+      tp.GetStats(&stats);
+      executed = 0;
+      for (const ThreadPoolWorkerStats& s : stats) executed += s.tasks_executed;
+    }
+    VERIFY_IS_EQUAL(stats.size(), static_cast<size_t>(kThreads));
+    for (const ThreadPoolWorkerStats& s : stats) {
+      VERIFY_LE(s.unparks, s.parks);
+    }
+    tp.SetSpinPolicy(nullptr);
+  }
+
+  // Without spinning the policy is never consulted.
+  policy.updates = 0;
+  {
+    ThreadPool tp(kThreads, /*allow_spinning=*/false);
+    tp.SetSpinPolicy(&policy);
+    Barrier barrier(kTasks);
+    for (int i = 0; i < kTasks; ++i) {
+      tp.Schedule([&]() { barrier.Notify(); });
+    }
+    barrier.Wait();
+  }
+  VERIFY_IS_EQUAL(policy.updates.load(), 0);
+}
+
+static void test_adaptive_spin_policy() {
+  AdaptiveSpinPolicy policy(16, 256);
+  VERIFY_IS_EQUAL(policy.SpinCount(4), 16);
+  // Work found late in the window grows it up to the budget.
+  for (int i = 0; i < 10; ++i) policy.Update(policy.SpinCount(4), true);
+  VERIFY_IS_EQUAL(policy.SpinCount(4), 256);
+  // Work found early keeps the window.
+  policy.Update(1, true);
+  VERIFY_IS_EQUAL(policy.SpinCount(4), 256);
+  // Unsuccessful spinning shrinks it down to the minimum.
+  for (int i = 0; i < 10; ++i) policy.Update(policy.SpinCount(4), false);
+  VERIFY_IS_EQUAL(policy.SpinCount(4), 16);
+
+  // The smallest window still spins, and grows back when it catches work.
+  AdaptiveSpinPolicy smallest(1, 8);
+  for (int i = 0; i < 10; ++i) smallest.Update(smallest.SpinCount(4), false);
+  VERIFY_IS_EQUAL(smallest.SpinCount(4), 1);
+  smallest.Update(1, true);
+  VERIFY_IS_EQUAL(smallest.SpinCount(4), 2);
+}
+
 EIGEN_DECLARE_TEST(cxx11_non_blocking_thread_pool) {
   CALL_SUBTEST(test_create_destroy_empty_pool());
   CALL_SUBTEST(test_parallelism(true));
   CALL_SUBTEST(test_parallelism(false));
   CALL_SUBTEST(test_cancel());
   CALL_SUBTEST(test_pool_partitions());
+  CALL_SUBTEST(test_schedule_bulk());
+  CALL_SUBTEST(test_spin_policy_and_stats());
+  CALL_SUBTEST(test_adaptive_spin_policy());
 }
@@ -0,0 +1,90 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_USE_THREADS
+#include "main.h"
+#include "Eigen/ThreadPool"
+
+static void test_flat_group(int num_threads) {
+  ThreadPool tp(num_threads);
+  const int kTasks = 1000;
+  std::atomic<int> count(0);
+  TaskGroup group(&tp);
+  for (int i = 0; i < kTasks; ++i) {
+    group.Run([&]() { count++; });
+  }
+  group.Wait();
+  VERIFY_IS_EQUAL(count.load(), kTasks);
+
+  // A group can be reused once Wait() returned.
+  for (int i = 0; i < kTasks; ++i) {
+    group.Run([&]() { count++; });
+  }
+  group.Wait();
+  VERIFY_IS_EQUAL(count.load(), 2 * kTasks);
+}
+
+// Recursive sum over [begin, end) forking one half at each level. Every level
+// waits inside a worker thread, which must not deadlock even with fewer
+// threads than recursion levels.
+static int64_t recursive_sum(ThreadPool* tp, int64_t begin, int64_t end) {
+  if (end - begin <= 64) {
+    int64_t sum = 0;
+    for (int64_t i = begin; i < end; ++i) sum += i;
+    return sum;
+  }
+  const int64_t mid = begin + (end - begin) / 2;
+  int64_t left = 0;
+  TaskGroup group(tp);
+  group.Run([&]() { left = recursive_sum(tp, begin, mid); });
+  int64_t right = recursive_sum(tp, mid, end);
+  group.Wait();
+  return left + right;
+}
+
+static void test_nested_groups(int num_threads) {
+  ThreadPool tp(num_threads);
+  const int64_t n = 1 << 16;
+  VERIFY_IS_EQUAL(recursive_sum(&tp, 0, n), n * (n - 1) / 2);
+
+  // Same from inside a worker thread.
+  int64_t result = 0;
+  Notification done;
+  tp.Schedule([&]() {
+    result = recursive_sum(&tp, 0, n);
+    done.Notify();
+  });
+  done.Wait();
+  VERIFY_IS_EQUAL(result, n * (n - 1) / 2);
+}
+
+static void test_tasks_forking_into_group() {
+  ThreadPool tp(4);
+  std::atomic<int> count(0);
+  {
+    TaskGroup group(&tp);
+    for (int i = 0; i < 16; ++i) {
+      group.Run([&]() {
+        for (int j = 0; j < 16; ++j) {
+          group.Run([&]() { count++; });
+        }
+      });
+    }
+    // The destructor waits for all tasks, including the ones forked by tasks.
+  }
+  VERIFY_IS_EQUAL(count.load(), 16 * 16);
+}
+
+EIGEN_DECLARE_TEST(threads_task_group) {
+  CALL_SUBTEST(test_flat_group(0));
+  CALL_SUBTEST(test_flat_group(1));
+  CALL_SUBTEST(test_flat_group(4));
+  CALL_SUBTEST(test_nested_groups(1));
+  CALL_SUBTEST(test_nested_groups(2));
+  CALL_SUBTEST(test_nested_groups(8));
+  CALL_SUBTEST(test_tasks_forking_into_group());
+}
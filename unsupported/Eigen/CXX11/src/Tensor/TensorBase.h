@@ -688,6 +688,31 @@ class TensorBase<Derived, ReadOnlyAccessors>
       return TensorScanOp<Reducer, const Derived>(derived(), axis, exclusive, reducer);
     }
 
+    // Sorting along an axis.
+    EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+    const TensorSortOp<false, const Derived>
+    sort(const Index& axis, bool descending = false) const {
+      return TensorSortOp<false, const Derived>(derived(), axis, -1, descending);
+    }
+
+    EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+    const TensorSortOp<true, const Derived>
+    argsort(const Index& axis, bool descending = false) const {
+      return TensorSortOp<true, const Derived>(derived(), axis, -1, descending);
+    }
+
+    EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+    const TensorSortOp<false, const Derived>
+    topk(const Index& k, const Index& axis) const {
+      return TensorSortOp<false, const Derived>(derived(), axis, k, true);
+    }
+
+    EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+    const TensorSortOp<true, const Derived>
+    argtopk(const Index& k, const Index& axis) const {
+      return TensorSortOp<true, const Derived>(derived(), axis, k, true);
+    }
+
     // Reductions.
     template <typename Dims> EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
     const TensorReductionOp<internal::SumReducer<CoeffReturnType>, const Dims, const Derived>
@@ -669,7 +669,12 @@ struct TensorContractionEvaluatorBase {
   }
 #endif
 
+  // Instrumented here rather than in evalProductSequential(), so that the ThreadPoolDevice contractions are recorded.
   EIGEN_DEVICE_FUNC void evalTo(Scalar* buffer) const {
+    EIGEN_INSTRUMENT_KERNEL("tensor_contraction", 2.0 * double(this->m_i_size) * this->m_j_size * this->m_k_size,
+                            double(this->m_i_size * this->m_k_size + this->m_k_size * this->m_j_size +
+                                   2 * this->m_i_size * this->m_j_size) *
+                                sizeof(Scalar));
     static_cast<const Derived*>(this)->template evalProduct<Unaligned>(buffer);
   }
 
@@ -187,31 +187,34 @@ struct ThreadPoolDevice {
     // Compute block size and total count of blocks.
     ParallelForBlock block = CalculateParallelForBlock(n, cost, block_align);
 
-    // Recursively divide size into halves until we reach block_size.
-    // Division code rounds mid to block_size, so we are guaranteed to get
-    // block_count leaves that do actual computations.
+    // Recursively divide the range of blocks into halves until we reach a
+    // single block. Ranges are expressed in block indices so that the
+    // scheduled closures (one reference and two ints) fit in the small buffer
+    // of std::function and do not allocate.
     Barrier barrier(static_cast<unsigned int>(block.count));
-    std::function<void(Index, Index)> handleRange;
-    handleRange = [=, &handleRange, &barrier, &f](Index firstIdx, Index lastIdx) {
-      while (lastIdx - firstIdx > block.size) {
+    std::function<void(int, int)> handleRange;
+    handleRange = [=, &handleRange, &barrier, &f](int firstBlock, int lastBlock) {
+      while (lastBlock - firstBlock > 1) {
         // Split into halves and schedule the second half on a different thread.
-        const Index midIdx = firstIdx + numext::div_ceil((lastIdx - firstIdx) / 2, block.size) * block.size;
-        pool_->Schedule([=, &handleRange]() { handleRange(midIdx, lastIdx); });
-        lastIdx = midIdx;
+        const int midBlock = firstBlock + (lastBlock - firstBlock + 1) / 2;
+        pool_->Schedule([=, &handleRange]() { handleRange(midBlock, lastBlock); });
+        lastBlock = midBlock;
       }
-      // Single block or less, execute directly.
-      f(firstIdx, lastIdx);
+      // Single block, execute directly.
+      const Index firstIdx = firstBlock * block.size;
+      f(firstIdx, numext::mini(n, firstIdx + block.size));
       barrier.Notify();
     };
 
+    const int block_count = static_cast<int>(block.count);
     if (block.count <= numThreads()) {
       // Avoid a thread hop by running the root of the tree and one block on the
       // main thread.
-      handleRange(0, n);
+      handleRange(0, block_count);
     } else {
       // Execute the root in the thread pool to avoid running work on more than
       // numThreads() threads.
-      pool_->Schedule([=, &handleRange]() { handleRange(0, n); });
+      pool_->Schedule([=, &handleRange]() { handleRange(0, block_count); });
     }
 
     barrier.Wait();
@@ -243,32 +246,33 @@ struct ThreadPoolDevice {
 
     ParallelForAsyncContext* const ctx = new ParallelForAsyncContext(block.count, std::move(f), std::move(done));
 
-    // Recursively divide size into halves until we reach block_size.
-    // Division code rounds mid to block_size, so we are guaranteed to get
-    // block_count leaves that do actual computations.
-    ctx->handle_range = [this, ctx, block](Index firstIdx, Index lastIdx) {
-      while (lastIdx - firstIdx > block.size) {
+    // Recursively divide the range of blocks into halves until we reach a
+    // single block (see parallelFor).
+    ctx->handle_range = [this, ctx, block, n](int firstBlock, int lastBlock) {
+      while (lastBlock - firstBlock > 1) {
         // Split into halves and schedule the second half on a different thread.
-        const Index midIdx = firstIdx + numext::div_ceil((lastIdx - firstIdx) / 2, block.size) * block.size;
-        pool_->Schedule([ctx, midIdx, lastIdx]() { ctx->handle_range(midIdx, lastIdx); });
-        lastIdx = midIdx;
+        const int midBlock = firstBlock + (lastBlock - firstBlock + 1) / 2;
+        pool_->Schedule([ctx, midBlock, lastBlock]() { ctx->handle_range(midBlock, lastBlock); });
+        lastBlock = midBlock;
       }
 
-      // Single block or less, execute directly.
-      ctx->f(firstIdx, lastIdx);
+      // Single block, execute directly.
+      const Index firstIdx = firstBlock * block.size;
+      ctx->f(firstIdx, numext::mini(n, firstIdx + block.size));
 
       // Delete async context if it was the last block.
       if (ctx->count.fetch_sub(1) == 1) delete ctx;
     };
 
+    const int block_count = static_cast<int>(block.count);
     if (block.count <= numThreads()) {
       // Avoid a thread hop by running the root of the tree and one block on the
       // main thread.
-      ctx->handle_range(0, n);
+      ctx->handle_range(0, block_count);
     } else {
       // Execute the root in the thread pool to avoid running work on more than
       // numThreads() threads.
-      pool_->Schedule([ctx, n]() { ctx->handle_range(0, n); });
+      pool_->Schedule([ctx, block_count]() { ctx->handle_range(0, block_count); });
     }
   }
 
@@ -299,7 +303,7 @@ struct ThreadPoolDevice {
     std::function<void(Index, Index)> f;
     std::function<void()> done;
 
-    std::function<void(Index, Index)> handle_range;
+    std::function<void(int, int)> handle_range;
   };
 
   struct ParallelForBlock {
@@ -327,6 +331,9 @@ struct ThreadPoolDevice {
     }
 
     Index block_count = numext::div_ceil(n, block_size);
+    // Blocks are addressed with int indices in parallelFor. There are at most
+    // a few blocks per thread unless block_align rounds up very aggressively.
+    eigen_assert(block_count <= NumTraits<int>::highest());
 
     // Calculate parallel efficiency as fraction of total CPU time used for
     // computations:
@@ -68,6 +68,15 @@ struct ExpressionHasTensorBroadcastingOp<const TensorBroadcastingOp<Broadcast, X
   enum { value = true };
 };
 
+// Bytes moved by an executor, i.e., the stores of the destination and the loads
+// of the leaf inputs, as estimated by the cost model of the evaluator. The
+// flops of an expression are not modeled, and are reported as 0.
+template <typename Evaluator>
+double tensor_executor_bytes(const Evaluator& evaluator) {
+  const TensorOpCost cost = evaluator.costPerCoeff(false);
+  return double(array_prod(evaluator.dimensions())) * (cost.bytes_loaded() + cost.bytes_stored());
+}
+
 // -------------------------------------------------------------------------- //
 
 /**
@@ -91,6 +100,7 @@ class TensorExecutor {
 
   static EIGEN_STRONG_INLINE void run(const Expression& expr, const Device& device = DefaultDevice()) {
     TensorEvaluator<Expression, Device> evaluator(expr, device);
+    EIGEN_INSTRUMENT_KERNEL("tensor_executor", 0, tensor_executor_bytes(evaluator));
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
       const StorageIndex size = array_prod(evaluator.dimensions());
@@ -120,6 +130,7 @@ class TensorExecutor<Expression, DefaultDevice, /*Vectorizable=*/true,
 
   static EIGEN_STRONG_INLINE void run(const Expression& expr, const DefaultDevice& device = DefaultDevice()) {
     TensorEvaluator<Expression, DefaultDevice> evaluator(expr, device);
+    EIGEN_INSTRUMENT_KERNEL("tensor_executor", 0, tensor_executor_bytes(evaluator));
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
       const StorageIndex size = array_prod(evaluator.dimensions());
@@ -171,6 +182,7 @@ class TensorExecutor<Expression, DefaultDevice, Vectorizable,
     typedef internal::TensorBlockScratchAllocator<DefaultDevice> TensorBlockScratch;
 
     Evaluator evaluator(expr, device);
+    EIGEN_INSTRUMENT_KERNEL("tensor_executor", 0, tensor_executor_bytes(evaluator));
 
     // TODO(ezhulenev): Do not use tiling for small tensors?
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
@@ -302,6 +314,7 @@ class TensorExecutor<Expression, ThreadPoolDevice, Vectorizable, Tiling> {
     typedef EvalRange<Evaluator, StorageIndex, Vectorizable> EvalRange;
 
     Evaluator evaluator(expr, device);
+    EIGEN_INSTRUMENT_KERNEL("tensor_executor", 0, tensor_executor_bytes(evaluator));
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(nullptr);
     if (needs_assign) {
       const StorageIndex size = array_prod(evaluator.dimensions());
@@ -332,6 +345,7 @@ class TensorExecutor<Expression, ThreadPoolDevice, Vectorizable,
 
   static EIGEN_STRONG_INLINE void run(const Expression& expr, const ThreadPoolDevice& device) {
     Evaluator evaluator(expr, device);
+    EIGEN_INSTRUMENT_KERNEL("tensor_executor", 0, tensor_executor_bytes(evaluator));
 
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(nullptr);
     if (needs_assign) {
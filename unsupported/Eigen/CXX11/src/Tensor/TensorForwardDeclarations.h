@@ -127,6 +127,8 @@ template <typename LeftXprType, typename RightXprType>
 class TensorAssignOp;
 template <typename Op, typename XprType>
 class TensorScanOp;
+template <bool ReturnIndices, typename XprType>
+class TensorSortOp;
 template <typename Dims, typename XprType>
 class TensorTraceOp;
 
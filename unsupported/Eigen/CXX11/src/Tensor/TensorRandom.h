@@ -197,6 +197,65 @@ struct functor_traits<UniformRandomGenerator<Scalar> > {
   };
 };
 
+// Maps the output of Eigen::Philox, in [-1,1) for floating point types, to the range of UniformRandomGenerator.
+template <typename T, bool IsComplex = NumTraits<T>::IsComplex, bool IsInteger = NumTraits<T>::IsInteger>
+struct philox_to_uniform {
+  static EIGEN_STRONG_INLINE T run(const T& x) { return T(0.5) * (x + T(1)); }
+};
+template <typename T>
+struct philox_to_uniform<T, false, true> {
+  static EIGEN_STRONG_INLINE T run(const T& x) { return x; }
+};
+template <typename T>
+struct philox_to_uniform<T, true, false> {
+  typedef typename NumTraits<T>::Real RealScalar;
+  static EIGEN_STRONG_INLINE T run(const T& x) {
+    return T(philox_to_uniform<RealScalar>::run(numext::real(x)), philox_to_uniform<RealScalar>::run(numext::imag(x)));
+  }
+};
+
+// A counter-based alternative to UniformRandomGenerator: coefficient i only depends on the generator and on i,
+// so that the tensor is the same whatever the device, the number of threads and the evaluation order.
+// Only available on the host.
+template <typename T>
+class PhiloxUniformRandomGenerator {
+ public:
+  static constexpr bool PacketAccess = true;
+
+  explicit PhiloxUniformRandomGenerator(uint64_t seed = 0, uint64_t stream = 0) : m_op(Philox(seed, stream), 1) {}
+  explicit PhiloxUniformRandomGenerator(const Philox& generator) : m_op(generator, 1) {}
+
+  template <typename Index>
+  EIGEN_STRONG_INLINE T operator()(Index i) const {
+    return philox_to_uniform<T>::run(m_op(static_cast<Eigen::Index>(i), 0));
+  }
+
+  template <typename Packet, typename Index>
+  EIGEN_STRONG_INLINE Packet packetOp(Index i) const {
+    enum {
+      packetSize = internal::unpacket_traits<Packet>::size,
+      PerBlock = scalar_philox_random_op<T, false>::PerBlock,
+      MaxBlocks = (packetSize + 2 * PerBlock - 2) / PerBlock,
+      Batch = MaxBlocks < philox4x32::kBatch ? int(MaxBlocks) : int(philox4x32::kBatch)
+    };
+    EIGEN_ALIGN_MAX T values[packetSize];
+    m_op.template fill<Batch>(values, static_cast<uint64_t>(i), packetSize);
+    for (int j = 0; j < packetSize; ++j) values[j] = philox_to_uniform<T>::run(values[j]);
+    return internal::pload<Packet>(values);
+  }
+
+ private:
+  scalar_philox_random_op<T, false> m_op;
+};
+
+template <typename Scalar>
+struct functor_traits<PhiloxUniformRandomGenerator<Scalar> > {
+  enum {
+    Cost = int(functor_traits<scalar_philox_random_op<Scalar, false> >::Cost) + int(NumTraits<Scalar>::MulCost),
+    PacketAccess = PhiloxUniformRandomGenerator<Scalar>::PacketAccess
+  };
+};
+
 template <typename T>
 EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE T RandomToTypeNormal(uint64_t* state, uint64_t stream) {
   // Use the ratio of uniform method to generate numbers following a normal
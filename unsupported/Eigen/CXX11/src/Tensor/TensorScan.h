@@ -258,6 +258,68 @@ struct ReduceBlock<Self, /*Vectorize=*/false, /*Parallel=*/true> {
   }
 };
 
+// Block-parallel scan of the single line of the scan axis starting at
+// `offset`, for scans with few but long lines. It uses a reduce-then-scan
+// scheme: the line is split into blocks whose totals are reduced in parallel,
+// the totals are combined serially into per-block prefixes, and each block is
+// then scanned in parallel starting from its prefix. This requires the
+// accumulator of the reducer to be a plain scalar that can be fed back into
+// reduce(), which holds for all stateless reducers.
+template <typename Self>
+EIGEN_STRONG_INLINE void ReduceLineParallel(Self& self, Index offset, typename Self::CoeffReturnType* data) {
+  using Scalar = typename Self::CoeffReturnType;
+  const Index size = self.size();
+  const Index stride = self.stride();
+  const Index num_threads = self.device().numThreads();
+  // Have a few blocks per thread for load balancing, but keep them large
+  // enough to amortize the second pass over the input.
+  EIGEN_CONSTEXPR Index kMinBlockSize = 4096;
+  const Index block_size = AdjustBlockSize(
+      sizeof(Scalar), numext::maxi<Index>(kMinBlockSize, numext::div_ceil<Index>(size, 4 * num_threads)));
+  const Index num_blocks = numext::div_ceil(size, block_size);
+  const TensorOpCost block_cost =
+      static_cast<double>(block_size) * (self.inner().costPerCoeff(false) + TensorOpCost(0, sizeof(Scalar), 1));
+
+  // Totals of all blocks but the last one.
+  std::vector<Scalar> prefixes(num_blocks);
+  self.device().parallelFor(num_blocks - 1, block_cost, [&](Index first, Index last) {
+    for (Index block = first; block < last; ++block) {
+      Scalar accum = self.accumulator().initialize();
+      const Index begin = offset + block * block_size * stride;
+      for (Index i = 0; i < block_size; ++i) {
+        self.accumulator().reduce(self.inner().coeff(begin + i * stride), &accum);
+      }
+      prefixes[block] = accum;
+    }
+  });
+
+  // Exclusive scan of the block totals.
+  Scalar accum = self.accumulator().initialize();
+  for (Index block = 0; block < num_blocks; ++block) {
+    const Scalar total = prefixes[block];
+    prefixes[block] = accum;
+    if (block + 1 < num_blocks) self.accumulator().reduce(total, &accum);
+  }
+
+  self.device().parallelFor(num_blocks, block_cost, [&](Index first, Index last) {
+    for (Index block = first; block < last; ++block) {
+      Scalar block_accum = prefixes[block];
+      const Index begin = block * block_size;
+      const Index end = numext::mini(size, begin + block_size);
+      for (Index i = begin; i < end; ++i) {
+        const Index curr = offset + i * stride;
+        if (self.exclusive()) {
+          data[curr] = self.accumulator().finalize(block_accum);
+          self.accumulator().reduce(self.inner().coeff(curr), &block_accum);
+        } else {
+          self.accumulator().reduce(self.inner().coeff(curr), &block_accum);
+          data[curr] = self.accumulator().finalize(block_accum);
+        }
+      }
+    }
+  });
+}
+
 // Specialization for multi-threaded execution.
 template <typename Self, typename Reducer, bool Vectorize>
 struct ScanLauncher<Self, Reducer, ThreadPoolDevice, Vectorize> {
@@ -267,6 +329,21 @@ struct ScanLauncher<Self, Reducer, ThreadPoolDevice, Vectorize> {
     const int PacketSize = internal::unpacket_traits<Packet>::size;
     const Index total_size = internal::array_prod(self.dimensions());
     const Index inner_block_size = self.stride() * self.size();
+    if (total_size == 0) return;
+
+    // There are fewer independent lines than threads: split the lines
+    // themselves into blocks.
+    EIGEN_CONSTEXPR Index kMinParallelLineSize = 32768;
+    const Index num_lines = total_size / self.size();
+    if (!internal::reducer_traits<Reducer, ThreadPoolDevice>::IsStateful && self.device().numThreads() > 1 &&
+        num_lines < self.device().numThreads() && self.size() >= kMinParallelLineSize) {
+      for (Index line = 0; line < num_lines; ++line) {
+        const Index offset = (line / self.stride()) * inner_block_size + line % self.stride();
+        ReduceLineParallel(self, offset, data);
+      }
+      return;
+    }
+
     bool parallelize_by_outer_blocks = (total_size >= (self.stride() * inner_block_size));
 
     if ((parallelize_by_outer_blocks && total_size <= 4096) ||
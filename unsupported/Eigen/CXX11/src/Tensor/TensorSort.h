@@ -0,0 +1,405 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CXX11_TENSOR_TENSOR_SORT_H
+#define EIGEN_CXX11_TENSOR_TENSOR_SORT_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+template <bool ReturnIndices, typename XprType>
+struct traits<TensorSortOp<ReturnIndices, XprType> > : public traits<XprType> {
+  typedef traits<XprType> XprTraits;
+  typedef typename XprTraits::Index Index;
+  typedef std::conditional_t<ReturnIndices, Index, typename XprType::Scalar> Scalar;
+  typedef typename XprTraits::StorageKind StorageKind;
+  typedef typename XprType::Nested Nested;
+  typedef std::remove_reference_t<Nested> Nested_;
+  static constexpr int NumDimensions = XprTraits::NumDimensions;
+  static constexpr int Layout = XprTraits::Layout;
+  typedef std::conditional_t<ReturnIndices, Index*, typename XprTraits::PointerType> PointerType;
+};
+
+template <bool ReturnIndices, typename XprType>
+struct eval<TensorSortOp<ReturnIndices, XprType>, Eigen::Dense> {
+  typedef const TensorSortOp<ReturnIndices, XprType>& type;
+};
+
+template <bool ReturnIndices, typename XprType>
+struct nested<TensorSortOp<ReturnIndices, XprType>, 1, typename eval<TensorSortOp<ReturnIndices, XprType> >::type> {
+  typedef TensorSortOp<ReturnIndices, XprType> type;
+};
+
+}  // end namespace internal
+
+/** \class TensorSort
+ * \ingroup CXX11_Tensor_Module
+ *
+ * \brief Tensor sort and top-k class.
+ *
+ * Sorts every line of the input along \c axis and keeps the first \c k
+ * entries of each line, either their values or their positions along the axis
+ * (when \c ReturnIndices is true). Ties are broken by position, so the result
+ * is deterministic. NaNs compare greater than any other value.
+ */
+template <bool ReturnIndices, typename XprType>
+class TensorSortOp : public TensorBase<TensorSortOp<ReturnIndices, XprType>, ReadOnlyAccessors> {
+ public:
+  typedef typename Eigen::internal::traits<TensorSortOp>::Scalar Scalar;
+  typedef typename Eigen::NumTraits<Scalar>::Real RealScalar;
+  typedef Scalar CoeffReturnType;
+  typedef typename Eigen::internal::nested<TensorSortOp>::type Nested;
+  typedef typename Eigen::internal::traits<TensorSortOp>::StorageKind StorageKind;
+  typedef typename Eigen::internal::traits<TensorSortOp>::Index Index;
+
+  // A negative k keeps all the entries of each line.
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE TensorSortOp(const XprType& expr, const Index& axis, const Index& k,
+                                                     bool descending)
+      : m_expr(expr), m_axis(axis), m_k(k), m_descending(descending) {}
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Index axis() const { return m_axis; }
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Index k() const { return m_k; }
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE bool descending() const { return m_descending; }
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const XprType& expression() const { return m_expr; }
+
+ protected:
+  typename XprType::Nested m_expr;
+  const Index m_axis;
+  const Index m_k;
+  const bool m_descending;
+};
+
+namespace internal {
+
+template <typename Scalar>
+struct SortEntry {
+  Scalar value;
+  Index index;
+};
+
+// Strict weak ordering on sort entries, sorting NaNs last in ascending order
+// and first in descending order, and breaking ties by position.
+template <typename Scalar>
+struct SortEntryCompare {
+  explicit SortEntryCompare(bool descending) : m_descending(descending) {}
+
+  static bool less(const Scalar& a, const Scalar& b) {
+    return !(numext::isnan)(a) && ((numext::isnan)(b) || a < b);
+  }
+
+  bool operator()(const SortEntry<Scalar>& a, const SortEntry<Scalar>& b) const {
+    if (m_descending ? less(b.value, a.value) : less(a.value, b.value)) return true;
+    if (m_descending ? less(a.value, b.value) : less(b.value, a.value)) return false;
+    return a.index < b.index;
+  }
+
+  bool m_descending;
+};
+
+template <bool ReturnIndices>
+struct SortOutput {
+  template <typename Scalar>
+  static EIGEN_STRONG_INLINE Index get(const SortEntry<Scalar>& entry) {
+    return entry.index;
+  }
+};
+
+template <>
+struct SortOutput<false> {
+  template <typename Scalar>
+  static EIGEN_STRONG_INLINE Scalar get(const SortEntry<Scalar>& entry) {
+    return entry.value;
+  }
+};
+
+// Copies the entries of the given line of the input into entries[0, size).
+template <typename Self>
+EIGEN_STRONG_INLINE void GatherSortLine(const Self& self, Index line, Index begin, Index end,
+                                        SortEntry<typename Self::InputScalar>* entries) {
+  const Index offset = self.inputOffset(line);
+  for (Index i = begin; i < end; ++i) {
+    entries[i].value = self.inner().coeff(offset + i * self.stride());
+    entries[i].index = i;
+  }
+}
+
+// Writes the first k() sorted entries to the given line of the output.
+template <typename Self>
+EIGEN_STRONG_INLINE void ScatterSortLine(const Self& self, Index line, const SortEntry<typename Self::InputScalar>* entries,
+                                         typename Self::CoeffReturnType* data) {
+  const Index offset = self.outputOffset(line);
+  for (Index i = 0; i < self.k(); ++i) {
+    data[offset + i * self.stride()] = SortOutput<Self::ReturnIndices>::get(entries[i]);
+  }
+}
+
+// Sorts a single line with std::sort, or std::partial_sort for top-k.
+template <typename Self>
+EIGEN_STRONG_INLINE void SortLine(const Self& self, Index line, SortEntry<typename Self::InputScalar>* entries,
+                                  typename Self::CoeffReturnType* data) {
+  typedef typename Self::InputScalar Scalar;
+  GatherSortLine(self, line, 0, self.size(), entries);
+  const SortEntryCompare<Scalar> compare(self.descending());
+  if (self.k() < self.size()) {
+    std::partial_sort(entries, entries + self.k(), entries + self.size(), compare);
+  } else {
+    std::sort(entries, entries + self.size(), compare);
+  }
+  ScatterSortLine(self, line, entries, data);
+}
+
+// Single-threaded CPU implementation of sort.
+template <typename Self, typename Device>
+struct SortLauncher {
+  void operator()(const Self& self, typename Self::CoeffReturnType* data) const {
+    std::vector<SortEntry<typename Self::InputScalar> > entries(self.size());
+    for (Index line = 0; line < self.numLines(); ++line) {
+      SortLine(self, line, entries.data(), data);
+    }
+  }
+};
+
+#ifdef EIGEN_USE_THREADS
+
+// Sorts a single long line by sorting blocks of it in parallel and merging
+// them pairwise, each round of merges running in parallel. For top-k with a
+// small k, only the k first entries of each block are sorted, and the
+// candidates of all blocks are then reduced to the final k.
+template <typename Self>
+void SortLongLine(const Self& self, Index line, typename Self::CoeffReturnType* data) {
+  typedef typename Self::InputScalar Scalar;
+  typedef SortEntry<Scalar> Entry;
+  const Index size = self.size();
+  const Index k = self.k();
+  const SortEntryCompare<Scalar> compare(self.descending());
+
+  EIGEN_CONSTEXPR Index kMinBlockSize = 4096;
+  const Index block_size = numext::maxi<Index>(kMinBlockSize, numext::div_ceil<Index>(size, self.device().numThreads()));
+  const Index num_blocks = numext::div_ceil(size, block_size);
+  const double log_block_size = std::log2(static_cast<double>(block_size));
+  const TensorOpCost block_cost = static_cast<double>(block_size) *
+                                  (self.inner().costPerCoeff(false) + TensorOpCost(0, sizeof(Entry), log_block_size));
+
+  std::vector<Entry> entries(size);
+  // Only the top-k candidates of each block are needed if there are fewer
+  // of them than entries.
+  const bool select = k * num_blocks < size;
+  self.device().parallelFor(num_blocks, block_cost, [&](Index first, Index last) {
+    for (Index block = first; block < last; ++block) {
+      const Index begin = block * block_size;
+      const Index end = numext::mini(size, begin + block_size);
+      GatherSortLine(self, line, begin, end, entries.data());
+      if (select && k < end - begin) {
+        std::partial_sort(entries.data() + begin, entries.data() + begin + k, entries.data() + end, compare);
+      } else {
+        std::sort(entries.data() + begin, entries.data() + end, compare);
+      }
+    }
+  });
+
+  if (select) {
+    std::vector<Entry> candidates;
+    candidates.reserve(k * num_blocks);
+    for (Index block = 0; block < num_blocks; ++block) {
+      const Index begin = block * block_size;
+      const Index end = numext::mini(size, begin + k);
+      candidates.insert(candidates.end(), entries.begin() + begin, entries.begin() + end);
+    }
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), compare);
+    ScatterSortLine(self, line, candidates.data(), data);
+    return;
+  }
+
+  std::vector<Entry> buffer(size);
+  Entry* src = entries.data();
+  Entry* dst = buffer.data();
+  for (Index width = block_size; width < size; width *= 2) {
+    const Index num_merges = numext::div_ceil(size, 2 * width);
+    const TensorOpCost merge_cost(2 * width * sizeof(Entry), 2 * width * sizeof(Entry), 2 * width);
+    self.device().parallelFor(num_merges, merge_cost, [&](Index first, Index last) {
+      for (Index merge = first; merge < last; ++merge) {
+        const Index begin = merge * 2 * width;
+        const Index mid = numext::mini(size, begin + width);
+        const Index end = numext::mini(size, begin + 2 * width);
+        std::merge(src + begin, src + mid, src + mid, src + end, dst + begin, compare);
+      }
+    });
+    std::swap(src, dst);
+  }
+  ScatterSortLine(self, line, src, data);
+}
+
+// Multi-threaded implementation of sort: lines are sorted in parallel, and
+// each line is split into blocks when there are fewer lines than threads.
+template <typename Self>
+struct SortLauncher<Self, ThreadPoolDevice> {
+  void operator()(const Self& self, typename Self::CoeffReturnType* data) const {
+    typedef SortEntry<typename Self::InputScalar> Entry;
+    EIGEN_CONSTEXPR Index kMinParallelLineSize = 32768;
+    if (self.numLines() < self.device().numThreads() && self.size() >= kMinParallelLineSize) {
+      for (Index line = 0; line < self.numLines(); ++line) {
+        SortLongLine(self, line, data);
+      }
+      return;
+    }
+
+    const double log_size = std::log2(static_cast<double>(numext::maxi<Index>(2, self.size())));
+    const TensorOpCost line_cost = static_cast<double>(self.size()) *
+                                   (self.inner().costPerCoeff(false) + TensorOpCost(0, sizeof(Entry), log_size));
+    self.device().parallelFor(self.numLines(), line_cost, [&](Index first, Index last) {
+      std::vector<Entry> entries(self.size());
+      for (Index line = first; line < last; ++line) {
+        SortLine(self, line, entries.data(), data);
+      }
+    });
+  }
+};
+
+#endif  // EIGEN_USE_THREADS
+
+}  // namespace internal
+
+// Eval as rvalue
+template <bool ReturnIndices_, typename ArgType, typename Device>
+struct TensorEvaluator<const TensorSortOp<ReturnIndices_, ArgType>, Device> {
+  typedef TensorSortOp<ReturnIndices_, ArgType> XprType;
+  typedef typename XprType::Index Index;
+  static constexpr int NumDims = internal::array_size<typename TensorEvaluator<ArgType, Device>::Dimensions>::value;
+  static constexpr bool ReturnIndices = ReturnIndices_;
+  typedef DSizes<Index, NumDims> Dimensions;
+  typedef std::remove_const_t<typename XprType::Scalar> Scalar;
+  typedef std::remove_const_t<typename ArgType::Scalar> InputScalar;
+  typedef typename XprType::CoeffReturnType CoeffReturnType;
+  typedef typename PacketType<CoeffReturnType, Device>::type PacketReturnType;
+  typedef TensorEvaluator<const TensorSortOp<ReturnIndices_, ArgType>, Device> Self;
+  typedef StorageMemory<Scalar, Device> Storage;
+  typedef typename Storage::Type EvaluatorPointerType;
+
+  static constexpr int Layout = TensorEvaluator<ArgType, Device>::Layout;
+  enum {
+    IsAligned = false,
+    PacketAccess = (PacketType<CoeffReturnType, Device>::size > 1),
+    BlockAccess = false,
+    PreferBlockAccess = false,
+    CoordAccess = false,
+    RawAccess = true
+  };
+
+  //===- Tensor block evaluation strategy (see TensorBlock.h) -------------===//
+  typedef internal::TensorBlockNotImplemented TensorBlock;
+  //===--------------------------------------------------------------------===//
+
+  EIGEN_STRONG_INLINE TensorEvaluator(const XprType& op, const Device& device)
+      : m_impl(op.expression(), device),
+        m_device(device),
+        m_descending(op.descending()),
+        m_size(m_impl.dimensions()[op.axis()]),
+        m_k(op.k() < 0 ? m_size : op.k()),
+        m_stride(1),
+        m_output(NULL) {
+    // Sorting a scalar isn't supported.
+    EIGEN_STATIC_ASSERT((NumDims > 0), YOU_MADE_A_PROGRAMMING_MISTAKE);
+    eigen_assert(op.axis() >= 0 && op.axis() < NumDims);
+    eigen_assert(m_k <= m_size && "k must not exceed the size of the sorted axis");
+
+    m_dimensions = m_impl.dimensions();
+    m_dimensions[op.axis()] = m_k;
+    // Compute stride of sort axis
+    if (static_cast<int>(Layout) == static_cast<int>(ColMajor)) {
+      for (int i = 0; i < op.axis(); ++i) {
+        m_stride = m_stride * m_dimensions[i];
+      }
+    } else {
+      // Use an unsigned loop index to prevent spurious "may be used
+      // uninitialized" warnings, see TensorScan.h.
+      unsigned int axis = internal::convert_index<unsigned int>(op.axis());
+      for (unsigned int i = NumDims - 1; i > axis; --i) {
+        m_stride = m_stride * m_dimensions[i];
+      }
+    }
+    m_num_lines = m_size == 0 ? 0 : internal::array_prod(m_impl.dimensions()) / m_size;
+  }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Dimensions& dimensions() const { return m_dimensions; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Index& stride() const { return m_stride; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Index& size() const { return m_size; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Index& k() const { return m_k; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Index& numLines() const { return m_num_lines; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE bool descending() const { return m_descending; }
+
+  // Offsets of the first coefficient of a line in the input and the output.
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE Index inputOffset(Index line) const {
+    return (line / m_stride) * m_stride * m_size + line % m_stride;
+  }
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE Index outputOffset(Index line) const {
+    return (line / m_stride) * m_stride * m_k + line % m_stride;
+  }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const TensorEvaluator<ArgType, Device>& inner() const { return m_impl; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE const Device& device() const { return m_device; }
+
+  EIGEN_STRONG_INLINE bool evalSubExprsIfNeeded(EvaluatorPointerType data) {
+    m_impl.evalSubExprsIfNeeded(NULL);
+    internal::SortLauncher<Self, Device> launcher;
+    if (data) {
+      if (m_k > 0) launcher(*this, data);
+      return false;
+    }
+
+    const Index total_size = internal::array_prod(dimensions());
+    m_output =
+        static_cast<EvaluatorPointerType>(m_device.get((Scalar*)m_device.allocate_temp(total_size * sizeof(Scalar))));
+    if (m_k > 0) launcher(*this, m_output);
+    return true;
+  }
+
+  template <int LoadMode>
+  EIGEN_DEVICE_FUNC PacketReturnType packet(Index index) const {
+    return internal::ploadt<PacketReturnType, LoadMode>(m_output + index);
+  }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE EvaluatorPointerType data() const { return m_output; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE CoeffReturnType coeff(Index index) const { return m_output[index]; }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE TensorOpCost costPerCoeff(bool) const {
+    return TensorOpCost(sizeof(CoeffReturnType), 0, 0);
+  }
+
+  EIGEN_STRONG_INLINE void cleanup() {
+    if (m_output) {
+      m_device.deallocate_temp(m_output);
+      m_output = NULL;
+    }
+    m_impl.cleanup();
+  }
+
+ protected:
+  TensorEvaluator<ArgType, Device> m_impl;
+  const Device EIGEN_DEVICE_REF m_device;
+  const bool m_descending;
+  const Index m_size;
+  const Index m_k;
+  Index m_stride;
+  Index m_num_lines;
+  Dimensions m_dimensions;
+  EvaluatorPointerType m_output;
+};
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_CXX11_TENSOR_TENSOR_SORT_H
@@ -239,6 +239,12 @@ struct TensorEvaluator<const TensorTraceOp<Dims, ArgType>, Device> {
     return result;
   }
 
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE TensorOpCost costPerCoeff(bool) const {
+    // The packets are assembled from the coefficients, so the trace is never vectorized.
+    const double compute_cost = m_traceDim * internal::functor_traits<internal::scalar_sum_op<CoeffReturnType> >::Cost;
+    return m_impl.costPerCoeff(false) * m_traceDim + TensorOpCost(0, 0, compute_cost);
+  }
+
  protected:
   // Given the output index, finds the first index in the input tensor used to compute the trace
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE Index firstInput(Index index) const {
@@ -0,0 +1,127 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_KERNELS_H
+#define EIGEN_BATCHED_KERNELS_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+namespace internal {
+
+// Kernels working on one group of interleaved matrices (see CompactBatch).
+// Each coefficient is a packet holding the same coefficient of all the
+// matrices of the group, so the scalar algorithms are simply run on packets.
+// Coefficient (i,j) of a m-row group starts at offset (j * m + i) * PacketSize.
+
+// C = alpha * A * B + beta * C, with A m x k, B k x n and C m x n.
+// C must not alias A or B.
+template <typename Packet, typename Scalar>
+void compact_gemm_group(Index m, Index n, Index k, Scalar alpha, const Scalar* a, const Scalar* b, Scalar beta,
+                        Scalar* c) {
+  const Index PacketSize = unpacket_traits<Packet>::size;
+  const Packet palpha = pset1<Packet>(alpha);
+  const Packet pbeta = pset1<Packet>(beta);
+  for (Index j = 0; j < n; ++j) {
+    const Scalar* bj = b + j * k * PacketSize;
+    Scalar* cj = c + j * m * PacketSize;
+    Index i = 0;
+    // Four rows at a time, accumulating in registers over the inner dimension.
+    for (; i + 4 <= m; i += 4) {
+      Packet c0 = pzero(palpha), c1 = pzero(palpha), c2 = pzero(palpha), c3 = pzero(palpha);
+      for (Index p = 0; p < k; ++p) {
+        const Packet bpj = pload<Packet>(bj + p * PacketSize);
+        const Scalar* ap = a + (p * m + i) * PacketSize;
+        c0 = pmadd(pload<Packet>(ap), bpj, c0);
+        c1 = pmadd(pload<Packet>(ap + PacketSize), bpj, c1);
+        c2 = pmadd(pload<Packet>(ap + 2 * PacketSize), bpj, c2);
+        c3 = pmadd(pload<Packet>(ap + 3 * PacketSize), bpj, c3);
+      }
+      Scalar* cij = cj + i * PacketSize;
+      if (beta == Scalar(0)) {
+        pstore(cij, pmul(palpha, c0));
+        pstore(cij + PacketSize, pmul(palpha, c1));
+        pstore(cij + 2 * PacketSize, pmul(palpha, c2));
+        pstore(cij + 3 * PacketSize, pmul(palpha, c3));
+      } else {
+        pstore(cij, pmadd(palpha, c0, pmul(pbeta, pload<Packet>(cij))));
+        pstore(cij + PacketSize, pmadd(palpha, c1, pmul(pbeta, pload<Packet>(cij + PacketSize))));
+        pstore(cij + 2 * PacketSize, pmadd(palpha, c2, pmul(pbeta, pload<Packet>(cij + 2 * PacketSize))));
+        pstore(cij + 3 * PacketSize, pmadd(palpha, c3, pmul(pbeta, pload<Packet>(cij + 3 * PacketSize))));
+      }
+    }
+    for (; i < m; ++i) {
+      Packet c0 = pzero(palpha);
+      for (Index p = 0; p < k; ++p)
+        c0 = pmadd(pload<Packet>(a + (p * m + i) * PacketSize), pload<Packet>(bj + p * PacketSize), c0);
+      Scalar* cij = cj + i * PacketSize;
+      // beta == 0 must not propagate NaNs from an uninitialized C.
+      if (beta == Scalar(0))
+        pstore(cij, pmul(palpha, c0));
+      else
+        pstore(cij, pmadd(palpha, c0, pmul(pbeta, pload<Packet>(cij))));
+    }
+  }
+}
+
+// Solves A X = B in place of B, with A m x m triangular and B m x n.
+template <int Mode, typename Packet, typename Scalar>
+void compact_trsm_group(Index m, Index n, const Scalar* a, Scalar* b) {
+  const Index PacketSize = unpacket_traits<Packet>::size;
+  const bool IsLower = (Mode & Lower) == Lower;
+  const bool IsUnit = (Mode & UnitDiag) == UnitDiag;
+  for (Index j = 0; j < n; ++j) {
+    Scalar* bj = b + j * m * PacketSize;
+    for (Index q = 0; q < m; ++q) {
+      const Index p = IsLower ? q : m - 1 - q;
+      const Scalar* ap = a + p * m * PacketSize;
+      Packet x = pload<Packet>(bj + p * PacketSize);
+      if (!IsUnit) x = pdiv(x, pload<Packet>(ap + p * PacketSize));
+      pstore(bj + p * PacketSize, x);
+      const Index start = IsLower ? p + 1 : 0;
+      const Index end = IsLower ? m : p;
+      for (Index i = start; i < end; ++i)
+        pstore(bj + i * PacketSize,
+               pnmadd(pload<Packet>(ap + i * PacketSize), x, pload<Packet>(bj + i * PacketSize)));
+    }
+  }
+}
+
+// Overwrites the lower triangular part of the m x m matrices with their
+// Cholesky factors L, such that A = L L^T. The strictly upper part is left
+// untouched. Returns the packet mask of the lanes that are not positive
+// definite.
+template <typename Packet, typename Scalar>
+Packet compact_llt_group(Index m, Scalar* a) {
+  const Index PacketSize = unpacket_traits<Packet>::size;
+  const Packet zero = pset1<Packet>(Scalar(0));
+  Packet failed = zero;
+  for (Index j = 0; j < m; ++j) {
+    Scalar* aj = a + j * m * PacketSize;
+    // Left-looking: update column j with the already factored columns.
+    for (Index p = 0; p < j; ++p) {
+      const Scalar* ap = a + p * m * PacketSize;
+      const Packet ljp = pload<Packet>(ap + j * PacketSize);
+      for (Index i = j; i < m; ++i)
+        pstore(aj + i * PacketSize, pnmadd(pload<Packet>(ap + i * PacketSize), ljp, pload<Packet>(aj + i * PacketSize)));
+    }
+    const Packet d = pload<Packet>(aj + j * PacketSize);
+    failed = por(failed, pcmp_le(d, zero));
+    const Packet ljj = psqrt(d);
+    pstore(aj + j * PacketSize, ljj);
+    for (Index i = j + 1; i < m; ++i) pstore(aj + i * PacketSize, pdiv(pload<Packet>(aj + i * PacketSize), ljj));
+  }
+  return failed;
+}
+
+}  // namespace internal
+
+}  // namespace Eigen
+
+#endif  // EIGEN_BATCHED_KERNELS_H
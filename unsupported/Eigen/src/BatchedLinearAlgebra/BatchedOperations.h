@@ -0,0 +1,146 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_OPERATIONS_H
+#define EIGEN_BATCHED_OPERATIONS_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+/** \ingroup BatchedLinearAlgebra_Module
+ *
+ * Computes \f$ C_b = \alpha A_b B_b + \beta C_b \f$ for every matrix \c b of the batches.
+ *
+ * When \a beta is zero, \a c is resized to the dimensions of the products if
+ * needed and its previous content is ignored. \a c must not be \a a or \a b.
+ */
+template <typename Scalar>
+void batchedGemm(const CompactBatch<Scalar>& a, const CompactBatch<Scalar>& b, CompactBatch<Scalar>& c,
+                 const Scalar& alpha = Scalar(1), const Scalar& beta = Scalar(0)) {
+  typedef typename CompactBatch<Scalar>::Packet Packet;
+  eigen_assert(a.batchSize() == b.batchSize() && a.cols() == b.rows());
+  eigen_assert(&c != &a && &c != &b);
+  if (beta == Scalar(0) && (c.batchSize() != a.batchSize() || c.rows() != a.rows() || c.cols() != b.cols()))
+    c.resize(a.batchSize(), a.rows(), b.cols());
+  eigen_assert(c.batchSize() == a.batchSize() && c.rows() == a.rows() && c.cols() == b.cols());
+  for (Index g = 0; g < a.groupCount(); ++g)
+    internal::compact_gemm_group<Packet>(a.rows(), b.cols(), a.cols(), alpha, a.groupData(g), b.groupData(g), beta,
+                                         c.groupData(g));
+}
+
+/** \ingroup BatchedLinearAlgebra_Module
+ *
+ * Computes \f$ C_b = \alpha A_b B_b + \beta C_b \f$ for the \a batchSize column-major
+ * matrices pointed to by \a a, \a b and \a c, where \f$ A_b \f$ is \a m x \a k,
+ * \f$ B_b \f$ is \a k x \a n and \f$ C_b \f$ is \a m x \a n, with leading
+ * dimensions \a lda, \a ldb and \a ldc.
+ *
+ * The matrices are gathered by groups into the interleaved layout of
+ * CompactBatch, multiplied, and scattered back, which pays off for small sizes
+ * only. For repeated operations on the same matrices, store them in a
+ * CompactBatch directly.
+ */
+template <typename Scalar>
+void batchedGemm(Index batchSize, Index m, Index n, Index k, const Scalar& alpha, const Scalar* const* a, Index lda,
+                 const Scalar* const* b, Index ldb, const Scalar& beta, Scalar* const* c, Index ldc) {
+  typedef typename internal::packet_traits<Scalar>::type Packet;
+  const Index PacketSize = internal::unpacket_traits<Packet>::size;
+  eigen_assert(batchSize >= 0 && m >= 0 && n >= 0 && k >= 0);
+  eigen_assert(lda >= m && ldb >= k && ldc >= m);
+  if (batchSize == 0 || m == 0 || n == 0) return;
+
+  Matrix<Scalar, Dynamic, 1> ga(m * k * PacketSize), gb(k * n * PacketSize), gc(m * n * PacketSize);
+  for (Index g = 0; g < batchSize; g += PacketSize) {
+    const Index lanes = numext::mini<Index>(PacketSize, batchSize - g);
+    if (lanes < PacketSize) {
+      // Unused lanes of the last group must not hold stale data of the
+      // previous group, which could raise floating point exceptions.
+      ga.setZero();
+      gb.setZero();
+      gc.setZero();
+    }
+    for (Index l = 0; l < lanes; ++l) {
+      const Scalar* al = a[g + l];
+      const Scalar* bl = b[g + l];
+      for (Index j = 0; j < k; ++j)
+        for (Index i = 0; i < m; ++i) ga[(j * m + i) * PacketSize + l] = al[j * lda + i];
+      for (Index j = 0; j < n; ++j)
+        for (Index i = 0; i < k; ++i) gb[(j * k + i) * PacketSize + l] = bl[j * ldb + i];
+      if (beta != Scalar(0)) {
+        const Scalar* cl = c[g + l];
+        for (Index j = 0; j < n; ++j)
+          for (Index i = 0; i < m; ++i) gc[(j * m + i) * PacketSize + l] = cl[j * ldc + i];
+      }
+    }
+    internal::compact_gemm_group<Packet>(m, n, k, alpha, ga.data(), gb.data(), beta, gc.data());
+    for (Index l = 0; l < lanes; ++l) {
+      Scalar* cl = c[g + l];
+      for (Index j = 0; j < n; ++j)
+        for (Index i = 0; i < m; ++i) cl[j * ldc + i] = gc[(j * m + i) * PacketSize + l];
+    }
+  }
+}
+
+/** \ingroup BatchedLinearAlgebra_Module
+ *
+ * Solves \f$ A_b X_b = B_b \f$ in place of \f$ B_b \f$ for every matrix \c b of the
+ * batches, where the \f$ A_b \f$ are triangular.
+ *
+ * \tparam Mode one of \c Lower, \c Upper, \c UnitLower or \c UnitUpper. Only
+ * the corresponding triangular part of \a a is referenced.
+ */
+template <int Mode, typename Scalar>
+void batchedTriangularSolve(const CompactBatch<Scalar>& a, CompactBatch<Scalar>& b) {
+  typedef typename CompactBatch<Scalar>::Packet Packet;
+  EIGEN_STATIC_ASSERT((Mode & (Lower | Upper)) == Lower || (Mode & (Lower | Upper)) == Upper,
+                      INVALID_MATRIX_TEMPLATE_PARAMETERS);
+  eigen_assert(a.batchSize() == b.batchSize() && a.rows() == a.cols() && a.cols() == b.rows());
+  for (Index g = 0; g < a.groupCount(); ++g)
+    internal::compact_trsm_group<Mode, Packet>(b.rows(), b.cols(), a.groupData(g), b.groupData(g));
+}
+
+/** \ingroup BatchedLinearAlgebra_Module
+ *
+ * Computes the Cholesky factorizations \f$ A_b = L_b L_b^T \f$ of a batch of real
+ * symmetric positive definite matrices. The factors \f$ L_b \f$ overwrite the
+ * lower triangular parts of \a a, the strictly upper parts are not referenced.
+ *
+ * \returns \c Success if all the matrices are positive definite, and
+ * \c NumericalIssue otherwise. In the latter case, the content of the failing
+ * matrices is unspecified, while the other ones are correctly factored. When
+ * \a failed is not null, it is set to the indices of the failing matrices.
+ */
+template <typename Scalar>
+ComputationInfo batchedLLT(CompactBatch<Scalar>& a, std::vector<Index>* failed = 0) {
+  typedef typename CompactBatch<Scalar>::Packet Packet;
+  const Index PacketSize = CompactBatch<Scalar>::LaneCount;
+  EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL);
+  eigen_assert(a.rows() == a.cols());
+  if (failed) failed->clear();
+  ComputationInfo info = Success;
+  const Packet one = internal::pset1<Packet>(Scalar(1));
+  const Packet zero = internal::pset1<Packet>(Scalar(0));
+  for (Index g = 0; g < a.groupCount(); ++g) {
+    const Packet mask = internal::compact_llt_group<Packet>(a.rows(), a.groupData(g));
+    if (!internal::predux_any(mask)) continue;
+    // Inspect the lanes, ignoring the padding of the last group.
+    EIGEN_ALIGN_MAX Scalar lanes[PacketSize];
+    internal::pstore(lanes, internal::pselect(mask, one, zero));
+    for (Index l = 0; l < PacketSize && g * PacketSize + l < a.batchSize(); ++l) {
+      if (lanes[l] == Scalar(0)) continue;
+      info = NumericalIssue;
+      if (failed) failed->push_back(g * PacketSize + l);
+    }
+  }
+  return info;
+}
+
+}  // namespace Eigen
+
+#endif  // EIGEN_BATCHED_OPERATIONS_H
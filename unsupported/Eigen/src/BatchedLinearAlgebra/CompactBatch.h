@@ -0,0 +1,111 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_COMPACT_BATCH_H
+#define EIGEN_BATCHED_COMPACT_BATCH_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+/** \ingroup BatchedLinearAlgebra_Module
+ *
+ * \class CompactBatch
+ *
+ * \brief A batch of equally sized matrices stored in interleaved layout
+ *
+ * \tparam Scalar_ the scalar type of the matrices
+ *
+ * The matrices are grouped by \c LaneCount, the packet size of \a Scalar_.
+ * Within a group, the coefficient (i,j) of the \c LaneCount matrices is stored
+ * contiguously, and the coefficients follow each other in column-major order:
+ * the coefficient (i,j) of the matrix \c b is found at
+ * \code
+ * data[((b / LaneCount) * rows * cols + j * rows + i) * LaneCount + b % LaneCount]
+ * \endcode
+ * A packet load thus fetches the same coefficient of \c LaneCount matrices, and
+ * the batched kernels run the scalar algorithm once per group with every
+ * operation acting on a full packet.
+ *
+ * The last group is padded up to \c LaneCount matrices. Padding matrices are
+ * zero after resize() and setZero(), and never reported in results.
+ */
+template <typename Scalar_>
+class CompactBatch {
+ public:
+  typedef Scalar_ Scalar;
+  typedef typename internal::packet_traits<Scalar>::type Packet;
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  enum { LaneCount = internal::unpacket_traits<Packet>::size };
+
+  CompactBatch() : m_batchSize(0), m_rows(0), m_cols(0) {}
+
+  /** Constructs a batch of \a batchSize zero matrices of size \a rows x \a cols. */
+  CompactBatch(Index batchSize, Index rows, Index cols) : m_batchSize(0), m_rows(0), m_cols(0) {
+    resize(batchSize, rows, cols);
+  }
+
+  /** Resizes the batch, all coefficients are set to zero. */
+  void resize(Index batchSize, Index rows, Index cols) {
+    eigen_assert(batchSize >= 0 && rows >= 0 && cols >= 0);
+    m_batchSize = batchSize;
+    m_rows = rows;
+    m_cols = cols;
+    m_data.setZero(groupCount() * groupSize());
+  }
+
+  void setZero() { m_data.setZero(); }
+
+  Index batchSize() const { return m_batchSize; }
+  Index rows() const { return m_rows; }
+  Index cols() const { return m_cols; }
+
+  /** \returns the number of groups of \c LaneCount interleaved matrices */
+  Index groupCount() const { return (m_batchSize + LaneCount - 1) / LaneCount; }
+
+  /** \returns the number of scalars used by one group */
+  Index groupSize() const { return m_rows * m_cols * LaneCount; }
+
+  /** \returns a pointer to the interleaved coefficients of the group \a g */
+  Scalar* groupData(Index g) { return m_data.data() + g * groupSize(); }
+  const Scalar* groupData(Index g) const { return m_data.data() + g * groupSize(); }
+
+  Scalar& operator()(Index b, Index i, Index j) { return m_data.coeffRef(index(b, i, j)); }
+  const Scalar& operator()(Index b, Index i, Index j) const { return m_data.coeffRef(index(b, i, j)); }
+
+  /** Copies \a matrix into the matrix \a b of the batch. */
+  template <typename Derived>
+  void set(Index b, const DenseBase<Derived>& matrix) {
+    eigen_assert(matrix.rows() == m_rows && matrix.cols() == m_cols);
+    for (Index j = 0; j < m_cols; ++j)
+      for (Index i = 0; i < m_rows; ++i) (*this)(b, i, j) = matrix.coeff(i, j);
+  }
+
+  /** \returns a copy of the matrix \a b of the batch. */
+  MatrixType get(Index b) const {
+    MatrixType matrix(m_rows, m_cols);
+    for (Index j = 0; j < m_cols; ++j)
+      for (Index i = 0; i < m_rows; ++i) matrix(i, j) = (*this)(b, i, j);
+    return matrix;
+  }
+
+ protected:
+  Index index(Index b, Index i, Index j) const {
+    eigen_assert(b >= 0 && b < m_batchSize && i >= 0 && i < m_rows && j >= 0 && j < m_cols);
+    return (b / LaneCount) * groupSize() + (j * m_rows + i) * LaneCount + b % LaneCount;
+  }
+
+  Matrix<Scalar, Dynamic, 1> m_data;
+  Index m_batchSize;
+  Index m_rows;
+  Index m_cols;
+};
+
+}  // namespace Eigen
+
+#endif  // EIGEN_BATCHED_COMPACT_BATCH_H
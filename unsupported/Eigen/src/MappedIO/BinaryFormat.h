@@ -0,0 +1,784 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BINARY_FORMAT_H
+#define EIGEN_BINARY_FORMAT_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+namespace Eigen {
+
+/** \ingroup MappedIO_Module Kind of object stored in a binary file. */
+enum BinaryFileKind { BinaryFileDense = 1, BinaryFileSparse = 2, BinaryFileTensor = 3 };
+
+/** \ingroup MappedIO_Module Options of saveBinary(). */
+enum BinaryFileOptions {
+  BinaryFileNoChecksums = 0,
+  /** Stores one checksum per outer vector, see MappedBinaryFile::verifyChecksums(). */
+  BinaryFileChecksums = 1
+};
+
+/** \ingroup MappedIO_Module Status of a MappedBinaryFile. */
+enum BinaryFileError {
+  BinaryFileSuccess = 0,
+  /** The file cannot be opened or mapped. */
+  BinaryFileCannotOpen,
+  /** The file is not in the binary format, or its header is inconsistent. */
+  BinaryFileBadHeader,
+  /** The file was written with a newer version of the format. */
+  BinaryFileUnsupportedVersion,
+  /** The file was written on a machine of another endianness. */
+  BinaryFileWrongEndianness,
+  /** The size of the file does not match its header. */
+  BinaryFileTruncated,
+  /** The content of the file does not match its checksums. */
+  BinaryFileChecksumMismatch,
+  /** The outer or inner indices of a sparse matrix are out of range. */
+  BinaryFileBadIndices
+};
+
+namespace internal {
+
+const char binary_file_magic[8] = {'E', 'I', 'G', 'E', 'N', 'B', 'I', 'N'};
+const uint32_t binary_file_version = 1;
+const uint32_t binary_file_endianness = 0x01020304;
+const uint64_t binary_file_alignment = 64;
+const int binary_file_max_rank = 8;
+
+enum { binary_file_row_major = 1, binary_file_has_checksums = 2 };
+
+// Header at the beginning of every file. All offsets are in bytes from the beginning of the file, and all the
+// sections start on a multiple of binary_file_alignment:
+//  - dense objects and tensors store their coefficients at data_offset, in the order given by the storage order;
+//  - sparse matrices store their values at data_offset, and their outer and inner indices, as in a compressed
+//    SparseMatrix, at outer_index_offset and inner_index_offset;
+//  - if binary_file_has_checksums is set, outer_size 64-bit checksums are stored at checksum_offset.
+struct binary_file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t endianness;
+  uint32_t kind;
+  uint32_t scalar_type;
+  uint32_t scalar_size;
+  uint32_t index_size;
+  uint32_t flags;
+  uint32_t rank;
+  uint64_t dims[binary_file_max_rank];
+  uint64_t nnz;
+  uint64_t outer_size;
+  uint64_t data_offset;
+  uint64_t outer_index_offset;
+  uint64_t inner_index_offset;
+  uint64_t checksum_offset;
+  uint64_t file_size;
+  uint64_t reserved[11];
+  uint64_t header_checksum;
+};
+
+static_assert(sizeof(binary_file_header) == 256, "the binary file header must be 256 bytes");
+static_assert(sizeof(binary_file_header) % binary_file_alignment == 0, "the header must preserve the alignment");
+
+// Codes identifying the scalar types in files. Other types are identified by their size only.
+template <typename Scalar>
+struct binary_scalar_code {
+  enum { value = 0 };
+};
+
+#define EIGEN_BINARY_SCALAR_CODE(TYPE, CODE) \
+  template <>                                \
+  struct binary_scalar_code<TYPE> {          \
+    enum { value = CODE };                   \
+  };
+
+EIGEN_BINARY_SCALAR_CODE(float, 1)
+EIGEN_BINARY_SCALAR_CODE(double, 2)
+EIGEN_BINARY_SCALAR_CODE(std::complex<float>, 3)
+EIGEN_BINARY_SCALAR_CODE(std::complex<double>, 4)
+EIGEN_BINARY_SCALAR_CODE(int8_t, 5)
+EIGEN_BINARY_SCALAR_CODE(uint8_t, 6)
+EIGEN_BINARY_SCALAR_CODE(int16_t, 7)
+EIGEN_BINARY_SCALAR_CODE(uint16_t, 8)
+EIGEN_BINARY_SCALAR_CODE(int32_t, 9)
+EIGEN_BINARY_SCALAR_CODE(uint32_t, 10)
+EIGEN_BINARY_SCALAR_CODE(int64_t, 11)
+EIGEN_BINARY_SCALAR_CODE(uint64_t, 12)
+EIGEN_BINARY_SCALAR_CODE(Eigen::half, 13)
+EIGEN_BINARY_SCALAR_CODE(Eigen::bfloat16, 14)
+EIGEN_BINARY_SCALAR_CODE(bool, 15)
+
+#undef EIGEN_BINARY_SCALAR_CODE
+
+inline uint64_t binary_file_align(uint64_t offset) {
+  return (offset + binary_file_alignment - 1) & ~(binary_file_alignment - 1);
+}
+
+// Computes a = a * b, returning false on overflow.
+inline bool binary_file_mul(uint64_t& a, uint64_t b) {
+  if (b != 0 && a > (std::numeric_limits<uint64_t>::max)() / b) return false;
+  a *= b;
+  return true;
+}
+
+inline uint64_t binary_file_rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// 64-bit non-cryptographic hash of a buffer. The main loop runs four independent multiply-rotate lanes on 32-byte
+// blocks, so that checksums can be computed at memory bandwidth.
+inline uint64_t binary_file_checksum(const void* data, std::size_t bytes, uint64_t seed = 0) {
+  const uint64_t k1 = 0x9E3779B185EBCA87ull, k2 = 0xC2B2AE3D27D4EB4Full, k3 = 0x165667B19E3779F9ull;
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  const uint64_t length = bytes;
+  uint64_t h0 = seed + k1 + k2, h1 = seed + k2, h2 = seed, h3 = seed - k1;
+  for (; bytes >= 32; bytes -= 32, p += 32) {
+    uint64_t w[4];
+    std::memcpy(w, p, 32);
+    h0 = binary_file_rotl(h0 + w[0] * k2, 31) * k1;
+    h1 = binary_file_rotl(h1 + w[1] * k2, 31) * k1;
+    h2 = binary_file_rotl(h2 + w[2] * k2, 31) * k1;
+    h3 = binary_file_rotl(h3 + w[3] * k2, 31) * k1;
+  }
+  uint64_t h = binary_file_rotl(h0, 1) + binary_file_rotl(h1, 7) + binary_file_rotl(h2, 12) +
+               binary_file_rotl(h3, 18) + length;
+  for (; bytes > 0;) {
+    uint64_t w = 0;
+    const std::size_t n = bytes < 8 ? bytes : 8;
+    std::memcpy(&w, p, n);
+    h = binary_file_rotl(h ^ (binary_file_rotl(w * k2, 31) * k1), 27) * k1 + k3;
+    bytes -= n;
+    p += n;
+  }
+  h ^= h >> 33;
+  h *= k2;
+  h ^= h >> 29;
+  h *= k3;
+  h ^= h >> 32;
+  return h;
+}
+
+inline uint64_t binary_file_header_checksum(const binary_file_header& header) {
+  return binary_file_checksum(&header, offsetof(binary_file_header, header_checksum));
+}
+
+// Checksum of an outer vector of a sparse matrix: the number of nonzeros seeds the hash of the values, which seeds
+// the hash of the inner indices.
+inline uint64_t binary_file_sparse_checksum(const void* values, const void* indices, uint64_t nnz,
+                                            std::size_t scalar_size, std::size_t index_size) {
+  return binary_file_checksum(indices, std::size_t(nnz) * index_size,
+                              binary_file_checksum(values, std::size_t(nnz) * scalar_size, nnz));
+}
+
+// Reads the i-th signed integer of size index_size at p.
+inline int64_t binary_file_read_index(const uint8_t* p, uint32_t index_size, uint64_t i) {
+  switch (index_size) {
+    case 1: {
+      int8_t v;
+      std::memcpy(&v, p + i, 1);
+      return v;
+    }
+    case 2: {
+      int16_t v;
+      std::memcpy(&v, p + 2 * i, 2);
+      return v;
+    }
+    case 4: {
+      int32_t v;
+      std::memcpy(&v, p + 4 * i, 4);
+      return v;
+    }
+    default: {
+      int64_t v;
+      std::memcpy(&v, p + 8 * i, 8);
+      return v;
+    }
+  }
+}
+
+// Number of coefficients stored for a dense matrix or a tensor, and number of nonzeros for a sparse matrix.
+// Returns false on overflow.
+inline bool binary_file_element_count(const binary_file_header& header, uint64_t& count) {
+  if (header.kind == BinaryFileSparse) {
+    count = header.nnz;
+    return true;
+  }
+  count = 1;
+  for (uint32_t i = 0; i < header.rank; ++i)
+    if (!binary_file_mul(count, header.dims[i])) return false;
+  return true;
+}
+
+// Size of the contiguous outer vectors of a dense matrix or a tensor, and of the inner dimension of a sparse matrix.
+inline uint64_t binary_file_inner_size(const binary_file_header& header) {
+  const bool row_major = header.flags & binary_file_row_major;
+  if (header.rank == 0) return 1;
+  return row_major ? header.dims[header.rank - 1] : header.dims[0];
+}
+
+inline uint64_t binary_file_outer_size(const binary_file_header& header) {
+  const bool row_major = header.flags & binary_file_row_major;
+  if (header.kind != BinaryFileTensor) return row_major ? header.dims[0] : header.dims[1];
+  uint64_t count = 0;
+  binary_file_element_count(header, count);
+  const uint64_t inner = binary_file_inner_size(header);
+  return inner == 0 ? 0 : count / inner;
+}
+
+template <typename Scalar>
+binary_file_header binary_file_make_header(uint32_t kind, bool row_major, bool checksums, uint32_t rank,
+                                           const uint64_t* dims) {
+  static_assert(std::is_trivially_copyable<Scalar>::value, "only trivially copyable scalars can be stored");
+  binary_file_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, binary_file_magic, sizeof(header.magic));
+  header.version = binary_file_version;
+  header.endianness = binary_file_endianness;
+  header.kind = kind;
+  header.scalar_type = binary_scalar_code<Scalar>::value;
+  header.scalar_size = sizeof(Scalar);
+  header.flags = (row_major ? binary_file_row_major : 0) | (checksums ? binary_file_has_checksums : 0);
+  header.rank = rank;
+  for (uint32_t i = 0; i < rank; ++i) header.dims[i] = dims[i];
+  header.outer_size = binary_file_outer_size(header);
+  return header;
+}
+
+// Sets the offsets of the sections following the header, given their sizes in bytes, and the header checksum.
+inline void binary_file_layout(binary_file_header& header, uint64_t data_bytes, uint64_t outer_index_bytes,
+                               uint64_t inner_index_bytes) {
+  header.data_offset = sizeof(binary_file_header);
+  uint64_t end = header.data_offset + data_bytes;
+  if (header.kind == BinaryFileSparse) {
+    header.outer_index_offset = binary_file_align(end);
+    end = header.outer_index_offset + outer_index_bytes;
+    header.inner_index_offset = binary_file_align(end);
+    end = header.inner_index_offset + inner_index_bytes;
+  }
+  if (header.flags & binary_file_has_checksums) {
+    header.checksum_offset = binary_file_align(end);
+    end = header.checksum_offset + header.outer_size * sizeof(uint64_t);
+  }
+  header.file_size = end;
+  header.header_checksum = binary_file_header_checksum(header);
+}
+
+// Checks that the section [offset, offset + bytes) is aligned and lies within the file.
+inline bool binary_file_check_section(uint64_t offset, uint64_t bytes, uint64_t file_size) {
+  return offset % binary_file_alignment == 0 && offset >= sizeof(binary_file_header) && offset <= file_size &&
+         bytes <= file_size - offset;
+}
+
+// Validates the header of the file of the given size starting at data, and copies it into header. Only the header
+// and, for sparse matrices, two outer indices are read.
+inline BinaryFileError binary_file_check(const uint8_t* data, std::size_t size, binary_file_header& header) {
+  if (size < sizeof(binary_file_header))
+    return size >= sizeof(binary_file_magic) && std::memcmp(data, binary_file_magic, sizeof(binary_file_magic)) == 0
+               ? BinaryFileTruncated
+               : BinaryFileBadHeader;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, binary_file_magic, sizeof(binary_file_magic)) != 0) return BinaryFileBadHeader;
+  if (header.endianness != binary_file_endianness)
+    return header.endianness == 0x04030201u ? BinaryFileWrongEndianness : BinaryFileBadHeader;
+  if (header.version == 0 || header.version > binary_file_version) return BinaryFileUnsupportedVersion;
+  if (binary_file_header_checksum(header) != header.header_checksum) return BinaryFileBadHeader;
+  if (header.file_size > size) return BinaryFileTruncated;
+  if (header.file_size < size) return BinaryFileBadHeader;
+
+  if (header.kind < BinaryFileDense || header.kind > BinaryFileTensor) return BinaryFileBadHeader;
+  if (header.rank > uint32_t(binary_file_max_rank) || (header.kind != BinaryFileTensor && header.rank != 2))
+    return BinaryFileBadHeader;
+  for (uint32_t i = 0; i < header.rank; ++i)
+    if (header.dims[i] > uint64_t(NumTraits<Index>::highest())) return BinaryFileBadHeader;
+  if (header.scalar_size == 0 || header.outer_size != binary_file_outer_size(header)) return BinaryFileBadHeader;
+
+  uint64_t data_bytes = 0;
+  if (!binary_file_element_count(header, data_bytes) || !binary_file_mul(data_bytes, header.scalar_size) ||
+      !binary_file_check_section(header.data_offset, data_bytes, size))
+    return BinaryFileBadHeader;
+
+  if (header.kind == BinaryFileSparse) {
+    const uint32_t index_size = header.index_size;
+    if (index_size != 1 && index_size != 2 && index_size != 4 && index_size != 8) return BinaryFileBadHeader;
+    uint64_t outer_bytes = header.outer_size + 1, inner_bytes = header.nnz;
+    if (!binary_file_mul(outer_bytes, index_size) || !binary_file_mul(inner_bytes, index_size) ||
+        !binary_file_check_section(header.outer_index_offset, outer_bytes, size) ||
+        !binary_file_check_section(header.inner_index_offset, inner_bytes, size))
+      return BinaryFileBadHeader;
+    const uint8_t* outer = data + header.outer_index_offset;
+    if (binary_file_read_index(outer, index_size, 0) != 0 ||
+        binary_file_read_index(outer, index_size, header.outer_size) != int64_t(header.nnz))
+      return BinaryFileBadHeader;
+  }
+
+  if (header.flags & binary_file_has_checksums) {
+    uint64_t checksum_bytes = header.outer_size;
+    if (!binary_file_mul(checksum_bytes, sizeof(uint64_t)) ||
+        !binary_file_check_section(header.checksum_offset, checksum_bytes, size))
+      return BinaryFileBadHeader;
+  }
+  return BinaryFileSuccess;
+}
+
+// Sequential writer padding the sections to the offsets computed by binary_file_layout().
+class binary_file_writer {
+ public:
+  explicit binary_file_writer(const std::string& filename)
+      : m_file(std::fopen(filename.c_str(), "wb")), m_offset(0), m_ok(m_file != nullptr) {}
+
+  ~binary_file_writer() {
+    if (m_file != nullptr) std::fclose(m_file);
+  }
+
+  bool write(const void* data, uint64_t bytes) {
+    if (m_ok && bytes > 0) m_ok = std::fwrite(data, 1, std::size_t(bytes), m_file) == std::size_t(bytes);
+    m_offset += bytes;
+    return m_ok;
+  }
+
+  // Writes zeros up to offset.
+  bool padTo(uint64_t offset) {
+    static const uint8_t zeros[binary_file_alignment] = {0};
+    eigen_assert(offset >= m_offset && offset - m_offset < binary_file_alignment);
+    return write(zeros, offset - m_offset);
+  }
+
+  // Closes the file, and returns whether everything was written.
+  bool close() {
+    if (m_file == nullptr) return false;
+    const bool closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+    return m_ok && closed;
+  }
+
+ private:
+  std::FILE* m_file;
+  uint64_t m_offset;
+  bool m_ok;
+};
+
+// Writes the checksums section, if any, and closes the file.
+inline bool binary_file_finish(binary_file_writer& writer, const binary_file_header& header,
+                               const std::vector<uint64_t>& checksums) {
+  if (header.flags & binary_file_has_checksums) {
+    eigen_assert(checksums.size() == header.outer_size);
+    writer.padTo(header.checksum_offset);
+    writer.write(checksums.data(), checksums.size() * sizeof(uint64_t));
+  }
+  return writer.close();
+}
+
+template <typename T>
+struct binary_file_traits;
+
+template <typename Scalar>
+bool binary_file_scalar_matches(const binary_file_header& header) {
+  return header.scalar_type == uint32_t(binary_scalar_code<Scalar>::value) && header.scalar_size == sizeof(Scalar);
+}
+
+template <typename MatrixType>
+struct binary_file_dense_traits {
+  static bool matches(const binary_file_header& header) {
+    if (header.kind != BinaryFileDense || !binary_file_scalar_matches<typename MatrixType::Scalar>(header))
+      return false;
+    const uint64_t rows = header.dims[0], cols = header.dims[1];
+    if ((MatrixType::RowsAtCompileTime != Dynamic && rows != uint64_t(MatrixType::RowsAtCompileTime)) ||
+        (MatrixType::ColsAtCompileTime != Dynamic && cols != uint64_t(MatrixType::ColsAtCompileTime)) ||
+        (MatrixType::MaxRowsAtCompileTime != Dynamic && rows > uint64_t(MatrixType::MaxRowsAtCompileTime)) ||
+        (MatrixType::MaxColsAtCompileTime != Dynamic && cols > uint64_t(MatrixType::MaxColsAtCompileTime)))
+      return false;
+    // Vectors have the same layout in both storage orders.
+    return rows == 1 || cols == 1 || bool(header.flags & binary_file_row_major) == bool(MatrixType::IsRowMajor);
+  }
+};
+
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct binary_file_traits<Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols> >
+    : binary_file_dense_traits<Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols> > {};
+
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct binary_file_traits<Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols> >
+    : binary_file_dense_traits<Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols> > {};
+
+template <typename Scalar, int Options, typename StorageIndex>
+struct binary_file_traits<SparseMatrix<Scalar, Options, StorageIndex> > {
+  static bool matches(const binary_file_header& header) {
+    return header.kind == BinaryFileSparse && binary_file_scalar_matches<Scalar>(header) &&
+           header.index_size == sizeof(StorageIndex) &&
+           bool(header.flags & binary_file_row_major) == bool(Options & RowMajorBit) &&
+           header.dims[0] <= uint64_t(NumTraits<StorageIndex>::highest()) &&
+           header.dims[1] <= uint64_t(NumTraits<StorageIndex>::highest());
+  }
+};
+
+template <typename Scalar, int NumIndices, int Options, typename IndexType>
+struct binary_file_traits<Tensor<Scalar, NumIndices, Options, IndexType> > {
+  static bool matches(const binary_file_header& header) {
+    if (header.kind != BinaryFileTensor || !binary_file_scalar_matches<Scalar>(header) ||
+        header.rank != uint32_t(NumIndices))
+      return false;
+    for (int i = 0; i < NumIndices; ++i)
+      if (header.dims[i] > uint64_t(NumTraits<IndexType>::highest())) return false;
+    return NumIndices <= 1 || bool(header.flags & binary_file_row_major) == bool(Options & RowMajor);
+  }
+};
+
+}  // end namespace internal
+
+/** \ingroup MappedIO_Module
+ *
+ * Writes the dense matrix or array \a mat to \a filename, in its storage order.
+ *
+ * The coefficients are written one outer vector at a time. Expressions which
+ * are costly to evaluate coefficient-wise, such as products, are evaluated
+ * once into a temporary; the others are evaluated one column (or row) at a
+ * time.
+ *
+ * \param options BinaryFileChecksums to store one checksum per column (or row).
+ * \returns true if the file was successfully written.
+ */
+template <typename Derived>
+bool saveBinary(const std::string& filename, const DenseBase<Derived>& mat, int options = BinaryFileNoChecksums) {
+  typedef typename Derived::Scalar Scalar;
+  const bool row_major = Derived::IsRowMajor;
+  const bool checksums = options & BinaryFileChecksums;
+  const uint64_t dims[2] = {uint64_t(mat.rows()), uint64_t(mat.cols())};
+  internal::binary_file_header header =
+      internal::binary_file_make_header<Scalar>(BinaryFileDense, row_major, checksums, 2, dims);
+  internal::binary_file_layout(header, uint64_t(mat.size()) * sizeof(Scalar), 0, 0);
+
+  internal::binary_file_writer writer(filename);
+  if (!writer.write(&header, sizeof(header))) return false;
+  const Index inner = mat.innerSize(), outer = mat.outerSize();
+  const std::size_t bytes = std::size_t(inner) * sizeof(Scalar);
+  std::vector<uint64_t> outer_checksums;
+  if (checksums) outer_checksums.reserve(std::size_t(header.outer_size));
+  Matrix<Scalar, Dynamic, 1> buffer(inner);
+  // A block of a product would evaluate the whole product for each outer vector.
+  typename internal::nested_eval<Derived, 1>::type nested(mat.derived());
+  for (Index j = 0; j < outer; ++j) {
+    if (row_major)
+      buffer = nested.row(j).transpose();
+    else
+      buffer = nested.col(j);
+    if (checksums) outer_checksums.push_back(internal::binary_file_checksum(buffer.data(), bytes));
+    if (!writer.write(buffer.data(), bytes)) return false;
+  }
+  return internal::binary_file_finish(writer, header, outer_checksums);
+}
+
+/** \ingroup MappedIO_Module
+ *
+ * Writes the sparse matrix \a mat to \a filename. Uncompressed matrices are
+ * written in compressed form, without copying them.
+ *
+ * \param options BinaryFileChecksums to store one checksum per outer vector.
+ * \returns true if the file was successfully written.
+ */
+template <typename Scalar, int Options, typename StorageIndex>
+bool saveBinary(const std::string& filename, const SparseMatrix<Scalar, Options, StorageIndex>& mat,
+                int options = BinaryFileNoChecksums) {
+  const bool checksums = options & BinaryFileChecksums;
+  const uint64_t dims[2] = {uint64_t(mat.rows()), uint64_t(mat.cols())};
+  internal::binary_file_header header = internal::binary_file_make_header<Scalar>(
+      BinaryFileSparse, bool(Options & RowMajorBit), checksums, 2, dims);
+  const Index outer = mat.outerSize();
+  const uint64_t nnz = uint64_t(mat.nonZeros());
+  header.index_size = sizeof(StorageIndex);
+  header.nnz = nnz;
+  internal::binary_file_layout(header, nnz * sizeof(Scalar), uint64_t(outer + 1) * sizeof(StorageIndex),
+                               nnz * sizeof(StorageIndex));
+
+  const StorageIndex* outer_index = mat.outerIndexPtr();
+  const StorageIndex* inner_nnz = mat.innerNonZeroPtr();
+  const StorageIndex* inner_index = mat.innerIndexPtr();
+  const Scalar* values = mat.valuePtr();
+  auto outer_nnz = [&](Index j) -> Index {
+    return inner_nnz ? Index(inner_nnz[j]) : Index(outer_index[j + 1] - outer_index[j]);
+  };
+
+  internal::binary_file_writer writer(filename);
+  if (!writer.write(&header, sizeof(header))) return false;
+  std::vector<uint64_t> outer_checksums;
+  if (checksums) outer_checksums.reserve(std::size_t(outer));
+  for (Index j = 0; j < outer; ++j) {
+    const Index start = outer_index[j], n = outer_nnz(j);
+    if (checksums)
+      outer_checksums.push_back(internal::binary_file_sparse_checksum(
+          values + start, inner_index + start, uint64_t(n), sizeof(Scalar), sizeof(StorageIndex)));
+    if (!writer.write(values + start, uint64_t(n) * sizeof(Scalar))) return false;
+  }
+
+  writer.padTo(header.outer_index_offset);
+  if (mat.isCompressed()) {
+    writer.write(outer_index, uint64_t(outer + 1) * sizeof(StorageIndex));
+  } else {
+    // Compressed outer indices, computed by chunks.
+    StorageIndex chunk[256];
+    StorageIndex offset = 0;
+    Index count = 0;
+    chunk[count++] = 0;
+    for (Index j = 0; j < outer; ++j) {
+      offset += StorageIndex(outer_nnz(j));
+      chunk[count++] = offset;
+      if (count == 256) {
+        writer.write(chunk, uint64_t(count) * sizeof(StorageIndex));
+        count = 0;
+      }
+    }
+    if (count > 0) writer.write(chunk, uint64_t(count) * sizeof(StorageIndex));
+  }
+
+  writer.padTo(header.inner_index_offset);
+  for (Index j = 0; j < outer; ++j)
+    if (!writer.write(inner_index + outer_index[j], uint64_t(outer_nnz(j)) * sizeof(StorageIndex))) return false;
+  return internal::binary_file_finish(writer, header, outer_checksums);
+}
+
+/** \ingroup MappedIO_Module
+ *
+ * Writes the tensor \a tensor to \a filename, in its layout.
+ *
+ * \param options BinaryFileChecksums to store one checksum per slice along the
+ * first dimension (or the last one for row-major tensors).
+ * \returns true if the file was successfully written.
+ */
+template <typename Scalar, int NumIndices, int Options, typename IndexType>
+bool saveBinary(const std::string& filename, const Tensor<Scalar, NumIndices, Options, IndexType>& tensor,
+                int options = BinaryFileNoChecksums) {
+  static_assert(NumIndices <= internal::binary_file_max_rank, "the rank of tensors is limited to 8");
+  const bool checksums = options & BinaryFileChecksums;
+  uint64_t dims[internal::binary_file_max_rank + 1] = {0};
+  for (int i = 0; i < NumIndices; ++i) dims[i] = uint64_t(tensor.dimension(i));
+  internal::binary_file_header header = internal::binary_file_make_header<Scalar>(
+      BinaryFileTensor, bool(Options & RowMajor), checksums, NumIndices, dims);
+  const uint64_t bytes = uint64_t(tensor.size()) * sizeof(Scalar);
+  internal::binary_file_layout(header, bytes, 0, 0);
+
+  internal::binary_file_writer writer(filename);
+  if (!writer.write(&header, sizeof(header)) || !writer.write(tensor.data(), bytes)) return false;
+  std::vector<uint64_t> outer_checksums;
+  if (checksums) {
+    const std::size_t inner_bytes = std::size_t(internal::binary_file_inner_size(header)) * sizeof(Scalar);
+    outer_checksums.resize(std::size_t(header.outer_size));
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(tensor.data());
+    for (std::size_t j = 0; j < outer_checksums.size(); ++j)
+      outer_checksums[j] = internal::binary_file_checksum(data + j * inner_bytes, inner_bytes);
+  }
+  return internal::binary_file_finish(writer, header, outer_checksums);
+}
+
+/** \ingroup MappedIO_Module
+ *
+ * \brief Zero-copy reader of the files written by saveBinary()
+ *
+ * Opening a file maps it (see MappedFile) and validates its header, which
+ * takes a constant time whatever the size of the file. The content is then
+ * accessed through views over the mapped data:
+ * \code
+ * MappedBinaryFile file("weights.bin");
+ * if (file.is<MatrixXf>()) {
+ *   Map<const MatrixXf, MappedBinaryFile::MapAlignment> weights = file.matrix<MatrixXf>();
+ *   ...
+ * }
+ * \endcode
+ * The views are valid as long as the file is open.
+ *
+ * The sizes of all the sections are checked at opening, but not their
+ * content. Call verifyChecksums() to detect a corrupted file, and
+ * validateIndices() before accessing the indices of a sparse matrix from an
+ * untrusted file: the checksums do not detect a file crafted with
+ * consistent checksums.
+ */
+class MappedBinaryFile {
+ public:
+  /** Alignment of the views returned by matrix(). */
+  enum { MapAlignment = EIGEN_MAX_ALIGN_BYTES > 64 ? int(Aligned64) : int(AlignedMax) };
+
+  MappedBinaryFile() : m_error(BinaryFileCannotOpen) {}
+
+  /** Opens \a filename, see open(). */
+  explicit MappedBinaryFile(const std::string& filename) : m_error(BinaryFileCannotOpen) { open(filename); }
+
+  /** Maps \a filename and validates its header, closing the previously opened file if any.
+   * \returns false on error, see error(). */
+  bool open(const std::string& filename) {
+    close();
+    if (!m_file.open(filename)) return false;
+    m_error = internal::binary_file_check(m_file.data(), m_file.size(), m_header);
+    if (m_error != BinaryFileSuccess) m_file.close();
+    return m_error == BinaryFileSuccess;
+  }
+
+  /** Closes the file. The views returned previously are no longer valid. */
+  void close() {
+    m_file.close();
+    m_error = BinaryFileCannotOpen;
+  }
+
+  /** \returns true if a valid file is opened. */
+  bool isOpen() const { return m_file.isOpen(); }
+
+  /** \returns BinaryFileSuccess, or the reason why the last call to open(), verifyChecksums() or validateIndices()
+   * failed. */
+  BinaryFileError error() const { return m_error; }
+
+  /** \returns the version of the format of the file. */
+  int version() const { return isOpen() ? int(m_header.version) : 0; }
+
+  /** \returns the kind of object stored in the file. */
+  BinaryFileKind kind() const {
+    eigen_assert(isOpen());
+    return BinaryFileKind(m_header.kind);
+  }
+
+  /** \returns the number of dimensions, 2 for dense and sparse matrices. */
+  Index rank() const { return isOpen() ? Index(m_header.rank) : 0; }
+
+  /** \returns the size of the dimension \a i. */
+  Index dimension(Index i) const {
+    eigen_assert(isOpen() && i >= 0 && i < rank());
+    return Index(m_header.dims[i]);
+  }
+
+  /** \returns the number of rows of a dense or sparse matrix. */
+  Index rows() const { return dimension(0); }
+
+  /** \returns the number of columns of a dense or sparse matrix. */
+  Index cols() const { return dimension(1); }
+
+  /** \returns the number of nonzeros of a sparse matrix, and the number of coefficients otherwise. */
+  Index nonZeros() const {
+    uint64_t count = 0;
+    if (isOpen()) internal::binary_file_element_count(m_header, count);
+    return Index(count);
+  }
+
+  /** \returns true if the data is stored in row-major order. */
+  bool isRowMajor() const { return isOpen() && (m_header.flags & internal::binary_file_row_major); }
+
+  /** \returns true if the file stores checksums. */
+  bool hasChecksums() const { return isOpen() && (m_header.flags & internal::binary_file_has_checksums); }
+
+  /** \returns true if the file holds an object that can be viewed as a \c T, that is a Matrix or an Array
+   * (see matrix()), a SparseMatrix (see sparse()) or a Tensor (see tensor()) with the same scalar type, storage
+   * order and, for sparse matrices, index type. */
+  template <typename T>
+  bool is() const {
+    return isOpen() && internal::binary_file_traits<T>::matches(m_header);
+  }
+
+  /** \returns a view of the dense matrix or array of type \a MatrixType stored in the file.
+   * \pre is<MatrixType>() */
+  template <typename MatrixType>
+  Map<const MatrixType, MapAlignment> matrix() const {
+    eigen_assert(is<MatrixType>() && "the file does not hold a matrix of this type");
+    return Map<const MatrixType, MapAlignment>(section<typename MatrixType::Scalar>(m_header.data_offset),
+                                               rows(), cols());
+  }
+
+  /** \returns a view of the sparse matrix of type \a SparseMatrixType stored in the file. The view is in
+   * compressed mode.
+   * \pre is<SparseMatrixType>() */
+  template <typename SparseMatrixType>
+  Map<const SparseMatrixType> sparse() const {
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    eigen_assert(is<SparseMatrixType>() && "the file does not hold a sparse matrix of this type");
+    return Map<const SparseMatrixType>(rows(), cols(), nonZeros(), section<StorageIndex>(m_header.outer_index_offset),
+                                       section<StorageIndex>(m_header.inner_index_offset),
+                                       section<typename SparseMatrixType::Scalar>(m_header.data_offset));
+  }
+
+  /** \returns a view of the tensor of type \a TensorType stored in the file.
+   * \pre is<TensorType>() */
+  template <typename TensorType>
+  TensorMap<const TensorType, Aligned> tensor() const {
+    typedef typename TensorType::Index TensorIndex;
+    eigen_assert(is<TensorType>() && "the file does not hold a tensor of this type");
+    array<TensorIndex, TensorType::NumIndices> dims;
+    for (int i = 0; i < TensorType::NumIndices; ++i) dims[i] = TensorIndex(m_header.dims[i]);
+    return TensorMap<const TensorType, Aligned>(section<typename TensorType::Scalar>(m_header.data_offset), dims);
+  }
+
+  /** Checks the content of the file against its checksums, reading the whole file.
+   * \returns true if all the checksums match or the file has none, and false with error()
+   * set to BinaryFileChecksumMismatch otherwise. */
+  bool verifyChecksums() {
+    if (!isOpen()) return false;
+    if (!hasChecksums()) return true;
+    const uint8_t* data = m_file.data();
+    const uint8_t* values = data + m_header.data_offset;
+    const uint8_t* checksums = data + m_header.checksum_offset;
+    const std::size_t scalar_size = m_header.scalar_size;
+    for (uint64_t j = 0; j < m_header.outer_size; ++j) {
+      uint64_t checksum;
+      if (m_header.kind == BinaryFileSparse) {
+        const uint8_t* outer = data + m_header.outer_index_offset;
+        const int64_t start = internal::binary_file_read_index(outer, m_header.index_size, j);
+        const int64_t end = internal::binary_file_read_index(outer, m_header.index_size, j + 1);
+        if (start < 0 || end < start || uint64_t(end) > m_header.nnz) return checksumMismatch();
+        checksum = internal::binary_file_sparse_checksum(values + uint64_t(start) * scalar_size,
+                                                         data + m_header.inner_index_offset +
+                                                             uint64_t(start) * m_header.index_size,
+                                                         uint64_t(end - start), scalar_size, m_header.index_size);
+      } else {
+        const std::size_t bytes = std::size_t(internal::binary_file_inner_size(m_header)) * scalar_size;
+        checksum = internal::binary_file_checksum(values + j * bytes, bytes);
+      }
+      uint64_t stored;
+      std::memcpy(&stored, checksums + j * sizeof(uint64_t), sizeof(uint64_t));
+      if (checksum != stored) return checksumMismatch();
+    }
+    return true;
+  }
+
+  /** Checks that the outer indices of a sparse matrix are nondecreasing from 0 to nonZeros(), and that its inner
+   * indices are within the inner dimension, reading all the indices.
+   * \returns true if the indices are valid or the file does not hold a sparse matrix, and false with error() set
+   * to BinaryFileBadIndices otherwise. */
+  bool validateIndices() {
+    if (!isOpen()) return false;
+    if (m_header.kind != BinaryFileSparse) return true;
+    const uint8_t* outer = m_file.data() + m_header.outer_index_offset;
+    const uint8_t* inner = m_file.data() + m_header.inner_index_offset;
+    const uint32_t index_size = m_header.index_size;
+    const int64_t inner_size = int64_t(internal::binary_file_inner_size(m_header));
+    // open() checked the first and last outer indices.
+    int64_t start = 0;
+    for (uint64_t j = 0; j < m_header.outer_size; ++j) {
+      const int64_t end = internal::binary_file_read_index(outer, index_size, j + 1);
+      if (end < start || uint64_t(end) > m_header.nnz) return badIndices();
+      for (int64_t k = start; k < end; ++k) {
+        const int64_t i = internal::binary_file_read_index(inner, index_size, uint64_t(k));
+        if (i < 0 || i >= inner_size) return badIndices();
+      }
+      start = end;
+    }
+    return true;
+  }
+
+ private:
+  template <typename Scalar>
+  const Scalar* section(uint64_t offset) const {
+    return reinterpret_cast<const Scalar*>(m_file.data() + offset);
+  }
+
+  bool checksumMismatch() {
+    m_error = BinaryFileChecksumMismatch;
+    return false;
+  }
+
+  bool badIndices() {
+    m_error = BinaryFileBadIndices;
+    return false;
+  }
+
+  MappedFile m_file;
+  internal::binary_file_header m_header;
+  BinaryFileError m_error;
+};
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_BINARY_FORMAT_H
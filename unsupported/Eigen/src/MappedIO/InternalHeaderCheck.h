@@ -0,0 +1,3 @@
+#ifndef EIGEN_MAPPED_IO_MODULE_H
+#error "Please include unsupported/Eigen/MappedIO instead of including headers inside the src directory directly."
+#endif
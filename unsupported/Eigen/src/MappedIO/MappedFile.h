@@ -0,0 +1,151 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MAPPED_FILE_H
+#define EIGEN_MAPPED_FILE_H
+
+// IWYU pragma: private
+#include "./InternalHeaderCheck.h"
+
+#ifndef EIGEN_MAPPED_IO_USE_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define EIGEN_MAPPED_IO_USE_MMAP 1
+#else
+#define EIGEN_MAPPED_IO_USE_MMAP 0
+#endif
+#endif
+
+#if EIGEN_MAPPED_IO_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Eigen {
+
+/** \ingroup MappedIO_Module
+ *
+ * \brief Read-only view of the content of a file
+ *
+ * The file is memory-mapped on POSIX systems, so that opening it does not read
+ * any data, and pages are loaded on first access. On other systems, the file
+ * is read into a buffer aligned on 64 bytes.
+ *
+ * The data stays valid until the file is closed or the object is destroyed.
+ */
+class MappedFile {
+ public:
+  MappedFile() : m_data(nullptr), m_size(0), m_mapped(false), m_open(false) {}
+
+  /** Opens \a filename, see open(). */
+  explicit MappedFile(const std::string& filename) : m_data(nullptr), m_size(0), m_mapped(false), m_open(false) {
+    open(filename);
+  }
+
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /** Maps the whole content of \a filename, closing the previously opened file if any.
+   * \returns false if the file cannot be opened or mapped. */
+  bool open(const std::string& filename) {
+    close();
+#if EIGEN_MAPPED_IO_USE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size > 0) {
+      void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        m_size = 0;
+        return false;
+      }
+      m_data = static_cast<const uint8_t*>(data);
+      m_mapped = true;
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    m_open = true;
+    return true;
+#else
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr) return false;
+    const long long size = file_size(file);
+    bool ok = size >= 0 && static_cast<unsigned long long>(size) <= (std::numeric_limits<std::size_t>::max)() &&
+              std::fseek(file, 0, SEEK_SET) == 0;
+    if (ok && size > 0) {
+      uint8_t* data = static_cast<uint8_t*>(internal::handmade_aligned_malloc(static_cast<std::size_t>(size), 64));
+      ok = data != nullptr && std::fread(data, 1, static_cast<std::size_t>(size), file) == std::size_t(size);
+      if (ok) {
+        m_data = data;
+        m_size = static_cast<std::size_t>(size);
+      } else {
+        internal::handmade_aligned_free(data);
+      }
+    }
+    std::fclose(file);
+    m_open = ok;
+    return ok;
+#endif
+  }
+
+  /** Releases the mapping. The data returned by data() is no longer valid. */
+  void close() {
+    if (m_data != nullptr) {
+#if EIGEN_MAPPED_IO_USE_MMAP
+      if (m_mapped) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+#else
+      internal::handmade_aligned_free(const_cast<uint8_t*>(m_data));
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_open = false;
+  }
+
+  /** \returns true if a file is opened. */
+  bool isOpen() const { return m_open; }
+
+  /** \returns whether the file is memory-mapped, rather than read into memory. */
+  bool isMapped() const { return m_mapped; }
+
+  /** \returns a pointer to the content of the file, aligned on 64 bytes at least, or nullptr if the file is empty. */
+  const uint8_t* data() const { return m_data; }
+
+  /** \returns the size of the file in bytes. */
+  std::size_t size() const { return m_size; }
+
+ private:
+#if !EIGEN_MAPPED_IO_USE_MMAP
+  // Size of an opened file, or -1 on failure. std::ftell returns a long, which is 32-bit on Windows.
+  static long long file_size(std::FILE* file) {
+#ifdef _WIN32
+    return _fseeki64(file, 0, SEEK_END) == 0 ? _ftelli64(file) : -1;
+#else
+    return std::fseek(file, 0, SEEK_END) == 0 ? std::ftell(file) : -1;
+#endif
+  }
+#endif
+
+  const uint8_t* m_data;
+  std::size_t m_size;
+  bool m_mapped;
+  bool m_open;
+};
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_MAPPED_FILE_H
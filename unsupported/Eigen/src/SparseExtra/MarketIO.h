@@ -11,7 +11,9 @@
 #ifndef EIGEN_SPARSE_MARKET_IO_H
 #define EIGEN_SPARSE_MARKET_IO_H
 
+#include <cstdio>
 #include <iostream>
+#include <string>
 #include <vector>
 
 // IWYU pragma: private
@@ -20,38 +22,54 @@
 namespace Eigen {
 
 namespace internal {
-template <typename Scalar, typename StorageIndex>
-inline void GetMarketLine(const char* line, StorageIndex& i, StorageIndex& j, Scalar& value) {
-  std::stringstream sline(line);
-  sline >> i >> j >> value;
-}
-
-template <>
-inline void GetMarketLine(const char* line, int& i, int& j, float& value) {
-  std::sscanf(line, "%d %d %g", &i, &j, &value);
-}
 
-template <>
-inline void GetMarketLine(const char* line, int& i, int& j, double& value) {
-  std::sscanf(line, "%d %d %lg", &i, &j, &value);
+// Minimum size of the chunks of a file parsed in parallel.
+const std::ptrdiff_t market_min_chunk_bytes = 1 << 20;
+// Number of entries formatted by each task of saveMarket.
+const Index market_entries_per_task = 1 << 16;
+
+// Extracts the next blank-separated token of [p, end).
+inline bool market_next_token(const char*& p, const char* end, const char*& first, const char*& last) {
+  first = text_io_skip_blanks(p, end);
+  last = first;
+  while (last < end && !text_io_is_blank(*last)) ++last;
+  p = last;
+  return first != last;
 }
 
-template <>
-inline void GetMarketLine(const char* line, int& i, int& j, std::complex<float>& value) {
-  std::sscanf(line, "%d %d %g %g", &i, &j, &numext::real_ref(value), &numext::imag_ref(value));
+template <typename Scalar>
+inline bool market_parse_value(const char*& p, const char* end, Scalar& value) {
+  const char *first, *last;
+  return market_next_token(p, end, first, last) && text_io_parse(first, last, value);
 }
 
-template <>
-inline void GetMarketLine(const char* line, int& i, int& j, std::complex<double>& value) {
-  std::sscanf(line, "%d %d %lg %lg", &i, &j, &numext::real_ref(value), &numext::imag_ref(value));
+template <typename RealScalar>
+inline bool market_parse_value(const char*& p, const char* end, std::complex<RealScalar>& value) {
+  RealScalar re, im;
+  if (!market_parse_value(p, end, re) || !market_parse_value(p, end, im)) return false;
+  value = std::complex<RealScalar>(re, im);
+  return true;
 }
 
+// Parses the coordinate entries of the lines of [p, end) into entries, skipping blank and comment lines.
+// Returns false on a malformed line or an out of range index.
 template <typename Scalar, typename StorageIndex>
-inline void GetMarketLine(const char* line, StorageIndex& i, StorageIndex& j, std::complex<Scalar>& value) {
-  std::stringstream sline(line);
-  Scalar valR, valI;
-  sline >> i >> j >> valR >> valI;
-  value = std::complex<Scalar>(valR, valI);
+bool market_parse_entries(const char* p, const char* end, Index rows, Index cols,
+                          std::vector<Triplet<Scalar, StorageIndex> >& entries) {
+  while (p < end) {
+    const char* line_end = text_io_line_end(p, end);
+    const char* q = text_io_skip_blanks(p, line_end);
+    if (q < line_end && *q != '%') {
+      Index i, j;
+      Scalar value;
+      if (!market_parse_value(q, line_end, i) || !market_parse_value(q, line_end, j) ||
+          !market_parse_value(q, line_end, value) || i < 1 || j < 1 || i > rows || j > cols)
+        return false;
+      entries.push_back(Triplet<Scalar, StorageIndex>(StorageIndex(i - 1), StorageIndex(j - 1), value));
+    }
+    p = line_end + 1;
+  }
+  return true;
 }
 
 template <typename RealScalar>
@@ -89,13 +107,27 @@ inline void putMarketHeader(std::string& header, int sym) {
   }
 }
 
-template <typename Scalar, typename StorageIndex>
-inline void PutMatrixElt(Scalar value, StorageIndex row, StorageIndex col, std::ofstream& out) {
-  out << row << " " << col << " " << value << "\n";
+// Appends value with the shortest representation which reads back to the same value.
+template <typename Scalar>
+inline void market_put_value(std::string& out, const Scalar& value) {
+  text_io_put(out, value, 0);
 }
-template <typename Scalar, typename StorageIndex>
-inline void PutMatrixElt(std::complex<Scalar> value, StorageIndex row, StorageIndex col, std::ofstream& out) {
-  out << row << " " << col << " " << value.real() << " " << value.imag() << "\n";
+
+template <typename RealScalar>
+inline void market_put_value(std::string& out, const std::complex<RealScalar>& value) {
+  text_io_put(out, value.real(), 0);
+  out += ' ';
+  text_io_put(out, value.imag(), 0);
+}
+
+template <typename Scalar>
+inline void market_put_entry(std::string& out, Index row, Index col, const Scalar& value) {
+  market_put_value(out, row);
+  out += ' ';
+  market_put_value(out, col);
+  out += ' ';
+  market_put_value(out, value);
+  out += '\n';
 }
 
 template <typename Scalar>
@@ -147,6 +179,9 @@ inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscompl
  * \ingroup SparseExtra_Module
  * @brief Loads a sparse matrix from a matrixmarket format file.
  *
+ * The file is memory-mapped when possible and split into chunks of whole lines, which are parsed in parallel
+ * according to Eigen::nbThreads() (see also setGemmThreadPool() with EIGEN_GEMM_THREADPOOL).
+ *
  * @tparam SparseMatrixType to read into, symmetries are not supported
  * @param mat SparseMatrix to read into, current values are overwritten
  * @param filename to parse matrix from
@@ -156,59 +191,78 @@ template <typename SparseMatrixType>
 bool loadMarket(SparseMatrixType& mat, const std::string& filename) {
   typedef typename SparseMatrixType::Scalar Scalar;
   typedef typename SparseMatrixType::StorageIndex StorageIndex;
-  std::ifstream input(filename.c_str(), std::ios::in);
-  if (!input) return false;
-
-  char rdbuffer[4096];
-  input.rdbuf()->pubsetbuf(rdbuffer, 4096);
-
-  const int maxBuffersize = 2048;
-  char buffer[maxBuffersize];
-
-  bool readsizes = false;
-
   typedef Triplet<Scalar, StorageIndex> T;
-  std::vector<T> elements;
+  MappedFile file(filename);
+  if (!file.isOpen()) return false;
+
+  // Skip the header, the comments and the blank lines, as between the entries
+  // NOTE An appropriate test should be done on the header to get the  symmetry
+  const char* p = reinterpret_cast<const char*>(file.data());
+  const char* end = p + file.size();
+  const char* line_end = internal::text_io_line_end(p, end);
+  while (p < end) {
+    const char* q = internal::text_io_skip_blanks(p, line_end);
+    if (q < line_end && *q != '%') break;
+    p = internal::text_io_next_line(p, end);
+    line_end = internal::text_io_line_end(p, end);
+  }
 
   Index M(-1), N(-1), NNZ(-1);
-  Index count = 0;
-  while (input.getline(buffer, maxBuffersize)) {
-    // skip comments
-    // NOTE An appropriate test should be done on the header to get the  symmetry
-    if (buffer[0] == '%') continue;
-
-    if (!readsizes) {
-      std::stringstream line(buffer);
-      line >> M >> N >> NNZ;
-      if (M > 0 && N > 0) {
-        readsizes = true;
-        mat.resize(M, N);
-        mat.reserve(NNZ);
-        elements.reserve(NNZ);
-      }
-    } else {
-      StorageIndex i(-1), j(-1);
-      Scalar value;
-      internal::GetMarketLine(buffer, i, j, value);
-
-      i--;
-      j--;
-      if (i >= 0 && j >= 0 && i < M && j < N) {
-        ++count;
-        elements.push_back(T(i, j, value));
-      } else {
-        std::cerr << "Invalid read: " << i << "," << j << "\n";
-        return false;
-      }
+  if (!internal::market_parse_value(p, line_end, M) || !internal::market_parse_value(p, line_end, N) ||
+      !internal::market_parse_value(p, line_end, NNZ) || M < 0 || N < 0 || NNZ < 0) {
+    std::cerr << "Invalid matrix size in " << filename << "\n";
+    return false;
+  }
+  p = internal::text_io_next_line(p, end);
+  mat.resize(M, N);
+
+  // The entries are parsed by chunks of whole lines, in parallel when possible.
+  const std::ptrdiff_t bytes = end - p;
+  const int threads = nbThreads();
+  const int tasks =
+      threads > 1 ? int(numext::mini<std::ptrdiff_t>(4 * threads, bytes / internal::market_min_chunk_bytes + 1)) : 1;
+  std::vector<const char*> bounds(tasks + 1);
+  bounds[0] = p;
+  bounds[tasks] = end;
+  for (int k = 1; k < tasks; ++k)
+    bounds[k] = numext::maxi(bounds[k - 1], internal::text_io_next_line(p + bytes / tasks * k, end));
+
+  std::vector<std::vector<T> > chunks(tasks);
+  std::vector<char> parsed(tasks, 0);
+  internal::parallelize_tasks(
+      [&](int k) {
+        chunks[k].reserve(std::size_t(bytes > 0 ? double(NNZ) * double(bounds[k + 1] - bounds[k]) / double(bytes) : 0));
+        parsed[k] = internal::market_parse_entries(bounds[k], bounds[k + 1], M, N, chunks[k]);
+      },
+      tasks);
+  for (int k = 0; k < tasks; ++k) {
+    if (!parsed[k]) {
+      std::cerr << "Invalid entry in " << filename << "\n";
+      return false;
     }
   }
 
+  std::vector<T> elements;
+  if (tasks == 1) {
+    elements.swap(chunks[0]);
+  } else {
+    std::vector<std::size_t> offsets(tasks + 1, 0);
+    for (int k = 0; k < tasks; ++k) offsets[k + 1] = offsets[k] + chunks[k].size();
+    elements.resize(offsets[tasks]);
+    internal::parallelize_tasks(
+        [&](int k) {
+          std::copy(chunks[k].begin(), chunks[k].end(), elements.begin() + offsets[k]);
+          std::vector<T>().swap(chunks[k]);
+        },
+        tasks);
+  }
+
+  const Index count = Index(elements.size());
   mat.setFromTriplets(elements.begin(), elements.end());
   if (count != NNZ) {
     std::cerr << count << "!=" << NNZ << "\n";
     return false;
   }
-  input.close();
   return true;
 }
 
@@ -289,6 +343,8 @@ bool loadMarketVector(VectorType& vec, const std::string& filename) {
  * \ingroup SparseExtra_Module
  * @brief writes a sparse Matrix to a marketmarket format file
  *
+ * The entries are formatted by blocks, in parallel according to Eigen::nbThreads(), and written in large buffers.
+ *
  * @tparam SparseMatrixType to write to file
  * @param mat matrix to write to file
  * @param filename filename to write to
@@ -298,25 +354,43 @@ bool loadMarketVector(VectorType& vec, const std::string& filename) {
 template <typename SparseMatrixType>
 bool saveMarket(const SparseMatrixType& mat, const std::string& filename, int sym = 0) {
   typedef typename SparseMatrixType::Scalar Scalar;
-  typedef typename SparseMatrixType::RealScalar RealScalar;
-  std::ofstream out(filename.c_str(), std::ios::out);
+  std::FILE* out = std::fopen(filename.c_str(), "wb");
   if (!out) return false;
 
-  out.flags(std::ios_base::scientific);
-  out.precision(std::numeric_limits<RealScalar>::digits10 + 2);
   std::string header;
   internal::putMarketHeader<Scalar>(header, sym);
-  out << header << std::endl;
-  out << mat.rows() << " " << mat.cols() << " " << mat.nonZeros() << "\n";
-  int count = 0;
-  EIGEN_UNUSED_VARIABLE(count);
-  for (int j = 0; j < mat.outerSize(); ++j)
-    for (typename SparseMatrixType::InnerIterator it(mat, j); it; ++it) {
-      ++count;
-      internal::PutMatrixElt(it.value(), it.row() + 1, it.col() + 1, out);
-    }
-  out.close();
-  return true;
+  header += '\n';
+  internal::market_put_value(header, mat.rows());
+  header += ' ';
+  internal::market_put_value(header, mat.cols());
+  header += ' ';
+  internal::market_put_value(header, mat.nonZeros());
+  header += '\n';
+  bool ok = std::fwrite(header.data(), 1, header.size(), out) == header.size();
+
+  // The outer vectors are formatted by blocks of about market_entries_per_task entries, in parallel when possible,
+  // and the blocks are written in order.
+  const Index outer = mat.outerSize();
+  const Index average_nnz = numext::maxi<Index>(1, mat.nonZeros() / numext::maxi<Index>(1, outer));
+  const Index outer_per_task = numext::maxi<Index>(1, internal::market_entries_per_task / average_nnz);
+  const int tasks = int(numext::mini<Index>(nbThreads(), numext::div_ceil(outer, outer_per_task)));
+  std::vector<std::string> buffers(numext::maxi(tasks, 1));
+  for (Index first = 0; ok && first < outer; first += tasks * outer_per_task) {
+    internal::parallelize_tasks(
+        [&](int k) {
+          std::string& buffer = buffers[k];
+          buffer.clear();
+          const Index start = numext::mini(outer, first + k * outer_per_task);
+          const Index stop = numext::mini(outer, start + outer_per_task);
+          for (Index j = start; j < stop; ++j)
+            for (typename SparseMatrixType::InnerIterator it(mat, j); it; ++it)
+              internal::market_put_entry(buffer, it.row() + 1, it.col() + 1, it.value());
+        },
+        tasks);
+    for (int k = 0; ok && k < tasks; ++k)
+      ok = std::fwrite(buffers[k].data(), 1, buffers[k].size(), out) == buffers[k].size();
+  }
+  return (std::fclose(out) == 0) && ok;
 }
 
 /**
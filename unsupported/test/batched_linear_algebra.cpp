@@ -0,0 +1,152 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/BatchedLinearAlgebra>
+
+template <typename Scalar>
+void fill_random(CompactBatch<Scalar>& batch, std::vector<Matrix<Scalar, Dynamic, Dynamic> >& matrices) {
+  matrices.resize(batch.batchSize());
+  for (Index b = 0; b < batch.batchSize(); ++b) {
+    matrices[b] = Matrix<Scalar, Dynamic, Dynamic>::Random(batch.rows(), batch.cols());
+    batch.set(b, matrices[b]);
+  }
+}
+
+template <typename Scalar>
+void test_compact_layout() {
+  typedef CompactBatch<Scalar> Batch;
+  const Index lanes = Batch::LaneCount;
+  Batch batch(2 * lanes + 1, 3, 2);
+  VERIFY_IS_EQUAL(batch.groupCount(), 3);
+  for (Index b = 0; b < batch.batchSize(); ++b)
+    for (Index j = 0; j < 2; ++j)
+      for (Index i = 0; i < 3; ++i) batch(b, i, j) = Scalar(100 * b + 10 * i + j);
+  // Same coefficient of consecutive matrices are contiguous.
+  const Scalar* g1 = batch.groupData(1);
+  for (Index l = 0; l < lanes; ++l) {
+    VERIFY_IS_EQUAL(g1[l], Scalar(100 * (lanes + l)));
+    VERIFY_IS_EQUAL(g1[(1 * 3 + 2) * lanes + l], Scalar(100 * (lanes + l) + 21));
+  }
+  Matrix<Scalar, 3, 2> m;
+  m << 1, 2, 3, 4, 5, 6;
+  batch.set(lanes + 1, m);
+  VERIFY_IS_EQUAL(batch.get(lanes + 1), m);
+}
+
+template <typename Scalar>
+void test_gemm(Index batch_size, Index m, Index n, Index k) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  CompactBatch<Scalar> a(batch_size, m, k), b(batch_size, k, n), c(batch_size, m, n);
+  std::vector<MatrixType> ma, mb, mc;
+  fill_random(a, ma);
+  fill_random(b, mb);
+  fill_random(c, mc);
+
+  const Scalar alpha = internal::random<Scalar>();
+  const Scalar beta = internal::random<Scalar>();
+  batchedGemm(a, b, c, alpha, beta);
+  for (Index i = 0; i < batch_size; ++i) VERIFY_IS_APPROX(c.get(i), alpha * ma[i] * mb[i] + beta * mc[i]);
+
+  // beta == 0 resizes and ignores the destination.
+  CompactBatch<Scalar> d;
+  batchedGemm(a, b, d);
+  VERIFY_IS_EQUAL(d.batchSize(), batch_size);
+  for (Index i = 0; i < batch_size; ++i) VERIFY_IS_APPROX(d.get(i), ma[i] * mb[i]);
+
+  // Pointer array variant, on blocks of larger matrices.
+  const Index lda = m + 1, ldb = k + 2, ldc = m + 3;
+  std::vector<MatrixType> pa(batch_size), pb(batch_size), pc(batch_size), ref(batch_size);
+  std::vector<const Scalar*> ptr_a(batch_size), ptr_b(batch_size);
+  std::vector<Scalar*> ptr_c(batch_size);
+  for (Index i = 0; i < batch_size; ++i) {
+    pa[i] = MatrixType::Random(lda, k);
+    pb[i] = MatrixType::Random(ldb, n);
+    pc[i] = MatrixType::Random(ldc, n);
+    ref[i] = pc[i];
+    ref[i].topRows(m) = alpha * pa[i].topRows(m) * pb[i].topRows(k) + beta * pc[i].topRows(m);
+    ptr_a[i] = pa[i].data();
+    ptr_b[i] = pb[i].data();
+    ptr_c[i] = pc[i].data();
+  }
+  batchedGemm(batch_size, m, n, k, alpha, ptr_a.data(), lda, ptr_b.data(), ldb, beta, ptr_c.data(), ldc);
+  for (Index i = 0; i < batch_size; ++i) {
+    VERIFY_IS_APPROX(pc[i].topRows(m), ref[i].topRows(m));
+    VERIFY_IS_EQUAL(pc[i].bottomRows(ldc - m), ref[i].bottomRows(ldc - m));
+  }
+}
+
+template <int Mode, typename Scalar>
+void test_triangular_solve(Index batch_size, Index m, Index n) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  CompactBatch<Scalar> a(batch_size, m, m), b(batch_size, m, n);
+  std::vector<MatrixType> ma, mb;
+  fill_random(a, ma);
+  for (Index i = 0; i < batch_size; ++i) {
+    // Make the triangular part well conditioned.
+    ma[i].diagonal().array() += Scalar(2 * m);
+    a.set(i, ma[i]);
+  }
+  fill_random(b, mb);
+  batchedTriangularSolve<Mode>(a, b);
+  for (Index i = 0; i < batch_size; ++i) {
+    MatrixType x = ma[i].template triangularView<Mode>().solve(mb[i]);
+    VERIFY_IS_APPROX(b.get(i), x);
+  }
+}
+
+template <typename Scalar>
+void test_llt(Index batch_size, Index m) {
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  CompactBatch<Scalar> a(batch_size, m, m);
+  std::vector<MatrixType> spd(batch_size);
+  for (Index i = 0; i < batch_size; ++i) {
+    MatrixType r = MatrixType::Random(m, m);
+    spd[i] = r * r.transpose() + MatrixType::Identity(m, m) * Scalar(m);
+    a.set(i, spd[i]);
+  }
+  VERIFY_IS_EQUAL(batchedLLT(a), Success);
+  for (Index i = 0; i < batch_size; ++i) {
+    MatrixType l = a.get(i).template triangularView<Lower>();
+    VERIFY_IS_APPROX(MatrixType(l * l.transpose()), spd[i]);
+    VERIFY_IS_APPROX(l, MatrixType(spd[i].llt().matrixL()));
+  }
+
+  // Failures are reported per matrix, padding lanes are ignored.
+  if (batch_size < 2) return;
+  a.resize(batch_size, m, m);
+  for (Index i = 0; i < batch_size; ++i) a.set(i, spd[i]);
+  a.set(1, MatrixType(-spd[1]));
+  std::vector<Index> failed;
+  VERIFY_IS_EQUAL(batchedLLT(a, &failed), NumericalIssue);
+  VERIFY_IS_EQUAL(failed.size(), 1u);
+  VERIFY_IS_EQUAL(failed[0], 1);
+  MatrixType l0 = a.get(0).template triangularView<Lower>();
+  VERIFY_IS_APPROX(MatrixType(l0 * l0.transpose()), spd[0]);
+}
+
+EIGEN_DECLARE_TEST(batched_linear_algebra) {
+  CALL_SUBTEST_1(test_compact_layout<float>());
+  CALL_SUBTEST_1(test_compact_layout<double>());
+  for (int i = 0; i < g_repeat; ++i) {
+    CALL_SUBTEST_2(test_gemm<float>(internal::random<Index>(1, 67), 8, 8, 8));
+    CALL_SUBTEST_2(test_gemm<float>(internal::random<Index>(1, 67), internal::random<Index>(1, 32),
+                                    internal::random<Index>(1, 32), internal::random<Index>(1, 32)));
+    CALL_SUBTEST_3(test_gemm<double>(internal::random<Index>(1, 67), internal::random<Index>(1, 32),
+                                     internal::random<Index>(1, 32), internal::random<Index>(0, 32)));
+    CALL_SUBTEST_4(test_gemm<std::complex<float> >(internal::random<Index>(1, 33), internal::random<Index>(1, 16),
+                                                   internal::random<Index>(1, 16), internal::random<Index>(1, 16)));
+    CALL_SUBTEST_5((test_triangular_solve<Lower, float>(internal::random<Index>(1, 67), internal::random<Index>(1, 24),
+                                                        internal::random<Index>(1, 8))));
+    CALL_SUBTEST_5((test_triangular_solve<UnitUpper, double>(
+        internal::random<Index>(1, 67), internal::random<Index>(1, 24), internal::random<Index>(1, 8))));
+    CALL_SUBTEST_5((test_triangular_solve<Upper, double>(internal::random<Index>(1, 67),
+                                                         internal::random<Index>(1, 24), internal::random<Index>(1, 8))));
+    CALL_SUBTEST_6(test_llt<float>(internal::random<Index>(1, 67), internal::random<Index>(1, 16)));
+    CALL_SUBTEST_6(test_llt<double>(internal::random<Index>(1, 67), internal::random<Index>(1, 24)));
+  }
+}
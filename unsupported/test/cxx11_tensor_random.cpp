@@ -67,6 +67,28 @@ static void test_custom() {
   }
 }
 
+template <typename Scalar>
+static void test_philox() {
+  typedef Eigen::internal::PhiloxUniformRandomGenerator<Scalar> Generator;
+  Tensor<Scalar, 2> t1(37, 11);
+  t1 = t1.random(Generator(42));
+  Tensor<Scalar, 2> t2(37, 11);
+  t2 = t2.random(Generator(42));
+  Tensor<Scalar, 2> t3(37, 11);
+  t3 = t3.random(Generator(43));
+  bool differ = false;
+  for (int j = 0; j < 11; ++j) {
+    for (int i = 0; i < 37; ++i) {
+      VERIFY_IS_EQUAL(t1(i, j), t2(i, j));
+      // coefficients match the ones of a matrix generated with the same seed
+      VERIFY_IS_EQUAL(t1(i, j), Scalar(0.5) * (MatrixX<Scalar>::Random(37, 11, Philox(42))(i, j) + Scalar(1)));
+      VERIFY(t1(i, j) >= Scalar(0) && t1(i, j) < Scalar(1));
+      differ = differ || t1(i, j) != t3(i, j);
+    }
+  }
+  VERIFY(differ);
+}
+
 EIGEN_DECLARE_TEST(cxx11_tensor_random) {
   CALL_SUBTEST((test_default<float>()));
   CALL_SUBTEST((test_normal<float>()));
@@ -77,4 +99,6 @@ EIGEN_DECLARE_TEST(cxx11_tensor_random) {
   CALL_SUBTEST((test_default<Eigen::bfloat16>()));
   CALL_SUBTEST((test_normal<Eigen::bfloat16>()));
   CALL_SUBTEST(test_custom());
+  CALL_SUBTEST((test_philox<float>()));
+  CALL_SUBTEST((test_philox<double>()));
 }
@@ -0,0 +1,167 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_USE_THREADS
+
+#include "main.h"
+#include <algorithm>
+#include <limits>
+#include <Eigen/CXX11/Tensor>
+
+using Eigen::Tensor;
+
+template <int DataLayout>
+static void test_simple_sort() {
+  Tensor<int, 2, DataLayout> a(2, 4);
+  a.setValues({{3, 1, 4, 1}, {5, 9, 2, 6}});
+
+  Tensor<int, 2, DataLayout> sorted = a.sort(1);
+  Tensor<int, 2, DataLayout> expected(2, 4);
+  expected.setValues({{1, 1, 3, 4}, {2, 5, 6, 9}});
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      VERIFY_IS_EQUAL(sorted(i, j), expected(i, j));
+    }
+  }
+
+  Tensor<Index, 2, DataLayout> order = a.argsort(1, /*descending=*/true);
+  Tensor<Index, 2, DataLayout> expected_order(2, 4);
+  // Ties keep their original order.
+  expected_order.setValues({{2, 0, 1, 3}, {1, 3, 0, 2}});
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      VERIFY_IS_EQUAL(order(i, j), expected_order(i, j));
+    }
+  }
+
+  Tensor<int, 2, DataLayout> top = a.topk(2, 1);
+  VERIFY_IS_EQUAL(top.dimension(0), 2);
+  VERIFY_IS_EQUAL(top.dimension(1), 2);
+  VERIFY_IS_EQUAL(top(0, 0), 4);
+  VERIFY_IS_EQUAL(top(0, 1), 3);
+  VERIFY_IS_EQUAL(top(1, 0), 9);
+  VERIFY_IS_EQUAL(top(1, 1), 6);
+
+  Tensor<Index, 2, DataLayout> top_idx = a.argtopk(1, 0);
+  VERIFY_IS_EQUAL(top_idx.dimension(0), 1);
+  VERIFY_IS_EQUAL(top_idx.dimension(1), 4);
+  VERIFY_IS_EQUAL(top_idx(0, 0), 1);
+  VERIFY_IS_EQUAL(top_idx(0, 1), 1);
+  VERIFY_IS_EQUAL(top_idx(0, 2), 0);
+  VERIFY_IS_EQUAL(top_idx(0, 3), 1);
+}
+
+static void test_sort_nan() {
+  Tensor<float, 1> a(5);
+  a.setValues({2.f, std::numeric_limits<float>::quiet_NaN(), -1.f, 3.f, 0.f});
+  Tensor<float, 1> sorted = a.sort(0);
+  VERIFY_IS_EQUAL(sorted(0), -1.f);
+  VERIFY_IS_EQUAL(sorted(1), 0.f);
+  VERIFY_IS_EQUAL(sorted(2), 2.f);
+  VERIFY_IS_EQUAL(sorted(3), 3.f);
+  VERIFY((numext::isnan)(sorted(4)));
+  Tensor<float, 1> top = a.topk(2, 0);
+  VERIFY((numext::isnan)(top(0)));
+  VERIFY_IS_EQUAL(top(1), 3.f);
+}
+
+// Compares sort and top-k along each axis of a 3d tensor against
+// std::stable_sort on each line, on the default and the thread pool devices.
+template <int DataLayout>
+static void test_sort_matches_stl(int d0, int d1, int d2, bool use_thread_pool) {
+  Tensor<int, 3, DataLayout> a(d0, d1, d2);
+  a = a.random().unaryExpr([](int x) { return x % 50; });
+
+  const int num_threads = internal::random<int>(2, 8);
+  ThreadPool tp(num_threads);
+  Eigen::ThreadPoolDevice device(&tp, num_threads);
+
+  for (int axis = 0; axis < 3; ++axis) {
+    const Index size = a.dimension(axis);
+    const Index k = internal::random<Index>(1, size);
+    Tensor<int, 3, DataLayout> sorted(a.dimensions());
+    Tensor<Index, 3, DataLayout> order(a.dimensions());
+    array<Index, 3> top_dims = a.dimensions();
+    top_dims[axis] = k;
+    Tensor<int, 3, DataLayout> top(top_dims);
+    Tensor<Index, 3, DataLayout> top_idx(top_dims);
+    if (use_thread_pool) {
+      sorted.device(device) = a.sort(axis);
+      order.device(device) = a.argsort(axis);
+      top.device(device) = a.topk(k, axis);
+      top_idx.device(device) = a.argtopk(k, axis);
+    } else {
+      sorted = a.sort(axis);
+      order = a.argsort(axis);
+      top = a.topk(k, axis);
+      top_idx = a.argtopk(k, axis);
+    }
+
+    array<Index, 3> idx;
+    std::vector<std::pair<int, Index>> line(size);
+    const Index other1 = (axis + 1) % 3, other2 = (axis + 2) % 3;
+    for (Index i = 0; i < a.dimension(other1); ++i) {
+      for (Index j = 0; j < a.dimension(other2); ++j) {
+        idx[other1] = i;
+        idx[other2] = j;
+        for (Index l = 0; l < size; ++l) {
+          idx[axis] = l;
+          line[l] = std::make_pair(a(idx), l);
+        }
+        std::stable_sort(line.begin(), line.end(),
+                         [](const std::pair<int, Index>& x, const std::pair<int, Index>& y) { return x.first < y.first; });
+        for (Index l = 0; l < size; ++l) {
+          idx[axis] = l;
+          VERIFY_IS_EQUAL(sorted(idx), line[l].first);
+          VERIFY_IS_EQUAL(order(idx), line[l].second);
+        }
+        std::stable_sort(line.begin(), line.end(),
+                         [](const std::pair<int, Index>& x, const std::pair<int, Index>& y) { return x.first > y.first; });
+        for (Index l = 0; l < k; ++l) {
+          idx[axis] = l;
+          VERIFY_IS_EQUAL(top(idx), line[l].first);
+          VERIFY_IS_EQUAL(top_idx(idx), line[l].second);
+        }
+      }
+    }
+  }
+}
+
+template <int DataLayout>
+static void test_long_line(Index k) {
+  const int num_threads = internal::random<int>(2, 8);
+  ThreadPool tp(num_threads);
+  Eigen::ThreadPoolDevice device(&tp, num_threads);
+
+  const Index size = internal::random<Index>(1 << 15, 1 << 17);
+  if (k < 0) k = size;
+  Tensor<float, 1, DataLayout> a(size);
+  a.setRandom();
+  Tensor<float, 1, DataLayout> top(k);
+  top.device(device) = a.topk(k, 0);
+  Tensor<Index, 1, DataLayout> top_idx(k);
+  top_idx.device(device) = a.argtopk(k, 0);
+
+  std::vector<float> expected(a.data(), a.data() + size);
+  std::sort(expected.begin(), expected.end(), [](float x, float y) { return x > y; });
+  for (Index i = 0; i < k; ++i) {
+    VERIFY_IS_EQUAL(top(i), expected[i]);
+    VERIFY_IS_EQUAL(a(top_idx(i)), expected[i]);
+  }
+}
+
+EIGEN_DECLARE_TEST(cxx11_tensor_sort) {
+  CALL_SUBTEST(test_simple_sort<ColMajor>());
+  CALL_SUBTEST(test_simple_sort<RowMajor>());
+  CALL_SUBTEST(test_sort_nan());
+  CALL_SUBTEST(test_sort_matches_stl<ColMajor>(5, 7, 11, false));
+  CALL_SUBTEST(test_sort_matches_stl<RowMajor>(5, 7, 11, false));
+  CALL_SUBTEST(test_sort_matches_stl<ColMajor>(17, 13, 19, true));
+  CALL_SUBTEST(test_sort_matches_stl<RowMajor>(17, 13, 19, true));
+  CALL_SUBTEST(test_long_line<ColMajor>(10));
+  CALL_SUBTEST(test_long_line<RowMajor>(-1));
+}
@@ -640,6 +640,49 @@ void test_threadpool_allocate(TestAllocator* allocator) {
   VERIFY_IS_EQUAL(allocator->dealloc_count(), num_allocs);
 }
 
+template <int DataLayout, bool Exclusive>
+void test_multithread_long_scan() {
+  const int num_threads = internal::random<int>(4, 11);
+  ThreadPool tp(num_threads);
+  Eigen::ThreadPoolDevice device(&tp, num_threads);
+
+  // A single long line, scanned by blocks.
+  const int size = internal::random<int>(1 << 16, 1 << 18);
+  Tensor<int, 1, DataLayout> t1(size);
+  t1 = t1.random().unaryExpr([](int x) { return x % 100; });
+  Tensor<int, 1, DataLayout> sum(size);
+  sum.device(device) = t1.cumsum(0, Exclusive);
+  Tensor<int, 1, DataLayout> max(size);
+  max.device(device) = t1.scan(0, internal::MaxReducer<int>(), Exclusive);
+  int accum_sum = 0;
+  int accum_max = internal::MaxReducer<int>().initialize();
+  for (int i = 0; i < size; ++i) {
+    if (Exclusive) {
+      VERIFY_IS_EQUAL(sum(i), accum_sum);
+      VERIFY_IS_EQUAL(max(i), accum_max);
+    }
+    accum_sum += t1(i);
+    accum_max = numext::maxi(accum_max, t1(i));
+    if (!Exclusive) {
+      VERIFY_IS_EQUAL(sum(i), accum_sum);
+      VERIFY_IS_EQUAL(max(i), accum_max);
+    }
+  }
+
+  // A few strided lines.
+  Tensor<float, 2, DataLayout> t2(3, size);
+  t2.setRandom();
+  Tensor<float, 2, DataLayout> result(3, size);
+  result.device(device) = t2.cumsum(1, Exclusive);
+  Tensor<float, 2, DataLayout> expected(3, size);
+  expected = t2.cumsum(1, Exclusive);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < size; ++j) {
+      VERIFY_IS_APPROX(result(i, j), expected(i, j));
+    }
+  }
+}
+
 EIGEN_DECLARE_TEST(cxx11_tensor_thread_pool) {
   CALL_SUBTEST_1(test_multithread_elementwise());
   CALL_SUBTEST_1(test_async_multithread_elementwise());
@@ -685,6 +728,11 @@ EIGEN_DECLARE_TEST(cxx11_tensor_thread_pool) {
   CALL_SUBTEST_11(test_multithread_shuffle<RowMajor>(&test_allocator));
   CALL_SUBTEST_11(test_threadpool_allocate(&test_allocator));
 
+  CALL_SUBTEST_12((test_multithread_long_scan<ColMajor, false>()));
+  CALL_SUBTEST_12((test_multithread_long_scan<ColMajor, true>()));
+  CALL_SUBTEST_12((test_multithread_long_scan<RowMajor, false>()));
+  CALL_SUBTEST_12((test_multithread_long_scan<RowMajor, true>()));
+
   // Force CMake to split this test.
-  // EIGEN_SUFFIXES;1;2;3;4;5;6;7;8;9;10;11
+  // EIGEN_SUFFIXES;1;2;3;4;5;6;7;8;9;10;11;12
 }
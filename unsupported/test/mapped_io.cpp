@@ -0,0 +1,255 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/MappedIO>
+
+// Overwrites the byte at offset in filename.
+void corrupt_byte(const std::string& filename, long offset) {
+  std::FILE* file = std::fopen(filename.c_str(), "r+b");
+  VERIFY(file != nullptr);
+  std::fseek(file, offset, SEEK_SET);
+  int c = std::fgetc(file);
+  std::fseek(file, offset, SEEK_SET);
+  std::fputc(c ^ 0x5a, file);
+  std::fclose(file);
+}
+
+template <typename MatrixType>
+void test_dense(const MatrixType& m, int options) {
+  typedef typename MatrixType::Scalar Scalar;
+  std::string filename = GetTestTempFilename("mapped_io_dense.bin");
+  VERIFY(saveBinary(filename, m, options));
+
+  MappedBinaryFile file(filename);
+  VERIFY(file.isOpen());
+  VERIFY_IS_EQUAL(file.error(), BinaryFileSuccess);
+  VERIFY_IS_EQUAL(file.kind(), BinaryFileDense);
+  VERIFY_IS_EQUAL(file.rows(), m.rows());
+  VERIFY_IS_EQUAL(file.cols(), m.cols());
+  VERIFY_IS_EQUAL(file.hasChecksums(), bool(options & BinaryFileChecksums));
+  VERIFY(file.is<MatrixType>());
+  VERIFY(!file.is<SparseMatrix<Scalar> >());
+  VERIFY(!(file.is<Matrix<int16_t, Dynamic, Dynamic> >()));
+  Map<const MatrixType, MappedBinaryFile::MapAlignment> view = file.matrix<MatrixType>();
+  VERIFY_IS_EQUAL(view.matrix(), m.matrix());
+  VERIFY(file.verifyChecksums());
+
+  // Expressions are evaluated by columns, in their storage order.
+  VERIFY(saveBinary(filename, m.transpose() * Scalar(2), options));
+  VERIFY(file.open(filename));
+  typedef Matrix<Scalar, Dynamic, Dynamic, MatrixType::IsRowMajor ? ColMajor : RowMajor> TransposedType;
+  VERIFY(file.is<TransposedType>() || m.rows() == 1 || m.cols() == 1);
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
+  MatrixX expected = (m.transpose() * Scalar(2)).matrix();
+  VERIFY_IS_EQUAL(MatrixX(file.matrix<TransposedType>()), expected);
+}
+
+// Counts the evaluations of the coefficients of a nullary expression.
+struct counting_functor {
+  Index* calls;
+  double operator()(Index i, Index j) const {
+    ++*calls;
+    return double(i - 2 * j);
+  }
+};
+
+// A product is evaluated once, and not for each column written.
+template <int Options>
+void test_product(Index rows, Index depth, Index cols) {
+  typedef Matrix<double, Dynamic, Dynamic, Options> MatrixType;
+  Index calls = 0;
+  const counting_functor f = {&calls};
+  const MatrixType rhs = MatrixType::Random(depth, cols);
+  std::string filename = GetTestTempFilename("mapped_io_product.bin");
+  const auto product = MatrixType::NullaryExpr(rows, depth, f) * rhs;
+  VERIFY(saveBinary(filename, product));
+  VERIFY(calls <= rows * depth);
+
+  // The file has the storage order of the product expression.
+  typedef typename std::decay_t<decltype(product)>::PlainObject PlainObject;
+  MappedBinaryFile file(filename);
+  VERIFY(file.is<PlainObject>());
+  const MatrixXd expected = MatrixXd::NullaryExpr(rows, depth, f) * rhs;
+  VERIFY_IS_APPROX(MatrixXd(file.matrix<PlainObject>()), expected);
+}
+
+template <typename SparseMatrixType>
+void test_sparse(Index rows, Index cols, int options) {
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::StorageIndex StorageIndex;
+  SparseMatrixType m(rows, cols);
+  m.reserve(VectorXi::Constant(m.outerSize(), 4));
+  for (Index j = 0; j < m.outerSize(); ++j)
+    for (Index k = 0; k < 3; ++k) {
+      Index i = internal::random<Index>(0, m.innerSize() - 1);
+      if (SparseMatrixType::IsRowMajor)
+        m.coeffRef(j, i) = internal::random<Scalar>();
+      else
+        m.coeffRef(i, j) = internal::random<Scalar>();
+    }
+  VERIFY(!m.isCompressed());
+
+  std::string filename = GetTestTempFilename("mapped_io_sparse.bin");
+  for (int compressed = 0; compressed < 2; ++compressed) {
+    if (compressed) m.makeCompressed();
+    VERIFY(saveBinary(filename, m, options));
+    MappedBinaryFile file(filename);
+    VERIFY(file.isOpen());
+    VERIFY_IS_EQUAL(file.kind(), BinaryFileSparse);
+    VERIFY_IS_EQUAL(file.nonZeros(), m.nonZeros());
+    VERIFY(file.is<SparseMatrixType>());
+    VERIFY(!(file.is<SparseMatrix<Scalar, SparseMatrixType::IsRowMajor ? ColMajor : RowMajor, StorageIndex> >()));
+    VERIFY(!(file.is<SparseMatrix<Scalar, SparseMatrixType::Options, int64_t> >()) || sizeof(StorageIndex) == 8);
+    VERIFY(!(file.is<Matrix<Scalar, Dynamic, Dynamic> >()));
+    Map<const SparseMatrixType> view = file.sparse<SparseMatrixType>();
+    VERIFY(view.isCompressed());
+    VERIFY_IS_EQUAL(view.nonZeros(), m.nonZeros());
+    VERIFY_IS_EQUAL(view.toDense(), m.toDense());
+    VERIFY(file.verifyChecksums());
+    VERIFY(file.validateIndices());
+  }
+}
+
+template <typename TensorType>
+void test_tensor(const TensorType& t, int options) {
+  std::string filename = GetTestTempFilename("mapped_io_tensor.bin");
+  VERIFY(saveBinary(filename, t, options));
+  MappedBinaryFile file(filename);
+  VERIFY(file.isOpen());
+  VERIFY_IS_EQUAL(file.kind(), BinaryFileTensor);
+  VERIFY_IS_EQUAL(file.rank(), Index(TensorType::NumIndices));
+  VERIFY(file.is<TensorType>());
+  VERIFY(!(file.is<Tensor<typename TensorType::Scalar, TensorType::NumIndices + 1> >()));
+  TensorMap<const TensorType, Aligned> view = file.tensor<TensorType>();
+  for (int i = 0; i < TensorType::NumIndices; ++i) VERIFY_IS_EQUAL(view.dimension(i), t.dimension(i));
+  for (Index i = 0; i < t.size(); ++i) VERIFY_IS_EQUAL(view.data()[i], t.data()[i]);
+  VERIFY(file.verifyChecksums());
+}
+
+void test_checksums() {
+  MatrixXd m = MatrixXd::Random(37, 11);
+  std::string filename = GetTestTempFilename("mapped_io_checksums.bin");
+  VERIFY(saveBinary(filename, m, BinaryFileChecksums));
+  // Coefficient (5, 3), right after the 256-byte header.
+  corrupt_byte(filename, 256 + long(sizeof(double)) * (3 * 37 + 5));
+  MappedBinaryFile file(filename);
+  // Opening only checks the header.
+  VERIFY(file.isOpen());
+  VERIFY(!file.verifyChecksums());
+  VERIFY_IS_EQUAL(file.error(), BinaryFileChecksumMismatch);
+
+  SparseMatrix<float> s = MatrixXf::Random(20, 20).sparseView(0.5f, 1.0f);
+  VERIFY(saveBinary(filename, s, BinaryFileChecksums));
+  VERIFY(file.open(filename));
+  VERIFY(file.verifyChecksums());
+  // First inner index.
+  MappedFile raw(filename);
+  long inner_offset = 0;
+  {
+    internal::binary_file_header header;
+    std::memcpy(&header, raw.data(), sizeof(header));
+    inner_offset = long(header.inner_index_offset);
+  }
+  raw.close();
+  file.close();
+  corrupt_byte(filename, inner_offset);
+  VERIFY(file.open(filename));
+  VERIFY(!file.verifyChecksums());
+
+  // Without checksums, only validateIndices() detects an inner index out of range.
+  VERIFY(saveBinary(filename, s));
+  corrupt_byte(filename, inner_offset);
+  VERIFY(file.open(filename));
+  VERIFY(file.verifyChecksums());
+  VERIFY(!file.validateIndices());
+  VERIFY_IS_EQUAL(file.error(), BinaryFileBadIndices);
+}
+
+void test_errors() {
+  MappedBinaryFile file;
+  VERIFY(!file.isOpen());
+  VERIFY(!file.open(GetTestTempFilename("mapped_io_does_not_exist.bin")));
+  VERIFY_IS_EQUAL(file.error(), BinaryFileCannotOpen);
+
+  std::string filename = GetTestTempFilename("mapped_io_errors.bin");
+  std::FILE* text = std::fopen(filename.c_str(), "wb");
+  std::fputs("%%MatrixMarket matrix coordinate real general\n", text);
+  std::fclose(text);
+  VERIFY(!file.open(filename));
+  VERIFY_IS_EQUAL(file.error(), BinaryFileBadHeader);
+
+  MatrixXf m = MatrixXf::Random(10, 10);
+  VERIFY(saveBinary(filename, m));
+  // Corrupted header: the number of rows.
+  corrupt_byte(filename, long(offsetof(internal::binary_file_header, dims)));
+  VERIFY(!file.open(filename));
+  VERIFY_IS_EQUAL(file.error(), BinaryFileBadHeader);
+
+  // Truncated file.
+  VERIFY(saveBinary(filename, m));
+  {
+    MappedFile raw(filename);
+    std::vector<char> content(raw.data(), raw.data() + raw.size() - 4);
+    raw.close();
+    std::FILE* out = std::fopen(filename.c_str(), "wb");
+    std::fwrite(content.data(), 1, content.size(), out);
+    std::fclose(out);
+  }
+  VERIFY(!file.open(filename));
+  VERIFY_IS_EQUAL(file.error(), BinaryFileTruncated);
+
+  // Newer version.
+  VERIFY(saveBinary(filename, m));
+  {
+    MappedFile raw(filename);
+    internal::binary_file_header header;
+    std::memcpy(&header, raw.data(), sizeof(header));
+    std::vector<char> content(raw.data(), raw.data() + raw.size());
+    raw.close();
+    header.version = internal::binary_file_version + 1;
+    header.header_checksum = internal::binary_file_header_checksum(header);
+    std::memcpy(content.data(), &header, sizeof(header));
+    std::FILE* out = std::fopen(filename.c_str(), "wb");
+    std::fwrite(content.data(), 1, content.size(), out);
+    std::fclose(out);
+  }
+  VERIFY(!file.open(filename));
+  VERIFY_IS_EQUAL(file.error(), BinaryFileUnsupportedVersion);
+  VERIFY(!file.isOpen());
+}
+
+EIGEN_DECLARE_TEST(mapped_io) {
+  for (int i = 0; i < g_repeat; i++) {
+    Index rows = internal::random<Index>(1, 60), cols = internal::random<Index>(1, 60);
+    int options = i % 2 == 0 ? BinaryFileChecksums : BinaryFileNoChecksums;
+    CALL_SUBTEST_1(test_dense(MatrixXf::Random(rows, cols).eval(), options));
+    CALL_SUBTEST_1(test_dense(Matrix<double, Dynamic, Dynamic, RowMajor>::Random(rows, cols).eval(), options));
+    CALL_SUBTEST_1(test_dense(Matrix4d::Random().eval(), options));
+    CALL_SUBTEST_1(test_dense(VectorXcd::Random(rows).eval(), options));
+    CALL_SUBTEST_1(test_dense(ArrayXXi::Random(rows, cols).eval(), options));
+    CALL_SUBTEST_1(test_dense(MatrixXf(0, cols), options));
+
+    CALL_SUBTEST_2((test_sparse<SparseMatrix<double> >(rows, cols, options)));
+    CALL_SUBTEST_2((test_sparse<SparseMatrix<float, RowMajor> >(rows, cols, options)));
+    CALL_SUBTEST_2((test_sparse<SparseMatrix<std::complex<double>, ColMajor, int64_t> >(rows, cols, options)));
+
+    Tensor<float, 3> t3(internal::random<int>(1, 10), internal::random<int>(1, 10), internal::random<int>(1, 10));
+    t3.setRandom();
+    CALL_SUBTEST_3(test_tensor(t3, options));
+    Tensor<double, 4, RowMajor> t4(3, 1, 4, 5);
+    t4.setRandom();
+    CALL_SUBTEST_3(test_tensor(t4, options));
+    TEST_SET_BUT_UNUSED_VARIABLE(rows)
+    TEST_SET_BUT_UNUSED_VARIABLE(cols)
+    TEST_SET_BUT_UNUSED_VARIABLE(options)
+  }
+  CALL_SUBTEST_4(test_checksums());
+  CALL_SUBTEST_4(test_errors());
+  CALL_SUBTEST_5(test_product<ColMajor>(50, 30, 40));
+  CALL_SUBTEST_5(test_product<RowMajor>(internal::random<Index>(1, 60), internal::random<Index>(1, 60), 40));
+}
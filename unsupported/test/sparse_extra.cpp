@@ -22,16 +22,6 @@
 
 #include <Eigen/SparseExtra>
 
-// Read from an environment variable TEST_TMPDIR, if available,
-// and append the provided filename. Defaults to local directory.
-std::string GetTestTempFilename(const char* filename) {
-  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
-  if (test_tmpdir == nullptr) {
-    return std::string(filename);
-  }
-  return std::string(test_tmpdir) + std::string("/") + std::string(filename);
-}
-
 template <typename SetterType, typename DenseType, typename Scalar, int Options>
 bool test_random_setter(SparseMatrix<Scalar, Options>& sm, const DenseType& ref,
                         const std::vector<Vector2i>& nonzeroCoords) {
@@ -135,6 +125,62 @@ void check_marketio() {
   VERIFY_IS_EQUAL(DenseMatrix(m1), DenseMatrix(m2));
 }
 
+template <typename SparseMatrixType>
+void check_marketio_large() {
+  typedef typename SparseMatrixType::Scalar Scalar;
+  // Large enough to be split into several chunks when parsed in parallel.
+  Index rows = internal::random<Index>(1000, 3000), cols = internal::random<Index>(1000, 3000);
+  SparseMatrixType m1(rows, cols), m2;
+  std::vector<Triplet<Scalar, typename SparseMatrixType::StorageIndex> > entries;
+  for (Index k = 0; k < 60000; ++k)
+    entries.emplace_back(internal::random<Index>(0, rows - 1), internal::random<Index>(0, cols - 1),
+                         internal::random<Scalar>());
+  m1.setFromTriplets(entries.begin(), entries.end());
+  std::string filename = GetTestTempFilename("sparse_extra_large.mtx");
+  VERIFY(saveMarket(m1, filename));
+  VERIFY(loadMarket(m2, filename));
+  VERIFY_IS_EQUAL(m2.nonZeros(), m1.nonZeros());
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrix;
+  VERIFY_IS_EQUAL(DenseMatrix(m1), DenseMatrix(m2));
+}
+
+void check_marketio_format() {
+  std::string filename = GetTestTempFilename("sparse_extra_format.mtx");
+  SparseMatrix<double> m;
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n% comment\n%\n  3 4\t3\r\n"
+        << "1 1 1.5\r\n\n\t2  4 -2e-3\n 3 2 +4\n";
+  }
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.rows(), 3);
+  VERIFY_IS_EQUAL(m.cols(), 4);
+  VERIFY_IS_EQUAL(m.nonZeros(), 3);
+  VERIFY_IS_EQUAL(m.coeff(0, 0), 1.5);
+  VERIFY_IS_EQUAL(m.coeff(1, 3), -2e-3);
+  VERIFY_IS_EQUAL(m.coeff(2, 1), 4.0);
+
+  // Blank lines before the size line.
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n\n% comment\r\n \t\r\n\n2 2 1\n2 1 3\n";
+  }
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.rows(), 2);
+  VERIFY_IS_EQUAL(m.nonZeros(), 1);
+  VERIFY_IS_EQUAL(m.coeff(1, 0), 3.0);
+
+  // Missing size, out of range index, missing value and wrong number of entries.
+  const char* invalid[] = {"\n\n", "3 3 1\n4 1 1.0\n", "3 3 1\n1 1\n", "3 3 2\n1 1 1.0\n", "3 3 1\n1 1 x\n"};
+  for (const char* content : invalid) {
+    {
+      std::ofstream out(filename.c_str());
+      out << "%%MatrixMarket matrix coordinate real general\n" << content;
+    }
+    VERIFY(!loadMarket(m, filename));
+  }
+}
+
 template <typename VectorType>
 void check_marketio_vector() {
   Index size = internal::random<Index>(1, 100);
@@ -249,6 +295,10 @@ EIGEN_DECLARE_TEST(sparse_extra) {
 
     CALL_SUBTEST_6((check_sparse_inverse<double>()));
 
+    CALL_SUBTEST_7((check_marketio_large<SparseMatrix<double> >()));
+    CALL_SUBTEST_7((check_marketio_large<SparseMatrix<std::complex<float>, RowMajor, long int> >()));
+
     TEST_SET_BUT_UNUSED_VARIABLE(s);
   }
+  CALL_SUBTEST_7(check_marketio_format());
 }
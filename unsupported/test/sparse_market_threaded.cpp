@@ -0,0 +1,47 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_GEMM_THREADPOOL
+#include "main.h"
+#include <Eigen/SparseExtra>
+
+template <typename SparseMatrixType>
+void test_market_threaded(Index rows, Index cols, Index nnz) {
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrix;
+  SparseMatrixType m1(rows, cols), m2, m3;
+  std::vector<Triplet<Scalar, typename SparseMatrixType::StorageIndex> > entries;
+  for (Index k = 0; k < nnz; ++k)
+    entries.emplace_back(internal::random<Index>(0, rows - 1), internal::random<Index>(0, cols - 1),
+                         internal::random<Scalar>());
+  m1.setFromTriplets(entries.begin(), entries.end());
+
+  // The file is large enough to be parsed in several chunks, whose boundaries fall inside lines.
+  std::string filename = GetTestTempFilename("sparse_market_threaded.mtx");
+  VERIFY(saveMarket(m1, filename));
+  VERIFY(loadMarket(m2, filename));
+  VERIFY_IS_EQUAL(m2.nonZeros(), m1.nonZeros());
+  VERIFY_IS_EQUAL(DenseMatrix(m1), DenseMatrix(m2));
+
+  // Same result with a single thread.
+  const int threads = nbThreads();
+  setNbThreads(1);
+  VERIFY(loadMarket(m3, filename));
+  setNbThreads(threads);
+  VERIFY_IS_EQUAL(DenseMatrix(m2), DenseMatrix(m3));
+}
+
+EIGEN_DECLARE_TEST(sparse_market_threaded) {
+  ThreadPool pool(4);
+  setGemmThreadPool(&pool);
+  VERIFY_IS_EQUAL(nbThreads(), 4);
+  for (int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1((test_market_threaded<SparseMatrix<double> >(2000, 1500, 200000)));
+    CALL_SUBTEST_2((test_market_threaded<SparseMatrix<std::complex<float>, RowMajor> >(700, 900, 60000)));
+    CALL_SUBTEST_3((test_market_threaded<SparseMatrix<double> >(30, 20, 10)));
+  }
+}